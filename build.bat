@@ -20,10 +20,11 @@ set "IMGUI_SRC=external\imgui\imgui.cpp external\imgui\imgui_demo.cpp external\i
 REM Backends (DX11 + Win32)
 set "BACKEND_SRC=external\imgui\backends\imgui_impl_dx11.cpp external\imgui\backends\imgui_impl_win32.cpp"
 REM App
-set "APP_SRC=src\main.cpp src\network\UdpSocket.cpp src\radar\TrackManager.cpp src\radar\Track.cpp src\physics\KalmanFilter.cpp src\physics\ExtendedKalmanFilter.cpp"
+set "CORE_SRC=src\network\UdpSocket.cpp src\network\MetricsServer.cpp src\radar\TrackManager.cpp src\radar\Track.cpp src\radar\TrackHistory.cpp src\radar\TrackPool.cpp src\radar\TrackerPipeline.cpp src\radar\MetricsRegistry.cpp src\physics\KalmanFilter.cpp src\physics\ExtendedKalmanFilter.cpp src\radar\SpatialGrid.cpp src\radar\TrackInitiator.cpp src\radar\FixedLagSmoother.cpp src\radar\SensorRegistry.cpp src\radar\SensorMerger.cpp src\radar\Partition.cpp src\radar\PlotRouter.cpp src\radar\TrackFusion.cpp src\radar\Checkpoint.cpp src\radar\ScanScheduler.cpp src\radar\ThreadPool.cpp src\radar\Association.cpp src\radar\MultiHypothesis.cpp src\radar\GateKernel.cpp"
+set "APP_SRC=src\main.cpp %CORE_SRC%"
 
 REM --- Includes ---
-set "INCLUDES=/Iinclude /Iexternal\glm /Iexternal\imgui /Iexternal\imgui\backends"
+set "INCLUDES=/Iinclude /Isrc /Iexternal\glm /Iexternal\imgui /Iexternal\imgui\backends"
 
 REM --- Flags ---
 set "CFLAGS=/nologo /std:c++20 /W4 /EHsc /MD /O2"
@@ -40,6 +41,11 @@ cl %CFLAGS% %SENDER_SRC% %INCLUDES% /D_CRT_SECURE_NO_WARNINGS /Fo%OUT_DIR%\ /lin
 
 if %errorlevel% neq 0 exit /b %errorlevel%
 
+REM --- Compile Headless Tracker Daemon ---
+echo Compiling Tracker Daemon...
+cl %CFLAGS% src\trackerd_main.cpp %CORE_SRC% %INCLUDES% /D_CRT_SECURE_NO_WARNINGS /Fo%OUT_DIR%\ /link /out:%OUT_DIR%\aegis_trackerd.exe ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
 echo Compiling Tests...
 cl /EHsc /std:c++17 %INCLUDES% /I src tests\test_kalman.cpp src\physics\KalmanFilter.cpp /Fe:build\test_kalman.exe
 if %errorlevel% neq 0 exit /b %errorlevel%
@@ -48,6 +54,94 @@ echo Compiling EKF Tests...
 cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_ekf.cpp src\physics\ExtendedKalmanFilter.cpp /Fe:build\test_ekf.exe /Fo%OUT_DIR%\
 if %errorlevel% neq 0 exit /b %errorlevel%
 
+echo Compiling State Filter Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_state_filter.cpp /Fe:build\test_state_filter.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling IMM Tests and Benchmark...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_imm.cpp src\radar\Track.cpp src\physics\ExtendedKalmanFilter.cpp /Fe:build\test_imm.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl %CFLAGS% %INCLUDES% /I src tests\bench_imm.cpp src\physics\ExtendedKalmanFilter.cpp /Fe:build\bench_imm.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl %CFLAGS% %INCLUDES% /I src tests\bench_ctrv.cpp src\physics\ExtendedKalmanFilter.cpp /Fe:build\bench_ctrv.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Spatial Index Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_spatial_index.cpp %CORE_SRC% /Fe:build\test_spatial_index.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Track Initiator Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_track_initiator.cpp %CORE_SRC% /Fe:build\test_track_initiator.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Out-of-Sequence Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_oosm.cpp %CORE_SRC% /Fe:build\test_oosm.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Smoother Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_smoother.cpp %CORE_SRC% /Fe:build\test_smoother.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Sensor Fusion Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_sensors.cpp %CORE_SRC% /Fe:build\test_sensors.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Partition Tests and Benchmark...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_partition.cpp %CORE_SRC% /Fe:build\test_partition.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl %CFLAGS% %INCLUDES% /I src tests\bench_partition.cpp %CORE_SRC% /Fe:build\bench_partition.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_partition_cluster.cpp %CORE_SRC% /Fe:build\test_partition_cluster.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Track Fusion Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_fusion.cpp %CORE_SRC% /Fe:build\test_fusion.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Checkpoint Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_checkpoint.cpp %CORE_SRC% /Fe:build\test_checkpoint.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Scan Scheduler Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_scheduler.cpp %CORE_SRC% /Fe:build\test_scheduler.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Association Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_association.cpp %CORE_SRC% /Fe:build\test_association.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl %CFLAGS% %INCLUDES% /I src tests\bench_association.cpp %CORE_SRC% /Fe:build\bench_association.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Gate Kernel Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_gate_kernel.cpp %CORE_SRC% /Fe:build\test_gate_kernel.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+cl %CFLAGS% %INCLUDES% /I src tests\bench_gate_kernel.cpp %CORE_SRC% /Fe:build\bench_gate_kernel.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling MHT Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_mht.cpp %CORE_SRC% /Fe:build\test_mht.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Determinism Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_determinism.cpp %CORE_SRC% /Fe:build\test_determinism.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Track Pool Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_track_pool.cpp %CORE_SRC% /Fe:build\test_track_pool.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Track History Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_track_history.cpp src\radar\TrackHistory.cpp /Fe:build\test_track_history.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Metrics Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_metrics.cpp src\radar\MetricsRegistry.cpp /Fe:build\test_metrics.exe /Fo%OUT_DIR%\
+if %errorlevel% neq 0 exit /b %errorlevel%
+
+echo Compiling Metrics Server Tests...
+cl /EHsc /std:c++20 %INCLUDES% /I src tests\test_metrics_server.cpp src\network\MetricsServer.cpp src\radar\MetricsRegistry.cpp /Fe:build\test_metrics_server.exe /Fo%OUT_DIR%\ ws2_32.lib
+if %errorlevel% neq 0 exit /b %errorlevel%
+
 if %ERRORLEVEL% EQU 0 (
     echo Build Successful! Run %OUT_DIR%\%EXE_NAME% or %OUT_DIR%\Sender.exe
 ) else (
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace aegis {
@@ -14,7 +15,64 @@ struct Plot {
   float velocity;   // Speed (m/s)
   float heading;    // Heading (degrees)
   double timestamp; // Time of detection
+  uint16_t sensorId; // Reporting sensor (see SensorRegistry), 0 = default
+};
+
+// Track output published by the tracker to downstream consumers
+struct TrackReport {
+  uint32_t trackId;   // Tracker-assigned track ID
+  uint8_t state;      // TrackState (0=Tentative, 1=Confirmed, 2=Coasting)
+  uint16_t hitCount;  // Successful associations
+  uint16_t missCount; // Consecutive misses
+  float x;            // X position (meters)
+  float y;            // Y position (meters)
+  float vx;           // X velocity (m/s)
+  float vy;           // Y velocity (m/s)
+  double timestamp;   // Time of the last measurement update
+};
+
+// Track handed from one tracker node to the neighbour whose region it has
+// entered: the full estimate, so the neighbour carries on without restarting
+struct TrackHandover {
+  uint32_t trackId;     // Kept across nodes
+  uint16_t fromNode;    // Sending node's index in the partition map
+  uint32_t sequence;    // Per sender and receiver, from 1; 0 in checkpoints
+  uint8_t filterModel;  // TrackFilterModel (0=EKF, 1=IMM)
+  uint8_t state;        // TrackState (0=Tentative, 1=Confirmed, 2=Coasting)
+  uint16_t hitCount;    // Successful associations
+  uint16_t missCount;   // Consecutive misses
+  double stateTime;     // Epoch of the estimate
+  double lastUpdate;    // Time of the last measurement update
+  float x[5];           // CTRV state: x, y, speed, heading (rad), turn rate
+  float covariance[15]; // Packed upper triangle of the 5x5 covariance
+};
+
+// Receipt for a TrackHandover, sent back to the sender's handover port
+// (told apart from a handover by its size). Until it arrives the sender
+// holds the track and re-sends it.
+struct HandoverAck {
+  uint16_t fromNode; // Acknowledging node's index in the partition map
+  uint32_t sequence; // Of the handover acknowledged
+};
+
+// One confirmed track as exchanged between trackers for track-to-track
+// fusion: a Cartesian estimate with its covariance, filter-agnostic and
+// far smaller than the plots behind it. Several are packed per datagram.
+struct TrackStateReport {
+  uint32_t trackId;     // Sender's track ID
+  uint16_t sourceNode;  // Sending tracker
+  uint8_t state;        // TrackState (0=Tentative, 1=Confirmed, 2=Coasting)
+  double timestamp;     // Epoch of the estimate
+  float x;              // X position (meters)
+  float y;              // Y position (meters)
+  float vx;             // X velocity (m/s)
+  float vy;             // Y velocity (m/s)
+  float covariance[10]; // Packed upper triangle over (x, y, vx, vy)
 };
 #pragma pack(pop)
 
+// Senders that predate sensorId send plots ending at the timestamp; the
+// tracker still accepts that size and reads such plots as sensor 0
+constexpr size_t LEGACY_PLOT_SIZE = offsetof(Plot, sensorId);
+
 } // namespace aegis
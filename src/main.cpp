@@ -15,9 +15,7 @@
 #include "imgui.h"
 
 #include "Protocol.h"
-#include "network/UdpSocket.h"
-#include "radar/ThreadSafeQueue.h"
-#include "radar/TrackManager.h"
+#include "radar/TrackerPipeline.h"
 
 // Data
 static ID3D11Device *g_pd3dDevice = nullptr;
@@ -28,9 +26,8 @@ static UINT g_ResizeWidth = 0, g_ResizeHeight = 0;
 static ID3D11RenderTargetView *g_mainRenderTargetView = nullptr;
 
 // Aegis System Components
-aegis::ThreadSafeQueue<aegis::Plot> g_packetQueue;
-aegis::TrackManager g_trackManager;
-std::atomic<bool> g_running = true;
+// Tracking runs on the pipeline's own threads; the GUI is only a consumer.
+aegis::TrackerPipeline g_pipeline;
 
 // Forward declarations of helper functions
 bool CreateDeviceD3D(HWND hWnd);
@@ -39,40 +36,9 @@ void CreateRenderTarget();
 void CleanupRenderTarget();
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
-// Receiver Thread Function
-void ReceiverThread() {
-  try {
-    aegis::net::UdpSocket socket;
-    socket.Bind(5000);
-    // socket.SetNonBlocking(false); // Blocking receive
-
-    std::cout << "Receiver Thread Started on Port 5000" << std::endl;
-
-    while (g_running) {
-      aegis::Plot plot;
-      std::string senderAddr;
-      int senderPort;
-
-      // Use a small timeout or non-blocking if possible to check g_running,
-      // but for now blocking is fine as we can kill the app.
-      // Actually, if we block forever, joining the thread at exit might hang if
-      // no packets come. Let's set a timeout if we could, but UdpSocket wrapper
-      // is simple. We'll just rely on OS closing the socket or detaching.
-
-      int bytes =
-          socket.ReceiveFrom(&plot, sizeof(plot), senderAddr, senderPort);
-      if (bytes == sizeof(plot)) {
-        g_packetQueue.Push(plot);
-      }
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "Receiver Error: " << e.what() << std::endl;
-  }
-}
-
 // Visualization Helper
 void DrawPPIScope(ImDrawList *draw_list, const ImVec2 &center, float radius,
-                  const std::vector<std::shared_ptr<aegis::Track>> &tracks) {
+                  const aegis::TrackSnapshot &snapshot) {
   // Draw Radar Circle
   draw_list->AddCircle(center, radius, IM_COL32(0, 255, 0, 255), 64, 2.0f);
   draw_list->AddCircle(center, radius * 0.75f, IM_COL32(0, 255, 0, 100), 64,
@@ -94,15 +60,19 @@ void DrawPPIScope(ImDrawList *draw_list, const ImVec2 &center, float radius,
   // Map World Coordinates (-10000 to 10000) to Screen Coordinates
   float scale = radius / 10000.0f; // 10km range
 
-  for (const auto &track : tracks) {
-    glm::vec2 pos = track->GetPosition();
+  // Scratch buffers reused across frames
+  static std::vector<glm::vec2> trail;
+  static std::vector<ImVec2> screenTrail;
+
+  for (const auto &track : snapshot.tracks) {
+    glm::vec2 pos = track.position;
     ImVec2 screenPos(center.x + pos.x * scale,
                      center.y - pos.y * scale); // Invert Y for screen
 
     // Color-code by track state
     ImU32 trackColor, textColor;
     const char *statePrefix;
-    switch (track->GetState()) {
+    switch (track.state) {
     case aegis::TrackState::CONFIRMED:
       trackColor = IM_COL32(0, 255, 0, 255); // Green (confirmed)
       textColor = IM_COL32(0, 255, 0, 255);
@@ -125,15 +95,21 @@ void DrawPPIScope(ImDrawList *draw_list, const ImVec2 &center, float radius,
       break;
     }
 
-    // Draw History Trail
-    const auto &history = track->GetHistory();
-    ImU32 trailColor = IM_COL32(0, 255, 0, 100);
-    for (size_t i = 1; i < history.size(); ++i) {
-      ImVec2 p1(center.x + history[i - 1].x * scale,
-                center.y - history[i - 1].y * scale);
-      ImVec2 p2(center.x + history[i].x * scale,
-                center.y - history[i].y * scale);
-      draw_list->AddLine(p1, p2, trailColor, 1.0f);
+    // Draw History Trail: merge points closer than one pixel, then submit
+    // the whole trail as a single polyline
+    const glm::vec2 *history = snapshot.history.data() + track.historyOffset;
+    trail.resize(track.historyCount);
+    size_t trailCount = aegis::DecimateTrail(history, track.historyCount,
+                                             1.0f / scale, trail.data(),
+                                             trail.size());
+    screenTrail.resize(trailCount);
+    for (size_t i = 0; i < trailCount; ++i) {
+      screenTrail[i] = ImVec2(center.x + trail[i].x * scale,
+                              center.y - trail[i].y * scale);
+    }
+    if (trailCount > 1) {
+      draw_list->AddPolyline(screenTrail.data(), static_cast<int>(trailCount),
+                             IM_COL32(0, 255, 0, 100), ImDrawFlags_None, 1.0f);
     }
 
     // Draw Current Position (Blip) - color-coded by state
@@ -141,15 +117,15 @@ void DrawPPIScope(ImDrawList *draw_list, const ImVec2 &center, float radius,
 
     // Draw ID with state prefix
     std::string idStr =
-        statePrefix + std::to_string(track->GetId()) + " (" +
-        std::to_string(track->GetHitCount()) + "/" +
-        std::to_string(track->GetMissCount()) + ")";
+        statePrefix + std::to_string(track.id) + " (" +
+        std::to_string(track.hitCount) + "/" +
+        std::to_string(track.missCount) + ")";
     draw_list->AddText(ImVec2(screenPos.x + 8, screenPos.y + 8), textColor,
                        idStr.c_str());
 
     // Draw Velocity Vector (only for confirmed tracks)
-    if (track->GetState() == aegis::TrackState::CONFIRMED) {
-      glm::vec2 vel = track->GetVelocity();
+    if (track.state == aegis::TrackState::CONFIRMED) {
+      glm::vec2 vel = track.velocity;
       ImVec2 velEnd(screenPos.x + vel.x * scale * 10.0f,
                     screenPos.y -
                         vel.y * scale * 10.0f); // Scale velocity for visibility
@@ -227,9 +203,12 @@ int main(int, char **) {
   ImGui_ImplWin32_Init(hwnd);
   ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
 
-  // Start Receiver Thread
-  std::thread receiver(ReceiverThread);
-  receiver.detach(); // Detach for now, simple exit
+  // Start Tracking Pipeline (ingest, association and pruning threads)
+  try {
+    g_pipeline.Start();
+  } catch (const std::exception &e) {
+    std::cerr << "Pipeline Error: " << e.what() << std::endl;
+  }
 
   ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.00f);
 
@@ -256,21 +235,12 @@ int main(int, char **) {
       CreateRenderTarget();
     }
 
-    // --- Core Logic ---
-    // Process incoming packets
-    while (!g_packetQueue.Empty()) {
-      auto plot = g_packetQueue.Pop();
-      g_trackManager.ProcessPlot(plot.id, plot.x, plot.y, plot.timestamp);
-    }
-
-    // Prune old tracks
-    double currentTime =
-        std::chrono::duration<double>(
-            std::chrono::high_resolution_clock::now().time_since_epoch())
-            .count();
-    g_trackManager.PruneTracks(currentTime);
-
     // --- Rendering ---
+    // One immutable snapshot per frame, shared by every window
+    auto snapshot = g_pipeline.GetSnapshot();
+    const aegis::TrackSnapshot emptySnapshot;
+    const aegis::TrackSnapshot &scan = snapshot ? *snapshot : emptySnapshot;
+
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
@@ -289,8 +259,7 @@ int main(int, char **) {
                     winPos.y + winSize.y * 0.5f + 20); // Offset for title bar
       float radius = (std::min(winSize.x, winSize.y) * 0.4f);
 
-      auto tracks = g_trackManager.GetTracks();
-      DrawPPIScope(ImGui::GetWindowDrawList(), center, radius, tracks);
+      DrawPPIScope(ImGui::GetWindowDrawList(), center, radius, scan);
 
       ImGui::End();
     }
@@ -313,14 +282,13 @@ int main(int, char **) {
         ImGui::TableSetupColumn("Hits/Misses");
         ImGui::TableHeadersRow();
 
-        auto tracks = g_trackManager.GetTracks();
-        for (const auto &track : tracks) {
+        for (const auto &track : scan.tracks) {
           ImGui::TableNextRow();
 
           // Color-code rows by state
           ImVec4 rowColor;
           const char *stateStr;
-          switch (track->GetState()) {
+          switch (track.state) {
           case aegis::TrackState::CONFIRMED:
             rowColor = ImVec4(0.0f, 0.5f, 0.0f, 0.3f);
             stateStr = "CONFIRMED";
@@ -342,19 +310,19 @@ int main(int, char **) {
                                  ImGui::GetColorU32(rowColor));
 
           ImGui::TableSetColumnIndex(0);
-          ImGui::Text("%d", track->GetId());
+          ImGui::Text("%d", track.id);
           ImGui::TableSetColumnIndex(1);
           ImGui::Text("%s", stateStr);
           ImGui::TableSetColumnIndex(2);
-          ImGui::Text("%.1f", track->GetPosition().x);
+          ImGui::Text("%.1f", track.position.x);
           ImGui::TableSetColumnIndex(3);
-          ImGui::Text("%.1f", track->GetPosition().y);
+          ImGui::Text("%.1f", track.position.y);
           ImGui::TableSetColumnIndex(4);
-          glm::vec2 v = track->GetVelocity();
+          glm::vec2 v = track.velocity;
           float speed = std::sqrt(v.x * v.x + v.y * v.y);
           ImGui::Text("%.1f m/s", speed);
           ImGui::TableSetColumnIndex(5);
-          ImGui::Text("%d/%d", track->GetHitCount(), track->GetMissCount());
+          ImGui::Text("%d/%d", track.hitCount, track.missCount);
         }
         ImGui::EndTable();
       }
@@ -367,9 +335,8 @@ int main(int, char **) {
       ImGui::SetNextWindowSize(ImVec2(550, 240), ImGuiCond_FirstUseEver);
       ImGui::Begin("Performance Metrics");
 
-      // Update metrics before displaying
-      g_trackManager.UpdateMetrics();
-      const auto &metrics = g_trackManager.GetMetrics();
+      // Metrics are captured with the scan they describe
+      const auto &metrics = scan.metrics;
 
       // Track Statistics
       ImGui::Text("Track Statistics:");
@@ -386,18 +353,27 @@ int main(int, char **) {
       // Association Metrics
       ImGui::Text("Association Metrics:");
       ImGui::Separator();
-      ImGui::Text("Total Plots:      %d", metrics.totalPlots);
-      ImGui::Text("Associated Plots: %d (%.1f%%)", metrics.associatedPlots,
+      ImGui::Text("Total Plots:      %llu",
+                  (unsigned long long)metrics.totalPlots);
+      ImGui::Text("Associated Plots: %llu (%.1f%%)",
+                  (unsigned long long)metrics.associatedPlots,
                   metrics.GetAssociationRate() * 100.0f);
-      ImGui::Text("New Tracks:       %d", metrics.newTracks);
+      ImGui::Text("New Tracks:       %llu",
+                  (unsigned long long)metrics.newTracks);
 
       ImGui::Spacing();
 
       // Track Lifecycle
       ImGui::Text("Track Lifecycle:");
       ImGui::Separator();
-      ImGui::Text("Tracks Created:   %d", metrics.tracksCreated);
-      ImGui::Text("Tracks Deleted:   %d", metrics.tracksDeleted);
+      ImGui::Text("Tracks Created:   %llu",
+                  (unsigned long long)metrics.tracksCreated);
+      ImGui::Text("Tracks Deleted:   %llu",
+                  (unsigned long long)metrics.tracksDeleted);
+      ImGui::Text("Tracks Evicted:   %llu",
+                  (unsigned long long)metrics.tracksEvicted);
+      ImGui::Text("Plots Shed:       %llu",
+                  (unsigned long long)metrics.plotsDroppedAtCapacity);
 
       ImGui::Spacing();
 
@@ -405,8 +381,9 @@ int main(int, char **) {
       ImGui::Text("Accuracy:");
       ImGui::Separator();
       if (metrics.positionErrorSamples > 0) {
-        ImGui::Text("Avg Position Error: %.2f m (n=%d)",
-                    metrics.avgPositionError, metrics.positionErrorSamples);
+        ImGui::Text("Avg Position Error: %.2f m (sd %.2f m, n=%llu)",
+                    metrics.avgPositionError, metrics.positionErrorStdDev,
+                    (unsigned long long)metrics.positionErrorSamples);
       } else {
         ImGui::Text("Avg Position Error: N/A");
       }
@@ -429,8 +406,7 @@ int main(int, char **) {
     g_SwapChainOccluded = (hr == DXGI_STATUS_OCCLUDED);
   }
 
-  g_running = false;
-  // receiver.join(); // If we didn't detach
+  g_pipeline.Stop();
 
   // Cleanup
   ImGui_ImplDX11_Shutdown();
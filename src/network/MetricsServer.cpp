@@ -0,0 +1,272 @@
+#include "MetricsServer.h"
+#include <algorithm>
+#include <iostream>
+
+namespace aegis::net {
+
+namespace {
+
+const char *StatusText(int status) {
+  switch (status) {
+  case 200:
+    return "OK";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 413:
+    return "Payload Too Large";
+  case 500:
+    return "Internal Server Error";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "Unknown";
+  }
+}
+
+std::string Serialize(const HttpResponse &response) {
+  std::string out = "HTTP/1.1 " + std::to_string(response.status) + " " +
+                    StatusText(response.status) + "\r\n";
+  out += "Content-Type: " + response.contentType + "\r\n";
+  out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+  out += "Cache-Control: no-store\r\n";
+  out += "Connection: close\r\n\r\n";
+  out += response.body;
+  return out;
+}
+
+HttpResponse TextResponse(int status, const std::string &body) {
+  HttpResponse response;
+  response.status = status;
+  response.body = body + "\n";
+  return response;
+}
+
+} // namespace
+
+MetricsServer::MetricsServer()
+    : m_listenSocket(kInvalidSocket), m_initialized(false) {
+  // Initialize Winsock (no-op on POSIX)
+  if (!StartupSockets()) {
+    throw std::runtime_error("WSAStartup failed: " +
+                             std::to_string(LastSocketError()));
+  }
+  m_initialized = true;
+}
+
+MetricsServer::~MetricsServer() {
+  Stop();
+  if (m_initialized) {
+    CleanupSockets();
+  }
+}
+
+void MetricsServer::AddRoute(const std::string &path, Handler handler) {
+  m_routes[path] = std::move(handler);
+}
+
+void MetricsServer::Start(const std::string &address, int port) {
+  if (m_running) {
+    return;
+  }
+
+  m_listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (m_listenSocket == kInvalidSocket) {
+    throw std::runtime_error("socket failed: " +
+                             std::to_string(LastSocketError()));
+  }
+
+  int reuse = 1;
+  setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR,
+             reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+  sockaddr_in service{};
+  service.sin_family = AF_INET;
+  service.sin_port = htons(static_cast<uint16_t>(port));
+  if (inet_pton(AF_INET, address.c_str(), &service.sin_addr) != 1) {
+    CloseSocket(m_listenSocket);
+    m_listenSocket = kInvalidSocket;
+    throw std::runtime_error("invalid metrics address: " + address);
+  }
+
+  if (bind(m_listenSocket, reinterpret_cast<sockaddr *>(&service),
+           sizeof(service)) == kSocketError ||
+      listen(m_listenSocket, 16) == kSocketError) {
+    int error = LastSocketError();
+    CloseSocket(m_listenSocket);
+    m_listenSocket = kInvalidSocket;
+    throw std::runtime_error("metrics bind failed: " + std::to_string(error));
+  }
+  SetSocketNonBlocking(m_listenSocket, true);
+
+  sockaddr_in bound{};
+  SockLen boundLen = sizeof(bound);
+  getsockname(m_listenSocket, reinterpret_cast<sockaddr *>(&bound), &boundLen);
+  m_port = ntohs(bound.sin_port);
+
+  m_connections.reserve(MAX_CONNECTIONS);
+  m_running = true;
+  m_thread = std::thread(&MetricsServer::ServeLoop, this);
+}
+
+void MetricsServer::Stop() {
+  m_running = false;
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+
+  for (auto &conn : m_connections) {
+    CloseSocket(conn.socket);
+  }
+  m_connections.clear();
+
+  if (m_listenSocket != kInvalidSocket) {
+    CloseSocket(m_listenSocket);
+    m_listenSocket = kInvalidSocket;
+  }
+}
+
+void MetricsServer::ServeLoop() {
+  while (m_running) {
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+
+    // Stop accepting while full; pending clients wait in the backlog
+    SocketHandle maxSocket = m_listenSocket;
+    if (m_connections.size() < MAX_CONNECTIONS) {
+      FD_SET(m_listenSocket, &readSet);
+    }
+    for (const auto &conn : m_connections) {
+      FD_SET(conn.socket, conn.response.empty() ? &readSet : &writeSet);
+      maxSocket = std::max(maxSocket, conn.socket);
+    }
+
+    // Bounded wait so Stop() is noticed promptly
+    timeval timeout{0, 200 * 1000};
+    int ready = select(static_cast<int>(maxSocket + 1), &readSet, &writeSet,
+                       nullptr, &timeout);
+    if (ready == kSocketError) {
+      if (!IsWouldBlock(LastSocketError())) {
+        std::cerr << "Metrics server select failed: " << LastSocketError()
+                  << std::endl;
+        break;
+      }
+      continue;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < m_connections.size();) {
+      Connection &conn = m_connections[i];
+      bool keep = true;
+      if (FD_ISSET(conn.socket, &readSet)) {
+        keep = ServiceRead(conn);
+      } else if (FD_ISSET(conn.socket, &writeSet)) {
+        keep = ServiceWrite(conn);
+      } else if (now - conn.opened >
+                 std::chrono::milliseconds(CONNECTION_TIMEOUT_MS)) {
+        keep = false; // Idle or stalled client
+      }
+
+      if (keep) {
+        ++i;
+      } else {
+        CloseSocket(conn.socket);
+        m_connections[i] = std::move(m_connections.back());
+        m_connections.pop_back();
+      }
+    }
+
+    if (FD_ISSET(m_listenSocket, &readSet)) {
+      AcceptClients();
+    }
+  }
+}
+
+void MetricsServer::AcceptClients() {
+  while (m_connections.size() < MAX_CONNECTIONS) {
+    SocketHandle client = accept(m_listenSocket, nullptr, nullptr);
+    if (client == kInvalidSocket) {
+      return; // Drained (would block) or transient error
+    }
+    SetSocketNonBlocking(client, true);
+
+    Connection conn;
+    conn.socket = client;
+    conn.opened = std::chrono::steady_clock::now();
+    m_connections.push_back(std::move(conn));
+  }
+}
+
+bool MetricsServer::ServiceRead(Connection &conn) {
+  char buffer[2048];
+  int bytes = recv(conn.socket, buffer, sizeof(buffer), 0);
+  if (bytes == 0) {
+    return false; // Peer closed before finishing its request
+  }
+  if (bytes == kSocketError) {
+    return IsWouldBlock(LastSocketError());
+  }
+
+  conn.request.append(buffer, static_cast<size_t>(bytes));
+  if (conn.request.find("\r\n\r\n") != std::string::npos) {
+    conn.response = Serialize(Dispatch(conn.request));
+  } else if (conn.request.size() > MAX_REQUEST_BYTES) {
+    conn.response = Serialize(TextResponse(413, "request too large"));
+  } else {
+    return true; // Headers incomplete; keep reading
+  }
+
+  // Most responses fit the socket buffer; try to finish without another
+  // select() round
+  return ServiceWrite(conn);
+}
+
+bool MetricsServer::ServiceWrite(Connection &conn) {
+  while (conn.sent < conn.response.size()) {
+    int bytes = send(conn.socket, conn.response.data() + conn.sent,
+                     static_cast<int>(conn.response.size() - conn.sent),
+                     kSendFlags);
+    if (bytes == kSocketError) {
+      return IsWouldBlock(LastSocketError());
+    }
+    conn.sent += static_cast<size_t>(bytes);
+  }
+  return false; // Response complete; close
+}
+
+HttpResponse MetricsServer::Dispatch(const std::string &request) const {
+  // Request line: METHOD SP TARGET SP VERSION
+  size_t methodEnd = request.find(' ');
+  size_t targetEnd = (methodEnd == std::string::npos)
+                         ? std::string::npos
+                         : request.find(' ', methodEnd + 1);
+  if (targetEnd == std::string::npos) {
+    return TextResponse(400, "bad request");
+  }
+
+  std::string method = request.substr(0, methodEnd);
+  std::string path = request.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+  path = path.substr(0, path.find('?'));
+
+  if (method != "GET") {
+    return TextResponse(405, "method not allowed");
+  }
+
+  auto route = m_routes.find(path);
+  if (route == m_routes.end()) {
+    return TextResponse(404, "not found");
+  }
+
+  try {
+    return route->second();
+  } catch (const std::exception &e) {
+    return TextResponse(500, e.what());
+  }
+}
+
+} // namespace aegis::net
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "SocketCompat.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aegis::net {
+
+struct HttpResponse {
+  int status = 200;
+  std::string contentType = "text/plain; charset=utf-8";
+  std::string body;
+};
+
+// Minimal embedded HTTP/1.1 server for metrics scraping and health probes.
+// A single thread multiplexes the listener and all clients with select() on
+// non-blocking sockets, so a slow or stalled client cannot hold anything up.
+// Only GET is supported and every response closes its connection.
+class MetricsServer {
+public:
+  using Handler = std::function<HttpResponse()>;
+
+  MetricsServer();
+  ~MetricsServer();
+
+  // Prevent copying
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  // Register a handler for an exact path (query strings are ignored).
+  // Routes must be added before Start().
+  void AddRoute(const std::string &path, Handler handler);
+
+  // Bind to address:port and start serving. Port 0 picks an ephemeral port.
+  // Throws on bind/listen failure.
+  void Start(const std::string &address, int port);
+
+  // Stops the server thread and closes all connections. Safe to call twice.
+  void Stop();
+
+  // Port actually bound (useful with port 0)
+  int GetPort() const { return m_port; }
+
+private:
+  struct Connection {
+    SocketHandle socket = kInvalidSocket;
+    std::string request;  // Bytes received so far
+    std::string response; // Bytes to send, once the request is complete
+    size_t sent = 0;
+    std::chrono::steady_clock::time_point opened;
+  };
+
+  void ServeLoop();
+  void AcceptClients();
+  // Read/write one connection; returns false once it should be closed
+  bool ServiceRead(Connection &conn);
+  bool ServiceWrite(Connection &conn);
+  HttpResponse Dispatch(const std::string &request) const;
+
+  static constexpr size_t MAX_CONNECTIONS = 32;
+  static constexpr size_t MAX_REQUEST_BYTES = 8192;
+  static constexpr int CONNECTION_TIMEOUT_MS = 5000;
+
+  std::map<std::string, Handler> m_routes;
+  std::vector<Connection> m_connections;
+  SocketHandle m_listenSocket;
+  bool m_initialized;
+  int m_port = 0;
+  std::atomic<bool> m_running{false};
+  std::thread m_thread;
+};
+
+} // namespace aegis::net
@@ -0,0 +1,93 @@
+#pragma once
+
+// Thin portability layer over Winsock and BSD sockets so the network code
+// builds both for the Windows GUI and for the headless Linux daemon.
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace aegis::net {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+using SockLen = int;
+constexpr SocketHandle kInvalidSocket = INVALID_SOCKET;
+constexpr int kSocketError = SOCKET_ERROR;
+
+inline int LastSocketError() { return WSAGetLastError(); }
+inline void CloseSocket(SocketHandle s) { closesocket(s); }
+inline bool IsWouldBlock(int error) {
+  return error == WSAEWOULDBLOCK || error == WSAETIMEDOUT;
+}
+constexpr int kSendFlags = 0;
+#else
+using SocketHandle = int;
+using SockLen = socklen_t;
+constexpr SocketHandle kInvalidSocket = -1;
+constexpr int kSocketError = -1;
+
+inline int LastSocketError() { return errno; }
+inline void CloseSocket(SocketHandle s) { close(s); }
+inline bool IsWouldBlock(int error) {
+  return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+}
+// A peer closing mid-response must not raise SIGPIPE in the daemon
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+#endif
+
+// Winsock must be initialised once per socket owner; a no-op elsewhere.
+inline bool StartupSockets() {
+#ifdef _WIN32
+  WSADATA wsaData;
+  return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+  return true;
+#endif
+}
+
+inline void CleanupSockets() {
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+inline void SetSocketNonBlocking(SocketHandle s, bool nonBlocking) {
+#ifdef _WIN32
+  u_long mode = nonBlocking ? 1 : 0;
+  ioctlsocket(s, FIONBIO, &mode);
+#else
+  int flags = fcntl(s, F_GETFL, 0);
+  fcntl(s, F_SETFL, nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+#endif
+}
+
+inline void SetSocketReceiveTimeout(SocketHandle s, int timeoutMs) {
+#ifdef _WIN32
+  DWORD tv = static_cast<DWORD>(timeoutMs);
+#else
+  timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+#endif
+  setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&tv),
+             sizeof(tv));
+}
+
+} // namespace aegis::net
@@ -3,71 +3,72 @@
 
 namespace aegis::net {
 
-UdpSocket::UdpSocket() : m_socket(INVALID_SOCKET), m_initialized(false) {
-  // Initialize Winsock
-  WSADATA wsaData;
-  int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-  if (result != 0) {
-    throw std::runtime_error("WSAStartup failed: " + std::to_string(result));
+UdpSocket::UdpSocket() : m_socket(kInvalidSocket), m_initialized(false) {
+  // Initialize Winsock (no-op on POSIX)
+  if (!StartupSockets()) {
+    throw std::runtime_error("WSAStartup failed: " +
+                             std::to_string(LastSocketError()));
   }
 
   // Create UDP socket
   m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-  if (m_socket == INVALID_SOCKET) {
-    WSACleanup();
-    throw std::runtime_error("socket failed: " +
-                             std::to_string(WSAGetLastError()));
+  if (m_socket == kInvalidSocket) {
+    int error = LastSocketError();
+    CleanupSockets();
+    throw std::runtime_error("socket failed: " + std::to_string(error));
   }
 
   m_initialized = true;
 }
 
 UdpSocket::~UdpSocket() {
-  if (m_socket != INVALID_SOCKET) {
-    closesocket(m_socket);
+  if (m_socket != kInvalidSocket) {
+    CloseSocket(m_socket);
   }
   if (m_initialized) {
-    WSACleanup();
+    CleanupSockets();
   }
 }
 
 void UdpSocket::Bind(int port) {
-  sockaddr_in service;
+  sockaddr_in service{};
   service.sin_family = AF_INET;
   service.sin_addr.s_addr = INADDR_ANY;
-  service.sin_port = htons(static_cast<u_short>(port));
+  service.sin_port = htons(static_cast<uint16_t>(port));
 
-  if (bind(m_socket, (SOCKADDR *)&service, sizeof(service)) == SOCKET_ERROR) {
+  if (bind(m_socket, reinterpret_cast<sockaddr *>(&service),
+           sizeof(service)) == kSocketError) {
     throw std::runtime_error("bind failed: " +
-                             std::to_string(WSAGetLastError()));
+                             std::to_string(LastSocketError()));
   }
 }
 
 void UdpSocket::SendTo(const std::string &address, int port, const void *data,
                        size_t size) {
-  sockaddr_in dest;
+  sockaddr_in dest{};
   dest.sin_family = AF_INET;
-  dest.sin_port = htons(static_cast<u_short>(port));
+  dest.sin_port = htons(static_cast<uint16_t>(port));
   inet_pton(AF_INET, address.c_str(), &dest.sin_addr);
 
   if (sendto(m_socket, static_cast<const char *>(data), static_cast<int>(size),
-             0, (SOCKADDR *)&dest, sizeof(dest)) == SOCKET_ERROR) {
-    std::cerr << "sendto failed: " << WSAGetLastError() << std::endl;
+             0, reinterpret_cast<sockaddr *>(&dest),
+             sizeof(dest)) == kSocketError) {
+    std::cerr << "sendto failed: " << LastSocketError() << std::endl;
   }
 }
 
 int UdpSocket::ReceiveFrom(void *buffer, size_t size,
                            std::string &senderAddress, int &senderPort) {
-  sockaddr_in sender;
-  int senderLen = sizeof(sender);
+  sockaddr_in sender{};
+  SockLen senderLen = sizeof(sender);
 
-  int bytesReceived =
-      recvfrom(m_socket, static_cast<char *>(buffer), static_cast<int>(size), 0,
-               (SOCKADDR *)&sender, &senderLen);
+  int bytesReceived = static_cast<int>(
+      recvfrom(m_socket, static_cast<char *>(buffer), static_cast<int>(size),
+               0, reinterpret_cast<sockaddr *>(&sender), &senderLen));
 
-  if (bytesReceived == SOCKET_ERROR) {
-    int error = WSAGetLastError();
-    if (error != WSAEWOULDBLOCK) {
+  if (bytesReceived == kSocketError) {
+    int error = LastSocketError();
+    if (!IsWouldBlock(error)) {
       std::cerr << "recvfrom failed: " << error << std::endl;
     }
     return -1;
@@ -82,8 +83,11 @@ int UdpSocket::ReceiveFrom(void *buffer, size_t size,
 }
 
 void UdpSocket::SetNonBlocking(bool nonBlocking) {
-  u_long mode = nonBlocking ? 1 : 0;
-  ioctlsocket(m_socket, FIONBIO, &mode);
+  SetSocketNonBlocking(m_socket, nonBlocking);
+}
+
+void UdpSocket::SetReceiveTimeout(int timeoutMs) {
+  SetSocketReceiveTimeout(m_socket, timeoutMs);
 }
 
 } // namespace aegis::net
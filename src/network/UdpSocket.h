@@ -1,13 +1,9 @@
 #pragma once
 
+#include "SocketCompat.h"
 #include <stdexcept>
 #include <string>
 #include <vector>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-
-#pragma comment(lib, "Ws2_32.lib")
 
 namespace aegis::net {
 
@@ -29,14 +25,18 @@ public:
 
   // Receive data (blocking or non-blocking depending on socket state)
   // Returns number of bytes received. Fills senderAddress and senderPort.
+  // Returns -1 on error or when the receive timeout expires.
   int ReceiveFrom(void *buffer, size_t size, std::string &senderAddress,
                   int &senderPort);
 
   // Set non-blocking mode
   void SetNonBlocking(bool nonBlocking);
 
+  // Bound blocking receives so owner threads can observe shutdown requests
+  void SetReceiveTimeout(int timeoutMs);
+
 private:
-  SOCKET m_socket;
+  SocketHandle m_socket;
   bool m_initialized;
 };
 
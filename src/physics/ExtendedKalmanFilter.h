@@ -1,58 +1,82 @@
 #pragma once
 
+#include "MotionModels.h"
+#include "StateFilter.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace aegis {
 
+// Single-precision CTRV tracking filter: the tracker-facing wrapper around
+// StateFilter<float, CtrvModel> with the tuned noise parameters
 class ExtendedKalmanFilter {
 public:
+  using Filter = StateFilter<float, CtrvModel>;
+
   // State: [x, y, v, heading, turn_rate]
+  ExtendedKalmanFilter() : ExtendedKalmanFilter(0.0f, 0.0f, 0.0f, 0.0f) {}
   ExtendedKalmanFilter(float initialX, float initialY, float initialV,
                        float initialHeading);
 
-  void Predict(float dt);
+  void Predict(float dt) {
+    m_filter.Predict(dt);
+    m_sinceUpdate += dt;
+  }
+  // A filter with no speed (v = 0, as a single-plot start leaves it) has no
+  // heading to linearise about: the first plot after a predict sets its
+  // velocity by StartFromPlots instead of a Kalman update
   void Update(float measX, float measY);
+  // Update with the plot's own noise R = [rxx rxy; rxy ryy]
+  void Update(float measX, float measY, float rxx, float rxy, float ryy);
+
+  // Two-point start: the estimate at (x1, y1) from an earlier position
+  // (x0, y0) dt seconds before, with per-axis variances r0 and r1.
+  // Velocity is the difference over dt; speed, heading and their
+  // correlation with position follow from linearising it.
+  void StartFromPlots(float x0, float y0, float r0, float x1, float y1,
+                      float r1, float dt);
 
   glm::vec4 GetState() const; // Returns [x, y, vx, vy] for compatibility
   glm::vec2 GetPosition() const;
   glm::vec2 GetVelocity() const;
 
   // Mahalanobis distance for gating (sensor fusion best practice)
-  float GetMahalanobisDistance(float measX, float measY) const;
+  float GetMahalanobisDistance(float measX, float measY) const {
+    return m_filter.MahalanobisDistance({measX, measY});
+  }
+
+  // Innovation covariance S = H*P*H^T + R for a position plot
+  void GetInnovationCovariance(float &sxx, float &sxy, float &syy) const {
+    float S[4];
+    m_filter.GetInnovationCovariance(S);
+    sxx = S[0];
+    sxy = S[1];
+    syy = S[3];
+  }
+
+  // Covariance element (symmetric, so (row, col) and (col, row) agree)
+  float GetCovariance(int row, int col) const {
+    return m_filter.GetCovariance(row, col);
+  }
+
+  Filter &GetFilter() { return m_filter; }
+  const Filter &GetFilter() const { return m_filter; }
+
+  static constexpr int STATE_DIM = Filter::STATE_DIM;
+  static constexpr int PACKED_SIZE = Filter::PACKED_SIZE;
+
+  static constexpr float MEASUREMENT_VARIANCE = 2500.0f; // m^2, 50m plots
+  static constexpr float HEADING_VARIANCE = 1.0f;        // rad^2 prior
+  static constexpr float TURN_RATE_VARIANCE = 0.01f;     // (rad/s)^2 prior
 
 private:
-  // 5D State vector: x, y, v, heading, turn_rate
-  // We'll use glm::vec<5, float> if available, but GLM usually supports up to
-  // vec4. We can use a custom struct or just an array, or a larger matrix.
-  // Let's use Eigen if we had it, but we don't.
-  // We'll use manual arrays or a custom Matrix class, or just map it to
-  // glm::mat<5,1> if possible? GLM doesn't support vec5. We will implement a
-  // simple 5x5 matrix / 5x1 vector wrapper or just use raw arrays for the math.
-  // Actually, for simplicity and readability, let's use a struct for State and
-  // helper functions for matrix math. Or, since we only need 5x5, we can use an
-  // array `float m_x[5]` and `float m_P[25]`.
-
-  // State
-  float m_x[5];
-  // Covariance
-  float m_P[25]; // 5x5 row-major
-
-  // Process Noise
-  float m_Q[25];
-
-  // Measurement Noise
-  float m_R[4]; // 2x2 for x,y measurements
-
-  void MatrixMultiply(const float *A, const float *B, float *C, int r1, int c1,
-                      int c2) const;
-  void MatrixTranspose(const float *A, float *AT, int rows, int cols) const;
-  void MatrixAdd(const float *A, const float *B, float *C, int rows,
-                 int cols) const;
-  void MatrixSubtract(const float *A, const float *B, float *C, int rows,
-                      int cols) const;
-  bool MatrixInverse2x2(const float *A, float *invA)
-      const; // Only need 2x2 inverse for S
+  // True (and the filter started) if this plot should start it moving
+  bool StartMoving(float measX, float measY, float variance);
+  void Settle();
+
+  Filter m_filter;
+  float m_sinceUpdate = 0.0f;   // Seconds predicted since the last plot
+  float m_plotVariance = 0.0f;  // Position variance at the last plot
 };
 
 } // namespace aegis
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cmath>
+
+namespace aegis {
+
+// sin and cos of one angle together. Each CTRV predict needs both for two
+// headings; taking them as a pair lets GCC and Clang merge the two libm
+// calls into one sincos/sincosf, so the pair costs a single call and
+// carries libm's accuracy. A branch-free polynomial (1.5e-7 worst case)
+// was faster in isolation but no faster inside the EKF or batched IMM in
+// Release, so it was dropped.
+inline void SinCos(float x, float &s, float &c) {
+  s = std::sin(x);
+  c = std::cos(x);
+}
+
+inline void SinCos(double x, double &s, double &c) {
+  s = std::sin(x);
+  c = std::cos(x);
+}
+
+} // namespace aegis
@@ -0,0 +1,904 @@
+#pragma once
+
+#include "MotionModels.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace aegis {
+
+template <typename Scalar> class ImmBatch;
+
+// Interacting Multiple Model estimator over the CTRV state
+// [x, y, v, heading, turnRate], measuring (x, y). Three modes share the
+// state vector and differ only in process noise:
+//   CONSTANT_VELOCITY  turn rate pinned to zero, low noise (straight legs)
+//   COORDINATED_TURN   turn rate estimated, low noise (steady turns)
+//   MANEUVER           high noise on speed and turn rate (onset of a turn,
+//                      accelerations)
+// so quiet targets get tight gates while manoeuvres are still followed.
+//
+// Storage is structure-of-arrays with one lane per mode, padded to LANES:
+// every element of every covariance is a contiguous row of LANES scalars,
+// and mixing, predict and update loop over lanes innermost, so all modes
+// advance together in SIMD registers instead of three passes through a
+// scalar filter. The pad lane mirrors CONSTANT_VELOCITY and is never
+// weighted. Covariances are packed upper triangles as in StateFilter.
+template <typename Scalar> class ImmFilter {
+public:
+  enum Mode { CONSTANT_VELOCITY = 0, COORDINATED_TURN = 1, MANEUVER = 2 };
+
+  static constexpr int STATE_DIM = CtrvModel::STATE_DIM;
+  static constexpr int PACKED_SIZE = STATE_DIM * (STATE_DIM + 1) / 2;
+  static constexpr int MODES = 3;
+  static constexpr int LANES = 4; // MODES rounded up to a SIMD width
+
+  using State = std::array<Scalar, STATE_DIM>;
+
+  ImmFilter() : ImmFilter(0, 0, 0, 0) {}
+
+  // Same prior as the single-model EKF in every mode; heading in radians
+  ImmFilter(Scalar x, Scalar y, Scalar v, Scalar heading) {
+    const Scalar x0[STATE_DIM] = {x, y, v, heading, 0};
+    const Scalar p0[STATE_DIM] = {2500, 2500, 10000, 1, Scalar(0.01)};
+    for (int k = 0; k < LANES; ++k) {
+      for (int n = 0; n < STATE_DIM; ++n)
+        m_x[n][k] = x0[n];
+      for (int p = 0; p < PACKED_SIZE; ++p)
+        m_P[p][k] = Scalar(0);
+      for (int n = 0; n < STATE_DIM; ++n)
+        m_P[PackedIndex(n, n)][k] = p0[n];
+    }
+    // Tuned on a 200 m/s target with 1g/2g turns, 50m plots at 1 Hz
+    SetProcessNoise(CONSTANT_VELOCITY, {Scalar(0.1), Scalar(0.1), Scalar(1),
+                                        Scalar(1e-4), Scalar(0)});
+    SetProcessNoise(COORDINATED_TURN, {Scalar(0.1), Scalar(0.1), Scalar(1),
+                                       Scalar(1e-4), Scalar(1e-4)});
+    SetProcessNoise(MANEUVER, {Scalar(1), Scalar(1), Scalar(25), Scalar(0.01),
+                               Scalar(0.0025)});
+
+    // Markov mode switching per cycle; rows sum to one
+    const Scalar pi[MODES][MODES] = {{Scalar(0.95), Scalar(0.03), Scalar(0.02)},
+                                     {Scalar(0.03), Scalar(0.95), Scalar(0.02)},
+                                     {Scalar(0.05), Scalar(0.05), Scalar(0.90)}};
+    for (int i = 0; i < MODES; ++i) {
+      for (int j = 0; j < MODES; ++j)
+        SetTransitionProbability(i, j, pi[i][j]);
+    }
+    m_mu[CONSTANT_VELOCITY] = Scalar(0.6);
+    m_mu[COORDINATED_TURN] = Scalar(0.2);
+    m_mu[MANEUVER] = Scalar(0.2);
+    for (int k = 0; k < MODES; ++k)
+      m_predictedMu[k] = m_mu[k];
+    m_R = Scalar(2500); // 50m std dev, as the EKF
+
+    ApplyTurnRateMask();
+    Combine();
+  }
+
+  // Mix the mode estimates, then predict every mode by dt
+  void Predict(Scalar dt) {
+    using K = Kernels<1, LANES>;
+    K::Mix(m_x, m_P, m_transition, m_mu, m_predictedMu);
+    alignas(kAlign) Scalar lanesDt[LANES];
+    for (int k = 0; k < LANES; ++k)
+      lanesDt[k] = dt;
+    alignas(kAlign) Scalar G[JACOBIAN_TERMS][LANES];
+    K::Propagate(m_x, lanesDt, G);
+    K::PredictCovariance(m_P, m_Q, G);
+    Combine();
+  }
+
+  // Update every mode with a position plot and re-weight the modes by
+  // their measurement likelihoods. Returns false (and leaves the filter
+  // untouched) if any mode's innovation covariance is singular.
+  bool Update(Scalar measX, Scalar measY) {
+    return Update(measX, measY, m_R, Scalar(0), m_R);
+  }
+
+  // As above with the plot's own noise R = [rxx rxy; rxy ryy] in place of
+  // the filter's isotropic one
+  bool Update(Scalar measX, Scalar measY, Scalar rxx, Scalar rxy,
+              Scalar ryy) {
+    using K = Kernels<1, LANES>;
+    alignas(kAlign) Scalar mx[LANES], my[LANES], r0[LANES], r1[LANES],
+        r2[LANES];
+    for (int k = 0; k < LANES; ++k) {
+      mx[k] = measX;
+      my[k] = measY;
+      r0[k] = rxx;
+      r1[k] = rxy;
+      r2[k] = ryy;
+    }
+    alignas(kAlign) Scalar ia[LANES], ib[LANES], ic[LANES], det[LANES];
+    K::InvertInnovation(m_P, r0, r1, r2, ia, ib, ic, det);
+    for (int k = 0; k < MODES; ++k) {
+      if (!(det[k] > Scalar(0)))
+        return false;
+    }
+    alignas(kAlign) Scalar d2[LANES];
+    K::Correct(m_x, m_P, mx, my, r0, r1, r2, ia, ib, ic, d2);
+    K::Reweight(d2, det, m_mu, m_predictedMu);
+    Combine();
+    return true;
+  }
+
+  // Squared Mahalanobis distance of a plot from the combined prediction,
+  // S = sum_j mu_j * (S_j + spread_j); max() if S is singular
+  Scalar MahalanobisDistance(Scalar measX, Scalar measY) const {
+    Scalar a = m_S[0], b = m_S[1], c = m_S[2];
+    Scalar d = a * c - b * b;
+    if (!(d > Scalar(0)))
+      return std::numeric_limits<Scalar>::max();
+    Scalar dx = measX - m_combined[0], dy = measY - m_combined[1];
+    return (c * dx * dx - 2 * b * dx * dy + a * dy * dy) / d;
+  }
+
+  // Combined innovation covariance used by MahalanobisDistance
+  void GetInnovationCovariance(Scalar &sxx, Scalar &sxy, Scalar &syy) const {
+    sxx = m_S[0];
+    sxy = m_S[1];
+    syy = m_S[2];
+  }
+
+  // Combined (probability-weighted) estimate
+  const State &GetState() const { return m_combined; }
+  Scalar GetState(int i) const { return m_combined[i]; }
+  void GetVelocity(Scalar &vx, Scalar &vy) const {
+    if (!m_velocityValid) {
+      CtrvModel::Velocity(m_combined.data(), m_velocity[0], m_velocity[1]);
+      m_velocityValid = true;
+    }
+    vx = m_velocity[0];
+    vy = m_velocity[1];
+  }
+
+  // Combined covariance, including the spread of the mode means
+  Scalar GetCovariance(int row, int col) const {
+    Scalar sum = Scalar(0);
+    for (int k = 0; k < MODES; ++k) {
+      Scalar dr = Spread(row, k), dc = Spread(col, k);
+      sum += m_mu[k] * (m_P[PackedIndex(row, col)][k] + dr * dc);
+    }
+    return sum;
+  }
+
+  Scalar GetModeProbability(int mode) const { return m_mu[mode]; }
+  Scalar GetModeState(int mode, int i) const { return m_x[i][mode]; }
+  Scalar GetModeCovariance(int mode, int row, int col) const {
+    return m_P[PackedIndex(row, col)][mode];
+  }
+
+  // Diagonal process noise for one mode, added on every predict
+  void SetProcessNoise(int mode, const State &diagonal) {
+    for (int n = 0; n < STATE_DIM; ++n) {
+      m_Q[n][mode] = diagonal[n];
+      if (mode == CONSTANT_VELOCITY)
+        m_Q[n][PAD_LANE] = diagonal[n];
+    }
+  }
+  // Probability of switching from mode `from` to mode `to` per cycle
+  void SetTransitionProbability(int from, int to, Scalar p) {
+    m_transition[from][to] = p;
+    if (to == CONSTANT_VELOCITY)
+      m_transition[from][PAD_LANE] = p;
+  }
+  // Prior state, set in every mode (the constant-velocity mode keeps its
+  // turn rate pinned)
+  void SetState(const State &x) {
+    for (int k = 0; k < LANES; ++k) {
+      for (int n = 0; n < STATE_DIM; ++n)
+        m_x[n][k] = x[n];
+    }
+    ApplyTurnRateMask();
+    Combine();
+  }
+  // Prior covariance element, set in every mode (the constant-velocity
+  // mode keeps its turn rate pinned)
+  void SetCovariance(int row, int col, Scalar value) {
+    for (int k = 0; k < LANES; ++k)
+      m_P[PackedIndex(row, col)][k] = value;
+    ApplyTurnRateMask();
+    Combine();
+  }
+  void SetMeasurementVariance(Scalar variance) {
+    m_R = variance;
+    Combine();
+  }
+
+  static constexpr int PackedIndex(int i, int j) {
+    return (i <= j) ? i * STATE_DIM - i * (i - 1) / 2 + (j - i)
+                    : j * STATE_DIM - j * (j - 1) / 2 + (i - j);
+  }
+
+private:
+  friend class ImmBatch<Scalar>;
+
+  static constexpr int PAD_LANE = LANES - 1;
+  static constexpr int HEADING = 3;
+  static constexpr int TURN_RATE = 4;
+  static constexpr size_t kAlign = sizeof(Scalar) * LANES;
+  static constexpr Scalar MIN_MODE_PROBABILITY = Scalar(1e-4);
+
+  // Non-zero entries of G = F - I for CTRV: position rows depend on speed,
+  // heading and turn rate; heading depends on turn rate
+  static constexpr int JACOBIAN_TERMS = 7;
+  static constexpr int kJacobianRow[JACOBIAN_TERMS] = {0, 0, 0, 1, 1, 1, 3};
+  static constexpr int kJacobianCol[JACOBIAN_TERMS] = {2, 3, 4, 2, 3, 4, 4};
+
+  // The per-mode maths, for this filter (T = 1, W = LANES) and for
+  // ImmBatch (T tracks side by side). Lane l = k * T + t holds mode k of
+  // track t; lanes from MODES * T on are pad lanes mirroring constant
+  // velocity. Per-lane steps (propagation, covariance, gain, Joseph
+  // update) run W wide; steps that combine modes (mixing, likelihoods,
+  // the combined estimate) run across the T tracks. Per-track values are
+  // rows of T: mu[k * T + t], combined[n * T + t], cov[e * T + t]. No two
+  // arguments may overlap (__restrict), which is what lets the per-lane
+  // loops vectorise once they are out of line.
+  template <int T, int W> struct Kernels {
+    static_assert(W % T == 0 && W >= MODES * T, "lanes are whole modes");
+    static constexpr int GROUPS = W / T; // Modes, then pad
+    static constexpr size_t kAlign = sizeof(Scalar) * (W < 16 ? W : 16);
+    using Lanes = Scalar[W];
+
+    // detail::WrapAngle over N scalars: one branch-free step covers the
+    // angles the filter produces; anything still out of range takes the
+    // loop
+    template <int N> static void Wrap(Scalar *a) {
+      constexpr Scalar PI = detail::Pi<Scalar>();
+      bool outside = false;
+      for (int l = 0; l < N; ++l) {
+        Scalar v = a[l];
+        v = (v > PI) ? v - 2 * PI : v;
+        v = (v < -PI) ? v + 2 * PI : v;
+        a[l] = v;
+        outside |= (v > PI) | (v < -PI);
+      }
+      if (outside) {
+        for (int l = 0; l < N; ++l)
+          detail::WrapAngle(a[l]);
+      }
+    }
+
+    // Interaction step: each mode restarts from a blend of all modes,
+    // weighted by the probability it was reached from each of them
+    static void Mix(Lanes *__restrict x, Lanes *__restrict P,
+                    const Lanes *__restrict transition,
+                    const Scalar *__restrict mu,
+                    Scalar *__restrict predictedMu) {
+      // c_j = sum_i pi_ij * mu_i, w_ij = pi_ij * mu_i / c_j
+      alignas(kAlign) Lanes c, w[MODES];
+      for (int g = 0; g < GROUPS; ++g) {
+        for (int t = 0; t < T; ++t) {
+          const int l = g * T + t;
+          c[l] = Scalar(0);
+          for (int i = 0; i < MODES; ++i)
+            c[l] += transition[i][l] * mu[i * T + t];
+        }
+      }
+      for (int i = 0; i < MODES; ++i) {
+        for (int g = 0; g < GROUPS; ++g) {
+          for (int t = 0; t < T; ++t) {
+            const int l = g * T + t;
+            w[i][l] = transition[i][l] * mu[i * T + t] / c[l];
+          }
+        }
+      }
+      for (int l = 0; l < MODES * T; ++l)
+        predictedMu[l] = c[l];
+
+      // Differences between source mode i and each target lane, with the
+      // heading wrapped, then the mixed means
+      alignas(kAlign) Lanes diff[MODES][STATE_DIM];
+      for (int i = 0; i < MODES; ++i) {
+        for (int n = 0; n < STATE_DIM; ++n) {
+          for (int g = 0; g < GROUPS; ++g) {
+            for (int t = 0; t < T; ++t)
+              diff[i][n][g * T + t] = x[n][i * T + t] - x[n][g * T + t];
+          }
+        }
+        Wrap<W>(diff[i][HEADING]);
+      }
+      alignas(kAlign) Lanes shift[STATE_DIM];
+      for (int n = 0; n < STATE_DIM; ++n) {
+        for (int l = 0; l < W; ++l) {
+          shift[n][l] = Scalar(0);
+          for (int i = 0; i < MODES; ++i)
+            shift[n][l] += w[i][l] * diff[i][n][l];
+        }
+      }
+      // Re-centre the differences on the mixed mean
+      for (int i = 0; i < MODES; ++i) {
+        for (int n = 0; n < STATE_DIM; ++n) {
+          for (int l = 0; l < W; ++l)
+            diff[i][n][l] -= shift[n][l];
+        }
+      }
+
+      // P0_j = sum_i w_ij * (P_i + d_ij * d_ij^T)
+      alignas(kAlign) Lanes mixedP[PACKED_SIZE];
+      for (int r = 0; r < STATE_DIM; ++r) {
+        for (int s = r; s < STATE_DIM; ++s) {
+          const int p = PackedIndex(r, s);
+          Scalar *out = mixedP[p];
+          for (int l = 0; l < W; ++l)
+            out[l] = Scalar(0);
+          for (int i = 0; i < MODES; ++i) {
+            for (int g = 0; g < GROUPS; ++g) {
+              for (int t = 0; t < T; ++t) {
+                const int l = g * T + t;
+                out[l] += w[i][l] * (P[p][i * T + t] +
+                                     diff[i][r][l] * diff[i][s][l]);
+              }
+            }
+          }
+        }
+      }
+      for (int p = 0; p < PACKED_SIZE; ++p) {
+        for (int l = 0; l < W; ++l)
+          P[p][l] = mixedP[p][l];
+      }
+      for (int n = 0; n < STATE_DIM; ++n) {
+        for (int l = 0; l < W; ++l)
+          x[n][l] += shift[n][l];
+      }
+      Wrap<W>(x[HEADING]);
+
+      MaskTurnRate(x, P);
+    }
+
+    // The constant-velocity (and pad) lanes carry no turn rate and no
+    // uncertainty in it
+    static void MaskTurnRate(Lanes *__restrict x, Lanes *__restrict P) {
+      for (int g = 0; g < GROUPS; ++g) {
+        if (g < MODES && g != CONSTANT_VELOCITY)
+          continue;
+        for (int t = 0; t < T; ++t) {
+          x[TURN_RATE][g * T + t] = Scalar(0);
+          for (int n = 0; n < STATE_DIM; ++n)
+            P[PackedIndex(n, TURN_RATE)][g * T + t] = Scalar(0);
+        }
+      }
+    }
+
+    // CTRV propagation and Jacobian for all lanes at once (the maths of
+    // CtrvModel, with each lane's sin/cos computed once and shared between
+    // the state and F). Both branches are computed and selected per lane;
+    // lanes at a negligible turn rate take the second-order straight-line
+    // expansion. Writes only the non-identity Jacobian terms, in
+    // kJacobianRow/kJacobianCol order.
+    static void Propagate(Lanes *__restrict x, const Scalar *__restrict dt,
+                          Lanes *__restrict G) {
+      constexpr int V = 2;
+      alignas(kAlign) Lanes s0, c0, s1, c1;
+      for (int l = 0; l < MODES * T; ++l) {
+        Scalar theta = x[HEADING][l];
+        Scalar theta1 = theta + x[TURN_RATE][l] * dt[l];
+        SinCos(theta, s0[l], c0[l]);
+        // Constant velocity, and any mode not turning, ends where it began
+        if (theta1 == theta) {
+          s1[l] = s0[l];
+          c1[l] = c0[l];
+        } else {
+          SinCos(theta1, s1[l], c1[l]);
+        }
+      }
+      // Pad lanes are copies of constant velocity; skip their trig
+      for (int l = MODES * T; l < W; ++l) {
+        const int cv = CONSTANT_VELOCITY * T + l % T;
+        s0[l] = s0[cv];
+        c0[l] = c0[cv];
+        s1[l] = s1[cv];
+        c1[l] = c1[cv];
+      }
+      for (int l = 0; l < W; ++l) {
+        Scalar v = x[V][l], w = x[TURN_RATE][l], h = dt[l];
+        Scalar iw = Scalar(1) / w;
+        Scalar turnXv = (c0[l] - c1[l]) * iw;
+        Scalar turnYv = (s1[l] - s0[l]) * iw;
+        Scalar turnXh = v * iw * (s1[l] - s0[l]);
+        Scalar turnYh = v * iw * (c1[l] - c0[l]);
+        Scalar turnXw = -v * iw * turnXv + v * iw * s1[l] * h;
+        Scalar turnYw = -v * iw * turnYv + v * iw * c1[l] * h;
+        Scalar half = w * h / 2;
+        Scalar lineXv = h * (s0[l] + half * c0[l]);
+        Scalar lineYv = h * (c0[l] - half * s0[l]);
+        Scalar lineXh = v * lineYv;
+        Scalar lineYh = -v * lineXv;
+        Scalar lineXw = v * c0[l] * h * h / 2;
+        Scalar lineYw = -v * s0[l] * h * h / 2;
+        bool turning = std::abs(w) > Scalar(0.001);
+        Scalar dxdv = turning ? turnXv : lineXv;
+        Scalar dydv = turning ? turnYv : lineYv;
+        G[0][l] = dxdv;
+        G[1][l] = turning ? turnXh : lineXh;
+        G[2][l] = turning ? turnXw : lineXw;
+        G[3][l] = dydv;
+        G[4][l] = turning ? turnYh : lineYh;
+        G[5][l] = turning ? turnYw : lineYw;
+        G[6][l] = h;
+
+        // Both branches: the displacement is v * d(position)/dv
+        x[0][l] += v * dxdv;
+        x[1][l] += v * dydv;
+        x[HEADING][l] += w * h;
+      }
+      Wrap<W>(x[HEADING]);
+    }
+
+    // P = F * P * F^T + Q with F = I + G, using the sparsity of G:
+    // FP = P + G * P, then P = FP + FP * G^T (upper triangle only)
+    static void PredictCovariance(Lanes *__restrict P,
+                                  const Lanes *__restrict Q,
+                                  const Lanes *__restrict G) {
+      alignas(kAlign) Lanes FP[STATE_DIM][STATE_DIM];
+      for (int i = 0; i < STATE_DIM; ++i) {
+        for (int j = 0; j < STATE_DIM; ++j) {
+          for (int l = 0; l < W; ++l)
+            FP[i][j][l] = P[PackedIndex(i, j)][l];
+        }
+      }
+      for (int g = 0; g < JACOBIAN_TERMS; ++g) {
+        const int r = kJacobianRow[g], c = kJacobianCol[g];
+        for (int j = 0; j < STATE_DIM; ++j) {
+          const Scalar *p = P[PackedIndex(c, j)];
+          for (int l = 0; l < W; ++l)
+            FP[r][j][l] += G[g][l] * p[l];
+        }
+      }
+      for (int i = 0; i < STATE_DIM; ++i) {
+        for (int j = i; j < STATE_DIM; ++j) {
+          Scalar *out = P[PackedIndex(i, j)];
+          if (i == j) {
+            for (int l = 0; l < W; ++l)
+              out[l] = FP[i][j][l] + Q[i][l];
+          } else {
+            for (int l = 0; l < W; ++l)
+              out[l] = FP[i][j][l];
+          }
+        }
+      }
+      for (int g = 0; g < JACOBIAN_TERMS; ++g) {
+        const int r = kJacobianRow[g], c = kJacobianCol[g];
+        for (int i = 0; i <= r; ++i) {
+          Scalar *out = P[PackedIndex(i, r)];
+          for (int l = 0; l < W; ++l)
+            out[l] += FP[i][c][l] * G[g][l];
+        }
+      }
+    }
+
+    // The combined mean and the combined position covariance (xx, xy, yy;
+    // no heading to wrap), as GetCovariance computes it
+    static void Combine(const Lanes *__restrict x, const Lanes *__restrict P,
+                        const Scalar *__restrict mu,
+                        Scalar *__restrict combined, Scalar *__restrict cov) {
+      for (int n = 0; n < STATE_DIM; ++n) {
+        // Heading is averaged as offsets from mode 0 to respect the wrap
+        alignas(kAlign) Scalar sum[T];
+        for (int t = 0; t < T; ++t)
+          sum[t] = Scalar(0);
+        for (int k = 0; k < MODES; ++k) {
+          alignas(kAlign) Scalar d[T];
+          for (int t = 0; t < T; ++t)
+            d[t] = x[n][k * T + t] - x[n][t];
+          if (n == HEADING)
+            Wrap<T>(d);
+          for (int t = 0; t < T; ++t)
+            sum[t] += mu[k * T + t] * d[t];
+        }
+        for (int t = 0; t < T; ++t)
+          combined[n * T + t] = x[n][t] + sum[t];
+      }
+      Wrap<T>(combined + HEADING * T);
+
+      const int rows[3] = {0, 0, 1}, cols[3] = {0, 1, 1};
+      for (int e = 0; e < 3; ++e) {
+        const int row = rows[e], col = cols[e];
+        const Scalar *p = P[PackedIndex(row, col)];
+        Scalar *out = cov + e * T;
+        for (int t = 0; t < T; ++t)
+          out[t] = Scalar(0);
+        for (int k = 0; k < MODES; ++k) {
+          for (int t = 0; t < T; ++t) {
+            const int l = k * T + t;
+            Scalar dr = x[row][l] - combined[row * T + t];
+            Scalar dc = x[col][l] - combined[col * T + t];
+            out[t] += mu[k * T + t] * (p[l] + dr * dc);
+          }
+        }
+      }
+    }
+
+    // S = P(0:2, 0:2) + R per lane, inverted in closed form
+    static void InvertInnovation(const Lanes *__restrict P,
+                                 const Scalar *__restrict rxx,
+                                 const Scalar *__restrict rxy,
+                                 const Scalar *__restrict ryy,
+                                 Scalar *__restrict ia, Scalar *__restrict ib,
+                                 Scalar *__restrict ic,
+                                 Scalar *__restrict det) {
+      const Scalar *pxx = P[PackedIndex(0, 0)];
+      const Scalar *pxy = P[PackedIndex(0, 1)];
+      const Scalar *pyy = P[PackedIndex(1, 1)];
+      for (int l = 0; l < W; ++l) {
+        Scalar a = pxx[l] + rxx[l], b = pxy[l] + rxy[l], c = pyy[l] + ryy[l];
+        det[l] = a * c - b * b;
+        ia[l] = c / det[l];
+        ib[l] = -b / det[l];
+        ic[l] = a / det[l];
+      }
+    }
+
+    // Kalman update of every lane with its plot (mx, my) and noise R,
+    // given S^-1 from InvertInnovation; d2 is each lane's gate statistic
+    static void Correct(Lanes *__restrict x, Lanes *__restrict P,
+                        const Scalar *__restrict mx,
+                        const Scalar *__restrict my,
+                        const Scalar *__restrict rxx,
+                        const Scalar *__restrict rxy,
+                        const Scalar *__restrict ryy,
+                        const Scalar *__restrict ia,
+                        const Scalar *__restrict ib,
+                        const Scalar *__restrict ic, Scalar *__restrict d2) {
+      // Innovation and gate statistic per lane
+      alignas(kAlign) Lanes y0, y1;
+      for (int l = 0; l < W; ++l) {
+        y0[l] = mx[l] - x[0][l];
+        y1[l] = my[l] - x[1][l];
+        d2[l] = y0[l] * (ia[l] * y0[l] + ib[l] * y1[l]) +
+                y1[l] * (ib[l] * y0[l] + ic[l] * y1[l]);
+      }
+
+      // K = P * H^T * S^-1, two columns per state row
+      alignas(kAlign) Lanes K0[STATE_DIM], K1[STATE_DIM];
+      for (int n = 0; n < STATE_DIM; ++n) {
+        const Scalar *pn0 = P[PackedIndex(n, 0)];
+        const Scalar *pn1 = P[PackedIndex(n, 1)];
+        for (int l = 0; l < W; ++l) {
+          K0[n][l] = pn0[l] * ia[l] + pn1[l] * ib[l];
+          K1[n][l] = pn0[l] * ib[l] + pn1[l] * ic[l];
+        }
+      }
+      for (int n = 0; n < STATE_DIM; ++n) {
+        for (int l = 0; l < W; ++l)
+          x[n][l] += K0[n][l] * y0[l] + K1[n][l] * y1[l];
+      }
+
+      // Joseph form with H = [I 0]: B = (I - K*H) * P, then
+      // P(i,j) = B(i,j) - B(i,0:2) * K_j^T + K_i * R * K_j^T
+      alignas(kAlign) Lanes B[STATE_DIM * STATE_DIM];
+      for (int i = 0; i < STATE_DIM; ++i) {
+        for (int j = 0; j < STATE_DIM; ++j) {
+          const Scalar *pij = P[PackedIndex(i, j)];
+          const Scalar *p0j = P[PackedIndex(0, j)];
+          const Scalar *p1j = P[PackedIndex(1, j)];
+          Scalar *out = B[i * STATE_DIM + j];
+          for (int l = 0; l < W; ++l)
+            out[l] = pij[l] - K0[i][l] * p0j[l] - K1[i][l] * p1j[l];
+        }
+      }
+      for (int i = 0; i < STATE_DIM; ++i) {
+        const Scalar *bi0 = B[i * STATE_DIM + 0];
+        const Scalar *bi1 = B[i * STATE_DIM + 1];
+        for (int j = i; j < STATE_DIM; ++j) {
+          const Scalar *bij = B[i * STATE_DIM + j];
+          Scalar *out = P[PackedIndex(i, j)];
+          for (int l = 0; l < W; ++l) {
+            out[l] = bij[l] - bi0[l] * K0[j][l] - bi1[l] * K1[j][l] +
+                     rxx[l] * K0[i][l] * K0[j][l] +
+                     ryy[l] * K1[i][l] * K1[j][l] +
+                     rxy[l] * (K0[i][l] * K1[j][l] + K1[i][l] * K0[j][l]);
+          }
+        }
+      }
+      Wrap<W>(x[HEADING]);
+    }
+
+    // Mode probabilities: mu_j ~ c_j * N(y; 0, S_j). Exponents are taken
+    // relative to the smallest gate statistic so a far plot cannot
+    // underflow every mode at once.
+    static void Reweight(const Scalar *__restrict d2,
+                         const Scalar *__restrict det, Scalar *__restrict mu,
+                         Scalar *__restrict predictedMu) {
+      alignas(kAlign) Scalar minD2[T], total[T];
+      for (int t = 0; t < T; ++t) {
+        minD2[t] = d2[t];
+        total[t] = Scalar(0);
+      }
+      for (int k = 1; k < MODES; ++k) {
+        for (int t = 0; t < T; ++t)
+          minD2[t] = std::min(minD2[t], d2[k * T + t]);
+      }
+      for (int l = 0; l < MODES * T; ++l) {
+        const int t = l % T;
+        // exp(0) is exactly 1: the likeliest mode skips the call
+        Scalar relative = d2[l] - minD2[t];
+        Scalar likelihood = (relative == Scalar(0))
+                                ? Scalar(1)
+                                : std::exp(Scalar(-0.5) * relative);
+        mu[l] = predictedMu[l] * likelihood / std::sqrt(det[l]);
+        total[t] += mu[l];
+      }
+      for (int l = 0; l < MODES * T; ++l) {
+        // Floor keeps a mode recoverable after a long run of the others
+        Scalar p = mu[l] / total[l % T];
+        mu[l] = (p < MIN_MODE_PROBABILITY) ? MIN_MODE_PROBABILITY : p;
+      }
+      for (int t = 0; t < T; ++t)
+        total[t] = Scalar(0);
+      for (int l = 0; l < MODES * T; ++l)
+        total[l % T] += mu[l];
+      // A second plot before the next predict re-weights from here
+      for (int l = 0; l < MODES * T; ++l) {
+        mu[l] /= total[l % T];
+        predictedMu[l] = mu[l];
+      }
+    }
+  };
+
+  void ApplyTurnRateMask() { Kernels<1, LANES>::MaskTurnRate(m_x, m_P); }
+
+  // Mode k's mean minus the combined mean, heading wrapped
+  Scalar Spread(int n, int k) const {
+    Scalar d = m_x[n][k] - m_combined[n];
+    if (n == HEADING)
+      detail::WrapAngle(d);
+    return d;
+  }
+
+  // Refresh the combined mean and the combined innovation covariance used
+  // for gating
+  void Combine() {
+    Scalar cov[3];
+    Kernels<1, LANES>::Combine(m_x, m_P, m_mu, m_combined.data(), cov);
+    m_velocityValid = false;
+    m_S[0] = cov[0] + m_R;
+    m_S[1] = cov[1];
+    m_S[2] = cov[2] + m_R;
+  }
+
+  alignas(kAlign) Scalar m_x[STATE_DIM][LANES];   // Mode states, SoA
+  alignas(kAlign) Scalar m_P[PACKED_SIZE][LANES]; // Mode covariances, SoA
+  alignas(kAlign) Scalar m_Q[STATE_DIM][LANES];   // Diagonal process noise
+  Scalar m_transition[MODES][LANES]; // pi(from, to); pad mirrors column 0
+  Scalar m_mu[MODES];                // Mode probabilities
+  Scalar m_predictedMu[MODES];       // Prior weights for the next update
+  Scalar m_R;                        // Isotropic measurement variance
+  State m_combined;                  // Probability-weighted state
+  mutable Scalar m_velocity[2];      // Ground velocity of m_combined,
+  mutable bool m_velocityValid = false; // cached on first read
+  Scalar m_S[3];                     // Combined S: xx, xy, yy
+};
+
+// Many ImmFilters advanced together. Each SIMD lane holds one (mode, track)
+// pair of a block of BLOCK tracks, so every element of every mode's state
+// and covariance is a contiguous row of MODES * BLOCK scalars, and the
+// per-mode maths (propagation, covariance, gain, Joseph update) runs over
+// all of them in one loop. ImmFilter's own lanes are one track's modes,
+// which caps its vectors at MODES wide with a pad lane and leaves the
+// per-track steps scalar; here the steps that combine modes (mixing
+// weights, likelihoods, the combined estimate) run across the block's
+// tracks. Both run the same kernels (ImmFilter::Kernels), one track or
+// BLOCK tracks wide, so a filter comes out as its own Predict or Update
+// leaves it. Filters are gathered into a block, advanced and scattered
+// back; a partial block pads with copies of its first track, discarded.
+template <typename Scalar> class ImmBatch {
+public:
+  using Filter = ImmFilter<Scalar>;
+
+  static constexpr int BLOCK = 16; // Tracks per block
+
+  // A position plot and its noise, as Filter::Update takes them
+  struct Plot {
+    Scalar x, y;
+    Scalar rxx, rxy, ryy;
+  };
+
+  // What Track::PredictTo reads from a predicted filter
+  struct Prediction {
+    Scalar x, y, vx, vy;
+    Scalar sxx, sxy, syy; // Combined innovation covariance
+    Scalar pxx, pxy, pyy; // Combined position covariance
+  };
+
+  // filters[i]->Predict(dt[i]) for every i
+  static void Predict(Filter *const *filters, const Scalar *dt, size_t count) {
+    for (size_t first = 0; first < count; first += BLOCK) {
+      size_t n = std::min<size_t>(BLOCK, count - first);
+      Block b;
+      Gather(b, filters + first, n);
+      PredictBlock(b, dt + first, n);
+      Scatter(b, filters + first, n, nullptr);
+    }
+  }
+
+  // What filters[i] would read after Predict(dt[i]), leaving it untouched
+  static void Extrapolate(const Filter *const *filters, const Scalar *dt,
+                          size_t count, Prediction *out) {
+    for (size_t first = 0; first < count; first += BLOCK) {
+      size_t n = std::min<size_t>(BLOCK, count - first);
+      Block b;
+      Gather(b, filters + first, n);
+      PredictBlock(b, dt + first, n);
+      for (size_t t = 0; t < n; ++t) {
+        Prediction &p = out[first + t];
+        typename Filter::State combined;
+        for (int i = 0; i < STATE_DIM; ++i)
+          combined[i] = b.combined[i * BLOCK + t];
+        p.x = combined[0];
+        p.y = combined[1];
+        CtrvModel::Velocity(combined.data(), p.vx, p.vy);
+        p.pxx = b.cov[0 * BLOCK + t];
+        p.pxy = b.cov[1 * BLOCK + t];
+        p.pyy = b.cov[2 * BLOCK + t];
+        p.sxx = p.pxx + b.R[t];
+        p.sxy = p.pxy;
+        p.syy = p.pyy + b.R[t];
+      }
+    }
+  }
+
+  // Predict(dt[i]) then Update with plots[i], gathering each filter once;
+  // a filter whose update fails (ok[i] = false) is left predicted
+  static void Advance(Filter *const *filters, const Scalar *dt,
+                      const Plot *plots, size_t count, bool *ok) {
+    for (size_t first = 0; first < count; first += BLOCK) {
+      size_t n = std::min<size_t>(BLOCK, count - first);
+      Block b;
+      Gather(b, filters + first, n);
+      PredictBlock(b, dt + first, n);
+      UpdateBlock(b, plots + first, n, ok + first);
+      Scatter(b, filters + first, n, ok + first);
+      for (size_t t = 0; t < n; ++t) {
+        if (!ok[first + t])
+          filters[first + t]->Predict(dt[first + t]);
+      }
+    }
+  }
+
+  // ok[i] = filters[i]->Update(plots[i].x, plots[i].y, plots[i].rxx, ...)
+  static void Update(Filter *const *filters, const Plot *plots, size_t count,
+                     bool *ok) {
+    for (size_t first = 0; first < count; first += BLOCK) {
+      size_t n = std::min<size_t>(BLOCK, count - first);
+      Block b;
+      Gather(b, filters + first, n);
+      UpdateBlock(b, plots + first, n, ok + first);
+      Scatter(b, filters + first, n, ok + first);
+    }
+  }
+
+private:
+  static constexpr int STATE_DIM = Filter::STATE_DIM;
+  static constexpr int PACKED_SIZE = Filter::PACKED_SIZE;
+  static constexpr int MODES = Filter::MODES;
+  static constexpr int CV = Filter::CONSTANT_VELOCITY;
+  static constexpr int WIDTH = MODES * BLOCK; // Lane k * BLOCK + t
+  static constexpr size_t kAlign = sizeof(Scalar) * BLOCK;
+
+  using K = typename Filter::template Kernels<BLOCK, WIDTH>;
+  using Lanes = Scalar[WIDTH];  // One per (mode, track)
+  using Tracks = Scalar[BLOCK]; // One per track
+
+  struct Block {
+    alignas(kAlign) Lanes x[STATE_DIM];
+    alignas(kAlign) Lanes P[PACKED_SIZE];
+    alignas(kAlign) Lanes Q[STATE_DIM];
+    alignas(kAlign) Lanes transition[MODES]; // pi(from, lane's mode)
+    alignas(kAlign) Scalar mu[MODES * BLOCK];
+    alignas(kAlign) Scalar predictedMu[MODES * BLOCK];
+    alignas(kAlign) Tracks R;
+    alignas(kAlign) Scalar combined[STATE_DIM * BLOCK];
+    alignas(kAlign) Scalar cov[3 * BLOCK]; // Combined P: xx, xy, yy
+  };
+
+  // Per-track values repeated for every mode's lanes
+  static void Spread(const Tracks &in, Lanes &out) {
+    for (int k = 0; k < MODES; ++k) {
+      for (int t = 0; t < BLOCK; ++t)
+        out[k * BLOCK + t] = in[t];
+    }
+  }
+
+  // Lanes past `count` repeat the first filter so every lane stays finite
+  static void Gather(Block &b, const Filter *const *filters, size_t count) {
+    for (int t = 0; t < BLOCK; ++t) {
+      const Filter &f = *filters[static_cast<size_t>(t) < count ? t : 0];
+      for (int k = 0; k < MODES; ++k) {
+        const int l = k * BLOCK + t;
+        for (int n = 0; n < STATE_DIM; ++n) {
+          b.x[n][l] = f.m_x[n][k];
+          b.Q[n][l] = f.m_Q[n][k];
+        }
+        for (int p = 0; p < PACKED_SIZE; ++p)
+          b.P[p][l] = f.m_P[p][k];
+        for (int i = 0; i < MODES; ++i)
+          b.transition[i][l] = f.m_transition[i][k];
+        b.mu[l] = f.m_mu[k];
+        b.predictedMu[l] = f.m_predictedMu[k];
+      }
+      b.R[t] = f.m_R;
+    }
+  }
+
+  // Write tracks back (those with ok[t], if given); the pad lane mirrors
+  // constant velocity as in the filter's own kernels
+  static void Scatter(const Block &b, Filter *const *filters, size_t count,
+                      const bool *ok) {
+    for (size_t t = 0; t < count; ++t) {
+      if (ok && !ok[t])
+        continue;
+      Filter &f = *filters[t];
+      for (int k = 0; k < Filter::LANES; ++k) {
+        const size_t l = ((k < MODES) ? k : CV) * BLOCK + t;
+        for (int n = 0; n < STATE_DIM; ++n)
+          f.m_x[n][k] = b.x[n][l];
+        for (int p = 0; p < PACKED_SIZE; ++p)
+          f.m_P[p][k] = b.P[p][l];
+      }
+      for (int k = 0; k < MODES; ++k) {
+        f.m_mu[k] = b.mu[k * BLOCK + t];
+        f.m_predictedMu[k] = b.predictedMu[k * BLOCK + t];
+      }
+      for (int n = 0; n < STATE_DIM; ++n)
+        f.m_combined[n] = b.combined[n * BLOCK + t];
+      f.m_velocityValid = false;
+      f.m_S[0] = b.cov[0 * BLOCK + t] + b.R[t];
+      f.m_S[1] = b.cov[1 * BLOCK + t];
+      f.m_S[2] = b.cov[2 * BLOCK + t] + b.R[t];
+    }
+  }
+
+  // Filter::Predict
+  static void PredictBlock(Block &b, const Scalar *dtIn, size_t count) {
+    alignas(kAlign) Tracks trackDt;
+    for (int t = 0; t < BLOCK; ++t)
+      trackDt[t] = dtIn[static_cast<size_t>(t) < count ? t : 0];
+    alignas(kAlign) Lanes dt;
+    Spread(trackDt, dt);
+    K::Mix(b.x, b.P, b.transition, b.mu, b.predictedMu);
+    alignas(kAlign) Lanes G[Filter::JACOBIAN_TERMS];
+    K::Propagate(b.x, dt, G);
+    K::PredictCovariance(b.P, b.Q, G);
+    K::Combine(b.x, b.P, b.mu, b.combined, b.cov);
+  }
+
+  // Filter::Update. A track whose S is singular in any mode gets
+  // ok = false and is not written back.
+  static void UpdateBlock(Block &b, const Plot *plots, size_t count,
+                          bool *ok) {
+    alignas(kAlign) Tracks tx, ty, txx, txy, tyy;
+    for (int t = 0; t < BLOCK; ++t) {
+      const Plot &plot = plots[static_cast<size_t>(t) < count ? t : 0];
+      tx[t] = plot.x;
+      ty[t] = plot.y;
+      txx[t] = plot.rxx;
+      txy[t] = plot.rxy;
+      tyy[t] = plot.ryy;
+    }
+    alignas(kAlign) Lanes mx, my, rxx, rxy, ryy;
+    Spread(tx, mx);
+    Spread(ty, my);
+    Spread(txx, rxx);
+    Spread(txy, rxy);
+    Spread(tyy, ryy);
+
+    alignas(kAlign) Lanes ia, ib, ic, det;
+    K::InvertInnovation(b.P, rxx, rxy, ryy, ia, ib, ic, det);
+    for (size_t t = 0; t < count; ++t) {
+      ok[t] = true;
+      for (int k = 0; k < MODES; ++k) {
+        if (!(det[k * BLOCK + t] > Scalar(0)))
+          ok[t] = false;
+      }
+    }
+    alignas(kAlign) Lanes d2;
+    K::Correct(b.x, b.P, mx, my, rxx, rxy, ryy, ia, ib, ic, d2);
+    K::Reweight(d2, det, b.mu, b.predictedMu);
+    K::Combine(b.x, b.P, b.mu, b.combined, b.cov);
+  }
+};
+
+} // namespace aegis
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "FastMath.h"
+#include <cmath>
+
+namespace aegis {
+
+// Motion models for StateFilter. Each model is a stateless policy with:
+//   STATE_DIM, MEAS_DIM   constexpr dimensions
+//   Predict(x, dt)        propagate the state in place
+//   Jacobian(x, dt, F)    dF/dx at the pre-predict state, dense row-major
+//   Propagate(x, dt, F)   Jacobian then Predict, sharing their work
+//   Normalize(x)          wrap angles etc. after predict/update
+//   Velocity(x, vx, vy)   ground velocity, for display and reporting
+// Measurements are the first MEAS_DIM state components (positions), so the
+// measurement Jacobian is always H = [I 0] and never has to be formed.
+//
+// Heading convention matches TargetGenerator: 0 is North (+y), 90 degrees
+// is East (+x), so vx = v * sin(heading) and vy = v * cos(heading).
+
+namespace detail {
+
+template <typename S> constexpr S Pi() {
+  return static_cast<S>(3.14159265358979323846);
+}
+
+template <typename S> void WrapAngle(S &angle) {
+  while (angle > Pi<S>())
+    angle -= 2 * Pi<S>();
+  while (angle < -Pi<S>())
+    angle += 2 * Pi<S>();
+}
+
+template <typename S> void SetIdentity(S *F, int n) {
+  for (int i = 0; i < n * n; ++i)
+    F[i] = S(0);
+  for (int i = 0; i < n; ++i)
+    F[i * n + i] = S(1);
+}
+
+// Coordinated turn for [x, y, ..., v, heading, turnRate] laid out at the
+// given indices; shared by the CTRV models. Propagates x by dt and, if F is
+// not null, writes dF/dx at the pre-predict state, from one sin/cos pair
+// per heading. Both branches move the position by v * d(position)/dv.
+template <typename S, int N, int X, int Y, int V, int H, int W>
+void CtrvPropagate(S *x, S dt, S *F) {
+  S v = x[V], theta = x[H], w = x[W];
+  S s0, c0;
+  SinCos(theta, s0, c0);
+  S dxdv, dxdh, dxdw, dydv, dydh, dydw;
+  if (std::abs(w) > S(0.001)) {
+    // Integral of v * (sin, cos)(theta + w*t) over [0, dt]
+    S s1, c1;
+    SinCos(theta + w * dt, s1, c1);
+    S iw = S(1) / w;
+    dxdv = (c0 - c1) * iw;
+    dydv = (s1 - s0) * iw;
+    dxdh = v * dydv;
+    dydh = -v * dxdv;
+    dxdw = -v * iw * dxdv + v * iw * s1 * dt;
+    dydw = -v * iw * dydv + v * iw * c1 * dt;
+  } else {
+    // Second order in w, so the limit stays differentiable in w
+    S half = w * dt / 2;
+    dxdv = dt * (s0 + half * c0);
+    dydv = dt * (c0 - half * s0);
+    dxdh = v * dydv;
+    dydh = -v * dxdv;
+    dxdw = v * c0 * dt * dt / 2;
+    dydw = -v * s0 * dt * dt / 2;
+  }
+  if (F) {
+    SetIdentity(F, N);
+    F[X * N + V] = dxdv;
+    F[X * N + H] = dxdh;
+    F[X * N + W] = dxdw;
+    F[Y * N + V] = dydv;
+    F[Y * N + H] = dydh;
+    F[Y * N + W] = dydw;
+    F[H * N + W] = dt;
+  }
+  x[X] += v * dxdv;
+  x[Y] += v * dydv;
+  x[H] = theta + w * dt;
+}
+
+template <typename S, int N, int X, int Y, int V, int H, int W>
+void CtrvJacobian(const S *x, S dt, S *F) {
+  S scratch[N];
+  for (int i = 0; i < N; ++i)
+    scratch[i] = x[i];
+  CtrvPropagate<S, N, X, Y, V, H, W>(scratch, dt, F);
+}
+
+} // namespace detail
+
+// Constant velocity: [x, y, vx, vy]
+struct ConstantVelocityModel {
+  static constexpr int STATE_DIM = 4;
+  static constexpr int MEAS_DIM = 2;
+
+  template <typename S> static void Predict(S *x, S dt) {
+    x[0] += x[2] * dt;
+    x[1] += x[3] * dt;
+  }
+  template <typename S> static void Jacobian(const S *, S dt, S *F) {
+    detail::SetIdentity(F, STATE_DIM);
+    F[0 * 4 + 2] = dt;
+    F[1 * 4 + 3] = dt;
+  }
+  template <typename S> static void Propagate(S *x, S dt, S *F) {
+    Jacobian(x, dt, F);
+    Predict(x, dt);
+  }
+  template <typename S> static void Normalize(S *) {}
+  template <typename S> static void Velocity(const S *x, S &vx, S &vy) {
+    vx = x[2];
+    vy = x[3];
+  }
+};
+
+// Constant acceleration: [x, y, vx, vy, ax, ay]
+struct ConstantAccelerationModel {
+  static constexpr int STATE_DIM = 6;
+  static constexpr int MEAS_DIM = 2;
+
+  template <typename S> static void Predict(S *x, S dt) {
+    S half = dt * dt / 2;
+    x[0] += x[2] * dt + x[4] * half;
+    x[1] += x[3] * dt + x[5] * half;
+    x[2] += x[4] * dt;
+    x[3] += x[5] * dt;
+  }
+  template <typename S> static void Jacobian(const S *, S dt, S *F) {
+    detail::SetIdentity(F, STATE_DIM);
+    S half = dt * dt / 2;
+    F[0 * 6 + 2] = dt;
+    F[0 * 6 + 4] = half;
+    F[1 * 6 + 3] = dt;
+    F[1 * 6 + 5] = half;
+    F[2 * 6 + 4] = dt;
+    F[3 * 6 + 5] = dt;
+  }
+  template <typename S> static void Propagate(S *x, S dt, S *F) {
+    Jacobian(x, dt, F);
+    Predict(x, dt);
+  }
+  template <typename S> static void Normalize(S *) {}
+  template <typename S> static void Velocity(const S *x, S &vx, S &vy) {
+    vx = x[2];
+    vy = x[3];
+  }
+};
+
+// Constant turn rate and velocity: [x, y, v, heading, turnRate]
+struct CtrvModel {
+  static constexpr int STATE_DIM = 5;
+  static constexpr int MEAS_DIM = 2;
+
+  template <typename S> static void Predict(S *x, S dt) {
+    Propagate(x, dt, static_cast<S *>(nullptr));
+  }
+  template <typename S> static void Jacobian(const S *x, S dt, S *F) {
+    detail::CtrvJacobian<S, 5, 0, 1, 2, 3, 4>(x, dt, F);
+  }
+  template <typename S> static void Propagate(S *x, S dt, S *F) {
+    detail::CtrvPropagate<S, 5, 0, 1, 2, 3, 4>(x, dt, F);
+    Normalize(x);
+  }
+  template <typename S> static void Normalize(S *x) { detail::WrapAngle(x[3]); }
+  template <typename S> static void Velocity(const S *x, S &vx, S &vy) {
+    S s, c;
+    SinCos(x[3], s, c);
+    vx = x[2] * s;
+    vy = x[2] * c;
+  }
+};
+
+// CTRV in the horizontal plane plus constant climb rate:
+// [x, y, z, v, heading, turnRate, vz], measuring (x, y, z)
+struct CtrvAltitudeModel {
+  static constexpr int STATE_DIM = 7;
+  static constexpr int MEAS_DIM = 3;
+
+  template <typename S> static void Predict(S *x, S dt) {
+    Propagate(x, dt, static_cast<S *>(nullptr));
+  }
+  template <typename S> static void Jacobian(const S *x, S dt, S *F) {
+    detail::CtrvJacobian<S, 7, 0, 1, 3, 4, 5>(x, dt, F);
+    F[2 * 7 + 6] = dt;
+  }
+  template <typename S> static void Propagate(S *x, S dt, S *F) {
+    detail::CtrvPropagate<S, 7, 0, 1, 3, 4, 5>(x, dt, F);
+    if (F)
+      F[2 * 7 + 6] = dt;
+    x[2] += x[6] * dt;
+    Normalize(x);
+  }
+  template <typename S> static void Normalize(S *x) { detail::WrapAngle(x[4]); }
+  template <typename S> static void Velocity(const S *x, S &vx, S &vy) {
+    S s, c;
+    SinCos(x[4], s, c);
+    vx = x[3] * s;
+    vy = x[3] * c;
+  }
+};
+
+} // namespace aegis
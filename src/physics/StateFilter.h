@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace aegis {
+
+// Extended Kalman filter over a motion model (see MotionModels.h), generic
+// in scalar precision: run float for throughput and double for validation
+// from the same code. Dispatch to the model is static, and all storage is
+// fixed-size, so filters can live in pools and be copied freely.
+//
+// Covariance is stored as its packed upper triangle; predict and update
+// write only that triangle (Joseph form), so P stays exactly symmetric and
+// positive definite in float. Ground velocity is cached with the state on
+// first read after each change, so repeated reads cost no trig.
+template <typename Scalar, typename Model> class StateFilter {
+public:
+  static constexpr int STATE_DIM = Model::STATE_DIM;
+  static constexpr int MEAS_DIM = Model::MEAS_DIM;
+  static constexpr int PACKED_SIZE = STATE_DIM * (STATE_DIM + 1) / 2;
+
+  using State = std::array<Scalar, STATE_DIM>;
+  using Measurement = std::array<Scalar, MEAS_DIM>;
+
+  // Zero state, zero covariance; set them before use
+  StateFilter() {
+    m_x.fill(Scalar(0));
+    m_P.fill(Scalar(0));
+    m_Q.fill(Scalar(0));
+    m_R.fill(Scalar(0));
+  }
+
+  // Diagonal initial covariance, process noise and measurement variance
+  StateFilter(const State &x0, const State &initialVariance,
+              const State &processNoise, Scalar measurementVariance)
+      : StateFilter() {
+    m_x = x0;
+    for (int i = 0; i < STATE_DIM; ++i) {
+      m_P[PackedIndex(i, i)] = initialVariance[i];
+      m_Q[PackedIndex(i, i)] = processNoise[i];
+    }
+    for (int i = 0; i < MEAS_DIM; ++i) {
+      m_R[i * MEAS_DIM + i] = measurementVariance;
+    }
+  }
+
+  void Predict(Scalar dt) {
+    // Jacobian at the pre-predict state and the non-linear propagation,
+    // in one pass
+    Scalar F[STATE_DIM * STATE_DIM];
+    Model::Propagate(m_x.data(), dt, F);
+    m_velocityValid = false;
+
+    // P = F * P * F^T + Q: F*P once (reading P symmetrically), then only
+    // the upper triangle of (F*P)*F^T
+    Scalar FP[STATE_DIM * STATE_DIM];
+    for (int i = 0; i < STATE_DIM; ++i) {
+      for (int j = 0; j < STATE_DIM; ++j) {
+        Scalar sum = Scalar(0);
+        for (int k = 0; k < STATE_DIM; ++k) {
+          sum += F[i * STATE_DIM + k] * m_P[PackedIndex(k, j)];
+        }
+        FP[i * STATE_DIM + j] = sum;
+      }
+    }
+    for (int i = 0; i < STATE_DIM; ++i) {
+      for (int j = i; j < STATE_DIM; ++j) {
+        Scalar sum = Scalar(0);
+        for (int k = 0; k < STATE_DIM; ++k) {
+          sum += FP[i * STATE_DIM + k] * F[j * STATE_DIM + k];
+        }
+        m_P[PackedIndex(i, j)] = sum + m_Q[PackedIndex(i, j)];
+      }
+    }
+  }
+
+  // Update with the filter's own measurement noise
+  bool Update(const Measurement &z) { return Update(z, m_R.data()); }
+
+  // Update with an explicit MEAS_DIM x MEAS_DIM row-major noise R.
+  // Returns false (and leaves the filter untouched) if S is singular.
+  bool Update(const Measurement &z, const Scalar *R) {
+    // H = [I 0]: H*P*H^T is the top-left block of P, P*H^T its first
+    // MEAS_DIM columns
+    Scalar L[MEAS_DIM * MEAS_DIM];
+    if (!FactorInnovation(R, L))
+      return false;
+
+    // K = P * H^T * S^-1, row i solves S * K_i^T = P(i, 0:M)^T
+    Scalar K[STATE_DIM * MEAS_DIM];
+    for (int i = 0; i < STATE_DIM; ++i) {
+      Scalar rhs[MEAS_DIM];
+      for (int m = 0; m < MEAS_DIM; ++m)
+        rhs[m] = m_P[PackedIndex(i, m)];
+      CholeskySolve(L, rhs);
+      for (int m = 0; m < MEAS_DIM; ++m)
+        K[i * MEAS_DIM + m] = rhs[m];
+    }
+
+    // x = x + K * (z - H*x)
+    Scalar y[MEAS_DIM];
+    for (int m = 0; m < MEAS_DIM; ++m)
+      y[m] = z[m] - m_x[m];
+    for (int i = 0; i < STATE_DIM; ++i) {
+      for (int m = 0; m < MEAS_DIM; ++m)
+        m_x[i] += K[i * MEAS_DIM + m] * y[m];
+    }
+    Model::Normalize(m_x.data());
+    m_velocityValid = false;
+
+    // Joseph form: P = (I - K*H) * P * (I - K*H)^T + K * R * K^T
+    // B = (I - K*H) * P
+    Scalar B[STATE_DIM * STATE_DIM];
+    for (int i = 0; i < STATE_DIM; ++i) {
+      for (int j = 0; j < STATE_DIM; ++j) {
+        Scalar sum = m_P[PackedIndex(i, j)];
+        for (int m = 0; m < MEAS_DIM; ++m)
+          sum -= K[i * MEAS_DIM + m] * m_P[PackedIndex(m, j)];
+        B[i * STATE_DIM + j] = sum;
+      }
+    }
+    // P(i,j) = B(i,:) * (I - K*H)(j,:)^T + K_i * R * K_j^T, upper triangle
+    for (int i = 0; i < STATE_DIM; ++i) {
+      Scalar KR[MEAS_DIM]; // K_i * R
+      for (int b = 0; b < MEAS_DIM; ++b) {
+        KR[b] = Scalar(0);
+        for (int a = 0; a < MEAS_DIM; ++a)
+          KR[b] += K[i * MEAS_DIM + a] * R[a * MEAS_DIM + b];
+      }
+      for (int j = i; j < STATE_DIM; ++j) {
+        Scalar sum = B[i * STATE_DIM + j];
+        for (int m = 0; m < MEAS_DIM; ++m) {
+          sum -= B[i * STATE_DIM + m] * K[j * MEAS_DIM + m];
+          sum += KR[m] * K[j * MEAS_DIM + m];
+        }
+        m_P[PackedIndex(i, j)] = sum;
+      }
+    }
+    return true;
+  }
+
+  // Squared Mahalanobis distance of z from the predicted measurement, for
+  // chi-squared gating; max() if S is singular
+  Scalar MahalanobisDistance(const Measurement &z) const {
+    Scalar L[MEAS_DIM * MEAS_DIM];
+    if (!FactorInnovation(m_R.data(), L))
+      return std::numeric_limits<Scalar>::max();
+
+    // d^2 = y^T S^-1 y = |L^-1 y|^2
+    Scalar w[MEAS_DIM];
+    Scalar d2 = Scalar(0);
+    for (int i = 0; i < MEAS_DIM; ++i) {
+      Scalar sum = z[i] - m_x[i];
+      for (int k = 0; k < i; ++k)
+        sum -= L[i * MEAS_DIM + k] * w[k];
+      w[i] = sum / L[i * MEAS_DIM + i];
+      d2 += w[i] * w[i];
+    }
+    return d2;
+  }
+
+  // S = H*P*H^T + R, row-major MEAS_DIM x MEAS_DIM
+  void GetInnovationCovariance(Scalar *S) const {
+    for (int i = 0; i < MEAS_DIM; ++i) {
+      for (int j = 0; j < MEAS_DIM; ++j)
+        S[i * MEAS_DIM + j] = m_P[PackedIndex(i, j)] + m_R[i * MEAS_DIM + j];
+    }
+  }
+
+  const State &GetState() const { return m_x; }
+  Scalar GetState(int i) const { return m_x[i]; }
+  void SetState(const State &x) {
+    m_x = x;
+    m_velocityValid = false;
+  }
+
+  // Covariance element (symmetric, so (row, col) and (col, row) agree)
+  Scalar GetCovariance(int row, int col) const {
+    return m_P[PackedIndex(row, col)];
+  }
+  void SetCovariance(int row, int col, Scalar value) {
+    m_P[PackedIndex(row, col)] = value;
+  }
+  void SetProcessNoise(int row, int col, Scalar value) {
+    m_Q[PackedIndex(row, col)] = value;
+  }
+  // Row-major MEAS_DIM x MEAS_DIM
+  void SetMeasurementNoise(const Scalar *R) {
+    for (int i = 0; i < MEAS_DIM * MEAS_DIM; ++i)
+      m_R[i] = R[i];
+  }
+
+  void GetVelocity(Scalar &vx, Scalar &vy) const {
+    if (!m_velocityValid) {
+      Model::Velocity(m_x.data(), m_velocity[0], m_velocity[1]);
+      m_velocityValid = true;
+    }
+    vx = m_velocity[0];
+    vy = m_velocity[1];
+  }
+
+  // Packed upper-triangular index of (i, j), row by row: row 0 holds
+  // (0,0)..(0,N-1), row 1 holds (1,1)..(1,N-1), and so on
+  static constexpr int PackedIndex(int i, int j) {
+    return (i <= j) ? i * STATE_DIM - i * (i - 1) / 2 + (j - i)
+                    : j * STATE_DIM - j * (j - 1) / 2 + (i - j);
+  }
+
+private:
+  // Cholesky factor L (lower, row-major) of S = H*P*H^T + R
+  bool FactorInnovation(const Scalar *R, Scalar *L) const {
+    for (int i = 0; i < MEAS_DIM; ++i) {
+      for (int j = 0; j <= i; ++j) {
+        Scalar sum = m_P[PackedIndex(i, j)] + R[i * MEAS_DIM + j];
+        for (int k = 0; k < j; ++k)
+          sum -= L[i * MEAS_DIM + k] * L[j * MEAS_DIM + k];
+        if (i == j) {
+          if (!(sum > Scalar(0)))
+            return false; // Singular or indefinite
+          L[i * MEAS_DIM + i] = std::sqrt(sum);
+        } else {
+          L[i * MEAS_DIM + j] = sum / L[j * MEAS_DIM + j];
+        }
+      }
+    }
+    return true;
+  }
+
+  // Solve L * L^T * v = b in place
+  static void CholeskySolve(const Scalar *L, Scalar *b) {
+    for (int i = 0; i < MEAS_DIM; ++i) {
+      for (int k = 0; k < i; ++k)
+        b[i] -= L[i * MEAS_DIM + k] * b[k];
+      b[i] /= L[i * MEAS_DIM + i];
+    }
+    for (int i = MEAS_DIM - 1; i >= 0; --i) {
+      for (int k = i + 1; k < MEAS_DIM; ++k)
+        b[i] -= L[k * MEAS_DIM + i] * b[k];
+      b[i] /= L[i * MEAS_DIM + i];
+    }
+  }
+
+  State m_x;                                    // State vector
+  std::array<Scalar, PACKED_SIZE> m_P;          // Covariance, packed upper
+  std::array<Scalar, PACKED_SIZE> m_Q;          // Process noise, packed upper
+  std::array<Scalar, MEAS_DIM * MEAS_DIM> m_R; // Measurement noise
+  mutable std::array<Scalar, 2> m_velocity;     // Model::Velocity of m_x
+  mutable bool m_velocityValid = false;         // m_velocity matches m_x
+};
+
+} // namespace aegis
@@ -0,0 +1,340 @@
+#include "Association.h"
+#include <algorithm>
+#include <limits>
+
+namespace aegis {
+
+void UnionFind::Reset(size_t count) {
+  m_parent.resize(count);
+  m_size.assign(count, 1);
+  for (size_t i = 0; i < count; ++i) {
+    m_parent[i] = static_cast<uint32_t>(i);
+  }
+}
+
+uint32_t UnionFind::Find(uint32_t element) {
+  while (m_parent[element] != element) {
+    m_parent[element] = m_parent[m_parent[element]];
+    element = m_parent[element];
+  }
+  return element;
+}
+
+void UnionFind::Union(uint32_t a, uint32_t b) {
+  a = Find(a);
+  b = Find(b);
+  if (a == b) {
+    return;
+  }
+  if (m_size[a] < m_size[b]) {
+    std::swap(a, b);
+  }
+  m_parent[b] = a;
+  m_size[a] += m_size[b];
+}
+
+double SolveAssignment(const float *cost, size_t rows, size_t cols,
+                       std::vector<int> &rowToCol,
+                       AssignmentWorkspace &workspace) {
+  // Potentials u (rows) and v (columns), 1-based with column 0 as the
+  // virtual start of each augmenting path; p[j] is the row on column j
+  const double infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> &u = workspace.u, &v = workspace.v;
+  std::vector<double> &minv = workspace.minv;
+  std::vector<int> &p = workspace.p, &way = workspace.way;
+  std::vector<char> &used = workspace.used;
+  u.assign(rows + 1, 0.0);
+  v.assign(cols + 1, 0.0);
+  p.assign(cols + 1, 0);
+  way.assign(cols + 1, 0);
+
+  for (size_t i = 1; i <= rows; ++i) {
+    p[0] = static_cast<int>(i);
+    size_t j0 = 0;
+    minv.assign(cols + 1, infinity);
+    used.assign(cols + 1, 0);
+    do {
+      used[j0] = 1;
+      size_t i0 = static_cast<size_t>(p[j0]);
+      double delta = infinity;
+      size_t j1 = 0;
+      const float *row = cost + (i0 - 1) * cols;
+      for (size_t j = 1; j <= cols; ++j) {
+        if (used[j]) {
+          continue;
+        }
+        double reduced = row[j - 1] - u[i0] - v[j];
+        if (reduced < minv[j]) {
+          minv[j] = reduced;
+          way[j] = static_cast<int>(j0);
+        }
+        if (minv[j] < delta) {
+          delta = minv[j];
+          j1 = j;
+        }
+      }
+      for (size_t j = 0; j <= cols; ++j) {
+        if (used[j]) {
+          u[static_cast<size_t>(p[j])] += delta;
+          v[j] -= delta;
+        } else {
+          minv[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+    // Flip the augmenting path back to the start
+    do {
+      size_t j1 = static_cast<size_t>(way[j0]);
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  rowToCol.assign(rows, -1);
+  double total = 0.0;
+  for (size_t j = 1; j <= cols; ++j) {
+    if (p[j] != 0) {
+      size_t row = static_cast<size_t>(p[j]) - 1;
+      rowToCol[row] = static_cast<int>(j - 1);
+      total += cost[row * cols + (j - 1)];
+    }
+  }
+  return total;
+}
+
+namespace {
+
+// Whether an assignment avoids every forbidden entry
+bool Feasible(const float *cost, size_t rows, size_t cols,
+              const std::vector<int> &rowToCol) {
+  for (size_t r = 0; r < rows; ++r) {
+    if (rowToCol[r] < 0 ||
+        cost[r * cols + static_cast<size_t>(rowToCol[r])] >=
+            ASSIGNMENT_FORBIDDEN) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+size_t SolveKBestAssignments(const float *cost, size_t rows, size_t cols,
+                             size_t k, std::vector<int> &assignments,
+                             std::vector<double> &costs,
+                             KBestWorkspace &workspace) {
+  using Subproblem = KBestWorkspace::Subproblem;
+  const float forbidden = static_cast<float>(ASSIGNMENT_FORBIDDEN);
+  size_t size = rows * cols;
+  std::vector<Subproblem> &queue = workspace.queue;
+  std::vector<float> &matrices = workspace.matrices;
+  std::vector<int> &solutions = workspace.solutions;
+  queue.clear();
+  solutions.clear();
+  auto later = [](const Subproblem &a, const Subproblem &b) {
+    return a.cost > b.cost;
+  };
+  // Solve the matrix at `matrix` and queue it if it is feasible
+  auto push = [&](size_t matrix, size_t fixed) {
+    const float *m = matrices.data() + matrix;
+    double total = SolveAssignment(m, rows, cols, workspace.rowToCol,
+                                   workspace.solver);
+    if (!Feasible(m, rows, cols, workspace.rowToCol)) {
+      return;
+    }
+    queue.push_back(Subproblem{total, matrix, solutions.size(), fixed});
+    solutions.insert(solutions.end(), workspace.rowToCol.begin(),
+                     workspace.rowToCol.end());
+    std::push_heap(queue.begin(), queue.end(), later);
+  };
+
+  matrices.assign(cost, cost + size);
+  push(0, 0);
+  size_t found = 0;
+  while (found < k && !queue.empty()) {
+    std::pop_heap(queue.begin(), queue.end(), later);
+    Subproblem best = queue.back();
+    queue.pop_back();
+    workspace.parent.assign(solutions.begin() + best.solution,
+                            solutions.begin() + best.solution + rows);
+    assignments.insert(assignments.end(), workspace.parent.begin(),
+                       workspace.parent.end());
+    costs.push_back(best.cost);
+    if (++found == k) {
+      break;
+    }
+
+    // Partition the rest: subproblem r forbids row r's column and keeps
+    // rows before it. The parent's matrix is fixed row by row as it goes,
+    // and is not needed again.
+    for (size_t r = best.fixed; r < rows; ++r) {
+      size_t col = static_cast<size_t>(workspace.parent[r]);
+      size_t child = matrices.size();
+      matrices.resize(child + size);
+      std::copy(matrices.begin() + best.matrix,
+                matrices.begin() + best.matrix + size,
+                matrices.begin() + child);
+      matrices[child + r * cols + col] = forbidden;
+      push(child, r);
+
+      float *fix = matrices.data() + best.matrix;
+      for (size_t c = 0; c < cols; ++c) {
+        if (c != col) {
+          fix[r * cols + c] = forbidden;
+        }
+      }
+      for (size_t other = r + 1; other < rows; ++other) {
+        fix[other * cols + col] = forbidden;
+      }
+    }
+  }
+  return found;
+}
+
+void ClusterAssociator::Solve(
+    const std::vector<GatedPair> &pairs, size_t trackCount,
+    const std::vector<uint16_t> &groups, float missCost, ThreadPool *pool,
+    const std::function<void(GatedPair *, size_t)> &apply) {
+  // Tracks are elements [0, trackCount), plots follow
+  size_t elements = trackCount + groups.size();
+  m_sets.Reset(elements);
+  for (const GatedPair &pair : pairs) {
+    m_sets.Union(pair.track, static_cast<uint32_t>(trackCount + pair.plot));
+  }
+
+  // Number the components by first appearance and group their pairs
+  m_clusterOf.assign(elements, NONE);
+  m_assignedCount.clear();
+  m_sorted.resize(pairs.size());
+  m_pairCluster.resize(pairs.size());
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    uint32_t &cluster = m_clusterOf[m_sets.Find(pairs[i].track)];
+    if (cluster == NONE) {
+      cluster = static_cast<uint32_t>(m_assignedCount.size());
+      m_assignedCount.push_back(0);
+    }
+    m_pairCluster[i] = cluster;
+    m_assignedCount[cluster]++;
+  }
+  size_t clusters = m_assignedCount.size();
+  m_clusterStart.assign(clusters + 1, 0);
+  for (size_t c = 0; c < clusters; ++c) {
+    m_clusterStart[c + 1] = m_clusterStart[c] + m_assignedCount[c];
+    m_assignedCount[c] = 0; // Fill cursor
+  }
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    uint32_t c = m_pairCluster[i];
+    m_sorted[m_clusterStart[c] + m_assignedCount[c]++] = pairs[i];
+  }
+
+  size_t threads = pool ? pool->Size() : 1;
+  if (m_workspaces.size() < threads) {
+    m_workspaces.resize(threads);
+  }
+  for (Workspace &workspace : m_workspaces) {
+    if (workspace.trackColumn.size() < trackCount) {
+      workspace.trackColumn.resize(trackCount, NONE);
+    }
+    if (workspace.plotRow.size() < groups.size()) {
+      workspace.plotRow.resize(groups.size(), NONE);
+    }
+  }
+
+  auto task = [&](size_t cluster, size_t thread) {
+    size_t assigned =
+        SolveCluster(cluster, m_workspaces[thread], groups, missCost);
+    m_assignedCount[cluster] = assigned;
+    if (assigned > 0) {
+      apply(m_sorted.data() + m_clusterStart[cluster], assigned);
+    }
+  };
+  if (pool) {
+    pool->ParallelFor(clusters, task);
+  } else {
+    for (size_t c = 0; c < clusters; ++c) {
+      task(c, 0);
+    }
+  }
+}
+
+size_t ClusterAssociator::SolveCluster(size_t cluster, Workspace &workspace,
+                                       const std::vector<uint16_t> &groups,
+                                       float missCost) {
+  GatedPair *begin = m_sorted.data() + m_clusterStart[cluster];
+  size_t count = GetClusterPairs(cluster);
+  if (count == 1) {
+    return 1; // One track, one plot: nothing to solve
+  }
+
+  // Columns for the component's tracks; its plots, sensor by sensor
+  workspace.tracks.clear();
+  workspace.plots.clear();
+  for (size_t i = 0; i < count; ++i) {
+    const GatedPair &pair = begin[i];
+    if (workspace.trackColumn[pair.track] == NONE) {
+      workspace.trackColumn[pair.track] =
+          static_cast<uint32_t>(workspace.tracks.size());
+      workspace.tracks.push_back(pair.track);
+    }
+    if (workspace.plotRow[pair.plot] == NONE) {
+      workspace.plotRow[pair.plot] = 0;
+      workspace.plots.push_back(pair.plot);
+    }
+  }
+  std::sort(workspace.plots.begin(), workspace.plots.end(),
+            [&](uint32_t a, uint32_t b) {
+              return groups[a] != groups[b] ? groups[a] < groups[b] : a < b;
+            });
+
+  // Each sensor's plots against every track, plus one miss column per
+  // plot, so a complete assignment always exists
+  size_t tracks = workspace.tracks.size();
+  workspace.assigned.clear();
+  for (size_t first = 0; first < workspace.plots.size();) {
+    uint16_t group = groups[workspace.plots[first]];
+    size_t last = first;
+    while (last < workspace.plots.size() &&
+           groups[workspace.plots[last]] == group) {
+      workspace.plotRow[workspace.plots[last]] =
+          static_cast<uint32_t>(last - first);
+      ++last;
+    }
+    size_t rows = last - first;
+    size_t cols = tracks + rows;
+    workspace.cost.assign(rows * cols,
+                          static_cast<float>(ASSIGNMENT_FORBIDDEN));
+    for (size_t i = 0; i < count; ++i) {
+      const GatedPair &pair = begin[i];
+      if (groups[pair.plot] == group) {
+        workspace.cost[workspace.plotRow[pair.plot] * cols +
+                       workspace.trackColumn[pair.track]] = pair.cost;
+      }
+    }
+    for (size_t r = 0; r < rows; ++r) {
+      workspace.cost[r * cols + tracks + r] = missCost;
+    }
+    SolveAssignment(workspace.cost.data(), rows, cols, workspace.rowToCol,
+                    workspace.solver);
+    for (size_t r = 0; r < rows; ++r) {
+      size_t col = static_cast<size_t>(workspace.rowToCol[r]);
+      if (col < tracks) {
+        workspace.assigned.push_back(GatedPair{
+            workspace.tracks[col], workspace.plots[first + r],
+            workspace.cost[r * cols + col]});
+      }
+    }
+    first = last;
+  }
+
+  for (uint32_t track : workspace.tracks) {
+    workspace.trackColumn[track] = NONE;
+  }
+  for (uint32_t plot : workspace.plots) {
+    workspace.plotRow[plot] = NONE;
+  }
+  std::copy(workspace.assigned.begin(), workspace.assigned.end(), begin);
+  return workspace.assigned.size();
+}
+
+} // namespace aegis
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace aegis {
+
+// Disjoint sets over 0..count-1, with path halving and union by size
+class UnionFind {
+public:
+  // Every element in a set of its own; keeps storage
+  void Reset(size_t count);
+  uint32_t Find(uint32_t element);
+  void Union(uint32_t a, uint32_t b);
+
+private:
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_size;
+};
+
+// Costs at or above this mark pairs that must not be assigned
+constexpr double ASSIGNMENT_FORBIDDEN = 1e9;
+
+// Scratch for SolveAssignment, reused between calls
+struct AssignmentWorkspace {
+  std::vector<double> u, v, minv;
+  std::vector<int> p, way;
+  std::vector<char> used;
+};
+
+// Minimum-cost assignment of each of `rows` rows to a distinct one of
+// `cols` columns (rows <= cols) over a row-major cost matrix, by the
+// Hungarian method with shortest augmenting paths, O(rows^2 cols). Fills
+// rowToCol and returns the total cost; ASSIGNMENT_FORBIDDEN or more if no
+// complete assignment avoids the forbidden entries.
+double SolveAssignment(const float *cost, size_t rows, size_t cols,
+                       std::vector<int> &rowToCol,
+                       AssignmentWorkspace &workspace);
+
+// Scratch for SolveKBestAssignments, reused between calls
+struct KBestWorkspace {
+  struct Subproblem {
+    double cost;
+    size_t matrix;   // Offset of its cost matrix in `matrices`
+    size_t solution; // Offset of its assignment in `solutions`
+    size_t fixed;    // Rows before this one keep their assignment
+  };
+  std::vector<Subproblem> queue; // Min-heap on cost
+  std::vector<float> matrices;
+  std::vector<int> solutions;
+  std::vector<int> rowToCol, parent;
+  AssignmentWorkspace solver;
+};
+
+// The `k` cheapest complete assignments of a cost matrix (as
+// SolveAssignment), cheapest first, by Murty's method: each assignment
+// found splits what is left of its subproblem into one subproblem per
+// free row, with that row's column forbidden and the rows before it
+// fixed. Appends each assignment's rowToCol (`rows` entries) to
+// `assignments` and its cost to `costs`, and returns the number found:
+// fewer than k if no more avoid the forbidden entries. At most 1 + k rows
+// solves.
+size_t SolveKBestAssignments(const float *cost, size_t rows, size_t cols,
+                             size_t k, std::vector<int> &assignments,
+                             std::vector<double> &costs,
+                             KBestWorkspace &workspace);
+
+// One gated track/plot pair, tracks and plots numbered densely from 0
+struct GatedPair {
+  uint32_t track;
+  uint32_t plot;
+  float cost; // Mahalanobis distance squared, inside the gate
+};
+
+// Global nearest-neighbour association, cluster by cluster. The gated
+// pairs of a scan form a bipartite track/plot graph; its connected
+// components share no track and no plot, so each component's assignment
+// is solved on its own, and the components are spread over a thread
+// pool. Within a component the plots of each sensor are assigned
+// one-to-one to tracks at minimum total cost, leaving a plot unassigned
+// costing `missCost`; a track may take one plot per sensor. Components of
+// a single pair are assigned without the solver. All storage is reused
+// from scan to scan.
+class ClusterAssociator {
+public:
+  // `groups[plot]` is the sensor of each plot. apply(pairs, count) is
+  // called once per component with its assigned pairs, on the thread that
+  // solved it; it may reorder them. A null pool solves inline.
+  void Solve(const std::vector<GatedPair> &pairs, size_t trackCount,
+             const std::vector<uint16_t> &groups, float missCost,
+             ThreadPool *pool,
+             const std::function<void(GatedPair *, size_t)> &apply);
+
+  // The last Solve's components, in order of their first gated pair
+  size_t GetClusterCount() const { return m_assignedCount.size(); }
+  size_t GetClusterPairs(size_t cluster) const {
+    return m_clusterStart[cluster + 1] - m_clusterStart[cluster];
+  }
+  // visit(pair) for every assigned pair, component by component
+  template <typename Visit> void ForEachAssigned(Visit &&visit) const {
+    for (size_t c = 0; c < m_assignedCount.size(); ++c) {
+      const GatedPair *begin = m_sorted.data() + m_clusterStart[c];
+      for (size_t i = 0; i < m_assignedCount[c]; ++i) {
+        visit(begin[i]);
+      }
+    }
+  }
+
+private:
+  struct Workspace {
+    std::vector<uint32_t> trackColumn; // By track, NONE outside a solve
+    std::vector<uint32_t> tracks;      // Column -> track
+    std::vector<uint32_t> plots;       // The component's plots by group
+    std::vector<uint32_t> plotRow;     // By plot
+    std::vector<float> cost;
+    std::vector<int> rowToCol;
+    std::vector<GatedPair> assigned;
+    AssignmentWorkspace solver;
+  };
+
+  // Assign component `cluster` in place; returns the assigned count
+  size_t SolveCluster(size_t cluster, Workspace &workspace,
+                      const std::vector<uint16_t> &groups, float missCost);
+
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  UnionFind m_sets;
+  std::vector<uint32_t> m_clusterOf; // Root -> component, by element
+  std::vector<uint32_t> m_pairCluster; // Component, by input pair
+  std::vector<GatedPair> m_sorted;     // Pairs grouped by component
+  std::vector<size_t> m_clusterStart;
+  std::vector<size_t> m_assignedCount;
+  std::vector<Workspace> m_workspaces; // One per pool thread
+};
+
+} // namespace aegis
@@ -0,0 +1,276 @@
+#include "Checkpoint.h"
+#include "Partition.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+namespace aegis {
+
+namespace {
+
+constexpr char CHECKPOINT_MAGIC[4] = {'A', 'E', 'G', 'K'};
+constexpr uint32_t CHECKPOINT_VERSION = 2; // 2: handover sequence field
+
+#pragma pack(push, 1)
+struct CheckpointHeader {
+  char magic[4];
+  uint32_t version;
+  double scanTime;
+  uint32_t nextTrackId;
+  uint32_t trackCount;
+  uint32_t counterCount;
+};
+#pragma pack(pop)
+
+// FNV-1a, 64-bit
+uint64_t Checksum(const char *data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T> void Append(std::string &out, const T &value) {
+  out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Bounds-checked reads from a loaded file
+class Reader {
+public:
+  Reader(const std::string &data, size_t end, const std::string &path)
+      : m_data(data), m_end(end), m_path(path) {}
+
+  template <typename T> T Read() {
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+  std::string ReadString(size_t length) {
+    return std::string(Take(length), length);
+  }
+  bool AtEnd() const { return m_offset == m_end; }
+
+private:
+  const char *Take(size_t size) {
+    if (size > m_end - m_offset) {
+      throw std::runtime_error(m_path + ": truncated checkpoint");
+    }
+    const char *at = m_data.data() + m_offset;
+    m_offset += size;
+    return at;
+  }
+
+  const std::string &m_data;
+  size_t m_end;
+  size_t m_offset = 0;
+  const std::string &m_path;
+};
+
+// 10us to 1s
+std::vector<double> DurationBuckets() {
+  return {0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001,
+          0.0025,  0.005,    0.01,    0.025,   0.05,    0.1,    1.0};
+}
+
+} // namespace
+
+size_t SaveCheckpoint(const TrackCheckpoint &checkpoint,
+                      const std::string &path) {
+  std::string data;
+  data.reserve(sizeof(CheckpointHeader) +
+               checkpoint.tracks.size() * sizeof(TrackHandover) +
+               checkpoint.counters.size() * 64 + sizeof(uint64_t));
+  CheckpointHeader header{};
+  std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+  header.version = CHECKPOINT_VERSION;
+  header.scanTime = checkpoint.scanTime;
+  header.nextTrackId = checkpoint.nextTrackId;
+  header.trackCount = static_cast<uint32_t>(checkpoint.tracks.size());
+  header.counterCount = static_cast<uint32_t>(checkpoint.counters.size());
+  Append(data, header);
+  for (const TrackRecord &record : checkpoint.tracks) {
+    Append(data, ToHandover(record, 0));
+  }
+  for (const auto &counter : checkpoint.counters) {
+    uint16_t length = static_cast<uint16_t>(
+        std::min<size_t>(counter.first.size(), 0xFFFF));
+    Append(data, length);
+    data.append(counter.first, 0, length);
+    Append(data, counter.second);
+  }
+  Append(data, Checksum(data.data(), data.size()));
+
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    file.flush();
+    if (!file) {
+      throw std::runtime_error("cannot write checkpoint: " + temporary);
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    throw std::runtime_error("cannot replace checkpoint " + path + ": " +
+                             error.message());
+  }
+  return data.size();
+}
+
+TrackCheckpoint LoadCheckpoint(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open checkpoint: " + path);
+  }
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(CheckpointHeader) + sizeof(uint64_t)) {
+    throw std::runtime_error(path + ": truncated checkpoint");
+  }
+  size_t body = data.size() - sizeof(uint64_t);
+  uint64_t stored;
+  std::memcpy(&stored, data.data() + body, sizeof(stored));
+
+  Reader in(data, body, path);
+  CheckpointHeader header = in.Read<CheckpointHeader>();
+  if (std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0) {
+    throw std::runtime_error(path + ": not a checkpoint");
+  }
+  if (header.version != CHECKPOINT_VERSION) {
+    throw std::runtime_error(path + ": unsupported checkpoint version " +
+                             std::to_string(header.version));
+  }
+  if (stored != Checksum(data.data(), body)) {
+    throw std::runtime_error(path + ": checkpoint checksum mismatch");
+  }
+
+  TrackCheckpoint checkpoint;
+  checkpoint.scanTime = header.scanTime;
+  checkpoint.nextTrackId = header.nextTrackId;
+  // Counts come from the file: check them against its size before sizing
+  // anything by them
+  if (header.trackCount > body / sizeof(TrackHandover)) {
+    throw std::runtime_error(path + ": truncated checkpoint");
+  }
+  checkpoint.tracks.reserve(header.trackCount);
+  for (uint32_t i = 0; i < header.trackCount; ++i) {
+    checkpoint.tracks.push_back(FromHandover(in.Read<TrackHandover>()));
+  }
+  for (uint32_t i = 0; i < header.counterCount; ++i) {
+    uint16_t length = in.Read<uint16_t>();
+    std::string name = in.ReadString(length);
+    checkpoint.counters.emplace_back(std::move(name), in.Read<uint64_t>());
+  }
+  if (!in.AtEnd()) {
+    throw std::runtime_error(path + ": trailing data in checkpoint");
+  }
+  return checkpoint;
+}
+
+CheckpointWriter::CheckpointWriter(std::string path, MetricsRegistry &registry)
+    : m_path(std::move(path)),
+      m_writtenCounter(registry.AddCounter("aegis_checkpoints_written_total",
+                                           "Checkpoints saved")),
+      m_failedCounter(registry.AddCounter("aegis_checkpoint_failures_total",
+                                          "Checkpoints that could not be "
+                                          "saved")),
+      m_bytesGauge(registry.AddGauge("aegis_checkpoint_bytes",
+                                     "Size of the last checkpoint saved")),
+      m_captureDuration(registry.AddHistogram(
+          "aegis_checkpoint_capture_seconds",
+          "Tracker time spent copying state for a checkpoint",
+          DurationBuckets())),
+      m_writeDuration(registry.AddHistogram(
+          "aegis_checkpoint_write_seconds",
+          "Time to encode and save a checkpoint, off the tracker thread",
+          DurationBuckets())) {}
+
+CheckpointWriter::~CheckpointWriter() { Stop(); }
+
+void CheckpointWriter::Start() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_running) {
+    return;
+  }
+  m_running = true;
+  m_thread = std::thread(&CheckpointWriter::Run, this);
+}
+
+void CheckpointWriter::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+      return;
+    }
+    m_running = false;
+  }
+  m_cond.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+TrackCheckpoint *CheckpointWriter::Acquire() {
+  if (m_busy.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  m_captureStart = std::chrono::steady_clock::now();
+  return &m_buffer;
+}
+
+void CheckpointWriter::Submit() {
+  m_captureDuration.Observe(std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() -
+                                m_captureStart)
+                                .count());
+  m_busy.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_submitted = true;
+  }
+  m_cond.notify_all();
+}
+
+bool CheckpointWriter::Write(const TrackCheckpoint &checkpoint) {
+  auto start = std::chrono::steady_clock::now();
+  try {
+    size_t bytes = SaveCheckpoint(checkpoint, m_path);
+    m_bytesGauge.Set(static_cast<double>(bytes));
+  } catch (const std::exception &e) {
+    m_failedCounter.Add();
+    std::cerr << "Checkpoint Error: " << e.what() << std::endl;
+    return false;
+  }
+  m_writeDuration.Observe(std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+  m_writtenCounter.Add();
+  return true;
+}
+
+void CheckpointWriter::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this] { return m_submitted || !m_running; });
+    if (m_submitted) {
+      m_submitted = false;
+      lock.unlock();
+      Write(m_buffer);
+      m_busy.store(false, std::memory_order_release);
+      lock.lock();
+    } else {
+      break; // Stopped with nothing left to write
+    }
+  }
+}
+
+} // namespace aegis
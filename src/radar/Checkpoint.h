@@ -0,0 +1,86 @@
+#pragma once
+
+#include "MetricsRegistry.h"
+#include "Track.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aegis {
+
+// Everything a tracker needs to carry on after a restart: every track's
+// estimate and bookkeeping, the next track ID, and the counters of its
+// metrics registry. Trails, the initiator's unpaired plots and fusion
+// links are not kept; they rebuild within a few scans.
+struct TrackCheckpoint {
+  double scanTime = 0.0; // Tracker time of the capture
+  uint32_t nextTrackId = 1;
+  std::vector<TrackRecord> tracks;
+  std::vector<std::pair<std::string, uint64_t>> counters; // By metric name
+};
+
+// Binary file form: a header, one TrackHandover per track, the counters,
+// and a checksum over all of it; host byte order. Save writes a temporary
+// file beside `path` and renames it over `path`, so a crash mid-write
+// leaves the previous checkpoint intact; it returns the bytes written.
+// Both throw std::runtime_error naming the file; Load also on a
+// truncated, corrupt or foreign file.
+size_t SaveCheckpoint(const TrackCheckpoint &checkpoint,
+                      const std::string &path);
+TrackCheckpoint LoadCheckpoint(const std::string &path);
+
+// Writes checkpoints on its own thread. The tracker captures into the
+// writer's buffer and submits it; encoding and file I/O happen here, so
+// processing only pays for the capture. While a write is in progress the
+// buffer is unavailable and the tracker skips that checkpoint rather than
+// wait.
+class CheckpointWriter {
+public:
+  CheckpointWriter(std::string path, MetricsRegistry &registry);
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter &) = delete;
+  CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+  void Start();
+  void Stop(); // Writes what was submitted, then joins
+
+  // Buffer to capture the next checkpoint into, or null while the last
+  // one is still being written. Call from one thread only, and follow a
+  // non-null result with Submit(); the time between the two is recorded
+  // as the capture time.
+  TrackCheckpoint *Acquire();
+  void Submit();
+
+  // Write `checkpoint` now, on the calling thread. False (counted and
+  // logged) if it could not be saved.
+  bool Write(const TrackCheckpoint &checkpoint);
+
+private:
+  void Run();
+
+  std::string m_path;
+  TrackCheckpoint m_buffer;
+  std::atomic<bool> m_busy{false}; // m_buffer submitted, not yet written
+  std::chrono::steady_clock::time_point m_captureStart;
+
+  Counter &m_writtenCounter;
+  Counter &m_failedCounter;
+  Gauge &m_bytesGauge;
+  Histogram &m_captureDuration;
+  Histogram &m_writeDuration;
+
+  bool m_running = false;
+  bool m_submitted = false;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::thread m_thread;
+};
+
+} // namespace aegis
@@ -0,0 +1,302 @@
+#include "FixedLagSmoother.h"
+#include "../physics/MotionModels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace aegis {
+
+namespace {
+
+constexpr int N = CtrvModel::STATE_DIM;
+using Matrix = std::array<std::array<double, N>, N>;
+using Vector = std::array<double, N>;
+
+constexpr int PackedIndex(int i, int j) {
+  return (i <= j) ? i * N - i * (i - 1) / 2 + (j - i)
+                  : j * N - j * (j - 1) / 2 + (i - j);
+}
+
+void Unpack(const FilterSample &sample, Vector &x, Matrix &P) {
+  for (int i = 0; i < N; ++i) {
+    x[i] = sample.state[i];
+    for (int j = 0; j < N; ++j) {
+      P[i][j] = sample.covariance[PackedIndex(i, j)];
+    }
+  }
+}
+
+Matrix Multiply(const Matrix &A, const Matrix &B) {
+  Matrix C{};
+  for (int i = 0; i < N; ++i)
+    for (int k = 0; k < N; ++k)
+      for (int j = 0; j < N; ++j)
+        C[i][j] += A[i][k] * B[k][j];
+  return C;
+}
+
+Matrix MultiplyTransposed(const Matrix &A, const Matrix &B) { // A * B^T
+  Matrix C{};
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < N; ++j)
+      for (int k = 0; k < N; ++k)
+        C[i][j] += A[i][k] * B[j][k];
+  return C;
+}
+
+// Solve S * X = B for symmetric positive definite S, in place in B.
+// Returns false if S is not positive definite.
+bool CholeskySolve(const Matrix &S, Matrix &B) {
+  Matrix L{};
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      double sum = S[i][j];
+      for (int k = 0; k < j; ++k)
+        sum -= L[i][k] * L[j][k];
+      if (i == j) {
+        if (!(sum > 0.0))
+          return false;
+        L[i][i] = std::sqrt(sum);
+      } else {
+        L[i][j] = sum / L[j][j];
+      }
+    }
+  }
+  for (int c = 0; c < N; ++c) {
+    for (int i = 0; i < N; ++i) { // L y = b
+      double sum = B[i][c];
+      for (int k = 0; k < i; ++k)
+        sum -= L[i][k] * B[k][c];
+      B[i][c] = sum / L[i][i];
+    }
+    for (int i = N - 1; i >= 0; --i) { // L^T x = y
+      double sum = B[i][c];
+      for (int k = i + 1; k < N; ++k)
+        sum -= L[k][i] * B[k][c];
+      B[i][c] = sum / L[i][i];
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+FixedLagSmoother::FixedLagSmoother(const SmootherConfig &config)
+    : m_config(config) {}
+
+bool FixedLagSmoother::Add(const FilterSample &sample, SmoothedTrack &out) {
+  Window &window = m_windows[sample.trackId];
+  if (window.samples.empty()) {
+    window.samples.resize(m_config.lag + 1);
+  }
+  if (window.count > 0 &&
+      sample.time <= window.At(window.count - 1).time) {
+    return false; // Out of order (e.g. an out-of-sequence plot); skip
+  }
+
+  window.samples[window.head] = sample;
+  window.head = (window.head + 1) % window.samples.size();
+  window.count = std::min(window.count + 1, window.samples.size());
+  if (window.count < window.samples.size()) {
+    return false;
+  }
+
+  Smooth(window, out);
+  window.smoothed = out;
+  window.hasSmoothed = true;
+  return true;
+}
+
+void FixedLagSmoother::Smooth(const Window &window, SmoothedTrack &out) const {
+  // Backward pass from the newest (filtered = smoothed) to the oldest:
+  //   F, x- = f(x_k), P- = F P_k F^T + Q           (as the EKF predicted)
+  //   C = P_k F^T (P-)^-1
+  //   xs_k = x_k + C (xs_k+1 - x-),  Ps_k = P_k + C (Ps_k+1 - P-) C^T
+  Vector xs;
+  Matrix Ps;
+  Unpack(window.At(window.count - 1), xs, Ps);
+
+  for (size_t n = window.count - 1; n-- > 0;) {
+    const FilterSample &sample = window.At(n);
+    Vector x;
+    Matrix P;
+    Unpack(sample, x, P);
+    double dt = window.At(n + 1).time - sample.time;
+
+    Vector predicted = x;
+    Matrix F{};
+    for (int i = 0; i < N; ++i)
+      F[i][i] = 1.0;
+    Matrix Ppred = P;
+    if (dt > 0.0001) { // The EKF skips tiny steps
+      CtrvModel::Propagate(predicted.data(), dt, &F[0][0]);
+      Ppred = MultiplyTransposed(Multiply(F, P), F);
+      for (int i = 0; i < N; ++i)
+        Ppred[i][i] += m_config.processNoise[i];
+    }
+
+    // C^T = (P-)^-1 F P_k, since P- and P_k are symmetric
+    Matrix Ct = Multiply(F, P);
+    if (!CholeskySolve(Ppred, Ct)) {
+      xs = x; // Degenerate step: restart from the filtered state
+      Ps = P;
+      continue;
+    }
+
+    Vector d;
+    for (int i = 0; i < N; ++i)
+      d[i] = xs[i] - predicted[i];
+    detail::WrapAngle(d[3]);
+    for (int i = 0; i < N; ++i) {
+      double sum = x[i];
+      for (int k = 0; k < N; ++k)
+        sum += Ct[k][i] * d[k];
+      xs[i] = sum;
+    }
+    CtrvModel::Normalize(xs.data());
+
+    Matrix diff;
+    for (int i = 0; i < N; ++i)
+      for (int j = 0; j < N; ++j)
+        diff[i][j] = Ps[i][j] - Ppred[i][j];
+    // Ps = P + C diff C^T, with C = Ct^T
+    Matrix diffCt = Multiply(diff, Ct); // diff * C^T
+    for (int i = 0; i < N; ++i) {
+      for (int j = 0; j < N; ++j) {
+        double sum = P[i][j];
+        for (int k = 0; k < N; ++k)
+          sum += Ct[k][i] * diffCt[k][j];
+        Ps[i][j] = sum;
+      }
+    }
+  }
+
+  const FilterSample &oldest = window.At(0);
+  out.id = oldest.trackId;
+  out.time = oldest.time;
+  out.position = glm::vec2(static_cast<float>(xs[0]), static_cast<float>(xs[1]));
+  double vx, vy;
+  CtrvModel::Velocity(xs.data(), vx, vy);
+  out.velocity = glm::vec2(static_cast<float>(vx), static_cast<float>(vy));
+  out.turnRate = static_cast<float>(xs[4]);
+  out.sxx = static_cast<float>(Ps[0][0]);
+  out.sxy = static_cast<float>(0.5 * (Ps[0][1] + Ps[1][0]));
+  out.syy = static_cast<float>(Ps[1][1]);
+}
+
+void FixedLagSmoother::Remove(uint32_t trackId) { m_windows.erase(trackId); }
+
+size_t FixedLagSmoother::ExpireIdle(double now) {
+  size_t expired = 0;
+  for (auto it = m_windows.begin(); it != m_windows.end();) {
+    const Window &window = it->second;
+    if (window.count == 0 ||
+        now - window.At(window.count - 1).time > m_config.idleTimeout) {
+      it = m_windows.erase(it);
+      expired++;
+    } else {
+      ++it;
+    }
+  }
+  return expired;
+}
+
+void FixedLagSmoother::CollectSmoothed(std::vector<SmoothedTrack> &out) const {
+  size_t first = out.size();
+  for (const auto &entry : m_windows) {
+    if (entry.second.hasSmoothed) {
+      out.push_back(entry.second.smoothed);
+    }
+  }
+  std::sort(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+            [](const SmoothedTrack &a, const SmoothedTrack &b) {
+              return a.id < b.id;
+            });
+}
+
+SmootherWorker::SmootherWorker(const SmootherConfig &config,
+                               MetricsRegistry &registry)
+    : m_smoother(config), m_queue(config.queueCapacity),
+      m_pollIntervalMs(config.pollIntervalMs),
+      m_samplesCounter(registry.AddCounter("aegis_smoother_samples_total",
+                                           "Filter updates smoothed")),
+      m_droppedCounter(registry.AddCounter(
+          "aegis_smoother_dropped_total",
+          "Filter updates dropped because the smoother queue was full")),
+      m_tracksGauge(registry.AddGauge("aegis_smoother_tracks",
+                                      "Tracks with a smoothing window")) {}
+
+SmootherWorker::~SmootherWorker() { Stop(); }
+
+void SmootherWorker::Start() {
+  if (m_running) {
+    return;
+  }
+  m_running = true;
+  m_thread = std::thread(&SmootherWorker::Run, this);
+}
+
+void SmootherWorker::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_stopMutex);
+    if (!m_running) {
+      return;
+    }
+    m_running = false;
+  }
+  m_stopCond.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+bool SmootherWorker::Submit(const FilterSample &sample) {
+  if (!m_queue.TryPush(sample)) {
+    m_droppedCounter.Add();
+    return false;
+  }
+  return true;
+}
+
+size_t SmootherWorker::ProcessPending() {
+  size_t processed = 0;
+  uint64_t updates = 0;
+  FilterSample sample;
+  SmoothedTrack smoothed;
+  while (m_queue.TryPop(sample)) {
+    processed++;
+    if (sample.deleted) {
+      m_smoother.Remove(sample.trackId);
+      continue;
+    }
+    updates++;
+    m_newestSample = std::max(m_newestSample, sample.time);
+    m_smoother.Add(sample, smoothed);
+  }
+  if (processed == 0) {
+    return 0;
+  }
+  m_samplesCounter.Add(updates);
+  m_smoother.ExpireIdle(m_newestSample);
+  m_tracksGauge.Set(static_cast<double>(m_smoother.GetTrackCount()));
+
+  auto snapshot = m_snapshots.AcquireForWrite();
+  snapshot->sequence = ++m_sequence;
+  snapshot->newestSample = m_newestSample;
+  m_smoother.CollectSmoothed(snapshot->tracks);
+  m_snapshots.Publish(snapshot);
+  return processed;
+}
+
+void SmootherWorker::Run() {
+  while (m_running) {
+    if (ProcessPending() == 0) {
+      std::unique_lock<std::mutex> lock(m_stopMutex);
+      m_stopCond.wait_for(lock, std::chrono::milliseconds(m_pollIntervalMs),
+                          [this] { return !m_running; });
+    }
+  }
+  ProcessPending(); // Whatever was queued before Stop
+}
+
+} // namespace aegis
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "MetricsRegistry.h"
+#include "RcuBuffer.h"
+#include "SpscRing.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace aegis {
+
+// A track's filtered posterior after one update, as handed to the smoother
+struct FilterSample {
+  uint32_t trackId = 0;
+  bool deleted = false; // The track has ended; its window can go
+  double time = 0.0;
+  std::array<float, 5> state{};       // CTRV [x, y, v, heading, turn rate]
+  std::array<float, 15> covariance{}; // Packed upper triangle
+};
+
+// Smoothed estimate of a track, `lag` updates behind its newest plot
+struct SmoothedTrack {
+  uint32_t id = 0;
+  double time = 0.0;
+  glm::vec2 position{0.0f};
+  glm::vec2 velocity{0.0f};
+  float turnRate = 0.0f;
+  float sxx = 0.0f, sxy = 0.0f, syy = 0.0f; // Position covariance
+};
+
+struct SmoothedSnapshot {
+  uint64_t sequence = 0;      // Publications so far
+  double newestSample = 0.0;  // Latest filter time the smoother has seen
+  std::vector<SmoothedTrack> tracks; // By track id
+
+  void Clear() { tracks.clear(); }
+};
+
+struct SmootherConfig {
+  size_t lag = 5; // Updates between a track's newest plot and its output
+  // Per-predict process noise; must match the tracking filter (the EKF's)
+  std::array<double, 5> processNoise = {0.1, 0.1, 1.0, 0.1, 0.01};
+  double idleTimeout = 30.0;    // Seconds before a silent track's window goes
+  size_t queueCapacity = 16384; // Samples in flight to the worker
+  int pollIntervalMs = 5;       // Worker sleep when the queue is empty
+};
+
+// Fixed-lag Rauch-Tung-Striebel smoother over a short window of filtered
+// CTRV posteriors per track. Each new sample runs the backward pass from
+// the newest posterior to the oldest in the window, re-linearising the
+// motion model at each filtered state as the EKF did, and yields the
+// smoothed state `lag` updates back. Single-threaded; see SmootherWorker.
+class FixedLagSmoother {
+public:
+  explicit FixedLagSmoother(const SmootherConfig &config = SmootherConfig());
+
+  // Append a sample to its track's window. Once the window is full, writes
+  // the smoothed state of its oldest entry to `out` and returns true.
+  // Samples not newer than the track's last one are ignored.
+  bool Add(const FilterSample &sample, SmoothedTrack &out);
+  void Remove(uint32_t trackId);
+  // Drop windows whose newest sample is older than now - idleTimeout
+  size_t ExpireIdle(double now);
+
+  // Latest smoothed state per track, appended to `out` in id order
+  void CollectSmoothed(std::vector<SmoothedTrack> &out) const;
+  size_t GetTrackCount() const { return m_windows.size(); }
+
+private:
+  struct Window {
+    std::vector<FilterSample> samples; // Ring of lag + 1
+    size_t head = 0;                   // Next slot to write
+    size_t count = 0;
+    bool hasSmoothed = false;
+    SmoothedTrack smoothed;
+
+    const FilterSample &At(size_t i) const { // Oldest first
+      return samples[(head + samples.size() - count + i) % samples.size()];
+    }
+  };
+
+  void Smooth(const Window &window, SmoothedTrack &out) const;
+
+  SmootherConfig m_config;
+  std::unordered_map<uint32_t, Window> m_windows;
+};
+
+// Runs a FixedLagSmoother on its own thread. The tracker submits samples
+// through a lock-free SPSC ring and never waits: if the ring is full the
+// sample is dropped and counted. Smoothed tracks are published through an
+// RcuBuffer after each batch.
+class SmootherWorker {
+public:
+  SmootherWorker(const SmootherConfig &config, MetricsRegistry &registry);
+  ~SmootherWorker();
+
+  SmootherWorker(const SmootherWorker &) = delete;
+  SmootherWorker &operator=(const SmootherWorker &) = delete;
+
+  void Start();
+  void Stop(); // Drains what is queued, publishes, and joins
+
+  // Producer side; call from one thread only. False if the sample was
+  // dropped because the worker is behind.
+  bool Submit(const FilterSample &sample);
+
+  // Consume everything queued and publish, on the calling thread. For
+  // tests and for driving the smoother without a worker thread.
+  size_t ProcessPending();
+
+  // Latest published smoothed tracks; null before the first publication
+  std::shared_ptr<const SmoothedSnapshot> GetSnapshot() const {
+    return m_snapshots.Read();
+  }
+
+private:
+  void Run();
+
+  FixedLagSmoother m_smoother;
+  SpscRing<FilterSample> m_queue;
+  RcuBuffer<SmoothedSnapshot> m_snapshots;
+  uint64_t m_sequence = 0;
+  double m_newestSample = 0.0;
+  int m_pollIntervalMs;
+
+  Counter &m_samplesCounter;
+  Counter &m_droppedCounter;
+  Gauge &m_tracksGauge;
+
+  std::atomic<bool> m_running{false};
+  std::mutex m_stopMutex;
+  std::condition_variable m_stopCond;
+  std::thread m_thread;
+};
+
+} // namespace aegis
@@ -0,0 +1,49 @@
+#include "GateKernel.h"
+#include <algorithm>
+#include <limits>
+
+namespace aegis {
+
+void GateTile::Invert(const MeasurementNoise &noise) {
+  // Every lane, filled or not, branch-free so that it vectorises; lanes
+  // past Size() are evaluated by Gate but never reported
+  for (size_t k = 0; k < LANES; ++k) {
+    float a = m_pxx[k] + noise.xx;
+    float b = m_pxy[k] + noise.xy;
+    float c = m_pyy[k] + noise.yy;
+    float det = a * c - b * b;
+    float valid = det > 0.0f ? 1.0f : 0.0f;
+    float inverse = valid / std::max(det, std::numeric_limits<float>::min());
+    m_ixx[k] = c * inverse;
+    m_ixy2[k] = -2.0f * b * inverse;
+    m_iyy[k] = a * inverse;
+    m_invalid[k] = 1.0f - valid;
+  }
+}
+
+void GateTile::Gate(const GatePlotBlock &plots, float gate,
+                    std::vector<GatedPair> &out) const {
+  alignas(32) float d2[LANES];
+  for (size_t p = 0; p < plots.Size(); ++p) {
+    float px = plots.x[p], py = plots.y[p], dt = plots.lead[p];
+    int inside = 0;
+    for (size_t k = 0; k < LANES; ++k) {
+      float dx = px - (m_x[k] + m_vx[k] * dt);
+      float dy = py - (m_y[k] + m_vy[k] * dt);
+      // A singular lane has a zero inverse, so d2 = gate: outside
+      d2[k] = m_ixx[k] * dx * dx + m_ixy2[k] * dx * dy + m_iyy[k] * dy * dy +
+              m_invalid[k] * gate;
+      inside += d2[k] < gate ? 1 : 0;
+    }
+    if (inside == 0) {
+      continue; // The common case: no track in the tile gates the plot
+    }
+    for (size_t k = 0; k < m_count; ++k) {
+      if (d2[k] < gate) {
+        out.push_back(GatedPair{m_track[k], plots.index[p], d2[k]});
+      }
+    }
+  }
+}
+
+} // namespace aegis
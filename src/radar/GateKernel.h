@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Association.h"
+#include "Track.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aegis {
+
+// A track's prediction as the kernel reads it, packed for dense tables.
+// `track` is copied to the pairs it gates.
+struct GateTrack {
+  float x, y, vx, vy;
+  float pxx, pxy, pyy;
+  uint32_t track;
+
+  GateTrack() = default;
+  GateTrack(uint32_t id, const TrackPrediction &prediction)
+      : x(prediction.position.x), y(prediction.position.y),
+        vx(prediction.velocity.x), vy(prediction.velocity.y),
+        pxx(prediction.pxx), pxy(prediction.pxy), pyy(prediction.pyy),
+        track(id) {}
+};
+
+// Plots sharing one noise, structure-of-arrays, for GateTile::Gate.
+// `lead` is each plot's time after the tile's predictions (positions are
+// carried along the predicted velocity); `index` is the plot number its
+// pairs take.
+struct GatePlotBlock {
+  std::vector<float> x, y, lead;
+  std::vector<uint32_t> index;
+
+  void Clear() {
+    x.clear();
+    y.clear();
+    lead.clear();
+    index.clear();
+  }
+  size_t Size() const { return index.size(); }
+  void Add(float px, float py, float plotLead, uint32_t plot) {
+    x.push_back(px);
+    y.push_back(py);
+    lead.push_back(plotLead);
+    index.push_back(plot);
+  }
+};
+
+// Batched Mahalanobis gating of a tile of tracks against a block of plots.
+// The tile is structure-of-arrays with one lane per track, padded to
+// LANES: the tracks' predicted positions, velocities and inverse
+// innovation covariances S^-1 = (P + R)^-1 for the block's plot noise R.
+// Invert and Gate loop over lanes innermost, so the compiler evaluates a
+// whole tile per plot in SIMD registers; only the pairs inside the gate
+// leave the kernel, as sparse (track, plot, d2) triplets ready for the
+// assignment stage. It beats the scalar test only with several plots per
+// tile, which global association does not produce, so the tracker gates
+// pair by pair (see README).
+class GateTile {
+public:
+  static constexpr size_t LANES = 8;
+
+  void Clear() { m_count = 0; }
+  size_t Size() const { return m_count; }
+  bool Full() const { return m_count == LANES; }
+  uint32_t GetTrack(size_t lane) const { return m_track[lane]; }
+
+  // Add a track; every track's prediction is for the same time
+  void Add(const GateTrack &track) {
+    size_t k = m_count++;
+    m_x[k] = track.x;
+    m_y[k] = track.y;
+    m_vx[k] = track.vx;
+    m_vy[k] = track.vy;
+    m_pxx[k] = track.pxx;
+    m_pxy[k] = track.pxy;
+    m_pyy[k] = track.pyy;
+    m_track[k] = track.track;
+  }
+  // Form S^-1 for plots with noise `noise`. Lanes with a singular S gate
+  // nothing.
+  void Invert(const MeasurementNoise &noise);
+  // Append a pair for each track and plot inside `gate`
+  void Gate(const GatePlotBlock &plots, float gate,
+            std::vector<GatedPair> &out) const;
+
+private:
+  size_t m_count = 0;
+  alignas(32) float m_x[LANES] = {};
+  alignas(32) float m_y[LANES] = {};
+  alignas(32) float m_vx[LANES] = {};
+  alignas(32) float m_vy[LANES] = {};
+  alignas(32) float m_pxx[LANES] = {};
+  alignas(32) float m_pxy[LANES] = {};
+  alignas(32) float m_pyy[LANES] = {};
+  // S^-1, off-diagonal doubled; zero in lanes that gate nothing
+  alignas(32) float m_ixx[LANES] = {};
+  alignas(32) float m_ixy2[LANES] = {};
+  alignas(32) float m_iyy[LANES] = {};
+  alignas(32) float m_invalid[LANES] = {}; // 1 if S is singular, else 0
+  uint32_t m_track[LANES] = {};
+};
+
+} // namespace aegis
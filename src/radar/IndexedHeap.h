@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace aegis {
+
+// Binary min-heap over small integer IDs (e.g. track pool slots) with a
+// position index, so any entry can be re-keyed or removed in O(log N).
+template <typename Key> class IndexedMinHeap {
+public:
+  // Make IDs in [0, capacity) usable (allocates only when growing)
+  void Reserve(size_t capacity) {
+    if (capacity > m_position.size()) {
+      m_position.resize(capacity, kAbsent);
+      m_keys.resize(capacity);
+      m_heap.reserve(capacity);
+    }
+  }
+
+  bool Contains(uint32_t id) const {
+    return id < m_position.size() && m_position[id] != kAbsent;
+  }
+
+  bool Empty() const { return m_heap.empty(); }
+  size_t Size() const { return m_heap.size(); }
+
+  // ID with the smallest key; heap must be non-empty
+  uint32_t Top() const { return m_heap.front(); }
+  const Key &TopKey() const { return m_keys[m_heap.front()]; }
+
+  // Insert, or re-key if already present
+  void Push(uint32_t id, const Key &key) {
+    if (Contains(id)) {
+      Update(id, key);
+      return;
+    }
+    m_keys[id] = key;
+    m_position[id] = static_cast<uint32_t>(m_heap.size());
+    m_heap.push_back(id);
+    SiftUp(m_position[id]);
+  }
+
+  void Update(uint32_t id, const Key &key) {
+    uint32_t pos = m_position[id];
+    bool decreased = key < m_keys[id];
+    m_keys[id] = key;
+    if (decreased) {
+      SiftUp(pos);
+    } else {
+      SiftDown(pos);
+    }
+  }
+
+  void Remove(uint32_t id) {
+    if (!Contains(id)) {
+      return;
+    }
+    uint32_t pos = m_position[id];
+    uint32_t last = static_cast<uint32_t>(m_heap.size() - 1);
+    if (pos != last) {
+      Swap(pos, last);
+    }
+    m_heap.pop_back();
+    m_position[id] = kAbsent;
+    if (pos < m_heap.size()) {
+      SiftDown(pos);
+      SiftUp(pos);
+    }
+  }
+
+  uint32_t Pop() {
+    uint32_t id = Top();
+    Remove(id);
+    return id;
+  }
+
+  void Clear() {
+    for (uint32_t id : m_heap) {
+      m_position[id] = kAbsent;
+    }
+    m_heap.clear();
+  }
+
+private:
+  static constexpr uint32_t kAbsent = std::numeric_limits<uint32_t>::max();
+
+  bool Less(uint32_t a, uint32_t b) const {
+    return m_keys[m_heap[a]] < m_keys[m_heap[b]];
+  }
+
+  void Swap(uint32_t a, uint32_t b) {
+    std::swap(m_heap[a], m_heap[b]);
+    m_position[m_heap[a]] = a;
+    m_position[m_heap[b]] = b;
+  }
+
+  void SiftUp(uint32_t pos) {
+    while (pos > 0) {
+      uint32_t parent = (pos - 1) / 2;
+      if (!Less(pos, parent))
+        break;
+      Swap(pos, parent);
+      pos = parent;
+    }
+  }
+
+  void SiftDown(uint32_t pos) {
+    const uint32_t n = static_cast<uint32_t>(m_heap.size());
+    while (true) {
+      uint32_t left = 2 * pos + 1;
+      uint32_t right = left + 1;
+      uint32_t smallest = pos;
+      if (left < n && Less(left, smallest))
+        smallest = left;
+      if (right < n && Less(right, smallest))
+        smallest = right;
+      if (smallest == pos)
+        break;
+      Swap(pos, smallest);
+      pos = smallest;
+    }
+  }
+
+  std::vector<uint32_t> m_heap;     // Heap-ordered IDs
+  std::vector<uint32_t> m_position; // ID -> heap index, kAbsent if absent
+  std::vector<Key> m_keys;          // ID -> key
+};
+
+} // namespace aegis
@@ -0,0 +1,346 @@
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace aegis {
+
+size_t ThisThreadShard() {
+  static std::atomic<size_t> nextShard{0};
+  thread_local size_t shard =
+      nextShard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return shard;
+}
+
+// --- Counter ---
+
+uint64_t Counter::Value() const {
+  uint64_t total = 0;
+  for (const auto &cell : m_cells) {
+    total += cell.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// --- Histogram ---
+
+Histogram::Histogram(std::vector<double> upperBounds)
+    : m_upperBounds(std::move(upperBounds)) {
+  if (m_upperBounds.size() > kMaxBuckets) {
+    throw std::invalid_argument("Histogram: too many buckets");
+  }
+  std::sort(m_upperBounds.begin(), m_upperBounds.end());
+}
+
+void Histogram::Observe(double value) {
+  size_t bucket = static_cast<size_t>(
+      std::lower_bound(m_upperBounds.begin(), m_upperBounds.end(), value) -
+      m_upperBounds.begin());
+
+  Cell &cell = m_cells[ThisThreadShard()];
+  cell.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  cell.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+HistogramSnapshot Histogram::Snapshot() const {
+  HistogramSnapshot snap;
+  snap.upperBounds = m_upperBounds;
+  snap.counts.assign(m_upperBounds.size() + 1, 0);
+
+  for (const auto &cell : m_cells) {
+    for (size_t b = 0; b < snap.counts.size(); ++b) {
+      uint64_t n = cell.buckets[b].load(std::memory_order_relaxed);
+      snap.counts[b] += n;
+      snap.count += n;
+    }
+    snap.sum += cell.sum.load(std::memory_order_relaxed);
+  }
+  return snap;
+}
+
+// --- StatAccumulator ---
+
+void StatAccumulator::Add(double value) {
+  Cell &cell = m_cells[ThisThreadShard()];
+
+  // Take the shard's sequence lock (uncontended unless more than
+  // kMetricShards threads write this metric)
+  uint32_t seq = cell.sequence.load(std::memory_order_relaxed);
+  while ((seq & 1) != 0 ||
+         !cell.sequence.compare_exchange_weak(seq, seq + 1,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+    seq = cell.sequence.load(std::memory_order_relaxed);
+  }
+
+  // Welford's online update
+  uint64_t n = cell.count.load(std::memory_order_relaxed) + 1;
+  double mean = cell.mean.load(std::memory_order_relaxed);
+  double delta = value - mean;
+  mean += delta / static_cast<double>(n);
+  double m2 = cell.m2.load(std::memory_order_relaxed) + delta * (value - mean);
+
+  cell.count.store(n, std::memory_order_relaxed);
+  cell.mean.store(mean, std::memory_order_relaxed);
+  cell.m2.store(m2, std::memory_order_relaxed);
+  cell.sequence.store(seq + 2, std::memory_order_release);
+}
+
+StatSnapshot StatAccumulator::Snapshot() const {
+  uint64_t totalN = 0;
+  double totalMean = 0.0;
+  double totalM2 = 0.0;
+
+  for (const auto &cell : m_cells) {
+    uint64_t n;
+    double mean, m2;
+    uint32_t before, after;
+    do {
+      before = cell.sequence.load(std::memory_order_acquire);
+      n = cell.count.load(std::memory_order_relaxed);
+      mean = cell.mean.load(std::memory_order_relaxed);
+      m2 = cell.m2.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = cell.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    if (n == 0) {
+      continue;
+    }
+
+    // Chan et al. pairwise merge
+    uint64_t combined = totalN + n;
+    double delta = mean - totalMean;
+    totalMean += delta * static_cast<double>(n) / static_cast<double>(combined);
+    totalM2 += m2 + delta * delta * static_cast<double>(totalN) *
+                        static_cast<double>(n) / static_cast<double>(combined);
+    totalN = combined;
+  }
+
+  StatSnapshot snap;
+  snap.count = totalN;
+  snap.mean = totalMean;
+  snap.variance = (totalN > 1) ? totalM2 / static_cast<double>(totalN - 1) : 0.0;
+  return snap;
+}
+
+// --- MetricsRegistry ---
+
+Counter &MetricsRegistry::AddCounter(const std::string &name,
+                                     const std::string &help) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_counters.emplace_back();
+  m_entries.push_back({name, help, MetricType::COUNTER, m_counters.size() - 1});
+  return m_counters.back();
+}
+
+Counter *MetricsRegistry::FindCounter(const std::string &name) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const Entry &entry : m_entries) {
+    if (entry.type == MetricType::COUNTER && entry.name == name) {
+      return &m_counters[entry.index];
+    }
+  }
+  return nullptr;
+}
+
+Gauge &MetricsRegistry::AddGauge(const std::string &name,
+                                 const std::string &help) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_gauges.emplace_back();
+  m_entries.push_back({name, help, MetricType::GAUGE, m_gauges.size() - 1});
+  return m_gauges.back();
+}
+
+Histogram &MetricsRegistry::AddHistogram(const std::string &name,
+                                         const std::string &help,
+                                         std::vector<double> upperBounds) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_histograms.emplace_back(std::move(upperBounds));
+  m_entries.push_back(
+      {name, help, MetricType::HISTOGRAM, m_histograms.size() - 1});
+  return m_histograms.back();
+}
+
+StatAccumulator &MetricsRegistry::AddStat(const std::string &name,
+                                          const std::string &help) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.emplace_back();
+  m_entries.push_back({name, help, MetricType::STAT, m_stats.size() - 1});
+  return m_stats.back();
+}
+
+std::vector<MetricSample> MetricsRegistry::Snapshot() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  std::vector<MetricSample> samples;
+  samples.reserve(m_entries.size());
+  for (const auto &entry : m_entries) {
+    MetricSample sample;
+    sample.name = entry.name;
+    sample.help = entry.help;
+    sample.type = entry.type;
+    switch (entry.type) {
+    case MetricType::COUNTER:
+      sample.value = static_cast<double>(m_counters[entry.index].Value());
+      break;
+    case MetricType::GAUGE:
+      sample.value = m_gauges[entry.index].Value();
+      break;
+    case MetricType::HISTOGRAM:
+      sample.histogram = m_histograms[entry.index].Snapshot();
+      break;
+    case MetricType::STAT:
+      sample.stat = m_stats[entry.index].Snapshot();
+      break;
+    }
+    samples.push_back(std::move(sample));
+  }
+  return samples;
+}
+
+// --- Exporters ---
+
+namespace {
+
+// Shortest round-trippable text for a double; JSON has no NaN/Inf so those
+// are written as null (Prometheus accepts its own spellings)
+std::string FormatNumber(double value, bool json) {
+  if (std::isnan(value)) {
+    return json ? "null" : "NaN";
+  }
+  if (std::isinf(value)) {
+    return json ? "null" : (value > 0 ? "+Inf" : "-Inf");
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+  if (std::strtod(buffer, nullptr) != value) {
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+  }
+  return buffer;
+}
+
+std::string EscapeJson(const std::string &text) {
+  std::string out;
+  out.reserve(text.size());
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buffer[8];
+      std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      out += buffer;
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
+
+const char *PrometheusType(MetricType type) {
+  switch (type) {
+  case MetricType::COUNTER:
+    return "counter";
+  case MetricType::GAUGE:
+    return "gauge";
+  case MetricType::HISTOGRAM:
+    return "histogram";
+  case MetricType::STAT:
+    return "summary";
+  }
+  return "untyped";
+}
+
+} // namespace
+
+std::string FormatPrometheus(const std::vector<MetricSample> &samples) {
+  std::string out;
+  for (const auto &sample : samples) {
+    const std::string &name = sample.name;
+    out += "# HELP " + name + " " + sample.help + "\n";
+    out += "# TYPE " + name + " " + PrometheusType(sample.type) + "\n";
+
+    switch (sample.type) {
+    case MetricType::COUNTER:
+    case MetricType::GAUGE:
+      out += name + " " + FormatNumber(sample.value, false) + "\n";
+      break;
+    case MetricType::HISTOGRAM: {
+      // Prometheus buckets are cumulative
+      const auto &h = sample.histogram;
+      uint64_t cumulative = 0;
+      for (size_t b = 0; b < h.counts.size(); ++b) {
+        cumulative += h.counts[b];
+        std::string le = (b < h.upperBounds.size())
+                             ? FormatNumber(h.upperBounds[b], false)
+                             : "+Inf";
+        out += name + "_bucket{le=\"" + le + "\"} " +
+               std::to_string(cumulative) + "\n";
+      }
+      out += name + "_sum " + FormatNumber(h.sum, false) + "\n";
+      out += name + "_count " + std::to_string(h.count) + "\n";
+      break;
+    }
+    case MetricType::STAT: {
+      const auto &st = sample.stat;
+      out += name + "_sum " +
+             FormatNumber(st.mean * static_cast<double>(st.count), false) +
+             "\n";
+      out += name + "_count " + std::to_string(st.count) + "\n";
+      out += "# TYPE " + name + "_stddev gauge\n";
+      out += name + "_stddev " + FormatNumber(std::sqrt(st.variance), false) +
+             "\n";
+      break;
+    }
+    }
+  }
+  return out;
+}
+
+std::string FormatJson(const std::vector<MetricSample> &samples) {
+  std::string out = "{";
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const auto &sample = samples[i];
+    if (i > 0) {
+      out += ",";
+    }
+    out += "\n  \"" + EscapeJson(sample.name) + "\": ";
+
+    switch (sample.type) {
+    case MetricType::COUNTER:
+    case MetricType::GAUGE:
+      out += FormatNumber(sample.value, true);
+      break;
+    case MetricType::HISTOGRAM: {
+      const auto &h = sample.histogram;
+      out += "{\"count\": " + std::to_string(h.count) +
+             ", \"sum\": " + FormatNumber(h.sum, true) + ", \"buckets\": [";
+      for (size_t b = 0; b < h.counts.size(); ++b) {
+        std::string le = (b < h.upperBounds.size())
+                             ? FormatNumber(h.upperBounds[b], true)
+                             : "null"; // Overflow bucket
+        out += (b > 0 ? ", " : "");
+        out += "{\"le\": " + le + ", \"count\": " +
+               std::to_string(h.counts[b]) + "}";
+      }
+      out += "]}";
+      break;
+    }
+    case MetricType::STAT: {
+      const auto &st = sample.stat;
+      out += "{\"count\": " + std::to_string(st.count) +
+             ", \"mean\": " + FormatNumber(st.mean, true) +
+             ", \"stddev\": " + FormatNumber(std::sqrt(st.variance), true) +
+             "}";
+      break;
+    }
+    }
+  }
+  out += "\n}\n";
+  return out;
+}
+
+} // namespace aegis
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aegis {
+
+// Number of independent cells per metric. Threads are assigned cells
+// round-robin, so up to kMetricShards writer threads never share a cache
+// line; beyond that cells are shared but stay correct (atomic RMW).
+constexpr size_t kMetricShards = 16;
+constexpr size_t kCacheLine = 64;
+
+// Shard used by the calling thread (stable for the thread's lifetime)
+size_t ThisThreadShard();
+
+// Monotonic counter, summed across shards on read
+class Counter {
+public:
+  void Add(uint64_t n = 1) {
+    m_cells[ThisThreadShard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  uint64_t Value() const;
+
+private:
+  struct alignas(kCacheLine) Cell {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Cell, kMetricShards> m_cells;
+};
+
+// Last-written value (track counts, queue depth, ...)
+class Gauge {
+public:
+  void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+  double Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  alignas(kCacheLine) std::atomic<double> m_value{0.0};
+};
+
+struct HistogramSnapshot {
+  std::vector<double> upperBounds; // Bucket i counts values <= bound i
+  std::vector<uint64_t> counts;    // One per bound, plus +Inf overflow
+  uint64_t count = 0;
+  double sum = 0.0;
+};
+
+// Fixed-bucket histogram (e.g. stage latencies in seconds)
+class Histogram {
+public:
+  static constexpr size_t kMaxBuckets = 15; // Excluding the +Inf bucket
+
+  explicit Histogram(std::vector<double> upperBounds);
+
+  void Observe(double value);
+  HistogramSnapshot Snapshot() const;
+
+private:
+  struct alignas(kCacheLine) Cell {
+    std::array<std::atomic<uint64_t>, kMaxBuckets + 1> buckets{};
+    std::atomic<double> sum{0.0};
+  };
+  std::vector<double> m_upperBounds;
+  std::array<Cell, kMetricShards> m_cells;
+};
+
+struct StatSnapshot {
+  uint64_t count = 0;
+  double mean = 0.0;
+  double variance = 0.0; // Sample variance
+};
+
+// Numerically stable running mean/variance. Each shard runs Welford's
+// update under a per-shard sequence lock (writers never wait on readers);
+// shards are merged on read with Chan's parallel formula, so precision does
+// not decay after millions of samples the way a float running mean does.
+class StatAccumulator {
+public:
+  void Add(double value);
+  StatSnapshot Snapshot() const;
+
+private:
+  struct alignas(kCacheLine) Cell {
+    std::atomic<uint32_t> sequence{0}; // Odd while a write is in progress
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> mean{0.0};
+    std::atomic<double> m2{0.0};
+  };
+  std::array<Cell, kMetricShards> m_cells;
+};
+
+enum class MetricType { COUNTER, GAUGE, HISTOGRAM, STAT };
+
+struct MetricSample {
+  std::string name;
+  std::string help;
+  MetricType type;
+  double value = 0.0; // Counter / gauge value
+  HistogramSnapshot histogram;
+  StatSnapshot stat;
+};
+
+// Owns named metrics. Registration takes a lock and is meant for setup;
+// recording through the returned references is lock-free, and Snapshot()
+// aggregates every shard without stopping writers.
+class MetricsRegistry {
+public:
+  Counter &AddCounter(const std::string &name, const std::string &help);
+  Gauge &AddGauge(const std::string &name, const std::string &help);
+  Histogram &AddHistogram(const std::string &name, const std::string &help,
+                          std::vector<double> upperBounds);
+  StatAccumulator &AddStat(const std::string &name, const std::string &help);
+
+  // Counter registered under `name`, or null
+  Counter *FindCounter(const std::string &name);
+
+  std::vector<MetricSample> Snapshot() const;
+
+private:
+  struct Entry {
+    std::string name;
+    std::string help;
+    MetricType type;
+    size_t index; // Into the matching deque below
+  };
+
+  mutable std::mutex m_mutex; // Guards registration only
+  std::vector<Entry> m_entries;
+  // Deques keep metric addresses stable as more are registered
+  std::deque<Counter> m_counters;
+  std::deque<Gauge> m_gauges;
+  std::deque<Histogram> m_histograms;
+  std::deque<StatAccumulator> m_stats;
+};
+
+// Prometheus text exposition format (0.0.4). STAT metrics are exported as
+// a summary (_count/_sum) plus a _stddev gauge.
+std::string FormatPrometheus(const std::vector<MetricSample> &samples);
+
+// The same samples as one JSON object keyed by metric name
+std::string FormatJson(const std::vector<MetricSample> &samples);
+
+} // namespace aegis
@@ -0,0 +1,346 @@
+#include "MultiHypothesis.h"
+#include <algorithm>
+#include <cmath>
+
+namespace aegis {
+
+const TrackPrediction &HypothesisBranch::PredictTo(double time) const {
+  if (prediction.time != time) {
+    prediction = PredictFilter(filter, stateTime, time);
+  }
+  return prediction;
+}
+
+HypothesisForest::HypothesisForest(const MhtConfig &config,
+                                   MetricsRegistry &registry)
+    : m_config(config),
+      m_hypothesesCounter(registry.AddCounter(
+          "aegis_mht_hypotheses_total",
+          "Global hypotheses formed, k best per cluster per frame")),
+      m_prunedCounter(registry.AddCounter(
+          "aegis_mht_pruned_total",
+          "Branches dropped as unlikely or by N-scan pruning")),
+      m_limitedCounter(registry.AddCounter(
+          "aegis_mht_limited_total",
+          "Clusters solved for their best hypothesis only (too many plots "
+          "or too little branch room)")),
+      m_collapsedCounter(registry.AddCounter(
+          "aegis_mht_collapsed_total",
+          "Tracks cut to their best branch for want of arena room")),
+      m_reversalsCounter(registry.AddCounter(
+          "aegis_mht_reversals_total",
+          "Tracks whose best hypothesis moved to another branch")),
+      m_branchesGauge(registry.AddGauge(
+          "aegis_mht_branches", "Hypothesis branches held across tracks")) {
+  m_config.scanDepth =
+      std::clamp<size_t>(m_config.scanDepth, 1, MAX_SCAN_DEPTH);
+  m_config.hypothesesPerCluster =
+      std::max<size_t>(m_config.hypothesesPerCluster, 1);
+  float pd = std::clamp(m_config.detectionProbability, 0.01f, 0.99f);
+  m_missScore = std::log(1.0f - pd);
+  m_plotConstant = std::log(pd / (2.0f * 3.14159265f *
+                                  std::max(m_config.clutterDensity, 1e-30f)));
+}
+
+void HypothesisForest::BeginFrame() {
+  if (m_arenas[0].branches.empty()) {
+    for (Arena &arena : m_arenas) {
+      arena.branches.resize(m_config.maxHypotheses);
+    }
+  }
+  m_frame++;
+  m_arenas[m_frame & 1].used = 0;
+  m_stored[m_frame & 1].clear();
+  m_pending = m_arenas[(m_frame - 1) & 1].used;
+  m_reserved = 0;
+}
+
+const HypothesisForest::Entry *HypothesisForest::Find(TrackHandle handle,
+                                                      uint64_t frame) const {
+  const std::vector<Entry> &entries = m_entries[frame & 1];
+  if (handle.index >= entries.size()) {
+    return nullptr;
+  }
+  const Entry &entry = entries[handle.index];
+  return entry.frame == frame && entry.handle == handle ? &entry : nullptr;
+}
+
+const HypothesisBranch *HypothesisForest::Branches(TrackHandle handle,
+                                                   size_t &count) const {
+  const Entry *entry = Find(handle, m_frame - 1);
+  if (!entry) {
+    count = 0;
+    return nullptr;
+  }
+  count = entry->count;
+  return m_arenas[(m_frame - 1) & 1].branches.data() + entry->first;
+}
+
+float HypothesisForest::PlotScore(const TrackPrediction &prediction,
+                                  const MeasurementNoise &noise,
+                                  float d2) const {
+  float a = prediction.pxx + noise.xx, b = prediction.pxy + noise.xy,
+        c = prediction.pyy + noise.yy;
+  return m_plotConstant - 0.5f * std::log(std::max(a * c - b * b, 1e-6f)) -
+         0.5f * d2;
+}
+
+void HypothesisForest::Select(const std::vector<GatedPair> &pairs,
+                              const std::vector<uint32_t> &parents,
+                              const std::vector<TrackHandle> &targets,
+                              size_t plotCount,
+                              std::vector<BranchChoice> &choices) {
+  choices.clear();
+  // Tracks are elements [0, targets), plots follow
+  size_t elements = targets.size() + plotCount;
+  m_sets.Reset(elements);
+  for (const GatedPair &pair : pairs) {
+    m_sets.Union(pair.track,
+                 static_cast<uint32_t>(targets.size() + pair.plot));
+  }
+
+  // Group the pairs by cluster, clusters in order of first appearance
+  m_clusterOf.assign(elements, NONE);
+  m_fill.clear();
+  for (const GatedPair &pair : pairs) {
+    uint32_t &cluster = m_clusterOf[m_sets.Find(pair.track)];
+    if (cluster == NONE) {
+      cluster = static_cast<uint32_t>(m_fill.size());
+      m_fill.push_back(0);
+    }
+    m_fill[cluster]++;
+  }
+  size_t clusters = m_fill.size();
+  m_clusterStart.assign(clusters + 1, 0);
+  for (size_t c = 0; c < clusters; ++c) {
+    m_clusterStart[c + 1] = m_clusterStart[c] + m_fill[c];
+    m_fill[c] = 0;
+  }
+  m_clusterPairs.resize(pairs.size());
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    uint32_t c = m_clusterOf[m_sets.Find(pairs[i].track)];
+    m_clusterPairs[m_clusterStart[c] + m_fill[c]++] =
+        static_cast<uint32_t>(i);
+  }
+
+  m_column.assign(targets.size(), NONE);
+  m_row.assign(plotCount, NONE);
+  for (size_t c = 0; c < clusters; ++c) {
+    SelectCluster(m_clusterStart[c], m_clusterStart[c + 1], pairs, parents,
+                  targets, choices);
+  }
+}
+
+void HypothesisForest::SelectCluster(size_t begin, size_t end,
+                                     const std::vector<GatedPair> &pairs,
+                                     const std::vector<uint32_t> &parents,
+                                     const std::vector<TrackHandle> &targets,
+                                     std::vector<BranchChoice> &choices) {
+  m_targets.clear();
+  m_plots.clear();
+  for (size_t i = begin; i < end; ++i) {
+    const GatedPair &pair = pairs[m_clusterPairs[i]];
+    if (m_column[pair.track] == NONE) {
+      m_column[pair.track] = static_cast<uint32_t>(m_targets.size());
+      m_targets.push_back(pair.track);
+    }
+    if (m_row[pair.plot] == NONE) {
+      m_row[pair.plot] = static_cast<uint32_t>(m_plots.size());
+      m_plots.push_back(pair.plot);
+    }
+  }
+
+  // Plots are rows; columns are the tracks, then one per plot for
+  // "clutter or a new target", the baseline every score is relative to.
+  // A track no plot takes misses.
+  size_t rows = m_plots.size(), tracks = m_targets.size();
+  size_t cols = tracks + rows;
+  m_cost.assign(rows * cols, static_cast<float>(ASSIGNMENT_FORBIDDEN));
+  m_pairAt.assign(rows * cols, NONE);
+  for (size_t i = begin; i < end; ++i) {
+    uint32_t index = m_clusterPairs[i];
+    const GatedPair &pair = pairs[index];
+    size_t cell = m_row[pair.plot] * cols + m_column[pair.track];
+    m_cost[cell] = pair.cost;
+    m_pairAt[cell] = index;
+  }
+  for (size_t r = 0; r < rows; ++r) {
+    m_cost[r * cols + tracks + r] = 0.0f;
+  }
+
+  // Room for the branches this cluster could keep, leaving enough for
+  // the tracks still to be carried from the last frame
+  for (uint32_t target : m_targets) {
+    size_t held = 0;
+    Branches(targets[target], held);
+    m_pending -= held;
+  }
+  size_t k = m_config.hypothesesPerCluster;
+  size_t room = m_config.maxHypotheses - std::min(m_config.maxHypotheses,
+                                                  m_pending + m_reserved);
+  if (k > 1 && (rows > m_config.maxClusterPlots ||
+                tracks * std::min(k, rows + 1) > room)) {
+    k = 1;
+    m_limitedCounter.Add();
+  }
+  m_assignments.clear();
+  m_totals.clear();
+  size_t found = SolveKBestAssignments(m_cost.data(), rows, cols, k,
+                                       m_assignments, m_totals, m_kBest);
+  m_hypothesesCounter.Add(found);
+
+  // Each hypothesis gives every track one option: a plot, or a miss.
+  // Options carry the probability of the hypotheses that make them.
+  m_options.clear();
+  m_fill.assign(tracks, 0); // Options per track, at m_options[t * k]
+  m_options.resize(tracks * k);
+  double sum = 0.0;
+  for (size_t h = 0; h < found; ++h) {
+    double weight = std::exp(-(m_totals[h] - m_totals[0]));
+    sum += weight;
+    const int *assignment = m_assignments.data() + h * rows;
+    for (size_t t = 0; t < tracks; ++t) {
+      uint32_t plot = MISS, parent = 0;
+      float score = m_missScore;
+      for (size_t r = 0; r < rows; ++r) {
+        if (static_cast<size_t>(assignment[r]) == t) {
+          uint32_t index = m_pairAt[r * cols + t];
+          plot = m_plots[r];
+          parent = parents[index];
+          score = m_missScore - pairs[index].cost;
+          break;
+        }
+      }
+      Option *options = m_options.data() + t * k;
+      uint32_t &count = m_fill[t];
+      size_t i = 0;
+      while (i < count && options[i].plot != plot) {
+        ++i;
+      }
+      if (i == count) {
+        options[count++] = Option{m_targets[t], plot, parent, score, 0.0,
+                                  h == 0};
+      }
+      options[i].probability += weight;
+    }
+  }
+
+  // Keep the likely options that agree with the best one about the frame
+  // scanDepth back, the best one first
+  size_t depth = m_config.scanDepth;
+  for (size_t t = 0; t < tracks; ++t) {
+    const Option *options = m_options.data() + t * k;
+    size_t held = 0;
+    const HypothesisBranch *branches = Branches(targets[m_targets[t]], held);
+    auto decision = [&](const Option &option) {
+      const HypothesisBranch &parent = branches[option.parent];
+      return parent.depth >= depth ? parent.history[depth - 1] : NONE;
+    };
+    size_t first = choices.size();
+    for (size_t i = 0; i < m_fill[t]; ++i) {
+      const Option &option = options[i];
+      bool keep = option.best;
+      if (!keep) {
+        keep = option.probability >= m_config.pruneProbability * sum &&
+               (held == 0 || decision(option) == decision(options[0]));
+        if (!keep) {
+          m_prunedCounter.Add();
+          continue;
+        }
+      }
+      choices.push_back(BranchChoice{option.target, option.parent,
+                                     option.plot, option.score, option.best});
+    }
+    if (choices.size() - first > 1) {
+      m_reserved += choices.size() - first;
+    }
+  }
+
+  for (uint32_t target : m_targets) {
+    m_column[target] = NONE;
+  }
+  for (uint32_t plot : m_plots) {
+    m_row[plot] = NONE;
+  }
+}
+
+void HypothesisForest::Extend(const HypothesisBranch &parent, uint32_t plot,
+                              HypothesisBranch &child) {
+  child = parent;
+  for (size_t i = child.history.size() - 1; i > 0; --i) {
+    child.history[i] = child.history[i - 1];
+  }
+  child.history[0] = plot;
+  child.depth = static_cast<uint8_t>(
+      std::min<size_t>(parent.depth + 1u, child.history.size()));
+  child.hit = plot != MISS;
+  child.prediction = TrackPrediction();
+}
+
+void HypothesisForest::FromTrack(const Track &track,
+                                 HypothesisBranch &branch) {
+  using Packed = ExtendedKalmanFilter::Filter;
+  Packed::State x;
+  std::array<float, Packed::PACKED_SIZE> P;
+  track.GetFilterState(x.data(), P.data());
+  Packed &filter = branch.filter.GetFilter();
+  filter.SetState(x);
+  for (int i = 0; i < Packed::STATE_DIM; ++i) {
+    for (int j = i; j < Packed::STATE_DIM; ++j) {
+      filter.SetCovariance(i, j, P[Packed::PackedIndex(i, j)]);
+    }
+  }
+  branch.stateTime = track.GetStateTime();
+  branch.score = 0.0f;
+  branch.hit = false;
+  branch.depth = 0;
+  branch.history.fill(MISS);
+  branch.prediction = TrackPrediction();
+}
+
+HypothesisBranch *HypothesisForest::Store(TrackHandle handle, size_t count) {
+  Arena &out = m_arenas[m_frame & 1];
+  Collapse(handle);
+  if (out.used + count > out.branches.size()) {
+    m_collapsedCounter.Add();
+    return nullptr;
+  }
+  std::vector<Entry> &entries = m_entries[m_frame & 1];
+  if (handle.index >= entries.size()) {
+    entries.resize(handle.index + 1);
+  }
+  entries[handle.index] = Entry{handle, static_cast<uint32_t>(out.used),
+                                static_cast<uint32_t>(count), m_frame};
+  m_stored[m_frame & 1].push_back(handle.index);
+  HypothesisBranch *branches = out.branches.data() + out.used;
+  out.used += count;
+  return branches;
+}
+
+void HypothesisForest::Collapse(TrackHandle handle) {
+  for (uint64_t frame : {m_frame - 1, m_frame}) {
+    if (Find(handle, frame)) {
+      m_entries[frame & 1][handle.index].frame = 0;
+    }
+  }
+}
+
+void HypothesisForest::EndFrame(const TrackPool &pool) {
+  // Untouched tracks keep their branches as they were: a frame with no
+  // plot for a track scores every branch the same
+  uint64_t last = m_frame - 1;
+  const Arena &in = m_arenas[last & 1];
+  for (uint32_t slot : m_stored[last & 1]) {
+    const Entry &entry = m_entries[last & 1][slot];
+    if (entry.frame != last || !pool.Get(entry.handle)) {
+      continue; // Resolved this frame, or deleted
+    }
+    if (HypothesisBranch *out = Store(entry.handle, entry.count)) {
+      std::copy(in.branches.begin() + entry.first,
+                in.branches.begin() + entry.first + entry.count, out);
+    }
+  }
+  m_branchesGauge.Set(static_cast<double>(GetBranchCount()));
+}
+
+} // namespace aegis
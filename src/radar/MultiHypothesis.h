@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Association.h"
+#include "MetricsRegistry.h"
+#include "TrackPool.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aegis {
+
+struct MhtConfig {
+  // N-scan pruning: an assignment can be revised for this many frames,
+  // then every branch of the track that disagrees with its best one about
+  // it is dropped (1 to MAX_SCAN_DEPTH). A frame is one sensor's plots of
+  // one scan, and counts only for tracks it had plots for.
+  size_t scanDepth = 3;
+  // Global hypotheses formed per cluster (k-best assignment)
+  size_t hypothesesPerCluster = 8;
+  // Branches held at once across all tracks: each of the two per-frame
+  // arenas has room for this many. A cluster that could outgrow what is
+  // left is solved for its best hypothesis only.
+  size_t maxHypotheses = 4096;
+  // Clusters with more plots than this are solved for their best
+  // hypothesis only, bounding the k-best solve
+  size_t maxClusterPlots = 32;
+  // Branch scores: log-likelihood ratios of target against clutter
+  float detectionProbability = 0.9f;
+  float clutterDensity = 1e-9f; // False plots per m^2 per frame
+  // Branches with less probability than this over the cluster's k best
+  // hypotheses are dropped
+  float pruneProbability = 0.01f;
+};
+
+constexpr size_t MAX_SCAN_DEPTH = 8;
+
+// One hypothesis about a track: its estimate after one sequence of
+// assignments, and its score relative to the track's best branch. Plain
+// data, so arenas copy it freely.
+struct HypothesisBranch {
+  ExtendedKalmanFilter filter; // CTRV
+  double stateTime = 0.0;
+  float score = 0.0f; // 0 for the best; log-likelihood ratio to it
+  bool hit = false;   // Took a plot in its latest frame
+  uint8_t depth = 0;  // Frames in `history`
+  // Plot (index within its frame) taken in each of the latest frames,
+  // newest first; MISS for none. Identifies the branch's path in the
+  // track's hypothesis tree back to the last pruning decision.
+  std::array<uint32_t, MAX_SCAN_DEPTH + 1> history;
+  mutable TrackPrediction prediction; // Memoised PredictTo
+
+  const TrackPrediction &PredictTo(double time) const;
+};
+
+// A branch kept by Select: the plot (or MISS) it takes this frame, and
+// the branch it extends
+struct BranchChoice {
+  uint32_t target;
+  uint32_t parent; // Index into the target's branches; 0 = best
+  uint32_t plot;
+  float score; // Parent's score plus this frame's, before renormalising
+  bool best;   // Part of the cluster's best global hypothesis
+};
+
+// Track-oriented multiple hypothesis tracking. A track that is
+// ambiguous keeps several branches; one that is not keeps none here and
+// the Track itself is its only branch. Branches live in two fixed arenas
+// that swap every frame: a frame reads the branches written by the last
+// one and writes the survivors, along with the branches of tracks it did
+// not touch, to the other. Nothing is allocated after the first frame,
+// and memory is bounded by maxHypotheses.
+//
+// Each frame the tracker gates every branch against the plots and calls
+// Select, which splits the gated pairs into independent clusters, forms
+// each cluster's k best global hypotheses (Murty), and keeps the branches
+// that carry enough of their probability and agree with the best one
+// scanDepth frames back.
+class HypothesisForest {
+public:
+  HypothesisForest(const MhtConfig &config, MetricsRegistry &registry);
+
+  const MhtConfig &GetConfig() const { return m_config; }
+
+  // Start a frame: the last frame's output becomes this one's input
+  void BeginFrame();
+  // A track's branches as of the last frame, best first; none (count 0)
+  // if it has only one
+  const HypothesisBranch *Branches(TrackHandle handle, size_t &count) const;
+
+  // Score of a branch taking a plot it gates at distance d2 under
+  // `prediction` with plot noise `noise`, and of missing one
+  float PlotScore(const TrackPrediction &prediction,
+                  const MeasurementNoise &noise, float d2) const;
+  float MissScore() const { return m_missScore; }
+
+  // Choose this frame's branches. `pairs` are the frame's gated pairs,
+  // tracks numbered as `targets`, each with `parents[i]` the branch it
+  // extends (the best one for that plot) and cost MissScore() minus its
+  // branch's score; a track's miss extends branch 0. Fills `choices`,
+  // grouped by target, best first within each.
+  void Select(const std::vector<GatedPair> &pairs,
+              const std::vector<uint32_t> &parents,
+              const std::vector<TrackHandle> &targets, size_t plotCount,
+              std::vector<BranchChoice> &choices);
+
+  // Branch path bookkeeping: `child` continues `parent` with `plot`
+  static void Extend(const HypothesisBranch &parent, uint32_t plot,
+                     HypothesisBranch &child);
+  // A track's own estimate as a branch with no history
+  static void FromTrack(const Track &track, HypothesisBranch &branch);
+
+  // Room for a track's `count` branches in this frame's output, or null if
+  // the arena is full (the track then keeps only its best)
+  HypothesisBranch *Store(TrackHandle handle, size_t count);
+  // A track resolved to one branch, or changed outside MHT: drop its
+  // branches
+  void Collapse(TrackHandle handle);
+  // Finish the frame: carry the branches of live tracks it did not touch
+  // into its output
+  void EndFrame(const TrackPool &pool);
+
+  // Branches held, across all tracks
+  size_t GetBranchCount() const { return m_arenas[m_frame & 1].used; }
+  void CountReversal() { m_reversalsCounter.Add(); }
+
+  static constexpr uint32_t MISS = 0xFFFFFFFFu;
+
+private:
+  struct Arena {
+    std::vector<HypothesisBranch> branches; // maxHypotheses, once used
+    size_t used = 0;
+  };
+  // Where a track's branches are in one arena
+  struct Entry {
+    TrackHandle handle;
+    uint32_t first = 0;
+    uint32_t count = 0;
+    uint64_t frame = 0; // Valid for that frame's arena only
+  };
+
+  const Entry *Find(TrackHandle handle, uint64_t frame) const;
+  // Solve one cluster's pairs m_clusterPairs[begin, end)
+  void SelectCluster(size_t begin, size_t end,
+                     const std::vector<GatedPair> &pairs,
+                     const std::vector<uint32_t> &parents,
+                     const std::vector<TrackHandle> &targets,
+                     std::vector<BranchChoice> &choices);
+
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+  MhtConfig m_config;
+  float m_missScore;
+  float m_plotConstant; // ln(Pd / (2 pi clutterDensity))
+  uint64_t m_frame = 1; // Written arena: m_frame & 1
+  std::array<Arena, 2> m_arenas;
+  std::array<std::vector<Entry>, 2> m_entries; // By slot
+  std::array<std::vector<uint32_t>, 2> m_stored; // Slots, per arena
+  // This frame: branches of the last frame's not yet resolved (the most
+  // EndFrame may carry), and branches Select has promised
+  size_t m_pending = 0;
+  size_t m_reserved = 0;
+
+  // Select scratch
+  UnionFind m_sets;
+  std::vector<uint32_t> m_clusterOf;    // Root -> cluster
+  std::vector<size_t> m_clusterStart;   // Into m_clusterPairs
+  std::vector<uint32_t> m_clusterPairs; // Pair indices by cluster
+  std::vector<uint32_t> m_fill;
+  std::vector<uint32_t> m_column; // Target -> matrix column, or NONE
+  std::vector<uint32_t> m_row;    // Plot -> matrix row, or NONE
+  std::vector<uint32_t> m_targets, m_plots; // The cluster's
+  std::vector<float> m_cost;
+  std::vector<int> m_assignments;
+  std::vector<double> m_totals;
+  std::vector<uint32_t> m_pairAt; // (row, column) -> pair index
+  struct Option {
+    uint32_t target, plot, parent;
+    float score;
+    double probability;
+    bool best;
+  };
+  std::vector<Option> m_options;
+  KBestWorkspace m_kBest;
+
+  Counter &m_hypothesesCounter;
+  Counter &m_prunedCounter;
+  Counter &m_limitedCounter;
+  Counter &m_collapsedCounter;
+  Counter &m_reversalsCounter;
+  Gauge &m_branchesGauge;
+};
+
+} // namespace aegis
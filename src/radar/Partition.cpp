@@ -0,0 +1,103 @@
+#include "Partition.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace aegis {
+
+PartitionMap PartitionMap::Load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("cannot open partition map: " + path);
+  }
+
+  PartitionMap map;
+  std::string line;
+  int lineNumber = 0;
+  int spacingLine = 0; // Last overlap or hysteresis line
+  while (std::getline(file, line)) {
+    lineNumber++;
+    line = line.substr(0, line.find('#'));
+    std::istringstream in(line);
+    std::string keyword;
+    if (!(in >> keyword)) {
+      continue; // Blank or comment
+    }
+
+    bool ok = false;
+    if (keyword == "node") {
+      PartitionNode node;
+      ok = static_cast<bool>(in >> node.region.minX >> node.region.minY >>
+                             node.region.maxX >> node.region.maxY >>
+                             node.host >> node.plotPort >> node.handoverPort) &&
+           node.region.minX < node.region.maxX &&
+           node.region.minY < node.region.maxY;
+      map.nodes.push_back(node);
+    } else if (keyword == "overlap") {
+      ok = static_cast<bool>(in >> map.overlap) && map.overlap >= 0.0f;
+      spacingLine = lineNumber;
+    } else if (keyword == "hysteresis") {
+      ok = static_cast<bool>(in >> map.hysteresis) && map.hysteresis >= 0.0f;
+      spacingLine = lineNumber;
+    }
+    std::string extra;
+    if (!ok || (in >> extra)) {
+      throw std::runtime_error(path + ":" + std::to_string(lineNumber) +
+                               ": invalid partition line");
+    }
+  }
+  // A track handed over at or past the overlap lands on a node that has
+  // not been sent its plots
+  if (map.hysteresis >= map.overlap) {
+    throw std::runtime_error(path + ":" + std::to_string(spacingLine) +
+                             ": hysteresis must be below the overlap");
+  }
+  if (map.nodes.empty()) {
+    throw std::runtime_error(path + ": no nodes");
+  }
+  return map;
+}
+
+TrackHandover ToHandover(const TrackRecord &record, uint16_t fromNode) {
+  TrackHandover message{};
+  message.trackId = record.id;
+  message.fromNode = fromNode;
+  message.filterModel = static_cast<uint8_t>(record.model);
+  message.state = static_cast<uint8_t>(record.state);
+  message.hitCount = static_cast<uint16_t>(std::min(record.hitCount, 0xFFFF));
+  message.missCount =
+      static_cast<uint16_t>(std::min(record.missCount, 0xFFFF));
+  message.stateTime = record.stateTime;
+  message.lastUpdate = record.lastUpdate;
+  // Element by element: the message is packed
+  for (size_t i = 0; i < record.x.size(); ++i) {
+    message.x[i] = record.x[i];
+  }
+  for (size_t i = 0; i < record.covariance.size(); ++i) {
+    message.covariance[i] = record.covariance[i];
+  }
+  return message;
+}
+
+TrackRecord FromHandover(const TrackHandover &message) {
+  TrackRecord record;
+  record.id = message.trackId;
+  record.model = message.filterModel == 1 ? TrackFilterModel::IMM
+                                          : TrackFilterModel::EKF;
+  record.state = message.state <= 2 ? static_cast<TrackState>(message.state)
+                                    : TrackState::TENTATIVE;
+  record.hitCount = message.hitCount;
+  record.missCount = message.missCount;
+  record.stateTime = message.stateTime;
+  record.lastUpdate = message.lastUpdate;
+  for (size_t i = 0; i < record.x.size(); ++i) {
+    record.x[i] = message.x[i];
+  }
+  for (size_t i = 0; i < record.covariance.size(); ++i) {
+    record.covariance[i] = message.covariance[i];
+  }
+  return record;
+}
+
+} // namespace aegis
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Protocol.h"
+#include "Track.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace aegis {
+
+// Axis-aligned area of the common frame, half-open so tiles that share an
+// edge never both contain a point on it. Unbounded by default.
+struct Region {
+  float minX = -std::numeric_limits<float>::infinity();
+  float minY = -std::numeric_limits<float>::infinity();
+  float maxX = std::numeric_limits<float>::infinity();
+  float maxY = std::numeric_limits<float>::infinity();
+
+  // Inside the region grown by `margin` on every side (shrunk if negative)
+  bool Contains(float x, float y, float margin = 0.0f) const {
+    return x >= minX - margin && x < maxX + margin && y >= minY - margin &&
+           y < maxY + margin;
+  }
+};
+
+// One tracker process of a partitioned deployment
+struct PartitionNode {
+  Region region;                  // Area whose tracks this node owns
+  std::string host = "127.0.0.1"; // Where the node listens
+  int plotPort = 0;               // Routed plots
+  int handoverPort = 0;           // Tracks handed over by neighbours
+};
+
+// Split of the coverage area between tracker nodes. Each node owns the
+// tracks inside its region, and is sent the plots inside its region grown
+// by `overlap`, so it keeps updating its tracks just past the edge. A track
+// that gets `hysteresis` into a neighbour's region is handed over to it;
+// hysteresis below the overlap means the neighbour already sees its plots,
+// and stops tracks that run along an edge from bouncing between nodes.
+struct PartitionMap {
+  std::vector<PartitionNode> nodes;
+  float overlap = 2000.0f;   // m
+  float hysteresis = 500.0f; // m
+
+  // Node whose region contains the point, or -1 if none does
+  int Owner(float x, float y) const {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i].region.Contains(x, y)) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  // Calls visit(index) for every node that must see a plot at (x, y)
+  template <typename Visit>
+  void ForEachCovering(float x, float y, Visit &&visit) const {
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i].region.Contains(x, y, overlap)) {
+        visit(static_cast<int>(i));
+      }
+    }
+  }
+
+  // Read a map from a text file: one `node MINX MINY MAXX MAXY HOST
+  // PLOTPORT HANDOVERPORT` line per node, optional `overlap M` and
+  // `hysteresis M` lines, `#` comments; hysteresis must be below the
+  // overlap. Throws std::runtime_error naming the offending line.
+  static PartitionMap Load(const std::string &path);
+};
+
+// Wire form of a handed-over track
+TrackHandover ToHandover(const TrackRecord &record, uint16_t fromNode);
+TrackRecord FromHandover(const TrackHandover &message);
+
+} // namespace aegis
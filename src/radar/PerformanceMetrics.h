@@ -1,59 +1,43 @@
 #pragma once
 
 #include <cstdint>
-#include <map>
-#include <string>
 
 namespace aegis {
 
-// Performance metrics for tracking system evaluation
+// Performance metrics for tracking system evaluation. This is a value
+// snapshot aggregated from the TrackManager's MetricsRegistry; it is safe to
+// copy across threads and is never written to by the tracker directly.
 struct TrackingMetrics {
-  // Track quality metrics
+  // Track quality metrics (current scan)
   int totalTracks = 0;
   int confirmedTracks = 0;
   int tentativeTracks = 0;
   int coastingTracks = 0;
 
   // Association metrics
-  int totalPlots = 0;
-  int associatedPlots = 0;
-  int newTracks = 0;
+  uint64_t totalPlots = 0;
+  uint64_t associatedPlots = 0;
+  uint64_t newTracks = 0;
 
   // Ground truth comparison (requires plotId matching)
-  int correctAssociations = 0; // Track ID matches ground truth
-  int incorrectAssociations = 0;
+  uint64_t correctAssociations = 0; // Track ID matches ground truth
+  uint64_t incorrectAssociations = 0;
 
   // Track lifecycle
-  int tracksCreated = 0;
-  int tracksDeleted = 0;
+  uint64_t tracksCreated = 0;
+  uint64_t tracksDeleted = 0;
 
-  // Positional accuracy (running average)
-  float avgPositionError = 0.0f;
-  int positionErrorSamples = 0;
+  // Overload protection (track caps)
+  uint64_t tracksEvicted = 0;          // Weakest tentative tracks evicted at cap
+  uint64_t plotsDroppedAtCapacity = 0; // Plots shed with nothing left to evict
 
-  // Reset all metrics
-  void Reset() {
-    totalTracks = 0;
-    confirmedTracks = 0;
-    tentativeTracks = 0;
-    coastingTracks = 0;
-    totalPlots = 0;
-    associatedPlots = 0;
-    newTracks = 0;
-    correctAssociations = 0;
-    incorrectAssociations = 0;
-    tracksCreated = 0;
-    tracksDeleted = 0;
-    avgPositionError = 0.0f;
-    positionErrorSamples = 0;
-  }
+  // Positional accuracy (Welford mean / standard deviation)
+  double avgPositionError = 0.0;
+  double positionErrorStdDev = 0.0;
+  uint64_t positionErrorSamples = 0;
 
-  // Update running average for position error
-  void AddPositionError(float error) {
-    avgPositionError = (avgPositionError * positionErrorSamples + error) /
-                       (positionErrorSamples + 1);
-    positionErrorSamples++;
-  }
+  // Reset all metrics
+  void Reset() { *this = TrackingMetrics(); }
 
   // Calculate track purity (confirmed / total)
   float GetTrackPurity() const {
@@ -0,0 +1,83 @@
+#include "PlotRouter.h"
+#include "../network/UdpSocket.h"
+#include <iostream>
+#include <string>
+
+namespace aegis {
+
+PlotRouter::PlotRouter(const PartitionMap &map,
+                       const std::vector<SensorConfig> &sensors)
+    : m_map(map),
+      m_plotsCounter(m_registry.AddCounter("aegis_router_plots_total",
+                                           "Plots read by the router")),
+      m_forwardedCounter(m_registry.AddCounter(
+          "aegis_router_forwarded_total",
+          "Plot copies sent to nodes (overlap plots go to several)")),
+      m_unroutedCounter(m_registry.AddCounter(
+          "aegis_router_unrouted_total",
+          "Plots outside every node's region and overlap")) {
+  for (const SensorConfig &sensor : sensors) {
+    m_sensors.Register(sensor);
+  }
+}
+
+PlotRouter::~PlotRouter() { Stop(); }
+
+void PlotRouter::Start(int listenPort) {
+  if (m_running) {
+    return;
+  }
+  m_socket = std::make_unique<net::UdpSocket>();
+  m_socket->Bind(listenPort);
+  // Bounded receive so the thread notices shutdown promptly
+  m_socket->SetReceiveTimeout(200);
+  std::cout << "Plot Router Listening on Port " << listenPort << ", "
+            << m_map.nodes.size() << " nodes" << std::endl;
+  m_running = true;
+  m_thread = std::thread(&PlotRouter::Run, this);
+}
+
+void PlotRouter::Stop() {
+  m_running = false;
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  m_socket.reset();
+}
+
+void PlotRouter::Route(const Plot &plot, std::vector<int> &nodes) const {
+  const SensorConfig &sensor = m_sensors.Get(plot.sensorId);
+  m_map.ForEachCovering(plot.x + sensor.originX, plot.y + sensor.originY,
+                        [&](int node) { nodes.push_back(node); });
+}
+
+void PlotRouter::Run() {
+  net::UdpSocket sender;
+  std::vector<int> nodes;
+  while (m_running) {
+    Plot plot;
+    std::string senderAddr;
+    int senderPort;
+    int bytes =
+        m_socket->ReceiveFrom(&plot, sizeof(plot), senderAddr, senderPort);
+    if (bytes == static_cast<int>(LEGACY_PLOT_SIZE)) {
+      plot.sensorId = 0;
+    } else if (bytes != sizeof(plot)) {
+      continue;
+    }
+    m_plotsCounter.Add();
+
+    nodes.clear();
+    Route(plot, nodes);
+    if (nodes.empty()) {
+      m_unroutedCounter.Add();
+    }
+    for (int node : nodes) {
+      const PartitionNode &target = m_map.nodes[node];
+      sender.SendTo(target.host, target.plotPort, &plot, sizeof(plot));
+    }
+    m_forwardedCounter.Add(nodes.size());
+  }
+}
+
+} // namespace aegis
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "MetricsRegistry.h"
+#include "Partition.h"
+#include "Protocol.h"
+#include "SensorRegistry.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace aegis {
+
+namespace net {
+class UdpSocket;
+} // namespace net
+
+// Front of a partitioned deployment: reads plots from the radars and
+// forwards each to every node whose region, grown by the overlap, contains
+// it. Plots are forwarded unchanged (sensor frame and ID); only the
+// routing decision uses the common-frame position. Stateless, so one
+// router keeps up with many nodes.
+class PlotRouter {
+public:
+  PlotRouter(const PartitionMap &map,
+             const std::vector<SensorConfig> &sensors = {});
+  ~PlotRouter();
+
+  PlotRouter(const PlotRouter &) = delete;
+  PlotRouter &operator=(const PlotRouter &) = delete;
+
+  // Bind `listenPort` and start forwarding. Throws on bind failure.
+  void Start(int listenPort);
+  void Stop();
+
+  // Append the indices of the nodes that must see `plot` to `nodes`
+  void Route(const Plot &plot, std::vector<int> &nodes) const;
+
+  uint64_t GetPlotsReceived() const { return m_plotsCounter.Value(); }
+  uint64_t GetPlotsForwarded() const { return m_forwardedCounter.Value(); }
+  uint64_t GetPlotsUnrouted() const { return m_unroutedCounter.Value(); }
+  MetricsRegistry &GetMetricsRegistry() { return m_registry; }
+
+private:
+  void Run();
+
+  PartitionMap m_map;
+  SensorRegistry m_sensors;
+  std::unique_ptr<net::UdpSocket> m_socket;
+  std::atomic<bool> m_running{false};
+  std::thread m_thread;
+
+  MetricsRegistry m_registry;
+  Counter &m_plotsCounter;
+  Counter &m_forwardedCounter;
+  Counter &m_unroutedCounter;
+};
+
+} // namespace aegis
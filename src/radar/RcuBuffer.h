@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace aegis {
+
+// RCU-style publication of immutable snapshots. The single writer fills a
+// buffer no reader can still reach and swaps it in atomically; readers take
+// a reference to the current snapshot and never block the writer or observe
+// a partially written one. Retired buffers are recycled once every reader
+// has dropped them, so steady-state publishing does not allocate.
+// Snapshot must provide Clear().
+template <typename Snapshot> class RcuBuffer {
+public:
+  // Writer: returns an unpublished snapshot to refill.
+  std::shared_ptr<Snapshot> AcquireForWrite() {
+    for (auto &slot : m_pool) {
+      if (!slot) {
+        slot = std::make_shared<Snapshot>();
+        return slot;
+      }
+      // Only the pool holds it: not current and no reader still using it
+      if (slot.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        slot->Clear();
+        return slot;
+      }
+    }
+    // Readers are holding every pooled buffer; retire the oldest slot to
+    // them and start a fresh one
+    m_pool[m_nextEvict] = std::make_shared<Snapshot>();
+    auto &slot = m_pool[m_nextEvict];
+    m_nextEvict = (m_nextEvict + 1) % m_pool.size();
+    return slot;
+  }
+
+  // Writer: makes `snapshot` (from AcquireForWrite) the current one.
+  void Publish(const std::shared_ptr<Snapshot> &snapshot) {
+    m_current.store(snapshot, std::memory_order_release);
+  }
+
+  // Readers: latest published snapshot, or null before the first scan.
+  std::shared_ptr<const Snapshot> Read() const {
+    return m_current.load(std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<std::shared_ptr<const Snapshot>> m_current;
+  std::array<std::shared_ptr<Snapshot>, 3> m_pool; // Writer-only
+  size_t m_nextEvict = 0;
+};
+
+} // namespace aegis
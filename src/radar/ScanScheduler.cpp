@@ -0,0 +1,77 @@
+#include "ScanScheduler.h"
+
+namespace aegis {
+
+ScanScheduler::ScanScheduler(const ScanSchedulerConfig &config,
+                             MetricsRegistry &registry, bool deterministic)
+    : m_config(config), m_deterministic(deterministic),
+      m_overBudgetCounter(registry.AddCounter(
+          "aegis_scan_over_budget_total",
+          "Scans whose association ran past the scan budget")),
+      m_deferredCounter(registry.AddCounter(
+          "aegis_scan_deferred_plots_total",
+          "Low-priority plots put off to the next scan at the deadline")),
+      m_shedCounter(registry.AddCounter(
+          "aegis_scan_shed_plots_total",
+          "Low-priority plots dropped unprocessed under overload (far "
+          "clutter, or deferred too long or too many)")),
+      m_thinnedMetricsCounter(registry.AddCounter(
+          "aegis_scan_metrics_skipped_total",
+          "Overloaded scans that left the track state gauges as they were")),
+      m_deferredGauge(registry.AddGauge(
+          "aegis_scan_deferred_plots", "Plots waiting for the next scan")),
+      m_priorityDuration(registry.AddHistogram(
+          "aegis_scan_priority_seconds",
+          "Time from scan start until every plot near a confirmed or "
+          "coasting track was processed",
+          {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+           0.1, 0.25, 1.0})) {}
+
+const std::vector<Plot> &ScanScheduler::BeginScan(double scanTime) {
+  m_start = std::chrono::steady_clock::now();
+  m_deadline = m_start + std::chrono::duration_cast<
+                             std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double>(m_config.budget));
+  m_spent = 0.0;
+  m_overBudget = false;
+
+  m_carried.clear();
+  for (const Plot &plot : m_deferred) {
+    if (scanTime - plot.timestamp <= m_config.maxDeferredAge) {
+      m_carried.push_back(plot);
+    } else {
+      m_shedCounter.Add();
+    }
+  }
+  m_deferred.clear();
+  return m_carried;
+}
+
+bool ScanScheduler::OverBudget() {
+  if (!m_overBudget) {
+    m_overBudget = m_deterministic
+                       ? m_spent >= m_config.budget
+                       : std::chrono::steady_clock::now() >= m_deadline;
+  }
+  return m_overBudget;
+}
+
+bool ScanScheduler::RefreshMetrics() {
+  if (!m_overBudget || ++m_scansSinceMetrics >= m_config.metricsThinning) {
+    m_scansSinceMetrics = 0;
+    return true;
+  }
+  m_thinnedMetricsCounter.Add();
+  return false;
+}
+
+void ScanScheduler::Defer(const Plot &plot) {
+  if (m_deferred.size() < m_config.maxDeferred) {
+    m_deferred.push_back(plot);
+    m_deferredCounter.Add();
+  } else {
+    m_shedCounter.Add();
+  }
+}
+
+} // namespace aegis
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "MetricsRegistry.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aegis {
+
+// What a plot can do this scan, judged from the tracks within its motion
+// bound; most important first
+enum class PlotPriority : uint8_t {
+  MANOEUVRING, // Near a confirmed track that is turning
+  ESTABLISHED, // Near a confirmed or coasting track
+  TENTATIVE,   // Near tentative tracks only
+  INITIATION,  // Near no track: can only start one
+  FAR_CLUTTER  // As INITIATION, beyond the far range of its sensor
+};
+constexpr size_t PLOT_PRIORITY_COUNT = 5;
+
+struct ScanSchedulerConfig {
+  // Association time allowed per scan, s. 0 turns scheduling off: plots
+  // are processed in arrival order, however long that takes.
+  double budget = 0.0;
+  // Plots near no track farther than this from their sensor are far
+  // clutter, m; 0 puts every such plot in INITIATION
+  float farRange = 0.0f;
+  // Plots that miss the deadline wait for the next scan, at most this
+  // many and no older than maxDeferredAge (s); the rest are shed
+  size_t maxDeferred = 4096;
+  double maxDeferredAge = 1.0;
+  // Under overload the state gauges are refreshed every this many scans
+  int metricsThinning = 4;
+  // Deterministic schedulers charge this much association time per plot
+  // processed, s, instead of reading the clock (~9 us per plot on
+  // bench_association, single-threaded)
+  double plotCost = 10e-6;
+};
+
+// Per-scan deadline for association. The tracker queues each plot under
+// its priority and the scheduler hands them back most important first.
+// Plots that can update a confirmed or coasting track are always
+// processed; once the budget is spent the rest are deferred to the next
+// scan (tentative and initiation plots, up to the deferral limits) or
+// shed (far clutter, and whatever the limits refuse), and the tracker
+// thins its own bookkeeping. Everything shed is counted. A deterministic
+// scheduler keeps time by plot count (see plotCost), so which plots it
+// defers and sheds depends only on the plots it is given.
+class ScanScheduler {
+public:
+  ScanScheduler(const ScanSchedulerConfig &config, MetricsRegistry &registry,
+                bool deterministic = false);
+
+  bool Enabled() const { return m_config.budget > 0.0; }
+  const ScanSchedulerConfig &GetConfig() const { return m_config; }
+
+  // Start a scan's clock. Returns the plots deferred by earlier scans that
+  // are still young enough at `scanTime` (older ones are shed); queue them
+  // again with Add, they are not kept otherwise.
+  const std::vector<Plot> &BeginScan(double scanTime);
+  void Add(const Plot &plot, PlotPriority priority) {
+    m_queues[static_cast<size_t>(priority)].push_back(plot);
+  }
+  // Call process(plots, count) for the queued plots, most important
+  // first, while the budget allows: the manoeuvring and established
+  // classes as a single batch, then the rest SCHEDULE_CHUNK at a time
+  // between deadline checks. Empties the queues.
+  template <typename Process> void Run(Process &&process);
+
+  // The scan's deadline has passed. Sticky until the next BeginScan.
+  bool OverBudget();
+  // Whether an overloaded scan should still refresh the state gauges;
+  // call once per scan
+  bool RefreshMetrics();
+
+  size_t GetDeferredCount() const { return m_deferred.size(); }
+
+private:
+  void Defer(const Plot &plot);
+  // Run plots through `process`, charging them to the modelled clock
+  template <typename Process>
+  void Dispatch(Process &process, const Plot *plots, size_t count) {
+    m_spent += static_cast<double>(count) * m_config.plotCost;
+    process(plots, count);
+  }
+
+  // Plots processed between deadline checks past the essential classes
+  static constexpr size_t SCHEDULE_CHUNK = 16;
+
+  ScanSchedulerConfig m_config;
+  bool m_deterministic;
+  std::array<std::vector<Plot>, PLOT_PRIORITY_COUNT> m_queues;
+  std::vector<Plot> m_batch;    // Essential classes, together
+  std::vector<Plot> m_deferred; // For the next scan
+  std::vector<Plot> m_carried;  // From earlier scans, for this one
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_deadline;
+  double m_spent = 0.0; // Modelled association time this scan, s
+  bool m_overBudget = false;
+  int m_scansSinceMetrics = 0;
+
+  Counter &m_overBudgetCounter;
+  Counter &m_deferredCounter;
+  Counter &m_shedCounter;
+  Counter &m_thinnedMetricsCounter;
+  Gauge &m_deferredGauge;
+  Histogram &m_priorityDuration;
+};
+
+template <typename Process> void ScanScheduler::Run(Process &&process) {
+  // The essential classes go as one batch, whatever the time
+  m_batch.clear();
+  for (size_t i = 0; i <= static_cast<size_t>(PlotPriority::ESTABLISHED);
+       ++i) {
+    m_batch.insert(m_batch.end(), m_queues[i].begin(), m_queues[i].end());
+    m_queues[i].clear();
+  }
+  if (!m_batch.empty()) {
+    Dispatch(process, m_batch.data(), m_batch.size());
+  }
+  // Latency the budget protects: until every established track has had
+  // its plots
+  m_priorityDuration.Observe(std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - m_start)
+                                 .count());
+
+  for (size_t i = static_cast<size_t>(PlotPriority::TENTATIVE);
+       i < PLOT_PRIORITY_COUNT; ++i) {
+    std::vector<Plot> &queue = m_queues[i];
+    for (size_t first = 0; first < queue.size(); first += SCHEDULE_CHUNK) {
+      size_t count = std::min(SCHEDULE_CHUNK, queue.size() - first);
+      if (!OverBudget()) {
+        Dispatch(process, queue.data() + first, count);
+      } else if (static_cast<PlotPriority>(i) == PlotPriority::FAR_CLUTTER) {
+        m_shedCounter.Add(count);
+      } else {
+        for (size_t k = first; k < first + count; ++k) {
+          Defer(queue[k]);
+        }
+      }
+    }
+    queue.clear();
+  }
+  if (OverBudget()) {
+    m_overBudgetCounter.Add();
+  }
+  m_deferredGauge.Set(static_cast<double>(m_deferred.size()));
+}
+
+} // namespace aegis
@@ -0,0 +1,69 @@
+#include "SensorMerger.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace aegis {
+
+namespace {
+bool EarlierThan(const Plot &a, const Plot &b) {
+  return a.timestamp < b.timestamp;
+}
+} // namespace
+
+SensorMerger::SensorMerger(const SensorRegistry &sensors)
+    : m_sensors(sensors), m_holdBack(sensors.GetMaxLatency()) {
+  for (size_t i = 0; i < sensors.Size(); ++i) {
+    m_lanes.push_back(std::make_unique<Lane>());
+  }
+}
+
+void SensorMerger::Push(const Plot &plot) {
+  Lane &lane = *m_lanes[m_sensors.IndexOf(plot.sensorId)];
+  std::lock_guard<std::mutex> lock(lane.mutex);
+  // A sensor's plots nearly always arrive in order; a datagram overtaken
+  // in flight is slotted back in place
+  if (lane.plots.empty() || lane.plots.back().timestamp <= plot.timestamp) {
+    lane.plots.push_back(plot);
+  } else {
+    lane.plots.insert(std::upper_bound(lane.plots.begin(), lane.plots.end(),
+                                       plot, EarlierThan),
+                      plot);
+  }
+}
+
+size_t SensorMerger::Drain(double now, std::vector<Plot> &out) {
+  double cutoff = m_holdBack > 0.0 ? now - m_holdBack
+                                   : std::numeric_limits<double>::infinity();
+  size_t first = out.size();
+  size_t merged = first; // out[first, merged) is already in order
+  for (const auto &lane : m_lanes) {
+    {
+      std::lock_guard<std::mutex> lock(lane->mutex);
+      auto end = lane->plots.begin();
+      while (end != lane->plots.end() && end->timestamp <= cutoff) {
+        ++end;
+      }
+      out.insert(out.end(), lane->plots.begin(), end);
+      lane->plots.erase(lane->plots.begin(), end);
+    }
+    // Each lane is a sorted run; fold it into the merged prefix (stable,
+    // so equal times keep sensor order)
+    auto begin = out.begin() + static_cast<std::ptrdiff_t>(first);
+    std::inplace_merge(begin, out.begin() + static_cast<std::ptrdiff_t>(merged),
+                       out.end(), EarlierThan);
+    merged = out.size();
+  }
+  return out.size() - first;
+}
+
+size_t SensorMerger::Size() const {
+  size_t size = 0;
+  for (const auto &lane : m_lanes) {
+    std::lock_guard<std::mutex> lock(lane->mutex);
+    size += lane->plots.size();
+  }
+  return size;
+}
+
+} // namespace aegis
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Protocol.h"
+#include "SensorRegistry.h"
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aegis {
+
+// Time-ordered merge of several sensors' plot streams. Each sensor has its
+// own lane (queue and lock), so ingest threads for different sensors never
+// contend; plots from unregistered IDs share sensor 0's lane. Drain hands
+// the tracker one time-ordered batch: plots are held until every sensor's
+// latency has passed, so a slower sensor's older plots still land ahead of
+// a faster one's newer ones. Plots that arrive later than their sensor's
+// latency go out with the next batch and reach the tracker out of
+// sequence.
+class SensorMerger {
+public:
+  // The registry must outlive the merger and not change after this
+  explicit SensorMerger(const SensorRegistry &sensors);
+
+  // Queue a plot on its sensor's lane. Safe from any thread.
+  void Push(const Plot &plot);
+
+  // Append every plot detected at or before now - max latency to `out` in
+  // timestamp order and return how many. With no latency configured every
+  // queued plot is released, whatever its timestamp.
+  size_t Drain(double now, std::vector<Plot> &out);
+
+  size_t Size() const; // Plots queued across all lanes
+
+private:
+  struct Lane {
+    mutable std::mutex mutex;
+    std::deque<Plot> plots; // Timestamp order
+  };
+
+  const SensorRegistry &m_sensors;
+  std::vector<std::unique_ptr<Lane>> m_lanes; // By registry index
+  double m_holdBack;
+};
+
+} // namespace aegis
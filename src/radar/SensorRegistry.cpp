@@ -0,0 +1,28 @@
+#include "SensorRegistry.h"
+#include <algorithm>
+
+namespace aegis {
+
+SensorRegistry::SensorRegistry() : m_sensors(1), m_slots(1, 0) {}
+
+void SensorRegistry::Register(const SensorConfig &sensor) {
+  if (sensor.id >= m_slots.size()) {
+    m_slots.resize(static_cast<size_t>(sensor.id) + 1, 0);
+  }
+  if (sensor.id == 0 || m_slots[sensor.id] != 0) {
+    m_sensors[m_slots[sensor.id]] = sensor;
+    return;
+  }
+  m_slots[sensor.id] = static_cast<uint16_t>(m_sensors.size());
+  m_sensors.push_back(sensor);
+}
+
+double SensorRegistry::GetMaxLatency() const {
+  double latency = 0.0;
+  for (const SensorConfig &sensor : m_sensors) {
+    latency = std::max(latency, sensor.latency);
+  }
+  return latency;
+}
+
+} // namespace aegis
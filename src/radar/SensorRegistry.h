@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Track.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aegis {
+
+// One radar feeding the tracker. Plots carry the sensor's ID and are
+// reported in its local frame; the tracker works in a common one.
+struct SensorConfig {
+  uint16_t id = 0;
+  MeasurementNoise noise; // Plot covariance, m^2, common-frame axes
+  double latency = 0.0;   // s, worst-case delay from detection to arrival
+  float originX = 0.0f;   // Sensor site in the common frame, m
+  float originY = 0.0f;
+  int listenPort = 0; // Own UDP port; 0 shares the pipeline's
+};
+
+// Per-sensor noise, latency and origin, looked up by plot sensor ID.
+// Sensor 0 always exists (50 m, no latency, at the origin) and stands in
+// for any ID that was never registered, so plots from unconfigured
+// senders are tracked as before. Sites are a translation only: sensor
+// axes are taken to be aligned with the common frame, which holds for a
+// flat-earth frame over a few hundred kilometres.
+class SensorRegistry {
+public:
+  SensorRegistry();
+
+  // Add a sensor, or replace the one with the same ID
+  void Register(const SensorConfig &sensor);
+
+  // The sensor with `id`, or sensor 0 if there is none. O(1).
+  const SensorConfig &Get(uint16_t id) const {
+    return m_sensors[id < m_slots.size() ? m_slots[id] : 0];
+  }
+  bool Contains(uint16_t id) const {
+    return id == 0 || (id < m_slots.size() && m_slots[id] != 0);
+  }
+
+  // Largest latency of any sensor: how long the merge must hold plots
+  // before it knows none older can still arrive
+  double GetMaxLatency() const;
+
+  // Registered sensors, sensor 0 first
+  const std::vector<SensorConfig> &GetSensors() const { return m_sensors; }
+  size_t Size() const { return m_sensors.size(); }
+  // Dense index of a sensor's entry in GetSensors(); 0 for unknown IDs
+  size_t IndexOf(uint16_t id) const {
+    return id < m_slots.size() ? m_slots[id] : 0;
+  }
+
+private:
+  std::vector<SensorConfig> m_sensors; // Sensor 0 at index 0
+  std::vector<uint16_t> m_slots;       // ID -> index, 0 if unregistered
+};
+
+} // namespace aegis
@@ -0,0 +1,52 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+namespace aegis {
+
+SpatialGrid::SpatialGrid(float cellSize, size_t bucketCount)
+    : m_cellSize(cellSize), m_inverseCellSize(1.0f / cellSize) {
+  // Round the bucket table up to a power of two for masking
+  size_t buckets = 1;
+  while (buckets < bucketCount) {
+    buckets <<= 1;
+  }
+  m_bucketMask = buckets - 1;
+  m_bucketStart.assign(buckets + 1, 0);
+}
+
+void SpatialGrid::Clear() {
+  m_staged.clear();
+  m_entries.clear();
+  std::fill(m_bucketStart.begin(), m_bucketStart.end(), 0);
+}
+
+void SpatialGrid::Insert(uint32_t id, float x, float y) {
+  m_staged.push_back(Entry{x, y, static_cast<int32_t>(CellOf(x)),
+                           static_cast<int32_t>(CellOf(y)), id});
+}
+
+void SpatialGrid::Build() {
+  if (m_staged.empty()) {
+    return;
+  }
+  m_scratch.clear();
+  m_scratch.insert(m_scratch.end(), m_entries.begin(), m_entries.end());
+  m_scratch.insert(m_scratch.end(), m_staged.begin(), m_staged.end());
+  m_staged.clear();
+
+  // Counting sort by bucket: histogram, exclusive prefix sum, scatter
+  std::fill(m_bucketStart.begin(), m_bucketStart.end(), 0);
+  for (const Entry &e : m_scratch) {
+    m_bucketStart[BucketOf(e.cellX, e.cellY) + 1]++;
+  }
+  for (size_t b = 1; b < m_bucketStart.size(); ++b) {
+    m_bucketStart[b] += m_bucketStart[b - 1];
+  }
+  m_entries.resize(m_scratch.size());
+  m_cursor.assign(m_bucketStart.begin(), m_bucketStart.end() - 1);
+  for (const Entry &e : m_scratch) {
+    m_entries[m_cursor[BucketOf(e.cellX, e.cellY)]++] = e;
+  }
+}
+
+} // namespace aegis
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aegis {
+
+// Uniform grid over the plane for radius queries. Points are staged with
+// Insert and laid out bucket by bucket in Build (a counting sort into one
+// flat array), so a rebuild per scan is O(N) and, once the arrays have
+// grown to the working set, allocation-free. Cells hash into a fixed
+// power-of-two bucket table; the plane is unbounded.
+class SpatialGrid {
+public:
+  explicit SpatialGrid(float cellSize = 2000.0f, size_t bucketCount = 4096);
+
+  void Clear();
+  void Insert(uint32_t id, float x, float y);
+  // Make staged points queryable alongside those already built; points
+  // inserted later wait for the next Build
+  void Build();
+
+  // Calls visit(id, x, y) for every built point within `radius` of (x, y).
+  // Points from other cells that share a bucket are skipped.
+  template <typename Visit>
+  void Query(float x, float y, float radius, Visit &&visit) const {
+    if (m_entries.empty()) {
+      return;
+    }
+    int64_t x0 = CellOf(x - radius), x1 = CellOf(x + radius);
+    int64_t y0 = CellOf(y - radius), y1 = CellOf(y + radius);
+    // A huge radius would revisit buckets many times over; scan instead
+    if ((x1 - x0 + 1) * (y1 - y0 + 1) >
+        static_cast<int64_t>(m_bucketStart.size())) {
+      for (const Entry &e : m_entries) {
+        VisitIfNear(e, x, y, radius, visit);
+      }
+      return;
+    }
+    for (int64_t cy = y0; cy <= y1; ++cy) {
+      for (int64_t cx = x0; cx <= x1; ++cx) {
+        size_t bucket = BucketOf(cx, cy);
+        for (uint32_t i = m_bucketStart[bucket]; i < m_bucketStart[bucket + 1];
+             ++i) {
+          const Entry &e = m_entries[i];
+          if (e.cellX == cx && e.cellY == cy) {
+            VisitIfNear(e, x, y, radius, visit);
+          }
+        }
+      }
+    }
+  }
+
+  size_t Size() const { return m_entries.size(); }
+  float GetCellSize() const { return m_cellSize; }
+
+private:
+  struct Entry {
+    float x, y;
+    int32_t cellX, cellY;
+    uint32_t id;
+  };
+
+  int64_t CellOf(float v) const {
+    return static_cast<int64_t>(std::floor(v * m_inverseCellSize));
+  }
+  size_t BucketOf(int64_t cx, int64_t cy) const {
+    uint64_t h = static_cast<uint64_t>(cx) * 0x9E3779B97F4A7C15ull ^
+                 static_cast<uint64_t>(cy) * 0xC2B2AE3D27D4EB4Full;
+    return static_cast<size_t>(h >> 32) & m_bucketMask;
+  }
+
+  template <typename Visit>
+  static void VisitIfNear(const Entry &e, float x, float y, float radius,
+                          Visit &visit) {
+    float dx = e.x - x, dy = e.y - y;
+    if (dx * dx + dy * dy <= radius * radius) {
+      visit(e.id, e.x, e.y);
+    }
+  }
+
+  float m_cellSize;
+  float m_inverseCellSize;
+  size_t m_bucketMask;
+  std::vector<Entry> m_staged;         // Inserted since the last Build
+  std::vector<Entry> m_entries;        // Built points, grouped by bucket
+  std::vector<Entry> m_scratch;        // Build's sort buffer
+  std::vector<uint32_t> m_cursor;      // Build's per-bucket write position
+  std::vector<uint32_t> m_bucketStart; // Bucket b is [start[b], start[b+1])
+};
+
+} // namespace aegis
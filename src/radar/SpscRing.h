@@ -0,0 +1,71 @@
+#pragma once
+
+#include "MetricsRegistry.h"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace aegis {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Neither side ever blocks: TryPush fails when the ring is full and
+// TryPop when it is empty. Head and tail sit on separate cache lines, and
+// each side caches the other's index so the common case touches no shared
+// line it does not own.
+template <typename T> class SpscRing {
+public:
+  // Capacity is rounded up to a power of two
+  explicit SpscRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_buffer.resize(size);
+    m_mask = size - 1;
+  }
+
+  // Producer only
+  bool TryPush(const T &value) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead > m_mask) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+      if (tail - m_cachedHead > m_mask) {
+        return false; // Full
+      }
+    }
+    m_buffer[tail & m_mask] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only
+  bool TryPop(T &out) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+      if (head == m_cachedTail) {
+        return false; // Empty
+      }
+    }
+    out = m_buffer[head & m_mask];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate from either thread
+  size_t Size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+  size_t Capacity() const { return m_mask + 1; }
+
+private:
+  std::vector<T> m_buffer;
+  size_t m_mask;
+  alignas(kCacheLine) std::atomic<size_t> m_head{0}; // Next slot to pop
+  size_t m_cachedTail = 0;                           // Consumer's view
+  alignas(kCacheLine) std::atomic<size_t> m_tail{0}; // Next slot to fill
+  size_t m_cachedHead = 0;                           // Producer's view
+};
+
+} // namespace aegis
@@ -75,6 +75,7 @@ Plot TargetGenerator::GetNoisyPlot(double timestamp) {
   p.velocity = m_speed; // Doppler velocity (simplified)
   p.heading = m_heading;
   p.timestamp = timestamp;
+  p.sensorId = 0;
   return p;
 }
 
@@ -0,0 +1,81 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace aegis {
+
+ThreadPool::ThreadPool(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  m_workers.reserve(threads - 1);
+  for (size_t i = 1; i < threads; ++i) {
+    m_workers.emplace_back(&ThreadPool::Run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_start.notify_all();
+  for (std::thread &worker : m_workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(
+    size_t count, const std::function<void(size_t, size_t)> &task) {
+  if (count == 0) {
+    return;
+  }
+  if (m_workers.empty() || count == 1) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_next.store(0, std::memory_order_relaxed);
+    m_busy = m_workers.size();
+    ++m_generation;
+  }
+  m_start.notify_all();
+  Drain(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [this] { return m_busy == 0; });
+  m_task = nullptr;
+}
+
+void ThreadPool::Drain(size_t thread) {
+  for (size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+       i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+    (*m_task)(i, thread);
+  }
+}
+
+void ThreadPool::Run(size_t thread) {
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_start.wait(lock,
+                 [&] { return m_stopping || m_generation != seen; });
+    if (m_stopping) {
+      return;
+    }
+    seen = m_generation;
+    lock.unlock();
+    Drain(thread);
+    lock.lock();
+    if (--m_busy == 0) {
+      m_done.notify_one();
+    }
+  }
+}
+
+} // namespace aegis
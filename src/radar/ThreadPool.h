@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aegis {
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// works alongside them, so a pool of N threads starts N - 1 workers and a
+// pool of 1 runs everything inline. Indices are handed out one at a time
+// from a shared counter, so uneven tasks balance themselves.
+class ThreadPool {
+public:
+  // 0 = one thread per hardware core
+  explicit ThreadPool(size_t threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Threads taking part in ParallelFor, the caller included
+  size_t Size() const { return m_workers.size() + 1; }
+
+  // Run task(index, thread) for every index in [0, count) and return when
+  // all have finished. `thread` is in [0, Size()), distinct among tasks
+  // running at once, for per-thread scratch. Call from one thread at a
+  // time; tasks must not call back into the pool.
+  void ParallelFor(size_t count,
+                   const std::function<void(size_t, size_t)> &task);
+
+private:
+  void Run(size_t thread);
+  void Drain(size_t thread);
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_start;
+  std::condition_variable m_done;
+  uint64_t m_generation = 0; // Bumped for each ParallelFor
+  size_t m_busy = 0;         // Workers still in the current loop
+  bool m_stopping = false;
+
+  const std::function<void(size_t, size_t)> *m_task = nullptr;
+  size_t m_count = 0;
+  std::atomic<size_t> m_next{0};
+};
+
+} // namespace aegis
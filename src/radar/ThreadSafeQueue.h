@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
@@ -28,6 +29,17 @@ public:
     return value;
   }
 
+  // Blocking pop with timeout (lets consumer threads observe shutdown)
+  std::optional<T> PopFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_cond.wait_for(lock, timeout, [this] { return !m_queue.empty(); })) {
+      return std::nullopt;
+    }
+    T value = m_queue.front();
+    m_queue.pop();
+    return value;
+  }
+
   // Non-blocking pop
   std::optional<T> TryPop() {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -44,6 +56,11 @@ public:
     return m_queue.empty();
   }
 
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size();
+  }
+
 private:
   std::queue<T> m_queue;
   mutable std::mutex m_mutex;
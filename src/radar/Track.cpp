@@ -1,35 +1,537 @@
 #include "Track.h"
+#include "TrackFusion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace aegis {
 
-Track::Track(uint32_t id, float x, float y, double timestamp)
-    : m_id(id), m_lastUpdate(timestamp), m_kf(x, y, 0.0f, 0.0f),
-      m_state(TrackState::TENTATIVE), m_hitCount(1),
-      m_missCount(0) // Initial V=0, Heading=0.
-// Note: EKF convergence might be slow if init V is wrong.
-// Ideally we'd wait for 2 measurements to init V.
-// For now, 0 is safe, covariance will handle it.
-{
-  m_history.push_back(glm::vec2(x, y));
+Track::Track() : Track(0, 0.0f, 0.0f, 0.0) {}
+
+Track::Track(uint32_t id, float x, float y, double timestamp,
+             TrackFilterModel model) {
+  Reset(id, x, y, timestamp, model);
+}
+
+void Track::Reset(uint32_t id, float x, float y, double timestamp,
+                  TrackFilterModel model) {
+  m_id = id;
+  m_lastUpdate = timestamp;
+  m_stateTime = timestamp;
+  m_prediction = TrackPrediction();
+  // Initial V=0, Heading=0: the EKF takes its velocity from this plot and
+  // the next (ExtendedKalmanFilter::StartFromPlots); the IMM's
+  // constant-velocity mode pins the turn rate and converges as it is.
+  if (model == TrackFilterModel::IMM) {
+    m_filter = ImmFilter<float>(x, y, 0.0f, 0.0f);
+  } else {
+    m_filter = ExtendedKalmanFilter(x, y, 0.0f, 0.0f);
+  }
+  m_state = TrackState::TENTATIVE;
+  m_hitCount = 1;
+  m_missCount = 0;
+  m_checkpointHead = 0;
+  m_checkpointCount = 0;
+  RecordCheckpoint(x, y, timestamp);
+}
+
+void Track::Reset(uint32_t id, const TrackSeed &seed, double timestamp,
+                  TrackFilterModel model) {
+  Reset(id, seed.x, seed.y, timestamp, model);
+  if (model == TrackFilterModel::IMM) {
+    ImmFilter<float> imm(seed.x, seed.y, seed.speed, seed.heading);
+    for (int i = 0; i < ImmFilter<float>::STATE_DIM; ++i) {
+      for (int j = i; j < ImmFilter<float>::STATE_DIM; ++j) {
+        imm.SetCovariance(i, j, seed.covariance[imm.PackedIndex(i, j)]);
+      }
+    }
+    m_filter = imm;
+  } else {
+    // The EKF constructor takes its heading in degrees
+    ExtendedKalmanFilter ekf(seed.x, seed.y, seed.speed,
+                             seed.heading * (180.0f / detail::Pi<float>()));
+    for (int i = 0; i < ExtendedKalmanFilter::STATE_DIM; ++i) {
+      for (int j = i; j < ExtendedKalmanFilter::STATE_DIM; ++j) {
+        ekf.GetFilter().SetCovariance(
+            i, j, seed.covariance[ExtendedKalmanFilter::Filter::PackedIndex(i, j)]);
+      }
+    }
+    m_filter = ekf;
+  }
+  m_hitCount = seed.plots;
+  if (m_hitCount >= M_HITS_TO_CONFIRM) {
+    m_state = TrackState::CONFIRMED;
+  }
+  m_checkpointHead = 0;
+  m_checkpointCount = 0;
+  RecordCheckpoint(seed.x, seed.y, timestamp);
+}
+
+void Track::Reset(const TrackRecord &record) {
+  using Packed = ExtendedKalmanFilter::Filter;
+  float x = record.x[0], y = record.x[1];
+  Reset(record.id, x, y, record.stateTime, record.model);
+  if (record.model == TrackFilterModel::IMM) {
+    ImmFilter<float> &imm = std::get<ImmFilter<float>>(m_filter);
+    imm.SetState(record.x);
+    for (int i = 0; i < Packed::STATE_DIM; ++i) {
+      for (int j = i; j < Packed::STATE_DIM; ++j) {
+        imm.SetCovariance(i, j, record.covariance[Packed::PackedIndex(i, j)]);
+      }
+    }
+  } else {
+    Packed &filter = std::get<ExtendedKalmanFilter>(m_filter).GetFilter();
+    filter.SetState(record.x);
+    for (int i = 0; i < Packed::STATE_DIM; ++i) {
+      for (int j = i; j < Packed::STATE_DIM; ++j) {
+        filter.SetCovariance(i, j, record.covariance[Packed::PackedIndex(i, j)]);
+      }
+    }
+  }
+  m_lastUpdate = record.lastUpdate;
+  m_state = record.state;
+  m_hitCount = record.hitCount;
+  m_missCount = record.missCount;
+  m_checkpointHead = 0;
+  m_checkpointCount = 0;
+  RecordCheckpoint(x, y, record.stateTime);
+}
+
+void Track::Export(TrackRecord &record) const {
+  record.id = m_id;
+  record.model = GetFilterModel();
+  record.state = m_state;
+  record.hitCount = m_hitCount;
+  record.missCount = m_missCount;
+  record.stateTime = m_stateTime;
+  record.lastUpdate = m_lastUpdate;
+  GetFilterState(record.x.data(), record.covariance.data());
+}
+
+void Track::SetCheckpointDepth(size_t depth) {
+  if (depth != m_checkpoints.size()) {
+    m_checkpoints.resize(depth);
+    m_checkpointHead = 0;
+    m_checkpointCount = 0;
+  }
+}
+
+glm::vec2 Track::GetPosition() const {
+  if (const ImmFilter<float> *imm = GetImm()) {
+    return glm::vec2(imm->GetState(0), imm->GetState(1));
+  }
+  return std::get<ExtendedKalmanFilter>(m_filter).GetPosition();
+}
+
+glm::vec2 Track::GetVelocity() const {
+  if (const ImmFilter<float> *imm = GetImm()) {
+    glm::vec2 velocity;
+    imm->GetVelocity(velocity.x, velocity.y);
+    return velocity;
+  }
+  return std::get<ExtendedKalmanFilter>(m_filter).GetVelocity();
+}
+
+bool Track::IsManoeuvring() const {
+  if (const ImmFilter<float> *imm = GetImm()) {
+    return imm->GetModeProbability(ImmFilter<float>::CONSTANT_VELOCITY) <
+           0.5f;
+  }
+  const ExtendedKalmanFilter::Filter &filter =
+      std::get<ExtendedKalmanFilter>(m_filter).GetFilter();
+  return std::abs(filter.GetState(4)) > MANOEUVRE_TURN_RATE;
+}
+
+void Track::GetFilterState(float *state, float *covariance) const {
+  using Filter = ExtendedKalmanFilter::Filter;
+  if (const ImmFilter<float> *imm = GetImm()) {
+    for (int i = 0; i < Filter::STATE_DIM; ++i) {
+      state[i] = imm->GetState(i);
+      for (int j = i; j < Filter::STATE_DIM; ++j) {
+        covariance[Filter::PackedIndex(i, j)] = imm->GetCovariance(i, j);
+      }
+    }
+    return;
+  }
+  const Filter &filter = std::get<ExtendedKalmanFilter>(m_filter).GetFilter();
+  for (int i = 0; i < Filter::STATE_DIM; ++i) {
+    state[i] = filter.GetState(i);
+    for (int j = i; j < Filter::STATE_DIM; ++j) {
+      covariance[Filter::PackedIndex(i, j)] = filter.GetCovariance(i, j);
+    }
+  }
+}
+
+float Track::GetMahalanobisDistance(float x, float y) const {
+  if (const ImmFilter<float> *imm = GetImm()) {
+    return imm->MahalanobisDistance(x, y);
+  }
+  return std::get<ExtendedKalmanFilter>(m_filter).GetMahalanobisDistance(x, y);
 }
 
 void Track::Predict(double currentTime) {
-  float dt = static_cast<float>(currentTime - m_lastUpdate);
+  float dt = static_cast<float>(currentTime - m_stateTime);
+  if (dt > 0.0f) {
+    std::visit([dt](auto &filter) { filter.Predict(dt); }, m_filter);
+    m_stateTime = currentTime;
+    m_prediction = TrackPrediction();
+  }
+}
+
+namespace {
+
+// Extrapolate a copy of `filter` by dt into `out`; plots older than the
+// state gate against it unmoved
+template <typename Filter>
+void Extrapolate(const Filter &filter, float dt, TrackPrediction &out) {
+  Filter predicted = filter;
   if (dt > 0.0f) {
-    m_kf.Predict(dt);
-    m_lastUpdate = currentTime;
+    predicted.Predict(dt);
+  }
+  if constexpr (std::is_same_v<Filter, ExtendedKalmanFilter>) {
+    out.position = predicted.GetPosition();
+    out.velocity = predicted.GetVelocity();
+  } else {
+    out.position = glm::vec2(predicted.GetState(0), predicted.GetState(1));
+    predicted.GetVelocity(out.velocity.x, out.velocity.y);
+  }
+  predicted.GetInnovationCovariance(out.sxx, out.sxy, out.syy);
+  out.pxx = predicted.GetCovariance(0, 0);
+  out.pxy = predicted.GetCovariance(0, 1);
+  out.pyy = predicted.GetCovariance(1, 1);
+}
+
+} // namespace
+
+const TrackPrediction &Track::PredictTo(double time) const {
+  if (m_prediction.time == time) {
+    return m_prediction;
   }
+  float dt = static_cast<float>(time - m_stateTime);
+  std::visit([&](const auto &filter) { Extrapolate(filter, dt, m_prediction); },
+             m_filter);
+  m_prediction.time = time;
+  return m_prediction;
+}
+
+TrackPrediction PredictFilter(const ExtendedKalmanFilter &filter,
+                              double stateTime, double time) {
+  TrackPrediction prediction;
+  Extrapolate(filter, static_cast<float>(time - stateTime), prediction);
+  prediction.time = time;
+  return prediction;
 }
 
-void Track::Update(float x, float y, double timestamp) {
-  double dt = timestamp - m_lastUpdate;
-  if (dt > 0.0001) {
-    m_kf.Predict(static_cast<float>(dt));
+float TrackPrediction::MahalanobisDistance(float x, float y,
+                                           double plotTime) const {
+  float det = sxx * syy - sxy * sxy;
+  if (!(det > 0.0f)) {
+    return std::numeric_limits<float>::max();
   }
+  float lead = static_cast<float>(plotTime - time);
+  float dx = x - (position.x + velocity.x * lead);
+  float dy = y - (position.y + velocity.y * lead);
+  return (syy * dx * dx - 2.0f * sxy * dx * dy + sxx * dy * dy) / det;
+}
 
-  m_kf.Update(x, y);
+float TrackPrediction::MahalanobisDistance(
+    float x, float y, double plotTime, const MeasurementNoise &noise) const {
+  float a = pxx + noise.xx, b = pxy + noise.xy, c = pyy + noise.yy;
+  float det = a * c - b * b;
+  if (!(det > 0.0f)) {
+    return std::numeric_limits<float>::max();
+  }
+  float lead = static_cast<float>(plotTime - time);
+  float dx = x - (position.x + velocity.x * lead);
+  float dy = y - (position.y + velocity.y * lead);
+  return (c * dx * dx - 2.0f * b * dx * dy + a * dy * dy) / det;
+}
+
+bool Track::Update(float x, float y, double timestamp,
+                   const MeasurementNoise &noise) {
+  if (timestamp < m_stateTime) {
+    return UpdateOutOfSequence(x, y, timestamp, noise);
+  }
+
+  Advance(m_filter, timestamp - m_stateTime, x, y, noise);
+  CompleteUpdate(x, y, timestamp, noise);
+  return true;
+}
+
+void Track::CompleteUpdate(float x, float y, double timestamp,
+                           const MeasurementNoise &noise) {
   m_lastUpdate = timestamp;
+  m_stateTime = timestamp;
+  m_prediction = TrackPrediction();
+  RecordCheckpoint(x, y, timestamp, noise);
+  RegisterHit();
+}
+
+void Track::UpdateBatch(Track *const *tracks, const TrackPlot *plots,
+                        size_t count) {
+  using Batch = ImmBatch<float>;
+  ImmFilter<float> *filters[Batch::BLOCK], *predicting[Batch::BLOCK],
+      *updating[Batch::BLOCK];
+  Batch::Plot batchPlots[Batch::BLOCK], predictingPlots[Batch::BLOCK],
+      updatingPlots[Batch::BLOCK];
+  float dt[Batch::BLOCK];
+  bool ok[Batch::BLOCK];
+  size_t index[Batch::BLOCK];
+  size_t pending = 0;
+  auto flush = [&]() {
+    // Advance's step test decides which filters predict before updating
+    size_t predicted = 0, updated = 0;
+    for (size_t i = 0; i < pending; ++i) {
+      const Track &track = *tracks[index[i]];
+      double step = plots[index[i]].timestamp - track.m_stateTime;
+      if (step > 0.0001) {
+        predictingPlots[predicted] = batchPlots[i];
+        dt[predicted] = static_cast<float>(step);
+        predicting[predicted++] = filters[i];
+      } else {
+        updatingPlots[updated] = batchPlots[i];
+        updating[updated++] = filters[i];
+      }
+    }
+    Batch::Advance(predicting, dt, predictingPlots, predicted, ok);
+    Batch::Update(updating, updatingPlots, updated, ok + predicted);
+    for (size_t i = 0; i < pending; ++i) {
+      const TrackPlot &plot = plots[index[i]];
+      tracks[index[i]]->CompleteUpdate(plot.x, plot.y, plot.timestamp,
+                                       plot.noise);
+    }
+    pending = 0;
+  };
+
+  for (size_t i = 0; i < count; ++i) {
+    Track &track = *tracks[i];
+    const TrackPlot &plot = plots[i];
+    auto *imm = std::get_if<ImmFilter<float>>(&track.m_filter);
+    if (!imm || plot.timestamp < track.m_stateTime) {
+      track.Update(plot.x, plot.y, plot.timestamp, plot.noise);
+      continue;
+    }
+    filters[pending] = imm;
+    batchPlots[pending] = {plot.x, plot.y, plot.noise.xx, plot.noise.xy,
+                           plot.noise.yy};
+    index[pending++] = i;
+    if (pending == Batch::BLOCK) {
+      flush();
+    }
+  }
+  if (pending > 0) {
+    flush();
+  }
+}
+
+void Track::PredictBatch(const Track *const *tracks, size_t count,
+                         double time) {
+  using Batch = ImmBatch<float>;
+  const ImmFilter<float> *filters[Batch::BLOCK];
+  const Track *owners[Batch::BLOCK];
+  Batch::Prediction out[Batch::BLOCK];
+  float dt[Batch::BLOCK];
+  size_t pending = 0;
+  auto flush = [&]() {
+    Batch::Extrapolate(filters, dt, pending, out);
+    for (size_t i = 0; i < pending; ++i) {
+      const Batch::Prediction &p = out[i];
+      TrackPrediction &prediction = owners[i]->m_prediction;
+      prediction.position = glm::vec2(p.x, p.y);
+      prediction.velocity = glm::vec2(p.vx, p.vy);
+      prediction.sxx = p.sxx;
+      prediction.sxy = p.sxy;
+      prediction.syy = p.syy;
+      prediction.pxx = p.pxx;
+      prediction.pxy = p.pxy;
+      prediction.pyy = p.pyy;
+      prediction.time = time;
+    }
+    pending = 0;
+  };
+
+  for (size_t i = 0; i < count; ++i) {
+    const Track &track = *tracks[i];
+    const auto *imm = std::get_if<ImmFilter<float>>(&track.m_filter);
+    float step = static_cast<float>(time - track.m_stateTime);
+    if (!imm || track.m_prediction.time == time || !(step > 0.0f)) {
+      track.PredictTo(time);
+      continue;
+    }
+    filters[pending] = imm;
+    owners[pending] = &track;
+    dt[pending++] = step;
+    if (pending == Batch::BLOCK) {
+      flush();
+    }
+  }
+  if (pending > 0) {
+    flush();
+  }
+}
+
+float Track::Fuse(const RemoteTrack &remote) {
+  if (remote.time < m_stateTime) {
+    return -1.0f;
+  }
+  Predict(remote.time);
+  using Packed = ExtendedKalmanFilter::Filter;
+  Packed::State x;
+  std::array<float, Packed::PACKED_SIZE> P;
+  GetFilterState(x.data(), P.data());
+  float omega = FuseEstimate(x, P, remote);
+  if (omega < 0.0f) {
+    return omega;
+  }
+
+  SetEstimate(x, P.data());
+  m_prediction = TrackPrediction();
+  m_checkpointHead = 0;
+  m_checkpointCount = 0;
+  RecordCheckpoint(x[0], x[1], m_stateTime);
+  return omega;
+}
+
+void Track::Adopt(const ExtendedKalmanFilter &filter, double stateTime,
+                  bool hit) {
+  using Packed = ExtendedKalmanFilter::Filter;
+  std::array<float, Packed::PACKED_SIZE> P;
+  for (int i = 0; i < Packed::STATE_DIM; ++i) {
+    for (int j = i; j < Packed::STATE_DIM; ++j) {
+      P[Packed::PackedIndex(i, j)] = filter.GetCovariance(i, j);
+    }
+  }
+  const Packed::State &x = filter.GetFilter().GetState();
+  SetEstimate(x, P.data());
+  m_stateTime = stateTime;
+  m_prediction = TrackPrediction();
+  m_checkpointHead = 0;
+  m_checkpointCount = 0;
+  RecordCheckpoint(x[0], x[1], stateTime);
+  if (hit) {
+    m_lastUpdate = stateTime;
+    RegisterHit();
+  }
+}
+
+void Track::SetEstimate(const ExtendedKalmanFilter::Filter::State &x,
+                        const float *covariance) {
+  // An IMM track's modes all restart from the estimate, keeping their
+  // probabilities
+  using Packed = ExtendedKalmanFilter::Filter;
+  auto assign = [&](auto &filter) {
+    filter.SetState(x);
+    for (int i = 0; i < Packed::STATE_DIM; ++i) {
+      for (int j = i; j < Packed::STATE_DIM; ++j) {
+        filter.SetCovariance(i, j, covariance[Packed::PackedIndex(i, j)]);
+      }
+    }
+  };
+  std::visit(
+      [&](auto &f) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(f)>,
+                                     ExtendedKalmanFilter>) {
+          assign(f.GetFilter());
+        } else {
+          assign(f);
+        }
+      },
+      m_filter);
+}
+
+void Track::Advance(Filter &filter, double dt, float x, float y,
+                    const MeasurementNoise &noise) {
+  std::visit(
+      [&](auto &f) {
+        if (dt > 0.0001) {
+          f.Predict(static_cast<float>(dt));
+        }
+        f.Update(x, y, noise.xx, noise.xy, noise.yy);
+      },
+      filter);
+}
+
+void Track::RecordCheckpoint(float x, float y, double timestamp,
+                             const MeasurementNoise &noise) {
+  size_t depth = m_checkpoints.size();
+  if (depth == 0) {
+    return;
+  }
+  Checkpoint &checkpoint = m_checkpoints[m_checkpointHead];
+  checkpoint.time = timestamp;
+  checkpoint.x = x;
+  checkpoint.y = y;
+  checkpoint.noise = noise;
+  checkpoint.filter = m_filter;
+  m_checkpointHead = (m_checkpointHead + 1) % depth;
+  m_checkpointCount = std::min(m_checkpointCount + 1, depth);
+}
+
+Track::Checkpoint &Track::CheckpointAt(size_t i) {
+  size_t depth = m_checkpoints.size();
+  return m_checkpoints[(m_checkpointHead + depth - m_checkpointCount + i) %
+                       depth];
+}
+
+bool Track::UpdateOutOfSequence(float x, float y, double timestamp,
+                                const MeasurementNoise &noise) {
+  if (m_checkpointCount == 0 || timestamp < CheckpointAt(0).time) {
+    return false; // Older than the window
+  }
 
+  // Retrodict: restart from the newest checkpoint at or before the plot
+  size_t base = m_checkpointCount - 1;
+  while (CheckpointAt(base).time > timestamp) {
+    base--;
+  }
+  Filter filter = CheckpointAt(base).filter;
+  double time = CheckpointAt(base).time;
+
+  // Open a slot for the late plot after the base, dropping the oldest
+  // checkpoint if the ring is full (the base itself is already copied)
+  size_t depth = m_checkpoints.size();
+  size_t slot = base + 1;
+  if (m_checkpointCount == depth) {
+    m_checkpointCount--;
+    slot--;
+  }
+  m_checkpointHead = (m_checkpointHead + 1) % depth;
+  m_checkpointCount++;
+  for (size_t i = m_checkpointCount - 1; i > slot; --i) {
+    std::swap(CheckpointAt(i), CheckpointAt(i - 1));
+  }
+
+  // Apply the late plot, then replay every later plot on top of it
+  Advance(filter, timestamp - time, x, y, noise);
+  Checkpoint &late = CheckpointAt(slot);
+  late.time = timestamp;
+  late.x = x;
+  late.y = y;
+  late.noise = noise;
+  late.filter = filter;
+  time = timestamp;
+  for (size_t i = slot + 1; i < m_checkpointCount; ++i) {
+    Checkpoint &checkpoint = CheckpointAt(i);
+    Advance(filter, checkpoint.time - time, checkpoint.x, checkpoint.y,
+            checkpoint.noise);
+    checkpoint.filter = filter;
+    time = checkpoint.time;
+  }
+
+  // Back to the state time (later than the newest plot if coasted)
+  if (m_stateTime - time > 0.0001) {
+    float dt = static_cast<float>(m_stateTime - time);
+    std::visit([dt](auto &f) { f.Predict(dt); }, filter);
+  }
+  m_filter = filter;
+  m_prediction = TrackPrediction();
+  RegisterHit();
+  return true;
+}
+
+void Track::RegisterHit() {
   // M-of-N confirmation logic
   m_hitCount++;
   m_missCount = 0; // Reset consecutive miss count on successful update
@@ -43,11 +545,6 @@ void Track::Update(float x, float y, double timestamp) {
   if (m_state == TrackState::COASTING) {
     m_state = TrackState::CONFIRMED;
   }
-
-  m_history.push_back(m_kf.GetPosition());
-  if (m_history.size() > MAX_HISTORY) {
-    m_history.erase(m_history.begin());
-  }
 }
 
 void Track::IncrementMissCount(double currentTime) {
@@ -1,11 +1,19 @@
 #pragma once
 
 #include "../physics/ExtendedKalmanFilter.h"
+#include "../physics/ImmFilter.h"
+#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <limits>
+#include <variant>
 #include <vector>
 
 namespace aegis {
 
+struct RemoteTrack;
+
 // Track state enumeration for M-of-N confirmation logic
 enum class TrackState {
   TENTATIVE, // New track, not yet confirmed
@@ -13,24 +21,163 @@ enum class TrackState {
   COASTING   // Track is extrapolating without measurements
 };
 
+// State estimator behind a track
+enum class TrackFilterModel {
+  EKF, // Single CTRV extended Kalman filter
+  IMM  // Interacting multiple model: CV + coordinated turn + manoeuvre
+};
+
+// Initial estimate for a track started from several plots rather than one:
+// the CTRV state and its covariance, packed upper triangle as StateFilter
+struct TrackSeed {
+  float x = 0.0f, y = 0.0f;
+  float speed = 0.0f;   // m/s
+  float heading = 0.0f; // Radians, clockwise from +y
+  std::array<float, ExtendedKalmanFilter::PACKED_SIZE> covariance{};
+  int plots = 1; // Plots behind the seed; each counts as a hit
+};
+
+// A track's estimate and bookkeeping, enough to rebuild it elsewhere (on
+// another node, or after a restart). IMM tracks carry their combined CTRV
+// estimate; their mode probabilities restart from the prior.
+struct TrackRecord {
+  uint32_t id = 0;
+  TrackFilterModel model = TrackFilterModel::EKF;
+  TrackState state = TrackState::TENTATIVE;
+  int hitCount = 0;
+  int missCount = 0;
+  double stateTime = 0.0;  // Epoch of the estimate
+  double lastUpdate = 0.0; // Last plot
+  std::array<float, ExtendedKalmanFilter::STATE_DIM> x{}; // CTRV
+  std::array<float, ExtendedKalmanFilter::PACKED_SIZE> covariance{};
+};
+
+// Noise of one position plot, m^2: R = [xx xy; xy yy]. The default is
+// the filters' own (50 m per axis, uncorrelated).
+struct MeasurementNoise {
+  float xx = 2500.0f, xy = 0.0f, yy = 2500.0f;
+};
+
+// One plot for Track::UpdateBatch
+struct TrackPlot {
+  float x = 0.0f, y = 0.0f;
+  double timestamp = 0.0;
+  MeasurementNoise noise;
+};
+
+// A track's estimate extrapolated to a given time, as used for gating and
+// output. S is the innovation covariance of a position plot at that time
+// under the filters' own noise; P is the position covariance alone, for
+// plots with other noise.
+struct TrackPrediction {
+  double time = std::numeric_limits<double>::quiet_NaN(); // Not computed
+  glm::vec2 position{0.0f};
+  glm::vec2 velocity{0.0f};
+  float sxx = 0.0f, sxy = 0.0f, syy = 0.0f;
+  float pxx = 0.0f, pxy = 0.0f, pyy = 0.0f;
+
+  // Squared Mahalanobis distance of a plot at `plotTime`; the position is
+  // carried from `time` to the plot along the predicted velocity
+  float MahalanobisDistance(float x, float y, double plotTime) const;
+  // As above for a plot with noise `noise` (S = P + R)
+  float MahalanobisDistance(float x, float y, double plotTime,
+                            const MeasurementNoise &noise) const;
+};
+
+// `filter`, valid at `stateTime`, extrapolated to `time` as
+// Track::PredictTo does for a track's own
+TrackPrediction PredictFilter(const ExtendedKalmanFilter &filter,
+                              double stateTime, double time);
+
 class Track {
 public:
-  Track(uint32_t id, float x, float y, double timestamp);
+  Track();
+  Track(uint32_t id, float x, float y, double timestamp,
+        TrackFilterModel model = TrackFilterModel::EKF);
+
+  // Reinitialise in place for a new target
+  void Reset(uint32_t id, float x, float y, double timestamp,
+             TrackFilterModel model = TrackFilterModel::EKF);
+  // Reinitialise from a multi-plot seed valid at `timestamp`
+  void Reset(uint32_t id, const TrackSeed &seed, double timestamp,
+             TrackFilterModel model = TrackFilterModel::EKF);
+  // Reinitialise as an exported track; its estimate becomes the only
+  // checkpoint, so plots older than record.stateTime are dropped
+  void Reset(const TrackRecord &record);
+  void Export(TrackRecord &record) const;
 
+  // Advance the filter state to currentTime (no-op for earlier times)
   void Predict(double currentTime);
-  void Update(float x, float y, double timestamp);
+  // Apply a plot. A plot older than the state is applied out of sequence:
+  // the filter restarts from the newest checkpoint before it, takes the
+  // late plot, and replays the plots recorded since. Returns false, with
+  // the track untouched, if the plot predates every checkpoint. `noise` is
+  // the reporting sensor's; replays reuse each plot's own.
+  bool Update(float x, float y, double timestamp,
+              const MeasurementNoise &noise = MeasurementNoise());
+  // Fuse another tracker's estimate of the same target, valid at
+  // remote.time, by covariance intersection (see FuseEstimate). Not a
+  // plot: hit and miss counts are left alone, and the fused state becomes
+  // the only checkpoint, so plots older than it are dropped. Returns the
+  // weight kept on the local estimate, or a negative value if remote.time
+  // is before the state (track untouched) or a covariance is degenerate
+  // (track only predicted).
+  float Fuse(const RemoteTrack &remote);
+  // Multiple hypothesis tracking: take a hypothesis' CTRV filter, valid at
+  // `stateTime`, as the estimate (IMM: every mode, as Fuse), counting a
+  // hit if it took a plot at that time. It becomes the only checkpoint.
+  void Adopt(const ExtendedKalmanFilter &filter, double stateTime, bool hit);
+
+  // Out-of-sequence window: the creating plot and the newest updates are
+  // kept as (time, plot, posterior) checkpoints, `depth` in all, each
+  // CheckpointBytes() in size. 0 disables it, so late plots are dropped.
+  // Storage is kept across Reset.
+  void SetCheckpointDepth(size_t depth);
+  size_t GetCheckpointDepth() const { return m_checkpoints.size(); }
+  size_t GetCheckpointCount() const { return m_checkpointCount; }
+  static constexpr size_t CheckpointBytes() { return sizeof(Checkpoint); }
+
+  // Lazy prediction: the estimate at `time`, computed on a copy of the
+  // filter the first time it is asked for and memoised until the time
+  // changes or the track is updated. The filter state itself stays at
+  // GetStateTime().
+  const TrackPrediction &PredictTo(double time) const;
+
+  // Update and PredictTo over many tracks, with the same results: IMM
+  // tracks go through ImmBatch a block at a time, the rest one by one.
+  // UpdateBatch takes at most one plot per track.
+  static void UpdateBatch(Track *const *tracks, const TrackPlot *plots,
+                          size_t count);
+  static void PredictBatch(const Track *const *tracks, size_t count,
+                           double time);
 
   uint32_t GetId() const { return m_id; }
-  glm::vec2 GetPosition() const { return m_kf.GetPosition(); }
-  glm::vec2 GetVelocity() const { return m_kf.GetVelocity(); }
-  double GetLastUpdate() const { return m_lastUpdate; }
-  const std::vector<glm::vec2> &GetHistory() const { return m_history; }
+  glm::vec2 GetPosition() const; // At GetStateTime()
+  glm::vec2 GetVelocity() const;
+  // Turning or manoeuvring: an IMM track whose turn and manoeuvre modes
+  // together outweigh constant velocity, or an EKF track turning faster
+  // than MANOEUVRE_TURN_RATE
+  bool IsManoeuvring() const;
+  double GetLastUpdate() const { return m_lastUpdate; } // Last plot
+  double GetStateTime() const { return m_stateTime; }   // Filter epoch
 
-  // Statistical distance for data association
-  float GetMahalanobisDistance(float x, float y) const {
-    return m_kf.GetMahalanobisDistance(x, y);
+  TrackFilterModel GetFilterModel() const {
+    return std::holds_alternative<ImmFilter<float>>(m_filter)
+               ? TrackFilterModel::IMM
+               : TrackFilterModel::EKF;
+  }
+  // The IMM estimator, or nullptr for an EKF track
+  const ImmFilter<float> *GetImm() const {
+    return std::get_if<ImmFilter<float>>(&m_filter);
   }
 
+  // CTRV mean and packed upper-triangular covariance at GetStateTime(),
+  // ExtendedKalmanFilter::STATE_DIM and PACKED_SIZE floats (IMM: combined)
+  void GetFilterState(float *state, float *covariance) const;
+
+  // Statistical distance for data association
+  float GetMahalanobisDistance(float x, float y) const;
+
   // Track state management for M-of-N confirmation
   TrackState GetState() const { return m_state; }
   int GetHitCount() const { return m_hitCount; }
@@ -40,19 +187,52 @@ public:
   void IncrementMissCount(double currentTime);
 
 private:
+  using Filter = std::variant<ExtendedKalmanFilter, ImmFilter<float>>;
+
+  struct Checkpoint {
+    double time = 0.0;
+    float x = 0.0f, y = 0.0f; // Plot applied at `time`
+    MeasurementNoise noise;   // and its noise
+    Filter filter;            // Posterior after it
+  };
+
+  // Predict `filter` by dt (if positive) and apply a plot
+  static void Advance(Filter &filter, double dt, float x, float y,
+                      const MeasurementNoise &noise);
+  // Bookkeeping once the filter has taken an in-sequence plot
+  void CompleteUpdate(float x, float y, double timestamp,
+                      const MeasurementNoise &noise);
+  // Append the current state as the newest checkpoint
+  void RecordCheckpoint(float x, float y, double timestamp,
+                        const MeasurementNoise &noise = MeasurementNoise());
+  // i-th checkpoint, oldest first
+  Checkpoint &CheckpointAt(size_t i);
+  bool UpdateOutOfSequence(float x, float y, double timestamp,
+                           const MeasurementNoise &noise);
+  void RegisterHit();
+  // Replace the estimate with a CTRV mean and packed covariance
+  void SetEstimate(const ExtendedKalmanFilter::Filter::State &x,
+                   const float *covariance);
+
   uint32_t m_id;
-  ExtendedKalmanFilter m_kf;
+  Filter m_filter;
   double m_lastUpdate;
-  std::vector<glm::vec2> m_history;
+  double m_stateTime;
+  mutable TrackPrediction m_prediction; // Memoised PredictTo result
+
+  // Ring of checkpoints, oldest at m_checkpointHead - m_checkpointCount
+  std::vector<Checkpoint> m_checkpoints;
+  size_t m_checkpointHead = 0;
+  size_t m_checkpointCount = 0;
 
   // M-of-N confirmation logic (M=3 hits in N=5 scans to confirm)
   TrackState m_state;
   int m_hitCount;  // Number of successful associations
   int m_missCount; // Number of consecutive misses
 
-  static const size_t MAX_HISTORY = 100;
   static const int M_HITS_TO_CONFIRM = 3;
   static const int N_SCANS_WINDOW = 5;
+  static constexpr float MANOEUVRE_TURN_RATE = 0.05f; // rad/s, ~3 deg/s
   static const int MAX_COAST_MISSES = 5; // Delete after 5 consecutive misses
 };
 
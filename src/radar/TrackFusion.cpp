@@ -0,0 +1,349 @@
+#include "TrackFusion.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace aegis {
+
+namespace {
+
+using Matrix4 = std::array<std::array<double, 4>, 4>;
+
+Matrix4 Unpack(const std::array<float, 10> &packed) {
+  Matrix4 m;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      m[i][j] = packed[RemoteTrack::PackedIndex(i, j)];
+    }
+  }
+  return m;
+}
+
+// Inverse by Gauss-Jordan with partial pivoting; false if singular.
+// `det` gets the determinant.
+bool Invert(Matrix4 m, Matrix4 &inverse, double &det) {
+  inverse = Matrix4{};
+  for (int i = 0; i < 4; ++i) {
+    inverse[i][i] = 1.0;
+  }
+  det = 1.0;
+  for (int c = 0; c < 4; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < 4; ++r) {
+      if (std::abs(m[r][c]) > std::abs(m[pivot][c])) {
+        pivot = r;
+      }
+    }
+    if (m[pivot][c] == 0.0) {
+      return false;
+    }
+    if (pivot != c) {
+      std::swap(m[pivot], m[c]);
+      std::swap(inverse[pivot], inverse[c]);
+      det = -det;
+    }
+    double d = m[c][c];
+    det *= d;
+    for (int j = 0; j < 4; ++j) {
+      m[c][j] /= d;
+      inverse[c][j] /= d;
+    }
+    for (int r = 0; r < 4; ++r) {
+      if (r != c && m[r][c] != 0.0) {
+        double f = m[r][c];
+        for (int j = 0; j < 4; ++j) {
+          m[r][j] -= f * m[c][j];
+          inverse[r][j] -= f * inverse[c][j];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Weight as CovarianceIntersectionWeight, from the inverses
+double IntersectionWeight(const Matrix4 &aInverse, const Matrix4 &bInverse) {
+  // log det(w A^-1 + (1 - w) B^-1) is concave in w, so a golden-section
+  // search finds its maximum: the smallest fused covariance
+  auto information = [&](double w) {
+    Matrix4 sum, unused;
+    for (int i = 0; i < 4; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        sum[i][j] = w * aInverse[i][j] + (1.0 - w) * bInverse[i][j];
+      }
+    }
+    double det = 0.0;
+    Invert(sum, unused, det);
+    return det;
+  };
+  const double LOW = 0.01, HIGH = 0.99;
+  const double RATIO = 0.6180339887498949;
+  double lo = LOW, hi = HIGH;
+  double w1 = hi - RATIO * (hi - lo), w2 = lo + RATIO * (hi - lo);
+  double f1 = information(w1), f2 = information(w2);
+  for (int i = 0; i < 40; ++i) {
+    if (f1 < f2) {
+      lo = w1;
+      w1 = w2;
+      f1 = f2;
+      w2 = lo + RATIO * (hi - lo);
+      f2 = information(w2);
+    } else {
+      hi = w2;
+      w2 = w1;
+      f2 = f1;
+      w1 = hi - RATIO * (hi - lo);
+      f1 = information(w1);
+    }
+  }
+  double best = 0.5 * (lo + hi);
+  // Flat (equal estimates): stay even rather than wherever the search
+  // happened to stop
+  double even = information(0.5);
+  return information(best) > even * (1.0 + 1e-6) ? best : 0.5;
+}
+
+} // namespace
+
+float CovarianceIntersectionWeight(const std::array<float, 10> &a,
+                                   const std::array<float, 10> &b) {
+  Matrix4 aInverse, bInverse;
+  double aDet, bDet;
+  if (!Invert(Unpack(a), aInverse, aDet) || aDet <= 0.0 ||
+      !Invert(Unpack(b), bInverse, bDet) || bDet <= 0.0) {
+    return -1.0f;
+  }
+  return static_cast<float>(IntersectionWeight(aInverse, bInverse));
+}
+
+float FuseEstimate(ExtendedKalmanFilter::Filter::State &x,
+                   std::array<float, ExtendedKalmanFilter::PACKED_SIZE> &P,
+                   const RemoteTrack &remote) {
+  using Filter = ExtendedKalmanFilter::Filter;
+  const int N = Filter::STATE_DIM;
+  auto Pij = [&](int i, int j) {
+    return static_cast<double>(P[Filter::PackedIndex(i, j)]);
+  };
+
+  // Local estimate in remote form, h(x) = (x, y, v sin h, v cos h), and
+  // its Jacobian
+  double v = x[2], s = std::sin(x[3]), c = std::cos(x[3]);
+  const double local[4] = {x[0], x[1], v * s, v * c};
+  double J[4][N] = {};
+  J[0][0] = 1.0;
+  J[1][1] = 1.0;
+  J[2][2] = s;
+  J[2][3] = v * c;
+  J[3][2] = c;
+  J[3][3] = -v * s;
+
+  // P J' and A = J P J'
+  double PJt[N][4];
+  for (int i = 0; i < N; ++i) {
+    for (int r = 0; r < 4; ++r) {
+      double sum = 0.0;
+      for (int k = 0; k < N; ++k) {
+        sum += Pij(i, k) * J[r][k];
+      }
+      PJt[i][r] = sum;
+    }
+  }
+  Matrix4 A;
+  for (int r = 0; r < 4; ++r) {
+    for (int q = 0; q < 4; ++q) {
+      double sum = 0.0;
+      for (int k = 0; k < N; ++k) {
+        sum += J[r][k] * PJt[k][q];
+      }
+      A[r][q] = sum;
+    }
+  }
+
+  Matrix4 B = Unpack(remote.covariance);
+  Matrix4 aInverse, bInverse;
+  double aDet, bDet;
+  if (!Invert(A, aInverse, aDet) || aDet <= 0.0 ||
+      !Invert(B, bInverse, bDet) || bDet <= 0.0) {
+    return -1.0f;
+  }
+  double w = IntersectionWeight(aInverse, bInverse);
+
+  // S = A / w + B / (1 - w), K = (P / w) J' S^-1
+  Matrix4 S, SInverse;
+  for (int r = 0; r < 4; ++r) {
+    for (int q = 0; q < 4; ++q) {
+      S[r][q] = A[r][q] / w + B[r][q] / (1.0 - w);
+    }
+  }
+  double sDet;
+  if (!Invert(S, SInverse, sDet) || sDet <= 0.0) {
+    return -1.0f;
+  }
+  double K[N][4];
+  for (int i = 0; i < N; ++i) {
+    for (int q = 0; q < 4; ++q) {
+      double sum = 0.0;
+      for (int r = 0; r < 4; ++r) {
+        sum += PJt[i][r] * SInverse[r][q];
+      }
+      K[i][q] = sum / w;
+    }
+  }
+
+  const double measured[4] = {remote.position.x, remote.position.y,
+                              remote.velocity.x, remote.velocity.y};
+  double innovation[4];
+  for (int r = 0; r < 4; ++r) {
+    innovation[r] = measured[r] - local[r];
+  }
+  for (int i = 0; i < N; ++i) {
+    double sum = 0.0;
+    for (int r = 0; r < 4; ++r) {
+      sum += K[i][r] * innovation[r];
+    }
+    x[i] = static_cast<float>(x[i] + sum);
+  }
+  CtrvModel::Normalize(x.data());
+
+  // Joseph form: (I - K J) (P / w) (I - K J)' + K (B / (1 - w)) K'
+  double IKJ[N][N];
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      double sum = i == j ? 1.0 : 0.0;
+      for (int r = 0; r < 4; ++r) {
+        sum -= K[i][r] * J[r][j];
+      }
+      IKJ[i][j] = sum;
+    }
+  }
+  double M[N][N]; // (I - K J) P
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      double sum = 0.0;
+      for (int k = 0; k < N; ++k) {
+        sum += IKJ[i][k] * Pij(k, j);
+      }
+      M[i][j] = sum;
+    }
+  }
+  double KB[N][4];
+  for (int i = 0; i < N; ++i) {
+    for (int q = 0; q < 4; ++q) {
+      double sum = 0.0;
+      for (int r = 0; r < 4; ++r) {
+        sum += K[i][r] * B[r][q];
+      }
+      KB[i][q] = sum;
+    }
+  }
+  for (int i = 0; i < N; ++i) {
+    for (int j = i; j < N; ++j) {
+      double prior = 0.0, remoteTerm = 0.0;
+      for (int k = 0; k < N; ++k) {
+        prior += M[i][k] * IKJ[j][k];
+      }
+      for (int q = 0; q < 4; ++q) {
+        remoteTerm += KB[i][q] * K[j][q];
+      }
+      P[Filter::PackedIndex(i, j)] =
+          static_cast<float>(prior / w + remoteTerm / (1.0 - w));
+    }
+  }
+  return static_cast<float>(w);
+}
+
+RemoteTrack RemoteTrack::PredictTo(double time) const {
+  RemoteTrack predicted = *this;
+  float dt = static_cast<float>(time - this->time);
+  predicted.time = time;
+  if (dt == 0.0f) {
+    return predicted;
+  }
+  predicted.position = position + velocity * dt;
+
+  // P' = F P F' with F = [I dt I; 0 I]
+  auto P = [&](int i, int j) { return covariance[PackedIndex(i, j)]; };
+  auto &out = predicted.covariance;
+  for (int i = 0; i < 2; ++i) {
+    for (int j = i; j < 2; ++j) {
+      out[PackedIndex(i, j)] = P(i, j) + dt * (P(i, j + 2) + P(i + 2, j)) +
+                               dt * dt * P(i + 2, j + 2);
+    }
+    for (int j = 2; j < 4; ++j) {
+      out[PackedIndex(i, j)] = P(i, j) + dt * P(i + 2, j);
+    }
+  }
+  return predicted;
+}
+
+RemoteTrack MakeRemoteTrack(const TrackRecord &record, uint16_t source) {
+  using Filter = ExtendedKalmanFilter::Filter;
+  RemoteTrack track;
+  track.source = source;
+  track.id = record.id;
+  track.state = record.state;
+  track.time = record.stateTime;
+
+  // CTRV (x, y, v, h, w) -> (x, y, vx, vy) with vx = v sin h, vy = v cos h;
+  // covariance J P J' through the Jacobian of that map
+  float v = record.x[2], h = record.x[3];
+  float s = std::sin(h), c = std::cos(h);
+  track.position = glm::vec2(record.x[0], record.x[1]);
+  track.velocity = glm::vec2(v * s, v * c);
+
+  const int STATE_DIM = Filter::STATE_DIM;
+  float J[4][STATE_DIM] = {};
+  J[0][0] = 1.0f;
+  J[1][1] = 1.0f;
+  J[2][2] = s;
+  J[2][3] = v * c;
+  J[3][2] = c;
+  J[3][3] = -v * s;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i; j < 4; ++j) {
+      float sum = 0.0f;
+      for (int a = 0; a < STATE_DIM; ++a) {
+        for (int b = 0; b < STATE_DIM; ++b) {
+          sum += J[i][a] * record.covariance[Filter::PackedIndex(a, b)] *
+                 J[j][b];
+        }
+      }
+      track.covariance[RemoteTrack::PackedIndex(i, j)] = sum;
+    }
+  }
+  return track;
+}
+
+TrackStateReport ToReport(const RemoteTrack &track) {
+  TrackStateReport report{};
+  report.trackId = track.id;
+  report.sourceNode = track.source;
+  report.state = static_cast<uint8_t>(track.state);
+  report.timestamp = track.time;
+  report.x = track.position.x;
+  report.y = track.position.y;
+  report.vx = track.velocity.x;
+  report.vy = track.velocity.y;
+  // Element by element: the report is packed
+  for (size_t i = 0; i < track.covariance.size(); ++i) {
+    report.covariance[i] = track.covariance[i];
+  }
+  return report;
+}
+
+RemoteTrack FromReport(const TrackStateReport &report) {
+  RemoteTrack track;
+  track.source = report.sourceNode;
+  track.id = report.trackId;
+  track.state = report.state <= 2 ? static_cast<TrackState>(report.state)
+                                  : TrackState::TENTATIVE;
+  track.time = report.timestamp;
+  track.position = glm::vec2(report.x, report.y);
+  track.velocity = glm::vec2(report.vx, report.vy);
+  for (size_t i = 0; i < track.covariance.size(); ++i) {
+    track.covariance[i] = report.covariance[i];
+  }
+  return track;
+}
+
+} // namespace aegis
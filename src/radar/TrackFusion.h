@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Protocol.h"
+#include "Track.h"
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+
+namespace aegis {
+
+// Another tracker's estimate of one of its tracks, in the common frame:
+// position and velocity with their joint covariance
+struct RemoteTrack {
+  uint16_t source = 0; // Reporting tracker
+  uint32_t id = 0;     // Its track ID
+  TrackState state = TrackState::CONFIRMED;
+  double time = 0.0; // Epoch of the estimate
+  glm::vec2 position{0.0f};
+  glm::vec2 velocity{0.0f};
+  std::array<float, 10> covariance{}; // Packed upper over (x, y, vx, vy)
+
+  static constexpr int PackedIndex(int i, int j) {
+    return (i <= j) ? i * 4 - i * (i - 1) / 2 + (j - i) : PackedIndex(j, i);
+  }
+
+  // Position covariance block
+  MeasurementNoise PositionCovariance() const {
+    return MeasurementNoise{covariance[PackedIndex(0, 0)],
+                            covariance[PackedIndex(0, 1)],
+                            covariance[PackedIndex(1, 1)]};
+  }
+
+  // Extrapolate to `time` at constant velocity (no process noise: the
+  // remote tracker's own already went into the covariance, and reports
+  // are only carried across the short gap to the local state)
+  RemoteTrack PredictTo(double time) const;
+};
+
+// Covariance intersection weight on estimate `a` when fusing it with `b`
+// (packed covariances over x, y, vx, vy): the fused covariance is
+// (w A^-1 + (1 - w) B^-1)^-1, with w chosen to minimise its determinant.
+// Clamped to [0.01, 0.99] so neither side is ever discarded outright, and
+// 0.5 when neither is better. Negative if either is not positive definite.
+float CovarianceIntersectionWeight(const std::array<float, 10> &a,
+                                   const std::array<float, 10> &b);
+
+// Fuse `remote` into a CTRV estimate (state x, packed covariance P) valid
+// at remote.time, in place. Covariance intersection over the shared
+// position and velocity, so the result stays consistent however much the
+// two estimates have in common (shared plots, or each other's earlier
+// reports): an EKF update of the prior inflated to P / w by the remote
+// estimate with noise B / (1 - w). Returns w, or a negative value with the
+// estimate untouched if a covariance is degenerate.
+float FuseEstimate(ExtendedKalmanFilter::Filter::State &x,
+                   std::array<float, ExtendedKalmanFilter::PACKED_SIZE> &P,
+                   const RemoteTrack &remote);
+
+// Where to send this tracker's track reports
+struct FusionPeer {
+  std::string host = "127.0.0.1";
+  int port = 0;
+};
+
+// A local track's estimate in remote form: the CTRV state and covariance
+// of `record` mapped to Cartesian position and velocity
+RemoteTrack MakeRemoteTrack(const TrackRecord &record, uint16_t source);
+
+// Wire form
+TrackStateReport ToReport(const RemoteTrack &track);
+RemoteTrack FromReport(const TrackStateReport &report);
+
+} // namespace aegis
@@ -0,0 +1,122 @@
+#include "TrackHistory.h"
+#include <algorithm>
+
+namespace aegis {
+
+namespace {
+
+// Emits newest-to-oldest with spacing rejection, then flips to oldest-first
+template <typename PointAt>
+size_t EmitDecimated(size_t count, PointAt pointAt, float minSpacing,
+                     glm::vec2 *out, size_t maxOut) {
+  const float minSpacingSq = minSpacing * minSpacing;
+  size_t written = 0;
+  for (size_t i = 0; i < count && written < maxOut; ++i) {
+    glm::vec2 p = pointAt(i); // i = 0 is the newest point
+    if (written > 0) {
+      glm::vec2 d = p - out[written - 1];
+      if (d.x * d.x + d.y * d.y < minSpacingSq) {
+        continue;
+      }
+    }
+    out[written++] = p;
+  }
+  std::reverse(out, out + written);
+  return written;
+}
+
+} // namespace
+
+size_t DecimateTrail(const glm::vec2 *points, size_t count, float minSpacing,
+                     glm::vec2 *out, size_t maxOut) {
+  return EmitDecimated(
+      count, [&](size_t i) { return points[count - 1 - i]; }, minSpacing, out,
+      maxOut);
+}
+
+TrackHistoryArena::TrackHistoryArena(const TrackHistoryConfig &config)
+    : m_config(config),
+      m_stride(static_cast<size_t>(config.fineCapacity) +
+               config.coarseCapacity) {}
+
+void TrackHistoryArena::EnsureSlots(size_t slotCount) {
+  if (slotCount <= m_slots.size()) {
+    return;
+  }
+  m_slots.resize(slotCount);
+  m_x.resize(slotCount * m_stride);
+  m_y.resize(slotCount * m_stride);
+  m_t.resize(slotCount * m_stride);
+}
+
+void TrackHistoryArena::Reset(uint32_t slot, float x, float y, double t) {
+  m_slots[slot] = SlotHeader();
+  Append(slot, x, y, t);
+}
+
+void TrackHistoryArena::Append(uint32_t slot, float x, float y, double t) {
+  SlotHeader &hdr = m_slots[slot];
+  const size_t base = slot * m_stride;
+  const uint32_t fineCap = m_config.fineCapacity;
+
+  // When the fine ring is full, its oldest point sits at `head` and is about
+  // to be overwritten: keep it only if it starts a new coarse time bucket
+  if (hdr.fine.count == fineCap) {
+    size_t oldest = base + hdr.fine.head;
+    if (m_config.coarseCapacity > 0 &&
+        (hdr.coarse.count == 0 ||
+         m_t[oldest] - hdr.lastCoarseTime >= m_config.coarseInterval)) {
+      PushCoarse(slot, oldest);
+    }
+  }
+
+  size_t dst = base + hdr.fine.head;
+  m_x[dst] = x;
+  m_y[dst] = y;
+  m_t[dst] = t;
+  hdr.fine.head = (hdr.fine.head + 1) % fineCap;
+  hdr.fine.count = std::min(hdr.fine.count + 1, fineCap);
+}
+
+void TrackHistoryArena::PushCoarse(uint32_t slot, size_t src) {
+  SlotHeader &hdr = m_slots[slot];
+  const uint32_t coarseCap = m_config.coarseCapacity;
+  size_t dst = slot * m_stride + m_config.fineCapacity + hdr.coarse.head;
+
+  m_x[dst] = m_x[src];
+  m_y[dst] = m_y[src];
+  m_t[dst] = m_t[src];
+  hdr.coarse.head = (hdr.coarse.head + 1) % coarseCap;
+  hdr.coarse.count = std::min(hdr.coarse.count + 1, coarseCap);
+  hdr.lastCoarseTime = m_t[src];
+}
+
+size_t TrackHistoryArena::Count(uint32_t slot) const {
+  const SlotHeader &hdr = m_slots[slot];
+  return static_cast<size_t>(hdr.fine.count) + hdr.coarse.count;
+}
+
+size_t TrackHistoryArena::Query(uint32_t slot, float minSpacing,
+                                glm::vec2 *out, size_t maxOut) const {
+  const SlotHeader &hdr = m_slots[slot];
+  const size_t fineBase = slot * m_stride;
+  const size_t coarseBase = fineBase + m_config.fineCapacity;
+  const uint32_t fineCap = m_config.fineCapacity;
+  const uint32_t coarseCap = m_config.coarseCapacity;
+
+  // Newest first: walk the fine ring backwards, then the coarse ring
+  auto pointAt = [&](size_t i) {
+    size_t idx;
+    if (i < hdr.fine.count) {
+      idx = fineBase + (hdr.fine.head + fineCap - 1 - i) % fineCap;
+    } else {
+      size_t j = i - hdr.fine.count;
+      idx = coarseBase + (hdr.coarse.head + coarseCap - 1 - j) % coarseCap;
+    }
+    return glm::vec2(m_x[idx], m_y[idx]);
+  };
+
+  return EmitDecimated(Count(slot), pointAt, minSpacing, out, maxOut);
+}
+
+} // namespace aegis
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace aegis {
+
+struct TrackHistoryConfig {
+  uint32_t fineCapacity = 64;   // Most recent points kept at full rate
+  uint32_t coarseCapacity = 64; // Older points kept after decimation
+  double coarseInterval = 2.0;  // Seconds per coarse point (time buckets)
+};
+
+// Copies `points` into `out`, dropping any point closer than `minSpacing` to
+// the previously kept one (the newest point is always kept). At most
+// `maxOut` points are written, favouring the newest. Returns the count.
+size_t DecimateTrail(const glm::vec2 *points, size_t count, float minSpacing,
+                     glm::vec2 *out, size_t maxOut);
+
+// Trail storage for every track slot in one columnar arena. Each slot owns a
+// fixed-capacity fine ring; points falling off it are thinned to one per
+// `coarseInterval` into a second fixed ring, so a track's trail costs the
+// same memory (and draw work) whether it is ten seconds or ten hours old.
+// Slots are indexed by TrackHandle::index.
+class TrackHistoryArena {
+public:
+  explicit TrackHistoryArena(
+      const TrackHistoryConfig &config = TrackHistoryConfig());
+
+  // Grow to cover `slotCount` slots (allocates only when growing)
+  void EnsureSlots(size_t slotCount);
+
+  // Start a slot's trail over with a single point
+  void Reset(uint32_t slot, float x, float y, double t);
+  void Append(uint32_t slot, float x, float y, double t);
+
+  // Points currently stored for `slot` (coarse + fine)
+  size_t Count(uint32_t slot) const;
+
+  // Level-of-detail read, oldest first: points closer than `minSpacing`
+  // (e.g. one screen pixel in world units) are merged and at most `maxOut`
+  // points are written, favouring the newest. Returns the count written.
+  size_t Query(uint32_t slot, float minSpacing, glm::vec2 *out,
+               size_t maxOut) const;
+
+  size_t Capacity() const { return m_slots.size(); }
+  size_t PointsPerSlot() const { return m_stride; }
+
+private:
+  struct Ring {
+    uint32_t head = 0;  // Next write position
+    uint32_t count = 0;
+  };
+
+  struct SlotHeader {
+    Ring fine;
+    Ring coarse;
+    double lastCoarseTime = 0.0;
+  };
+
+  void PushCoarse(uint32_t slot, size_t src);
+
+  TrackHistoryConfig m_config;
+  size_t m_stride; // fineCapacity + coarseCapacity
+
+  // Columnar storage: slot s occupies [s * m_stride, (s + 1) * m_stride),
+  // fine ring first, then coarse ring
+  std::vector<float> m_x;
+  std::vector<float> m_y;
+  std::vector<double> m_t;
+  std::vector<SlotHeader> m_slots;
+};
+
+} // namespace aegis
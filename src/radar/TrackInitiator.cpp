@@ -0,0 +1,121 @@
+#include "TrackInitiator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace aegis {
+
+TrackInitiator::TrackInitiator(const TrackInitiatorConfig &config)
+    : m_config(config), m_grid(config.gridCellSize) {}
+
+size_t TrackInitiator::BeginScan(double scanTime) {
+  double cutoff = scanTime - m_config.maxCandidateAge;
+  size_t expired = 0;
+  size_t kept = 0;
+  for (const Candidate &c : m_candidates) {
+    if (c.used) {
+      continue;
+    }
+    if (c.timestamp < cutoff) {
+      expired++;
+      continue;
+    }
+    m_candidates[kept++] = c;
+  }
+  m_candidates.resize(kept);
+  m_candidates.insert(m_candidates.end(), m_pending.begin(), m_pending.end());
+  m_pending.clear();
+
+  if (m_candidates.size() > m_config.maxCandidates) {
+    size_t excess = m_candidates.size() - m_config.maxCandidates;
+    m_candidates.erase(m_candidates.begin(),
+                       m_candidates.begin() + static_cast<ptrdiff_t>(excess));
+    expired += excess;
+  }
+
+  m_grid.Clear();
+  m_oldestCandidate = scanTime;
+  m_maxCandidateVariance = 0.0f;
+  for (size_t i = 0; i < m_candidates.size(); ++i) {
+    const Candidate &c = m_candidates[i];
+    m_grid.Insert(static_cast<uint32_t>(i), c.x, c.y);
+    m_oldestCandidate = std::min(m_oldestCandidate, c.timestamp);
+    m_maxCandidateVariance = std::max(m_maxCandidateVariance, c.variance);
+  }
+  m_grid.Build();
+  return expired;
+}
+
+bool TrackInitiator::Offer(float x, float y, double timestamp,
+                           float variance, TrackSeed &seed) {
+  // Noise margin on the pair's difference; the query takes the widest
+  float margin =
+      GATE_SIGMAS * std::sqrt(variance + m_maxCandidateVariance);
+  float radius = m_config.maxTargetSpeed *
+                     static_cast<float>(std::max(
+                         timestamp - m_oldestCandidate, 0.0)) +
+                 margin;
+
+  // Best partner: the one deepest inside its own velocity gate
+  Candidate *best = nullptr;
+  float bestRatio = 1.0f;
+  m_grid.Query(x, y, radius, [&](uint32_t index, float cx, float cy) {
+    Candidate &c = m_candidates[index];
+    double dt = timestamp - c.timestamp;
+    if (c.used || dt < MIN_PAIR_INTERVAL) {
+      return;
+    }
+    float gate = m_config.maxTargetSpeed * static_cast<float>(dt) +
+                 GATE_SIGMAS * std::sqrt(variance + c.variance);
+    float dx = x - cx, dy = y - cy;
+    float ratio = (dx * dx + dy * dy) / (gate * gate);
+    if (ratio <= bestRatio) {
+      bestRatio = ratio;
+      best = &c;
+    }
+  });
+
+  if (!best) {
+    m_pending.push_back(Candidate{x, y, variance, timestamp, false});
+    return false;
+  }
+  best->used = true;
+  seed = MakeSeed(best->x, best->y, best->timestamp, best->variance, x, y,
+                  timestamp, variance);
+  return true;
+}
+
+size_t TrackInitiator::GetCandidateCount() const {
+  size_t count = m_pending.size();
+  for (const Candidate &c : m_candidates) {
+    count += c.used ? 0 : 1;
+  }
+  return count;
+}
+
+void TrackInitiator::Clear() {
+  m_candidates.clear();
+  m_pending.clear();
+  m_grid.Clear();
+}
+
+TrackSeed TrackInitiator::MakeSeed(float x0, float y0, double t0, float r0,
+                                   float x1, float y1, double t1, float r1) {
+  using Filter = ExtendedKalmanFilter::Filter;
+  ExtendedKalmanFilter ekf;
+  ekf.StartFromPlots(x0, y0, r0, x1, y1, r1, static_cast<float>(t1 - t0));
+
+  TrackSeed seed;
+  seed.x = x1;
+  seed.y = y1;
+  seed.speed = ekf.GetFilter().GetState(2);
+  seed.heading = ekf.GetFilter().GetState(3);
+  seed.plots = 2;
+  for (int i = 0; i < Filter::STATE_DIM; ++i) {
+    for (int j = i; j < Filter::STATE_DIM; ++j) {
+      seed.covariance[Filter::PackedIndex(i, j)] = ekf.GetCovariance(i, j);
+    }
+  }
+  return seed;
+}
+
+} // namespace aegis
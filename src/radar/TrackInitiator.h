@@ -0,0 +1,78 @@
+#pragma once
+
+#include "SpatialGrid.h"
+#include "Track.h"
+#include <cstddef>
+#include <vector>
+
+namespace aegis {
+
+struct TrackInitiatorConfig {
+  float maxTargetSpeed = 1000.0f;      // m/s, bounds the pairing gate
+  float measurementVariance = 2500.0f; // m^2 per axis (50m plots)
+  double maxCandidateAge = 3.0;        // Seconds a lone plot waits to pair
+  size_t maxCandidates = 20000;        // Oldest are dropped beyond this
+  float gridCellSize = 2000.0f;        // m, candidate index cell
+};
+
+// Two-point track initiation. Plots that no track claims wait in a
+// short-lived candidate buffer; a plot from a later scan that lies within
+// max speed x elapsed time (plus plot noise) of a candidate pairs with it,
+// and the pair seeds a track with a differenced velocity and heading and
+// the covariance that differencing implies. Lone clutter plots expire
+// without ever becoming tracks.
+class TrackInitiator {
+public:
+  explicit TrackInitiator(
+      const TrackInitiatorConfig &config = TrackInitiatorConfig());
+
+  // Start a scan: drop used and expired candidates, and make the plots
+  // buffered during the previous scan pairable. Returns the number of
+  // candidates that expired unpaired.
+  size_t BeginScan(double scanTime);
+
+  // Offer a plot no track claimed. If it pairs with a candidate from an
+  // earlier scan, the candidate is consumed, `seed` is filled and true is
+  // returned; otherwise the plot is buffered and false is returned.
+  // `variance` is the plot's per-axis noise (its sensor's), defaulting to
+  // the configured one.
+  bool Offer(float x, float y, double timestamp, TrackSeed &seed) {
+    return Offer(x, y, timestamp, m_config.measurementVariance, seed);
+  }
+  bool Offer(float x, float y, double timestamp, float variance,
+             TrackSeed &seed);
+
+  size_t GetCandidateCount() const;
+  void Clear();
+
+  // Seed at (x1, y1, t1) from an earlier plot (x0, y0, t0), as
+  // ExtendedKalmanFilter::StartFromPlots with per-axis plot variance `r`
+  static TrackSeed MakeSeed(float x0, float y0, double t0, float x1, float y1,
+                            double t1, float r) {
+    return MakeSeed(x0, y0, t0, r, x1, y1, t1, r);
+  }
+  // As above for plots of different variance (r0 and r1), e.g. from two
+  // sensors
+  static TrackSeed MakeSeed(float x0, float y0, double t0, float r0, float x1,
+                            float y1, double t1, float r1);
+
+private:
+  struct Candidate {
+    float x, y;
+    float variance;
+    double timestamp;
+    bool used;
+  };
+
+  TrackInitiatorConfig m_config;
+  std::vector<Candidate> m_candidates; // Pairable, oldest first
+  std::vector<Candidate> m_pending;    // Buffered during this scan
+  SpatialGrid m_grid;                  // m_candidates by index
+  double m_oldestCandidate = 0.0;
+  float m_maxCandidateVariance = 0.0f; // Widest plot noise in m_candidates
+
+  static constexpr double MIN_PAIR_INTERVAL = 1e-3; // Seconds
+  static constexpr float GATE_SIGMAS = 3.0f;        // Plot-noise margin
+};
+
+} // namespace aegis
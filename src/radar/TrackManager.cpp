@@ -1,66 +1,1175 @@
 #include "TrackManager.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <limits>
 
 
 namespace aegis {
 
-TrackManager::TrackManager() : m_nextTrackId(1) {}
+TrackManager::TrackManager(const TrackManagerConfig &config)
+    : m_config(config), m_pool(config.initialCapacity, config.oosmDepth),
+      m_history(config.history), m_initiator(config.initiator),
+      m_grid(config.gridCellSize),
+      m_nextTrackId(config.firstTrackId),
+      m_plotsCounter(m_registry.AddCounter("aegis_plots_total",
+                                           "Plots offered for association")),
+      m_associatedCounter(m_registry.AddCounter(
+          "aegis_plots_associated_total", "Plots associated to a track")),
+      m_createdCounter(m_registry.AddCounter("aegis_tracks_created_total",
+                                             "Tracks initiated")),
+      m_deletedCounter(m_registry.AddCounter(
+          "aegis_tracks_deleted_total", "Tracks deleted (expired or evicted)")),
+      m_evictedCounter(m_registry.AddCounter(
+          "aegis_tracks_evicted_total",
+          "Tentative tracks evicted at the track caps")),
+      m_shedCounter(m_registry.AddCounter(
+          "aegis_plots_shed_total",
+          "Plots dropped with no track slot available")),
+      m_gateCandidatesCounter(m_registry.AddCounter(
+          "aegis_gate_candidates_total",
+          "Track/plot pairs predicted and tested against the gate")),
+      m_motionPrunedCounter(m_registry.AddCounter(
+          "aegis_gate_motion_pruned_total",
+          "Nearby track/plot pairs rejected by the motion bound before "
+          "prediction")),
+      m_candidatesExpiredCounter(m_registry.AddCounter(
+          "aegis_init_candidates_expired_total",
+          "Unassociated plots that expired without pairing into a track")),
+      m_latePlotsCounter(m_registry.AddCounter(
+          "aegis_oosm_plots_total",
+          "Plots older than their track, applied out of sequence")),
+      m_lateDroppedCounter(m_registry.AddCounter(
+          "aegis_oosm_dropped_total",
+          "Late plots older than their track's checkpoint window")),
+      m_unknownSensorCounter(m_registry.AddCounter(
+          "aegis_plots_unknown_sensor_total",
+          "Plots from unregistered sensor IDs, treated as sensor 0")),
+      m_outsideRegionCounter(m_registry.AddCounter(
+          "aegis_plots_outside_region_total",
+          "Unassociated plots outside the initiation region")),
+      m_handedOverCounter(m_registry.AddCounter(
+          "aegis_handover_sent_total", "Tracks handed over to another node")),
+      m_adoptedCounter(m_registry.AddCounter(
+          "aegis_handover_adopted_total",
+          "Tracks taken over from another node")),
+      m_duplicateCounter(m_registry.AddCounter(
+          "aegis_handover_duplicates_total",
+          "Handed-over tracks that duplicated a local one (one of the pair "
+          "dropped)")),
+      m_remoteTracksCounter(m_registry.AddCounter(
+          "aegis_fusion_remote_tracks_total",
+          "Track reports received from other trackers")),
+      m_remoteFusedCounter(m_registry.AddCounter(
+          "aegis_fusion_fused_total",
+          "Remote tracks fused into a local track")),
+      m_remoteUnmatchedCounter(m_registry.AddCounter(
+          "aegis_fusion_unmatched_total",
+          "Remote tracks that gated with no local track")),
+      m_trailsSkippedCounter(m_registry.AddCounter(
+          "aegis_trail_points_skipped_total",
+          "Track updates left out of the trail by an overloaded scan")),
+      m_clustersCounter(m_registry.AddCounter(
+          "aegis_assoc_clusters_total",
+          "Independent track/plot clusters solved by global association")),
+      m_trivialClustersCounter(m_registry.AddCounter(
+          "aegis_assoc_trivial_clusters_total",
+          "Clusters of one track and one plot, assigned without the solver")),
+      m_contestedCounter(m_registry.AddCounter(
+          "aegis_assoc_contested_total",
+          "Plots that gated a track but lost it to a closer plot from the "
+          "same sensor")),
+      m_totalGauge(m_registry.AddGauge("aegis_tracks", "Live tracks")),
+      m_confirmedGauge(
+          m_registry.AddGauge("aegis_tracks_confirmed", "Confirmed tracks")),
+      m_tentativeGauge(
+          m_registry.AddGauge("aegis_tracks_tentative", "Tentative tracks")),
+      m_coastingGauge(
+          m_registry.AddGauge("aegis_tracks_coasting", "Coasting tracks")),
+      m_associationRateGauge(m_registry.AddGauge(
+          "aegis_association_rate", "Associated plots / total plots")),
+      m_candidatesGauge(m_registry.AddGauge(
+          "aegis_init_candidates", "Plots waiting to pair into a new track")),
+      m_positionError(m_registry.AddStat(
+          "aegis_position_error_meters",
+          "Distance between associated plots and updated track positions")),
+      m_lateUpdateDuration(m_registry.AddHistogram(
+          "aegis_oosm_update_seconds",
+          "Time to apply one out-of-sequence plot (retrodict and replay)",
+          {1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 1e-3})),
+      m_clusterPairs(m_registry.AddHistogram(
+          "aegis_assoc_cluster_pairs", "Gated pairs per association cluster",
+          {1, 2, 4, 8, 16, 32, 64, 128, 256})),
+      m_scheduler(config.scheduler, m_registry, config.deterministic),
+      m_hypotheses(config.mht, m_registry) {
+  for (const SensorConfig &sensor : config.sensors) {
+    m_sensors.Register(sensor);
+  }
+  m_tracks.reserve(config.initialCapacity);
+  m_history.EnsureSlots(m_pool.Capacity());
+  m_tentativeRank.Reserve(m_pool.Capacity());
+  if (config.association == AssociationMode::GLOBAL) {
+    m_workers = std::make_unique<ThreadPool>(config.associationThreads);
+  }
+}
+
+void TrackManager::RefreshTentativeRank(TrackHandle handle,
+                                        const Track &track) {
+  if (track.GetState() == TrackState::TENTATIVE) {
+    m_tentativeRank.Push(
+        handle.index,
+        TrackQuality{track.GetHitCount() - track.GetMissCount(),
+                     track.GetLastUpdate()});
+  } else {
+    m_tentativeRank.Remove(handle.index);
+  }
+}
+
+bool TrackManager::MakeRoomForNewTrack() {
+  while (m_pool.Size() >= m_config.maxTracks ||
+         m_tentativeRank.Size() >= m_config.maxTentativeTracks) {
+    if (m_tentativeRank.Empty()) {
+      return false; // Only confirmed/coasting tracks left; keep them
+    }
+
+    // O(log N): the handle stays in m_tracks as a stale entry until the
+    // next PruneTracks compaction
+    uint32_t slot = m_tentativeRank.Pop();
+    TrackHandle handle = m_pool.HandleAt(slot);
+    SubmitToSmoother(*m_pool.Get(handle), true);
+    m_pool.Destroy(handle);
+    m_evictedCounter.Add();
+    m_deletedCounter.Add();
+  }
+  return true;
+}
 
 void TrackManager::ProcessPlot(uint32_t plotId, float x, float y,
                                double timestamp) {
   std::lock_guard<std::mutex> lock(m_mutex);
+  // A lone plot is its own scan for the initiator
+  m_candidatesExpiredCounter.Add(m_initiator.BeginScan(timestamp));
+  AssociatePlot(x, y, timestamp, timestamp, m_sensors.Get(0).noise);
+}
+
+void TrackManager::RebuildSpatialIndex() {
+  m_grid.Clear();
+  m_gridOldestState = std::numeric_limits<double>::max();
+  m_gridNewestState = std::numeric_limits<double>::lowest();
+  m_newTracks.assign(m_tracks.begin(), m_tracks.end());
+  IndexNewTracks();
+}
 
+void TrackManager::IndexNewTracks() {
+  for (TrackHandle handle : m_newTracks) {
+    if (const Track *track = m_pool.Get(handle)) {
+      glm::vec2 position = track->GetPosition();
+      m_grid.Insert(handle.index, position.x, position.y);
+      m_gridOldestState = std::min(m_gridOldestState, track->GetStateTime());
+      m_gridNewestState = std::max(m_gridNewestState, track->GetStateTime());
+    }
+  }
+  m_grid.Build();
+  m_newTracks.clear();
+}
+
+template <typename Visit>
+uint64_t TrackManager::ForEachReachableTrack(float x, float y,
+                                             double timestamp, Visit &&visit) {
+  uint64_t pruned = 0;
+  auto consider = [&](TrackHandle handle) {
+    Track *track = m_pool.Get(handle);
+    if (!track) {
+      return; // Evicted this scan
+    }
+
+    // Motion bound: a target cannot have moved farther than max speed
+    // allows since its last estimate, so skip it before predicting
+    double elapsed = std::abs(timestamp - track->GetStateTime());
+    float reach = m_config.maxTargetSpeed * static_cast<float>(elapsed) +
+                  m_config.gateMargin;
+    glm::vec2 offset = track->GetPosition() - glm::vec2(x, y);
+    if (glm::dot(offset, offset) > reach * reach) {
+      pruned++;
+      return;
+    }
+    visit(handle, *track);
+  };
+
+  // Grid radius: the motion bound for the stalest indexed estimate
+  if (m_grid.Size() > 0) {
+    double elapsed = std::max(timestamp - m_gridOldestState,
+                              m_gridNewestState - timestamp);
+    float radius =
+        m_config.maxTargetSpeed * static_cast<float>(std::max(elapsed, 0.0)) +
+        m_config.gateMargin;
+    m_grid.Query(x, y, radius, [&](uint32_t slot, float, float) {
+      consider(m_pool.HandleAt(slot));
+    });
+  }
+  for (TrackHandle handle : m_newTracks) {
+    consider(handle);
+  }
+  return pruned;
+}
+
+void TrackManager::AssociatePlot(float x, float y, double timestamp,
+                                 double gateTime,
+                                 const MeasurementNoise &noise) {
   // Update metrics
-  m_metrics.totalPlots++;
+  m_plotsCounter.Add();
 
   // Nearest Neighbor Association with Mahalanobis Distance Gating
   // Uses innovation covariance for statistically-rigorous gating
-  std::shared_ptr<Track> bestTrack = nullptr;
+  Track *bestTrack = nullptr;
+  TrackHandle bestHandle;
   float minDist = std::numeric_limits<float>::max();
+  uint64_t candidates = 0;
 
-  for (auto &track : m_tracks) {
-    // Predict track to current time for better association
-    // Note: We don't want to modify the track state permanently here just for
-    // association check? Or we do. Let's use the current state.
+  uint64_t pruned = ForEachReachableTrack(
+      x, y, timestamp, [&](TrackHandle handle, Track &track) {
+        // Lazy prediction to the gate time, memoised on the track so every
+        // plot in the scan reuses it
+        const TrackPrediction &prediction = track.PredictTo(gateTime);
+        float mahalanobis_sq =
+            prediction.MahalanobisDistance(x, y, timestamp, noise);
+        candidates++;
 
-    // Calculate Mahalanobis distance (statistically weighted)
-    float mahalanobis_sq = track->GetMahalanobisDistance(x, y);
+        // Gate using chi-squared threshold (2 DOF, 99% confidence)
+        if (mahalanobis_sq < minDist && mahalanobis_sq < CHI_SQUARED_GATE) {
+          minDist = mahalanobis_sq;
+          bestTrack = &track;
+          bestHandle = handle;
+        }
+      });
+  m_gateCandidatesCounter.Add(candidates);
+  m_motionPrunedCounter.Add(pruned);
 
-    // Gate using chi-squared threshold (2 DOF, 99% confidence)
-    if (mahalanobis_sq < minDist && mahalanobis_sq < CHI_SQUARED_GATE) {
-      minDist = mahalanobis_sq;
+  if (bestTrack && timestamp < bestTrack->GetStateTime()) {
+    ApplyLateUpdate(bestHandle, *bestTrack, x, y, timestamp, noise);
+    return;
+  }
+
+  if (bestTrack) {
+    ApplyUpdate(bestHandle, *bestTrack, x, y, timestamp, noise);
+    return;
+  }
+
+  InitiateFromPlot(x, y, timestamp, noise);
+}
+
+void TrackManager::ApplyUpdate(TrackHandle handle, Track &track, float x,
+                               float y, double timestamp,
+                               const MeasurementNoise &noise) {
+  track.Update(x, y, timestamp, noise);
+  RecordUpdate(handle, track, x, y, timestamp);
+}
+
+void TrackManager::RecordUpdate(TrackHandle handle, const Track &track,
+                                float x, float y, double timestamp) {
+  RefreshTentativeRank(handle, track);
+  m_associatedCounter.Add();
+
+  // Calculate position error for metrics
+  glm::vec2 predicted = track.GetPosition();
+  float error = glm::distance(predicted, glm::vec2(x, y));
+  m_positionError.Add(error);
+  SubmitToSmoother(track, false);
+
+  if (m_thinTrails) {
+    m_trailsSkippedCounter.Add();
+  } else {
+    m_history.Append(handle.index, predicted.x, predicted.y, timestamp);
+  }
+}
+
+void TrackManager::ApplyLateUpdate(TrackHandle handle, Track &track, float x,
+                                   float y, double timestamp,
+                                   const MeasurementNoise &noise) {
+  // Retrodict and replay inside the track's checkpoint window
+  auto start = std::chrono::steady_clock::now();
+  bool applied = track.Update(x, y, timestamp, noise);
+  m_lateUpdateDuration.Observe(std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count());
+  if (applied) {
+    RefreshTentativeRank(handle, track);
+    m_associatedCounter.Add();
+    m_latePlotsCounter.Add();
+  } else {
+    m_lateDroppedCounter.Add();
+  }
+  // Trails stay in time order, so late plots are not drawn
+}
+
+bool TrackManager::JoinNewTrack(float x, float y, double timestamp,
+                                const MeasurementNoise &noise,
+                                double gateTime, size_t firstCreated) {
+  // Few tracks start per scan: test them all
+  Track *bestTrack = nullptr;
+  TrackHandle bestHandle;
+  float minDist = CHI_SQUARED_GATE;
+  for (size_t i = firstCreated; i < m_tracks.size(); ++i) {
+    Track *track = m_pool.Get(m_tracks[i]);
+    if (!track) {
+      continue; // Evicted to make room for a later one
+    }
+    float reach = m_config.maxTargetSpeed *
+                      static_cast<float>(
+                          std::abs(timestamp - track->GetStateTime())) +
+                  m_config.gateMargin;
+    glm::vec2 offset = track->GetPosition() - glm::vec2(x, y);
+    if (glm::dot(offset, offset) > reach * reach) {
+      continue;
+    }
+    float d2 = track->PredictTo(gateTime).MahalanobisDistance(x, y,
+                                                              timestamp, noise);
+    if (d2 < minDist) {
+      minDist = d2;
       bestTrack = track;
+      bestHandle = m_tracks[i];
     }
   }
+  if (!bestTrack) {
+    return false;
+  }
+  if (timestamp < bestTrack->GetStateTime()) {
+    // Older than the plots that started it: drop, as the late path would
+    m_lateDroppedCounter.Add();
+    return true;
+  }
+  ApplyUpdate(bestHandle, *bestTrack, x, y, timestamp, noise);
+  return true;
+}
 
-  if (bestTrack) {
-    bestTrack->Update(x, y, timestamp);
-    m_metrics.associatedPlots++;
+void TrackManager::InitiateFromPlot(float x, float y, double timestamp,
+                                    const MeasurementNoise &noise) {
+  // Tracks are started only inside the initiation region
+  if (!m_config.initiationRegion.Contains(x, y)) {
+    m_outsideRegionCounter.Add();
+    return;
+  }
 
-    // Calculate position error for metrics
-    glm::vec2 predicted = bestTrack->GetPosition();
-    float error = glm::distance(predicted, glm::vec2(x, y));
-    m_metrics.AddPositionError(error);
+  // No track claims the plot: with two-point initiation it waits for a
+  // partner from a later scan before a track is started
+  TrackSeed seed;
+  bool paired = false;
+  if (m_config.twoPointInitiation) {
+    // The initiator works per axis; take the plot's wider one
+    paired = m_initiator.Offer(x, y, timestamp, std::max(noise.xx, noise.yy),
+                               seed);
+    if (!paired) {
+      return;
+    }
+  }
+
+  if (!MakeRoomForNewTrack()) {
+    // At capacity with nothing evictable: shed the plot, not a good track
+    m_shedCounter.Add();
   } else {
     // Create new track
     // Use plotId as track ID if available/unique, or generate one.
     // For simulation, plotId is the ground truth ID. We can use it for debug,
     // but a real system would assign its own ID.
     // Let's use our own ID to be realistic.
-    m_tracks.push_back(
-        std::make_shared<Track>(m_nextTrackId++, x, y, timestamp));
-    m_metrics.newTracks++;
-    m_metrics.tracksCreated++;
+    TrackHandle handle =
+        paired ? m_pool.Create(m_nextTrackId++, seed, timestamp,
+                               m_config.filterModel)
+               : m_pool.Create(m_nextTrackId++, x, y, timestamp,
+                               m_config.filterModel);
+    m_history.EnsureSlots(m_pool.Capacity());
+    m_history.Reset(handle.index, x, y, timestamp);
+    m_tentativeRank.Reserve(m_pool.Capacity());
+    RefreshTentativeRank(handle, *m_pool.Get(handle));
+    SubmitToSmoother(*m_pool.Get(handle), false);
+    m_tracks.push_back(handle);
+    m_newTracks.push_back(handle); // Gated by brute force until indexed
+    m_createdCounter.Add();
+    if (m_newTracks.size() >= NEW_TRACK_BATCH) {
+      IndexNewTracks();
+    }
+  }
+}
+
+void TrackManager::AssociateBatch(const Plot *plots, size_t count,
+                                  double gateTime) {
+  m_plotsCounter.Add(count);
+
+  // Gate every plot before any track moves, so the assignment sees one
+  // consistent picture. Chunks of plots are gated in parallel in two
+  // passes: the first finds each plot's tracks within the motion bound,
+  // and whichever task reaches a track first gives it a row in a packed
+  // table; once the rows are predicted, a block of tracks per task, the
+  // second gates each plot against its tracks' rows.
+  m_batchPlots.assign(count, BatchPlot());
+  m_batchSensors.resize(count);
+  if (m_batchIndex.size() < m_pool.Capacity()) {
+    m_batchIndex.resize(m_pool.Capacity(), NONE);
+  }
+  if (m_gateRow.size() < m_pool.Capacity()) {
+    m_gateRow.resize(m_pool.Capacity());
+    m_gateTracks.resize(m_pool.Capacity());
+    m_gateOrder.resize(m_pool.Capacity());
+  }
+  m_gateRows = 0;
+  size_t chunks = (count + GATE_CHUNK - 1) / GATE_CHUNK;
+  if (m_gateChunks.size() < chunks) {
+    m_gateChunks.resize(chunks);
+  }
+  m_workers->ParallelFor(chunks, [&](size_t c, size_t) {
+    GateChunk &chunk = m_gateChunks[c];
+    chunk.candidates.clear();
+    chunk.predicted.clear();
+    chunk.pruned = 0;
+    size_t end = std::min(count, (c + 1) * GATE_CHUNK);
+    for (size_t i = c * GATE_CHUNK; i < end; ++i) {
+      const SensorConfig &sensor = m_sensors.Get(plots[i].sensorId);
+      BatchPlot &plot = m_batchPlots[i];
+      plot.x = plots[i].x + sensor.originX;
+      plot.y = plots[i].y + sensor.originY;
+      plot.timestamp = plots[i].timestamp;
+      plot.noise = &sensor.noise;
+      m_batchSensors[i] = plots[i].sensorId;
+      chunk.pruned += ForEachReachableTrack(
+          plot.x, plot.y, plot.timestamp, [&](TrackHandle handle, Track &) {
+            chunk.candidates.push_back({static_cast<uint32_t>(i), handle});
+            if (m_config.deterministic) {
+              return; // Rows are numbered below, in plot order
+            }
+            std::atomic_ref<uint32_t> mark(m_batchIndex[handle.index]);
+            uint32_t expected = NONE;
+            if (mark.compare_exchange_strong(expected, PREDICTED)) {
+              uint32_t row = m_gateRows.fetch_add(1);
+              m_gateOrder[row] = handle;
+              m_gateRow[handle.index] = row;
+              chunk.predicted.push_back(handle);
+            }
+          });
+    }
+  });
+  if (m_config.deterministic) {
+    // Number the table rows by each track's first candidate plot rather
+    // than by which task reached it first
+    uint32_t rows = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+      GateChunk &chunk = m_gateChunks[c];
+      for (const auto &candidate : chunk.candidates) {
+        TrackHandle handle = candidate.second;
+        if (m_batchIndex[handle.index] == NONE) {
+          m_batchIndex[handle.index] = PREDICTED;
+          m_gateRow[handle.index] = rows;
+          m_gateOrder[rows++] = handle;
+          chunk.predicted.push_back(handle);
+        }
+      }
+    }
+    m_gateRows = rows;
+  }
+  // Blocks of rows, so IMM tracks are extrapolated together in ImmBatch
+  size_t rows = m_gateRows;
+  m_workers->ParallelFor(
+      (rows + TRACK_CHUNK - 1) / TRACK_CHUNK, [&](size_t b, size_t) {
+        const Track *tracks[TRACK_CHUNK] = {};
+        size_t first = b * TRACK_CHUNK;
+        size_t n = std::min(TRACK_CHUNK, rows - first);
+        for (size_t i = 0; i < n; ++i) {
+          tracks[i] = m_pool.Get(m_gateOrder[first + i]);
+        }
+        Track::PredictBatch(tracks, n, gateTime);
+        for (size_t i = 0; i < n; ++i) {
+          m_gateTracks[first + i] = tracks[i]->PredictTo(gateTime);
+        }
+      });
+  m_workers->ParallelFor(chunks, [&](size_t c, size_t) {
+    // Each candidate pair against its track's table row
+    GateChunk &chunk = m_gateChunks[c];
+    chunk.pairs.clear();
+    for (const auto &candidate : chunk.candidates) {
+      BatchPlot &plot = m_batchPlots[candidate.first];
+      uint32_t slot = candidate.second.index;
+      float d2 = m_gateTracks[m_gateRow[slot]].MahalanobisDistance(
+          plot.x, plot.y, plot.timestamp, *plot.noise);
+      if (d2 < CHI_SQUARED_GATE) {
+        chunk.pairs.push_back(GatedPair{slot, candidate.first, d2});
+        plot.gated = true;
+      }
+    }
+  });
+
+  // Number the gated tracks densely, in plot order
+  m_gatedPairs.clear();
+  m_batchTracks.clear();
+  uint64_t candidates = 0;
+  uint64_t pruned = 0;
+  for (size_t c = 0; c < chunks; ++c) {
+    const GateChunk &chunk = m_gateChunks[c];
+    candidates += chunk.candidates.size();
+    pruned += chunk.pruned;
+    for (GatedPair pair : chunk.pairs) {
+      uint32_t &index = m_batchIndex[pair.track];
+      if (index == PREDICTED) {
+        index = static_cast<uint32_t>(m_batchTracks.size());
+        m_batchTracks.push_back(m_pool.HandleAt(pair.track));
+      }
+      pair.track = index;
+      m_gatedPairs.push_back(pair);
+    }
+  }
+  m_gateCandidatesCounter.Add(candidates);
+  m_motionPrunedCounter.Add(pruned);
+
+  // Clusters share no track, so each is solved on whichever worker picks
+  // it up, which also applies its late plots; only per-plot results are
+  // written
+  bool smoothing = m_smoother != nullptr;
+  if (smoothing) {
+    m_batchSamples.resize(count);
+  }
+  m_associator.Solve(
+      m_gatedPairs, m_batchTracks.size(), m_batchSensors, CHI_SQUARED_GATE,
+      m_workers.get(), [&](GatedPair *pairs, size_t assigned) {
+        // A track may take one plot per sensor: oldest first
+        std::sort(pairs, pairs + assigned,
+                  [&](const GatedPair &a, const GatedPair &b) {
+                    double ta = m_batchPlots[a.plot].timestamp;
+                    double tb = m_batchPlots[b.plot].timestamp;
+                    return ta != tb ? ta < tb : a.plot < b.plot;
+                  });
+        for (size_t k = 0; k < assigned; ++k) {
+          BatchPlot &plot = m_batchPlots[pairs[k].plot];
+          Track &track = *m_pool.Get(m_batchTracks[pairs[k].track]);
+          plot.assigned = true;
+          // Late plots sort first, so the in-sequence plots left for below
+          // cannot make one late
+          plot.late = plot.timestamp < track.GetStateTime();
+          if (plot.late) {
+            auto start = std::chrono::steady_clock::now();
+            plot.applied =
+                track.Update(plot.x, plot.y, plot.timestamp, *plot.noise);
+            m_lateUpdateDuration.Observe(
+                std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+          }
+        }
+      });
+
+  // In-sequence plots from every cluster, in blocks of tracks so IMM tracks
+  // are updated together in ImmBatch. A track's k-th plot goes in round k,
+  // so it still takes them oldest first.
+  m_updateRound.assign(m_batchTracks.size(), 0);
+  m_batchUpdates.clear();
+  bool repeated = false; // Some track takes more than one plot
+  m_associator.ForEachAssigned([&](const GatedPair &pair) {
+    if (!m_batchPlots[pair.plot].late) {
+      uint32_t round = m_updateRound[pair.track]++;
+      repeated = repeated || round > 0;
+      m_batchUpdates.push_back({round, pair});
+    }
+  });
+  if (repeated) {
+    std::stable_sort(m_batchUpdates.begin(), m_batchUpdates.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.first < b.first;
+                     });
+  }
+  for (size_t first = 0; first < m_batchUpdates.size();) {
+    size_t end = first;
+    while (end < m_batchUpdates.size() &&
+           m_batchUpdates[end].first == m_batchUpdates[first].first) {
+      ++end;
+    }
+    m_workers->ParallelFor(
+        (end - first + TRACK_CHUNK - 1) / TRACK_CHUNK, [&](size_t b, size_t) {
+          Track *tracks[TRACK_CHUNK] = {};
+          TrackPlot updates[TRACK_CHUNK];
+          size_t begin = first + b * TRACK_CHUNK;
+          size_t n = std::min(TRACK_CHUNK, end - begin);
+          for (size_t i = 0; i < n; ++i) {
+            const GatedPair &pair = m_batchUpdates[begin + i].second;
+            const BatchPlot &plot = m_batchPlots[pair.plot];
+            tracks[i] = m_pool.Get(m_batchTracks[pair.track]);
+            updates[i] = {plot.x, plot.y, plot.timestamp, *plot.noise};
+          }
+          Track::UpdateBatch(tracks, updates, n);
+          for (size_t i = 0; i < n; ++i) {
+            const GatedPair &pair = m_batchUpdates[begin + i].second;
+            BatchPlot &plot = m_batchPlots[pair.plot];
+            plot.applied = true;
+            plot.updated = tracks[i]->GetPosition();
+            if (smoothing) {
+              FillSample(*tracks[i], false, m_batchSamples[pair.plot]);
+            }
+          }
+        });
+    first = end;
+  }
+
+  size_t clusters = m_associator.GetClusterCount();
+  m_clustersCounter.Add(clusters);
+  for (size_t c = 0; c < clusters; ++c) {
+    size_t pairs = m_associator.GetClusterPairs(c);
+    m_clusterPairs.Observe(static_cast<double>(pairs));
+    if (pairs == 1) {
+      m_trivialClustersCounter.Add();
+    }
+  }
+
+  // Bookkeeping in cluster order, on this thread: the tentative heap, the
+  // smoother's queue and the trails are single-writer
+  m_associator.ForEachAssigned([&](const GatedPair &pair) {
+    const BatchPlot &plot = m_batchPlots[pair.plot];
+    TrackHandle handle = m_batchTracks[pair.track];
+    const Track &track = *m_pool.Get(handle);
+    if (plot.late) {
+      if (plot.applied) {
+        RefreshTentativeRank(handle, track);
+        m_associatedCounter.Add();
+        m_latePlotsCounter.Add();
+      } else {
+        m_lateDroppedCounter.Add();
+      }
+      return;
+    }
+    RefreshTentativeRank(handle, track);
+    m_associatedCounter.Add();
+    m_positionError.Add(
+        glm::distance(plot.updated, glm::vec2(plot.x, plot.y)));
+    if (smoothing) {
+      m_smoother->Submit(m_batchSamples[pair.plot]);
+    }
+    if (m_thinTrails) {
+      m_trailsSkippedCounter.Add();
+    } else {
+      m_history.Append(handle.index, plot.updated.x, plot.updated.y,
+                       plot.timestamp);
+    }
+  });
+  for (size_t c = 0; c < chunks; ++c) {
+    for (TrackHandle handle : m_gateChunks[c].predicted) {
+      m_batchIndex[handle.index] = NONE;
+    }
+  }
+
+  // Plots no track took start tracks, in arrival order. A track started
+  // here takes later plots that gate it, as under nearest neighbour, so a
+  // new target seen by two sensors starts one track.
+  size_t firstCreated = m_tracks.size();
+  uint32_t firstId = m_nextTrackId;
+  uint32_t lastId = firstId; // One past the last ID taken
+  uint32_t candidate = 0;    // Ungated plots so far
+  for (const BatchPlot &plot : m_batchPlots) {
+    if (plot.assigned) {
+      continue;
+    }
+    if (plot.gated) {
+      m_contestedCounter.Add();
+      continue;
+    }
+    // In deterministic mode an ID per ungated plot, whether or not it
+    // starts a track, so an ID depends only on the association and not on
+    // what the initiator, the region or eviction made of the plots before
+    uint32_t id = firstId + candidate++;
+    if (m_config.deterministic) {
+      m_nextTrackId = id;
+    }
+    if (!JoinNewTrack(plot.x, plot.y, plot.timestamp, *plot.noise, gateTime,
+                      firstCreated)) {
+      InitiateFromPlot(plot.x, plot.y, plot.timestamp, *plot.noise);
+    }
+    if (m_config.deterministic && m_nextTrackId != id) {
+      lastId = m_nextTrackId; // The plot started a track
+    }
+  }
+  if (m_config.deterministic) {
+    // Reserved up to the last ID taken, so scans that start nothing spend
+    // none
+    m_nextTrackId = lastId;
+  }
+}
+
+void TrackManager::AssociateFrames(const Plot *plots, size_t count,
+                                   double gateTime) {
+  // A sensor sees a target at most once per scan, so its plots form one
+  // frame in which a track takes at most one plot
+  m_framePlots.assign(plots, plots + count);
+  std::stable_sort(m_framePlots.begin(), m_framePlots.end(),
+                   [](const Plot &a, const Plot &b) {
+                     return a.sensorId < b.sensorId;
+                   });
+  for (size_t first = 0; first < count;) {
+    size_t last = first + 1;
+    while (last < count &&
+           m_framePlots[last].sensorId == m_framePlots[first].sensorId) {
+      ++last;
+    }
+    AssociateHypotheses(m_framePlots.data() + first, last - first, gateTime);
+    first = last;
+  }
+}
+
+void TrackManager::AssociateHypotheses(const Plot *plots, size_t count,
+                                       double gateTime) {
+  m_plotsCounter.Add(count);
+  m_hypotheses.BeginFrame();
+
+  // Gate each plot against every branch of the tracks within its motion
+  // bound. A track with no branches is its own only branch. A pair keeps
+  // the branch that scores best with the plot.
+  m_batchPlots.assign(count, BatchPlot());
+  if (m_batchIndex.size() < m_pool.Capacity()) {
+    m_batchIndex.resize(m_pool.Capacity(), NONE);
+  }
+  m_gatedPairs.clear();
+  m_pairParents.clear();
+  m_batchTracks.clear();
+  uint64_t candidates = 0;
+  uint64_t pruned = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const SensorConfig &sensor = m_sensors.Get(plots[i].sensorId);
+    BatchPlot &plot = m_batchPlots[i];
+    plot.x = plots[i].x + sensor.originX;
+    plot.y = plots[i].y + sensor.originY;
+    plot.timestamp = plots[i].timestamp;
+    plot.noise = &sensor.noise;
+    pruned += ForEachReachableTrack(
+        plot.x, plot.y, plot.timestamp, [&](TrackHandle handle, Track &track) {
+          candidates++;
+          float best = -std::numeric_limits<float>::infinity();
+          uint32_t parent = 0;
+          auto gate = [&](const TrackPrediction &prediction, float score,
+                          uint32_t branch) {
+            float d2 = prediction.MahalanobisDistance(
+                plot.x, plot.y, plot.timestamp, *plot.noise);
+            if (d2 < CHI_SQUARED_GATE) {
+              score += m_hypotheses.PlotScore(prediction, *plot.noise, d2);
+              if (score > best) {
+                best = score;
+                parent = branch;
+              }
+            }
+          };
+          size_t held = 0;
+          const HypothesisBranch *branches =
+              m_hypotheses.Branches(handle, held);
+          if (held == 0) {
+            gate(track.PredictTo(gateTime), 0.0f, 0);
+          }
+          for (size_t b = 0; b < held; ++b) {
+            gate(branches[b].PredictTo(gateTime), branches[b].score,
+                 static_cast<uint32_t>(b));
+          }
+          if (best == -std::numeric_limits<float>::infinity()) {
+            return; // No branch gates it
+          }
+          uint32_t &index = m_batchIndex[handle.index];
+          if (index == NONE) {
+            index = static_cast<uint32_t>(m_batchTracks.size());
+            m_batchTracks.push_back(handle);
+          }
+          m_gatedPairs.push_back(GatedPair{index, static_cast<uint32_t>(i),
+                                           m_hypotheses.MissScore() - best});
+          m_pairParents.push_back(parent);
+          plot.gated = true;
+        });
+  }
+  m_gateCandidatesCounter.Add(candidates);
+  m_motionPrunedCounter.Add(pruned);
+  for (TrackHandle handle : m_batchTracks) {
+    m_batchIndex[handle.index] = NONE;
+  }
+
+  m_hypotheses.Select(m_gatedPairs, m_pairParents, m_batchTracks, count,
+                      m_branchChoices);
+
+  // Build each track's kept branches and keep them if there is more than
+  // one. The track follows its best: updated with the plot in place while
+  // the best continues the branch it already holds, replaced by another
+  // branch's estimate when the best moves. Only confirmed tracks branch: a
+  // tentative one revised into retroactive hits could outlive the target
+  // it duplicates.
+  for (size_t first = 0; first < m_branchChoices.size();) {
+    uint32_t target = m_branchChoices[first].target;
+    size_t last = first + 1;
+    while (last < m_branchChoices.size() &&
+           m_branchChoices[last].target == target) {
+      ++last;
+    }
+    TrackHandle handle = m_batchTracks[target];
+    Track &track = *m_pool.Get(handle);
+    size_t kept = track.GetState() == TrackState::CONFIRMED ? last - first : 1;
+    size_t held = 0;
+    const HypothesisBranch *branches = m_hypotheses.Branches(handle, held);
+    if (held == 0) {
+      HypothesisForest::FromTrack(track, m_rootBranch);
+      branches = &m_rootBranch;
+    }
+    m_newBranches.resize(kept);
+    for (size_t c = first; c < first + kept; ++c) {
+      const BranchChoice &choice = m_branchChoices[c];
+      HypothesisBranch &branch = m_newBranches[c - first];
+      HypothesisForest::Extend(branches[choice.parent], choice.plot, branch);
+      branch.score = choice.score - m_branchChoices[first].score;
+      if (branch.hit) {
+        // A plot older than the branch is applied at the branch's time
+        const BatchPlot &plot = m_batchPlots[choice.plot];
+        double dt = plot.timestamp - branch.stateTime;
+        if (dt > 0.0001) {
+          branch.filter.Predict(static_cast<float>(dt));
+          branch.stateTime = plot.timestamp;
+        }
+        branch.filter.Update(plot.x, plot.y, plot.noise->xx, plot.noise->xy,
+                             plot.noise->yy);
+      }
+    }
+
+    const BranchChoice &best = m_branchChoices[first];
+    const HypothesisBranch &chosen = m_newBranches[0];
+    if (best.parent != 0) {
+      m_hypotheses.CountReversal();
+      track.Adopt(chosen.filter, chosen.stateTime, chosen.hit);
+      if (chosen.hit) {
+        const BatchPlot &plot = m_batchPlots[best.plot];
+        RecordUpdate(handle, track, plot.x, plot.y, plot.timestamp);
+      } else {
+        RefreshTentativeRank(handle, track);
+      }
+    } else if (chosen.hit) {
+      const BatchPlot &plot = m_batchPlots[best.plot];
+      if (plot.timestamp < track.GetStateTime()) {
+        ApplyLateUpdate(handle, track, plot.x, plot.y, plot.timestamp,
+                        *plot.noise);
+      } else {
+        ApplyUpdate(handle, track, plot.x, plot.y, plot.timestamp,
+                    *plot.noise);
+      }
+    }
+    if (chosen.hit) {
+      m_batchPlots[best.plot].assigned = true;
+    }
+
+    if (kept == 1) {
+      m_hypotheses.Collapse(handle);
+    } else if (HypothesisBranch *stored = m_hypotheses.Store(handle, kept)) {
+      std::copy(m_newBranches.begin(), m_newBranches.end(), stored);
+    }
+    first = last;
+  }
+  m_hypotheses.EndFrame(m_pool);
+
+  // Plots the best hypotheses call clutter or new start tracks if no
+  // track gated them
+  for (const BatchPlot &plot : m_batchPlots) {
+    if (plot.assigned) {
+      continue;
+    }
+    if (plot.gated) {
+      m_contestedCounter.Add();
+      continue;
+    }
+    InitiateFromPlot(plot.x, plot.y, plot.timestamp, *plot.noise);
+  }
+}
+
+void TrackManager::SubmitToSmoother(const Track &track, bool deleted) {
+  if (!m_smoother) {
+    return;
+  }
+  FilterSample sample;
+  FillSample(track, deleted, sample);
+  m_smoother->Submit(sample);
+}
+
+void TrackManager::FillSample(const Track &track, bool deleted,
+                              FilterSample &sample) {
+  sample.trackId = track.GetId();
+  sample.deleted = deleted;
+  sample.time = track.GetStateTime();
+  if (!deleted) {
+    track.GetFilterState(sample.state.data(), sample.covariance.data());
+  }
+}
+
+void TrackManager::DropTrack(TrackHandle handle) {
+  m_tentativeRank.Remove(handle.index);
+  SubmitToSmoother(*m_pool.Get(handle), true);
+  m_pool.Destroy(handle);
+}
+
+size_t TrackManager::ReleaseTracks(
+    const std::function<bool(glm::vec2)> &leaving,
+    std::vector<TrackRecord> &out) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t released = 0;
+  m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(),
+                                [&](TrackHandle handle) {
+                                  const Track *track = m_pool.Get(handle);
+                                  if (!track) {
+                                    return true; // Stale; compact
+                                  }
+                                  if (!leaving(track->GetPosition())) {
+                                    return false;
+                                  }
+                                  out.emplace_back();
+                                  track->Export(out.back());
+                                  DropTrack(handle);
+                                  released++;
+                                  return true;
+                                }),
+                 m_tracks.end());
+  m_handedOverCounter.Add(released);
+  return released;
+}
+
+template <typename Visit>
+void TrackManager::ForEachGatedTrack(const RemoteTrack &estimate,
+                                     Visit &&visit) {
+  auto consider = [&](TrackHandle handle) {
+    const Track *track = m_pool.Get(handle);
+    if (!track) {
+      return;
+    }
+    double elapsed = std::abs(estimate.time - track->GetStateTime());
+    float reach = m_config.maxTargetSpeed * static_cast<float>(elapsed) +
+                  m_config.gateMargin;
+    glm::vec2 offset = track->GetPosition() - estimate.position;
+    if (glm::dot(offset, offset) > reach * reach) {
+      return;
+    }
+    // Both estimates are uncertain: gate on S = P_local + P_remote, with
+    // whichever is older carried forward to the other's epoch
+    double time = std::max(estimate.time, track->GetStateTime());
+    RemoteTrack remote = estimate.PredictTo(time);
+    const TrackPrediction &prediction = track->PredictTo(time);
+    float d2 = prediction.MahalanobisDistance(remote.position.x,
+                                              remote.position.y, time,
+                                              remote.PositionCovariance());
+    if (d2 < CHI_SQUARED_GATE) {
+      visit(handle, d2);
+    }
+  };
+
+  if (m_grid.Size() > 0) {
+    double elapsed = std::max(estimate.time - m_gridOldestState,
+                              m_gridNewestState - estimate.time);
+    float radius =
+        m_config.maxTargetSpeed * static_cast<float>(std::max(elapsed, 0.0)) +
+        m_config.gateMargin;
+    m_grid.Query(estimate.position.x, estimate.position.y, radius,
+                 [&](uint32_t slot, float, float) {
+                   consider(m_pool.HandleAt(slot));
+                 });
+  }
+  for (TrackHandle handle : m_newTracks) {
+    consider(handle);
+  }
+}
+
+TrackHandle TrackManager::FindDuplicate(const TrackRecord &record) {
+  TrackHandle best;
+  float minDist = std::numeric_limits<float>::max();
+  ForEachGatedTrack(MakeRemoteTrack(record, 0),
+                    [&](TrackHandle handle, float d2) {
+                      if (d2 < minDist) {
+                        minDist = d2;
+                        best = handle;
+                      }
+                    });
+  return best;
+}
+
+size_t TrackManager::FuseRemoteTracks(const std::vector<RemoteTrack> &tracks) {
+  if (tracks.empty()) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_remoteTracksCounter.Add(tracks.size());
+  RebuildSpatialIndex();
+
+  // Forget links to tracks that have since been deleted
+  for (auto it = m_remoteLinks.begin(); it != m_remoteLinks.end();) {
+    it = m_pool.Get(it->second) ? std::next(it) : m_remoteLinks.erase(it);
+  }
+
+  auto key = [](uint16_t source, uint32_t value) {
+    return (static_cast<uint64_t>(source) << 32) | value;
+  };
+
+  // Every gated pair; a remote track's current link goes ahead of any
+  // cheaper newcomer so the association does not flip between near ties
+  m_fusionPairs.clear();
+  for (size_t r = 0; r < tracks.size(); ++r) {
+    auto link = m_remoteLinks.find(key(tracks[r].source, tracks[r].id));
+    ForEachGatedTrack(tracks[r], [&](TrackHandle handle, float d2) {
+      bool linked = link != m_remoteLinks.end() && link->second == handle;
+      m_fusionPairs.push_back({r, handle, linked ? -1.0f : d2});
+    });
+  }
+  std::sort(m_fusionPairs.begin(), m_fusionPairs.end(),
+            [](const FusionPair &a, const FusionPair &b) {
+              return a.cost < b.cost;
+            });
+
+  // Greedy one-to-one per source: a local track takes at most one report
+  // from each remote tracker, but may fuse several trackers' reports
+  m_remoteTaken.assign(tracks.size(), false);
+  m_localTaken.clear();
+  size_t fused = 0;
+  for (const FusionPair &pair : m_fusionPairs) {
+    const RemoteTrack &remote = tracks[pair.remote];
+    uint64_t local = key(remote.source, pair.local.index);
+    if (m_remoteTaken[pair.remote] || m_localTaken.count(local)) {
+      continue;
+    }
+    m_remoteTaken[pair.remote] = true;
+    m_localTaken.insert(local);
+
+    Track &track = *m_pool.Get(pair.local);
+    RemoteTrack common =
+        remote.PredictTo(std::max(remote.time, track.GetStateTime()));
+    if (track.Fuse(common) < 0.0f) {
+      continue; // Degenerate covariance: counted as unmatched
+    }
+    m_hypotheses.Collapse(pair.local); // Its branches predate the fusion
+    m_remoteLinks[key(remote.source, remote.id)] = pair.local;
+    fused++;
+  }
+  m_remoteFusedCounter.Add(fused);
+  m_remoteUnmatchedCounter.Add(tracks.size() - fused);
+  return fused;
+}
+
+size_t TrackManager::ExportRemoteTracks(uint16_t source,
+                                        std::vector<RemoteTrack> &out) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t exported = 0;
+  TrackRecord record;
+  for (TrackHandle handle : m_tracks) {
+    const Track *track = m_pool.Get(handle);
+    if (!track || track->GetState() == TrackState::TENTATIVE) {
+      continue;
+    }
+    track->Export(record);
+    out.push_back(MakeRemoteTrack(record, source));
+    exported++;
+  }
+  return exported;
+}
+
+void TrackManager::InsertTrack(const TrackRecord &record) {
+  TrackHandle handle = m_pool.Create(record);
+  const Track &track = *m_pool.Get(handle);
+  glm::vec2 position = track.GetPosition();
+  m_history.EnsureSlots(m_pool.Capacity());
+  m_history.Reset(handle.index, position.x, position.y, record.lastUpdate);
+  m_tentativeRank.Reserve(m_pool.Capacity());
+  RefreshTentativeRank(handle, track);
+  SubmitToSmoother(track, false);
+  m_tracks.push_back(handle);
+  m_newTracks.push_back(handle);
+}
+
+size_t TrackManager::AdoptTracks(const std::vector<TrackRecord> &records) {
+  if (records.empty()) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  RebuildSpatialIndex();
+  size_t adopted = 0;
+  for (const TrackRecord &record : records) {
+    TrackHandle duplicate = FindDuplicate(record);
+    if (duplicate.IsValid()) {
+      m_duplicateCounter.Add();
+      if (m_pool.Get(duplicate)->GetHitCount() >= record.hitCount) {
+        continue; // The local track is the better of the two
+      }
+      DropTrack(duplicate);
+    }
+    if (!MakeRoomForNewTrack()) {
+      m_shedCounter.Add();
+      continue;
+    }
+
+    InsertTrack(record);
+    adopted++;
+  }
+  m_adoptedCounter.Add(adopted);
+  return adopted;
+}
+
+void TrackManager::CaptureCheckpoint(TrackCheckpoint &out) const {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out.nextTrackId = m_nextTrackId;
+    size_t count = 0;
+    for (TrackHandle handle : m_tracks) {
+      if (const Track *track = m_pool.Get(handle)) {
+        if (count == out.tracks.size()) {
+          out.tracks.emplace_back();
+        }
+        track->Export(out.tracks[count++]);
+      }
+    }
+    out.tracks.resize(count);
+  }
+
+  // Counters are read lock-free, after the tracks
+  out.counters.clear();
+  for (const MetricSample &sample : m_registry.Snapshot()) {
+    if (sample.type == MetricType::COUNTER) {
+      out.counters.emplace_back(sample.name,
+                                static_cast<uint64_t>(sample.value));
+    }
+  }
+}
+
+size_t TrackManager::RestoreCheckpoint(const TrackCheckpoint &checkpoint,
+                                       double resumeTime) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (TrackHandle handle : m_tracks) {
+    if (m_pool.Get(handle)) {
+      DropTrack(handle);
+    }
+  }
+  m_tracks.clear();
+  m_newTracks.clear();
+  m_remoteLinks.clear();
+  m_nextTrackId = std::max(m_nextTrackId, checkpoint.nextTrackId);
+
+  // A checkpoint from the future (the clock stepped back) moves back whole
+  double outage = resumeTime - checkpoint.scanTime;
+  size_t restored = 0;
+  for (TrackRecord record : checkpoint.tracks) {
+    record.lastUpdate += outage;
+    if (outage < 0.0) {
+      record.stateTime += outage;
+    }
+    if (!MakeRoomForNewTrack()) {
+      m_shedCounter.Add();
+      continue;
+    }
+    InsertTrack(record);
+    restored++;
+  }
+
+  for (const auto &counter : checkpoint.counters) {
+    if (Counter *target = m_registry.FindCounter(counter.first)) {
+      target->Add(counter.second);
+    }
   }
+  return restored;
 }
 
 void TrackManager::IncrementMissedTracks(double currentTime) {
   std::lock_guard<std::mutex> lock(m_mutex);
 
   // Increment miss count for all tracks (will be reset when associated)
-  for (auto &track : m_tracks) {
-    track->IncrementMissCount(currentTime);
+  for (TrackHandle handle : m_tracks) {
+    if (Track *track = m_pool.Get(handle)) {
+      track->IncrementMissCount(currentTime);
+      RefreshTentativeRank(handle, *track);
+    }
   }
 }
 
@@ -71,59 +1180,277 @@ void TrackManager::PruneTracks(double currentTime) {
   m_tracks.erase(
       std::remove_if(
           m_tracks.begin(), m_tracks.end(),
-          [currentTime, this](const std::shared_ptr<Track> &track) {
+          [currentTime, this](TrackHandle handle) {
+            const Track *track = m_pool.Get(handle);
+            if (!track) {
+              return true; // Already evicted; compact the stale handle
+            }
+            bool expired = false;
+
             // Delete TENTATIVE tracks that haven't confirmed after timeout
             if (track->GetState() == TrackState::TENTATIVE &&
                 (currentTime - track->GetLastUpdate()) > TIMEOUT_THRESHOLD) {
-              return true;
+              expired = true;
             }
 
             // Delete COASTING tracks after max consecutive misses
             if (track->GetState() == TrackState::COASTING &&
                 track->GetMissCount() >= 5) {
-              return true;
+              expired = true;
             }
 
             // Standard timeout for all tracks
-            return (currentTime - track->GetLastUpdate()) > TIMEOUT_THRESHOLD;
+            if ((currentTime - track->GetLastUpdate()) > TIMEOUT_THRESHOLD) {
+              expired = true;
+            }
+
+            // Return the slot (and its history storage) to the pool
+            if (expired) {
+              m_tentativeRank.Remove(handle.index);
+              SubmitToSmoother(*track, true);
+              m_pool.Destroy(handle);
+              m_deletedCounter.Add();
+            }
+            return expired;
           }),
       m_tracks.end());
 }
 
-std::vector<std::shared_ptr<Track>> TrackManager::GetTracks() const {
+void TrackManager::ProcessScan(const std::vector<Plot> &plots,
+                               double scanTime) {
+  // Only scans that carried detections count as misses for silent tracks;
+  // associated tracks reset their miss count in Track::Update
+  if (!plots.empty()) {
+    IncrementMissedTracks(scanTime);
+  }
+
+  if (m_scheduler.Enabled()) {
+    ScheduleScan(plots, scanTime);
+  } else if (!plots.empty()) {
+    // One gate time per scan, so each track is predicted at most once
+    double gateTime = plots.front().timestamp;
+    for (const auto &plot : plots) {
+      gateTime = std::max(gateTime, plot.timestamp);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      RebuildSpatialIndex();
+      m_candidatesExpiredCounter.Add(m_initiator.BeginScan(scanTime));
+    }
+    if (m_config.association != AssociationMode::NEAREST_NEIGHBOUR) {
+      for (const auto &plot : plots) {
+        if (!m_sensors.Contains(plot.sensorId)) {
+          m_unknownSensorCounter.Add();
+        }
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_config.association == AssociationMode::GLOBAL) {
+        AssociateBatch(plots.data(), plots.size(), gateTime);
+      } else {
+        AssociateFrames(plots.data(), plots.size(), gateTime);
+      }
+    } else {
+      for (const auto &plot : plots) {
+        if (!m_sensors.Contains(plot.sensorId)) {
+          m_unknownSensorCounter.Add();
+        }
+        const SensorConfig &sensor = m_sensors.Get(plot.sensorId);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        AssociatePlot(plot.x + sensor.originX, plot.y + sensor.originY,
+                      plot.timestamp, gateTime, sensor.noise);
+      }
+    }
+  }
+
+  PruneTracks(scanTime);
+  if (m_scheduler.RefreshMetrics()) {
+    UpdateMetrics();
+  }
+}
+
+void TrackManager::ScheduleScan(const std::vector<Plot> &plots,
+                                double scanTime) {
+  const std::vector<Plot> &carried = m_scheduler.BeginScan(scanTime);
+  if (plots.empty() && carried.empty()) {
+    return;
+  }
+  double gateTime = std::numeric_limits<double>::lowest();
+  for (const auto &plot : plots) {
+    gateTime = std::max(gateTime, plot.timestamp);
+  }
+  for (const auto &plot : carried) {
+    gateTime = std::max(gateTime, plot.timestamp);
+  }
+
+  {
+    // Deferred plots are judged again against this scan's tracks
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RebuildSpatialIndex();
+    m_candidatesExpiredCounter.Add(m_initiator.BeginScan(scanTime));
+    for (const auto &plot : carried) {
+      m_scheduler.Add(plot, ClassifyPlot(plot));
+    }
+    for (const auto &plot : plots) {
+      if (!m_sensors.Contains(plot.sensorId)) {
+        m_unknownSensorCounter.Add();
+      }
+      m_scheduler.Add(plot, ClassifyPlot(plot));
+    }
+  }
+
+  m_scheduler.Run([&](const Plot *batch, size_t count) {
+    if (m_config.association != AssociationMode::NEAREST_NEIGHBOUR) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_thinTrails = m_scheduler.OverBudget();
+      if (m_config.association == AssociationMode::GLOBAL) {
+        AssociateBatch(batch, count, gateTime);
+      } else {
+        AssociateFrames(batch, count, gateTime);
+      }
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const Plot &plot = batch[i];
+      const SensorConfig &sensor = m_sensors.Get(plot.sensorId);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_thinTrails = m_scheduler.OverBudget();
+      AssociatePlot(plot.x + sensor.originX, plot.y + sensor.originY,
+                    plot.timestamp, gateTime, sensor.noise);
+    }
+  });
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_thinTrails = false;
+}
+
+PlotPriority TrackManager::ClassifyPlot(const Plot &plot) {
+  const SensorConfig &sensor = m_sensors.Get(plot.sensorId);
+  PlotPriority priority = PlotPriority::INITIATION;
+  ForEachReachableTrack(
+      plot.x + sensor.originX, plot.y + sensor.originY, plot.timestamp,
+      [&](TrackHandle, const Track &track) {
+        PlotPriority near = PlotPriority::TENTATIVE;
+        if (track.GetState() == TrackState::CONFIRMED &&
+            track.IsManoeuvring()) {
+          near = PlotPriority::MANOEUVRING;
+        } else if (track.GetState() != TrackState::TENTATIVE) {
+          near = PlotPriority::ESTABLISHED;
+        }
+        priority = std::min(priority, near);
+      });
+  // Ranged from the sensor, in its own frame
+  float range = m_scheduler.GetConfig().farRange;
+  if (priority == PlotPriority::INITIATION && range > 0.0f &&
+      plot.x * plot.x + plot.y * plot.y > range * range) {
+    priority = PlotPriority::FAR_CLUTTER;
+  }
+  return priority;
+}
+
+void TrackManager::FillSnapshot(TrackSnapshot &out, size_t maxHistoryPerTrack,
+                                float trailResolution,
+                                double predictTo) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  out.tracks.reserve(m_tracks.size());
+  for (TrackHandle handle : m_tracks) {
+    const Track *track = m_pool.Get(handle);
+    if (!track) {
+      continue;
+    }
+
+    // Level-of-detail read straight into the snapshot's flat trail buffer
+    size_t offset = out.history.size();
+    out.history.resize(offset + maxHistoryPerTrack);
+    size_t count = m_history.Query(handle.index, trailResolution,
+                                   out.history.data() + offset,
+                                   maxHistoryPerTrack);
+    out.history.resize(offset + count);
+
+    TrackView view;
+    view.id = track->GetId();
+    view.state = track->GetState();
+    if (predictTo != kNoPrediction) {
+      const TrackPrediction &prediction = track->PredictTo(predictTo);
+      view.position = prediction.position;
+      view.velocity = prediction.velocity;
+    } else {
+      view.position = track->GetPosition();
+      view.velocity = track->GetVelocity();
+    }
+    view.hitCount = track->GetHitCount();
+    view.missCount = track->GetMissCount();
+    view.lastUpdate = track->GetLastUpdate();
+    view.historyOffset = static_cast<uint32_t>(offset);
+    view.historyCount = static_cast<uint32_t>(count);
+    out.tracks.push_back(view);
+  }
+
+  out.metrics = GetMetrics();
+}
+
+size_t TrackManager::GetTrackCount() const {
   std::lock_guard<std::mutex> lock(m_mutex);
-  return m_tracks;
+  return m_pool.Size();
 }
 
 void TrackManager::UpdateMetrics() {
   std::lock_guard<std::mutex> lock(m_mutex);
 
   // Count tracks by state
-  m_metrics.totalTracks = static_cast<int>(m_tracks.size());
-  m_metrics.confirmedTracks = 0;
-  m_metrics.tentativeTracks = 0;
-  m_metrics.coastingTracks = 0;
-
-  for (const auto &track : m_tracks) {
+  int confirmed = 0;
+  int tentative = 0;
+  int coasting = 0;
+  for (TrackHandle handle : m_tracks) {
+    const Track *track = m_pool.Get(handle);
+    if (!track) {
+      continue;
+    }
     switch (track->GetState()) {
     case TrackState::CONFIRMED:
-      m_metrics.confirmedTracks++;
+      confirmed++;
       break;
     case TrackState::TENTATIVE:
-      m_metrics.tentativeTracks++;
+      tentative++;
       break;
     case TrackState::COASTING:
-      m_metrics.coastingTracks++;
+      coasting++;
       break;
     }
   }
 
-  // Track deletion detection
-  if (m_tracks.size() < static_cast<size_t>(m_previousTrackCount)) {
-    m_metrics.tracksDeleted +=
-        (m_previousTrackCount - static_cast<int>(m_tracks.size()));
-  }
-  m_previousTrackCount = static_cast<int>(m_tracks.size());
+  m_totalGauge.Set(static_cast<double>(m_pool.Size()));
+  m_confirmedGauge.Set(confirmed);
+  m_tentativeGauge.Set(tentative);
+  m_coastingGauge.Set(coasting);
+  m_candidatesGauge.Set(static_cast<double>(m_initiator.GetCandidateCount()));
+
+  uint64_t plots = m_plotsCounter.Value();
+  m_associationRateGauge.Set(
+      plots > 0 ? static_cast<double>(m_associatedCounter.Value()) / plots
+                : 0.0);
+}
+
+TrackingMetrics TrackManager::GetMetrics() const {
+  TrackingMetrics metrics;
+  metrics.totalTracks = static_cast<int>(m_totalGauge.Value());
+  metrics.confirmedTracks = static_cast<int>(m_confirmedGauge.Value());
+  metrics.tentativeTracks = static_cast<int>(m_tentativeGauge.Value());
+  metrics.coastingTracks = static_cast<int>(m_coastingGauge.Value());
+
+  metrics.totalPlots = m_plotsCounter.Value();
+  metrics.associatedPlots = m_associatedCounter.Value();
+  metrics.newTracks = m_createdCounter.Value();
+  metrics.tracksCreated = metrics.newTracks;
+  metrics.tracksDeleted = m_deletedCounter.Value();
+  metrics.tracksEvicted = m_evictedCounter.Value();
+  metrics.plotsDroppedAtCapacity = m_shedCounter.Value();
+
+  StatSnapshot error = m_positionError.Snapshot();
+  metrics.avgPositionError = error.mean;
+  metrics.positionErrorStdDev = std::sqrt(error.variance);
+  metrics.positionErrorSamples = error.count;
+  return metrics;
 }
 
 } // namespace aegis
@@ -1,42 +1,404 @@
 #pragma once
 
+#include "Association.h"
+#include "Checkpoint.h"
+#include "FixedLagSmoother.h"
+#include "IndexedHeap.h"
+#include "MetricsRegistry.h"
+#include "MultiHypothesis.h"
+#include "Partition.h"
 #include "PerformanceMetrics.h"
+#include "Protocol.h"
+#include "ScanScheduler.h"
+#include "SensorRegistry.h"
+#include "SpatialGrid.h"
 #include "Track.h"
+#include "TrackInitiator.h"
+#include "TrackHistory.h"
+#include "TrackFusion.h"
+#include "TrackPool.h"
+#include "ThreadPool.h"
+#include "TrackSnapshot.h"
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 
 namespace aegis {
 
+enum class AssociationMode {
+  NEAREST_NEIGHBOUR, // Plot by plot, each to the nearest gating track
+  GLOBAL,            // Whole scan, one-to-one per sensor, by clusters
+  MHT                // Several hypotheses per track, decided frames later
+};
+
+struct TrackManagerConfig {
+  size_t initialCapacity = 256;      // Track pool slots allocated up front
+  size_t maxTracks = 20000;          // Hard cap on live tracks
+  size_t maxTentativeTracks = 10000; // Hard cap on unconfirmed tracks
+  TrackFilterModel filterModel = TrackFilterModel::EKF; // For new tracks
+
+  // Gating pre-filter: a track can only gate a plot within
+  // maxTargetSpeed * |plot time - track state time| + gateMargin of its
+  // last estimate, so farther tracks are skipped before being predicted
+  float maxTargetSpeed = 1000.0f; // m/s
+  float gateMargin = 1000.0f;     // m, covers plot noise and track error
+  float gridCellSize = 2000.0f;   // m, spatial index cell
+
+  // GLOBAL association gates a whole scan before updating any track, then
+  // assigns each sensor's plots to tracks one-to-one at minimum total
+  // distance (see ClusterAssociator), solving independent clusters and
+  // applying their updates on associationThreads threads (0 = one per
+  // core). A plot that gates a track but loses it starts no track.
+  AssociationMode association = AssociationMode::NEAREST_NEIGHBOUR;
+  size_t associationThreads = 0;
+  // MHT association takes each sensor's plots of a scan as one frame and
+  // lets an ambiguous track keep several branches, one per plausible
+  // assignment sequence, until later plots settle it (see
+  // HypothesisForest). The best branch is the track's estimate; a switch
+  // to another branch replaces it. Runs on the tracker thread.
+  MhtConfig mht;
+
+  // Out-of-sequence plots: each track keeps this many checkpoints, and a
+  // plot older than its track is applied by rerunning from them. Plots
+  // older than the window (or any late plot, at 0) are dropped. Costs
+  // Track::CheckpointBytes() per checkpoint per pool slot.
+  size_t oosmDepth = 4;
+
+  // Start tracks from two plots paired across scans rather than from every
+  // unassociated plot; see TrackInitiator
+  bool twoPointInitiation = true;
+  TrackInitiatorConfig initiator;
+  TrackHistoryConfig history;
+
+  // Per-scan time budget and load shedding under overload; off by default
+  ScanSchedulerConfig scheduler;
+
+  // Deterministic mode, for replays that must reproduce a run bit for bit:
+  // tracks and metrics depend only on the plots and scan times given. The
+  // thread count never matters: gate table rows are numbered in plot
+  // order, clusters are solved independently, floating-point metrics are
+  // recorded on the calling thread in plot or cluster order, and a new
+  // track's ID is keyed to its plot's rank among the scan's ungated plots
+  // (each scan reserves one ID per such plot).
+  // This turns off the one wall-clock input, the scheduler's deadline,
+  // which is charged scheduler.plotCost per plot instead. Histograms of
+  // durations still measure real time.
+  bool deterministic = false;
+
+  // Sensors besides the default sensor 0: each plot is moved from its
+  // sensor's frame to the common one and filtered with its sensor's noise
+  std::vector<SensorConfig> sensors;
+
+  // Partitioned deployments: plots outside this region update tracks but
+  // never start one, and track IDs count up from firstTrackId so nodes
+  // never reuse each other's
+  Region initiationRegion;
+  uint32_t firstTrackId = 1;
+};
+
 class TrackManager {
 public:
-  TrackManager();
+  explicit TrackManager(const TrackManagerConfig &config = TrackManagerConfig());
 
+  // A single plot from the default sensor
   void ProcessPlot(uint32_t plotId, float x, float y, double timestamp);
   void PruneTracks(double currentTime);
   void IncrementMissedTracks(double currentTime); // Mark tracks with no association
 
-  // Thread-safe access for rendering
-  std::vector<std::shared_ptr<Track>> GetTracks() const;
+  // One scan: associate all plots, age unassociated tracks, prune, and
+  // refresh metrics. Tracks are predicted lazily: only those that pass the
+  // spatial index and motion bound for some plot are predicted, once per
+  // scan, to the newest plot time in the batch. Each plot is gated and
+  // applied with its sensor's noise, after its sensor's origin offset.
+  // With a scheduler budget, plots are taken in priority order (see
+  // ScanScheduler) together with those deferred by earlier scans.
+  void ProcessScan(const std::vector<Plot> &plots, double scanTime);
+
+  // Copy the current picture into `out`, with trails merged to
+  // `trailResolution` metres and capped at `maxHistoryPerTrack` points.
+  // With `predictTo` set, positions and velocities are extrapolated to
+  // that time rather than reported at each track's last update.
+  // Consumers read snapshots, never Tracks.
+  void FillSnapshot(TrackSnapshot &out, size_t maxHistoryPerTrack,
+                    float trailResolution = 0.0f,
+                    double predictTo = kNoPrediction) const;
 
-  // Performance metrics
-  const TrackingMetrics &GetMetrics() const { return m_metrics; }
+  static constexpr double kNoPrediction = -1.0;
+
+  // Performance metrics, aggregated from the registry on each call. Safe
+  // from any thread and never takes the tracker lock.
+  TrackingMetrics GetMetrics() const;
   void UpdateMetrics(); // Call periodically to update track state counts
 
+  // Registry behind GetMetrics(); other stages register their own metrics
+  // here so exporters see a single set
+  MetricsRegistry &GetMetricsRegistry() { return m_registry; }
+  const MetricsRegistry &GetMetricsRegistry() const { return m_registry; }
+
+  // Hand every in-sequence filter update, and every track deletion, to
+  // `smoother` (null to stop). Submission never blocks. Set before
+  // processing starts; the manager does not own it.
+  void SetSmoother(SmootherWorker *smoother) { m_smoother = smoother; }
+
+  // Handover out: export every track whose position satisfies `leaving`
+  // into `out` (appended) and delete it here. Returns the number released.
+  size_t ReleaseTracks(const std::function<bool(glm::vec2)> &leaving,
+                       std::vector<TrackRecord> &out);
+  // Handover in: take over tracks released by another tracker. A local
+  // track that gates with an incoming one (same target seen on both sides
+  // of an overlap) is a duplicate: the pair keeps whichever has more hits.
+  // Returns the number adopted.
+  size_t AdoptTracks(const std::vector<TrackRecord> &records);
+
+  // Track-to-track fusion in: each remote track is gated against the local
+  // tracks on position (S = P_local + P_remote, at the later of the two
+  // epochs) and the pairs are assigned one-to-one per source, cheapest
+  // first, a remote track keeping the local one it last fused into while
+  // it still gates. Each pair is fused by covariance intersection.
+  // Unmatched remote tracks are counted, not started here: their own
+  // tracker reports them. Returns the number fused.
+  size_t FuseRemoteTracks(const std::vector<RemoteTrack> &tracks);
+  // Track-to-track fusion out: append a remote-form report of every
+  // confirmed or coasting track to `out`, tagged as coming from `source`
+  size_t ExportRemoteTracks(uint16_t source,
+                            std::vector<RemoteTrack> &out) const;
+
+  // Warm restart, out: every track's estimate and bookkeeping, the next
+  // track ID and the registry's counters, into `out` (replacing its
+  // contents, reusing its storage). Holds the tracker lock only while the
+  // tracks are copied; out.scanTime is left to the caller.
+  void CaptureCheckpoint(TrackCheckpoint &out) const;
+  // Warm restart, in: replace every track with the checkpoint's, resume
+  // track IDs after its, and add its counters to the registry's. Times
+  // are re-aligned to `resumeTime`, the current tracker time: the outage
+  // since checkpoint.scanTime does not count against the timeouts, while
+  // the estimates keep their epoch so the next scan predicts them across
+  // the gap. Returns the number of tracks restored.
+  size_t RestoreCheckpoint(const TrackCheckpoint &checkpoint,
+                           double resumeTime);
+
+  // Sensors plots may come from, fixed at construction
+  const SensorRegistry &GetSensors() const { return m_sensors; }
+
+  // Resolve a handle; nullptr once the track has been deleted
+  const Track *GetTrack(TrackHandle handle) const { return m_pool.Get(handle); }
+  size_t GetTrackCount() const;
+
 private:
-  std::vector<std::shared_ptr<Track>> m_tracks;
+  // Eviction rank for tentative tracks: lowest hit/miss score goes first,
+  // then the one that has gone longest without an update
+  struct TrackQuality {
+    int score;
+    double lastUpdate;
+    bool operator<(const TrackQuality &other) const {
+      if (score != other.score)
+        return score < other.score;
+      return lastUpdate < other.lastUpdate;
+    }
+  };
+
+  // Keep the tentative eviction index in step with a track's state
+  void RefreshTentativeRank(TrackHandle handle, const Track &track);
+  // Evict the weakest tentative track if a new one would exceed a cap.
+  // Returns false if the caps cannot be met (no tentative track to evict).
+  bool MakeRoomForNewTrack();
+  // Gate a plot with noise `noise` against nearby tracks (predicted to
+  // gateTime) and update the best, or start a new track. Caller holds
+  // m_mutex.
+  void AssociatePlot(float x, float y, double timestamp, double gateTime,
+                     const MeasurementNoise &noise);
+  // GLOBAL association of `count` plots: gate them all, solve and update
+  // the clusters on the worker pool, then do the bookkeeping and start
+  // tracks in plot order on this thread. Caller holds m_mutex.
+  void AssociateBatch(const Plot *plots, size_t count, double gateTime);
+  // MHT association of `count` plots, one frame per sensor. Caller holds
+  // m_mutex.
+  void AssociateFrames(const Plot *plots, size_t count, double gateTime);
+  // One MHT frame: gate every branch of every nearby track, keep the
+  // branches HypothesisForest::Select chooses, and move each track to its
+  // best. Caller holds m_mutex.
+  void AssociateHypotheses(const Plot *plots, size_t count, double gateTime);
+  // In-sequence update of the track a plot associated with, and its
+  // metrics, smoother sample and trail point. Caller holds m_mutex.
+  void ApplyUpdate(TrackHandle handle, Track &track, float x, float y,
+                   double timestamp, const MeasurementNoise &noise);
+  // Metrics, smoother sample and trail point for a track just updated
+  // with a plot. Caller holds m_mutex.
+  void RecordUpdate(TrackHandle handle, const Track &track, float x, float y,
+                    double timestamp);
+  // Apply a plot older than its track by retrodiction, and count it.
+  // Caller holds m_mutex.
+  void ApplyLateUpdate(TrackHandle handle, Track &track, float x, float y,
+                       double timestamp, const MeasurementNoise &noise);
+  // Update the closest gating track among m_tracks[firstCreated...] (those
+  // started in this batch) with a plot; false if none gates it. Caller
+  // holds m_mutex.
+  bool JoinNewTrack(float x, float y, double timestamp,
+                    const MeasurementNoise &noise, double gateTime,
+                    size_t firstCreated);
+  // Offer a plot no track claimed to the initiator, and start a track if
+  // it pairs (or at once, without two-point initiation). Caller holds
+  // m_mutex.
+  void InitiateFromPlot(float x, float y, double timestamp,
+                        const MeasurementNoise &noise);
+  // ProcessScan's association step under the scheduler's budget
+  void ScheduleScan(const std::vector<Plot> &plots, double scanTime);
+  // Priority of a plot from the tracks within its motion bound. Needs a
+  // current spatial index. Caller holds m_mutex.
+  PlotPriority ClassifyPlot(const Plot &plot);
+  // Call visit(handle, track) for every track within the motion bound of
+  // a plot at (x, y, timestamp); returns the number of indexed tracks the
+  // bound rejected. Caller holds m_mutex.
+  template <typename Visit>
+  uint64_t ForEachReachableTrack(float x, float y, double timestamp,
+                                 Visit &&visit);
+  // Index every live track at its current estimate. Caller holds m_mutex.
+  void RebuildSpatialIndex();
+  // Pass a track's filtered state (or its end) to the smoother, if any
+  void SubmitToSmoother(const Track &track, bool deleted);
+  static void FillSample(const Track &track, bool deleted,
+                         FilterSample &sample);
+  // Add the tracks in m_newTracks to the index. Caller holds m_mutex.
+  void IndexNewTracks();
+  // Delete a track on handover or dedup, leaving its handle in m_tracks
+  // for the next compaction. Caller holds m_mutex.
+  void DropTrack(TrackHandle handle);
+  // Rebuild a track from `record` (handover or restart) and index it.
+  // Caller holds m_mutex and has made room.
+  void InsertTrack(const TrackRecord &record);
+  // Local track that duplicates `record`, if any. Caller holds m_mutex.
+  TrackHandle FindDuplicate(const TrackRecord &record);
+  // Call visit(handle, d2) for every track that gates with `estimate`,
+  // each side predicted to the later of their epochs. Needs a current
+  // spatial index. Caller holds m_mutex.
+  template <typename Visit>
+  void ForEachGatedTrack(const RemoteTrack &estimate, Visit &&visit);
+
+  TrackManagerConfig m_config;
+  SensorRegistry m_sensors;
+  TrackPool m_pool;
+  std::vector<TrackHandle> m_tracks; // Live tracks, in creation order
+  TrackHistoryArena m_history;       // Trails, indexed by handle slot
+  IndexedMinHeap<TrackQuality> m_tentativeRank; // Tentative tracks by slot
+  SmootherWorker *m_smoother = nullptr;
+  TrackInitiator m_initiator;           // Unassociated plots awaiting a pair
+  SpatialGrid m_grid;                   // Live tracks by slot, per scan
+  std::vector<TrackHandle> m_newTracks; // Created since the grid was built
+
+  // Track-to-track fusion: the local track each remote one last fused
+  // into, by (source << 32 | id), and per-call scratch
+  struct FusionPair {
+    size_t remote;
+    TrackHandle local;
+    float cost;
+  };
+  std::unordered_map<uint64_t, TrackHandle> m_remoteLinks;
+  std::vector<FusionPair> m_fusionPairs;
+  std::vector<bool> m_remoteTaken;
+  std::unordered_set<uint64_t> m_localTaken; // (source << 32 | slot)
+
+  // Global association scratch, per plot of the batch
+  struct BatchPlot {
+    float x = 0.0f, y = 0.0f; // Common frame
+    double timestamp = 0.0;
+    const MeasurementNoise *noise = nullptr;
+    bool gated = false;    // Some track gated it
+    bool assigned = false; // and it won one
+    bool late = false;     // Older than its track: out of sequence
+    bool applied = false;
+    glm::vec2 updated{0.0f}; // Track position after the update
+  };
+  std::vector<BatchPlot> m_batchPlots;
+  std::vector<uint16_t> m_batchSensors;
+  std::vector<FilterSample> m_batchSamples; // With a smoother
+  std::vector<GatedPair> m_gatedPairs;
+  std::vector<TrackHandle> m_batchTracks; // Dense index -> track
+  std::vector<uint32_t> m_batchIndex;     // Slot -> dense index, or NONE
+  // Predictions of the batch's candidate tracks, packed in the order they
+  // were claimed (in plot order when deterministic); rows by slot
+  std::vector<TrackPrediction> m_gateTracks;
+  std::vector<uint32_t> m_gateRow;
+  std::atomic<uint32_t> m_gateRows{0};
+  std::vector<TrackHandle> m_gateOrder; // Row -> track
+  // In-sequence assignments as (round, pair), applied after the solve
+  std::vector<std::pair<uint32_t, GatedPair>> m_batchUpdates;
+  std::vector<uint32_t> m_updateRound; // Dense index -> plots taken so far
+  struct GateChunk {
+    std::vector<std::pair<uint32_t, TrackHandle>> candidates; // (plot, track)
+    std::vector<TrackHandle> predicted; // Tracks this chunk predicted
+    std::vector<GatedPair> pairs;       // Track by slot until numbered
+    uint64_t pruned = 0;
+  };
+  std::vector<GateChunk> m_gateChunks;
+  ClusterAssociator m_associator;
+  std::unique_ptr<ThreadPool> m_workers; // GLOBAL mode only
+  // MHT scratch
+  std::vector<Plot> m_framePlots;       // The batch, by sensor
+  std::vector<uint32_t> m_pairParents;  // Branch each gated pair extends
+  std::vector<BranchChoice> m_branchChoices;
+  std::vector<HypothesisBranch> m_newBranches; // One track's, this frame
+  HypothesisBranch m_rootBranch; // A track with no branches, as one
+  // State time range of the indexed tracks
+  double m_gridOldestState = std::numeric_limits<double>::max();
+  double m_gridNewestState = std::numeric_limits<double>::lowest();
   mutable std::mutex m_mutex;
   uint32_t m_nextTrackId;
 
-  // Performance metrics tracking
-  TrackingMetrics m_metrics;
-  int m_previousTrackCount = 0; // For tracking created/deleted
+  // Performance metrics. Recorded lock-free into per-thread shards; the
+  // references below point into m_registry, so it must be declared first.
+  MetricsRegistry m_registry;
+  Counter &m_plotsCounter;
+  Counter &m_associatedCounter;
+  Counter &m_createdCounter;
+  Counter &m_deletedCounter;
+  Counter &m_evictedCounter;
+  Counter &m_shedCounter;
+  Counter &m_gateCandidatesCounter;
+  Counter &m_motionPrunedCounter;
+  Counter &m_candidatesExpiredCounter;
+  Counter &m_latePlotsCounter;
+  Counter &m_lateDroppedCounter;
+  Counter &m_unknownSensorCounter;
+  Counter &m_outsideRegionCounter;
+  Counter &m_handedOverCounter;
+  Counter &m_adoptedCounter;
+  Counter &m_duplicateCounter;
+  Counter &m_remoteTracksCounter;
+  Counter &m_remoteFusedCounter;
+  Counter &m_remoteUnmatchedCounter;
+  Counter &m_trailsSkippedCounter;
+  Counter &m_clustersCounter;
+  Counter &m_trivialClustersCounter;
+  Counter &m_contestedCounter;
+  Gauge &m_totalGauge;
+  Gauge &m_confirmedGauge;
+  Gauge &m_tentativeGauge;
+  Gauge &m_coastingGauge;
+  Gauge &m_associationRateGauge;
+  Gauge &m_candidatesGauge;
+  StatAccumulator &m_positionError;
+  Histogram &m_lateUpdateDuration;
+  Histogram &m_clusterPairs;
+  ScanScheduler m_scheduler; // Registers its metrics in m_registry
+  HypothesisForest m_hypotheses; // As does this; MHT mode only
+  bool m_thinTrails = false; // Over budget: associated plots leave no trail
 
   // Chi-squared gating threshold for 2 DOF (x,y) at 99% confidence
   // Chi2(0.99, 2) = 9.21
   const float CHI_SQUARED_GATE = 9.21f;
   const double TIMEOUT_THRESHOLD = 5.0;  // Seconds
+  const size_t NEW_TRACK_BATCH = 64; // New tracks scanned before indexing
+  static constexpr uint32_t NONE = 0xFFFFFFFFu;
+  static constexpr uint32_t PREDICTED = 0xFFFFFFFEu; // Claimed, no index yet
+  static constexpr size_t GATE_CHUNK = 64; // Plots per parallel gating task
+  static constexpr size_t TRACK_CHUNK = 64; // Tracks per predict/update task
 };
 
 } // namespace aegis
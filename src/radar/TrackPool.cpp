@@ -0,0 +1,90 @@
+#include "TrackPool.h"
+
+namespace aegis {
+
+TrackPool::TrackPool(size_t initialCapacity, size_t checkpointDepth)
+    : m_checkpointDepth(checkpointDepth) {
+  Grow(initialCapacity);
+}
+
+void TrackPool::Grow(size_t newCapacity) {
+  size_t oldCapacity = m_slots.size();
+  if (newCapacity <= oldCapacity) {
+    return;
+  }
+
+  m_slots.resize(newCapacity);
+  m_freeList.reserve(newCapacity);
+  // Push in reverse so the lowest indices are handed out first
+  for (size_t i = newCapacity; i > oldCapacity; --i) {
+    m_freeList.push_back(static_cast<uint32_t>(i - 1));
+  }
+}
+
+TrackHandle TrackPool::Create(uint32_t id, float x, float y,
+                              double timestamp, TrackFilterModel model) {
+  uint32_t index = AcquireSlot();
+  Slot &slot = m_slots[index];
+  slot.track.Reset(id, x, y, timestamp, model);
+  return TrackHandle{index, slot.generation};
+}
+
+TrackHandle TrackPool::Create(uint32_t id, const TrackSeed &seed,
+                              double timestamp, TrackFilterModel model) {
+  uint32_t index = AcquireSlot();
+  Slot &slot = m_slots[index];
+  slot.track.Reset(id, seed, timestamp, model);
+  return TrackHandle{index, slot.generation};
+}
+
+TrackHandle TrackPool::Create(const TrackRecord &record) {
+  uint32_t index = AcquireSlot();
+  Slot &slot = m_slots[index];
+  slot.track.Reset(record);
+  return TrackHandle{index, slot.generation};
+}
+
+uint32_t TrackPool::AcquireSlot() {
+  if (m_freeList.empty()) {
+    Grow(m_slots.empty() ? 16 : m_slots.size() * 2);
+  }
+
+  uint32_t index = m_freeList.back();
+  m_freeList.pop_back();
+  m_slots[index].alive = true;
+  m_slots[index].track.SetCheckpointDepth(m_checkpointDepth);
+  m_liveCount++;
+  return index;
+}
+
+void TrackPool::Destroy(TrackHandle handle) {
+  if (!Get(handle)) {
+    return;
+  }
+
+  Slot &slot = m_slots[handle.index];
+  slot.alive = false;
+  slot.generation++; // Invalidate every outstanding handle to this slot
+  m_freeList.push_back(handle.index);
+  m_liveCount--;
+}
+
+Track *TrackPool::Get(TrackHandle handle) {
+  if (handle.index >= m_slots.size()) {
+    return nullptr;
+  }
+  Slot &slot = m_slots[handle.index];
+  return (slot.alive && slot.generation == handle.generation) ? &slot.track
+                                                              : nullptr;
+}
+
+const Track *TrackPool::Get(TrackHandle handle) const {
+  if (handle.index >= m_slots.size()) {
+    return nullptr;
+  }
+  const Slot &slot = m_slots[handle.index];
+  return (slot.alive && slot.generation == handle.generation) ? &slot.track
+                                                              : nullptr;
+}
+
+} // namespace aegis
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Track.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace aegis {
+
+// Generational reference to a pooled Track. A handle goes stale as soon as
+// its track is destroyed, even if the slot is later reused.
+struct TrackHandle {
+  static constexpr uint32_t kInvalidIndex =
+      std::numeric_limits<uint32_t>::max();
+
+  uint32_t index = kInvalidIndex;
+  uint32_t generation = 0;
+
+  bool IsValid() const { return index != kInvalidIndex; }
+  bool operator==(const TrackHandle &other) const {
+    return index == other.index && generation == other.generation;
+  }
+  bool operator!=(const TrackHandle &other) const { return !(*this == other); }
+};
+
+// Slot-map allocator for tracks. Slots (and the history storage inside each
+// Track) are recycled on destroy, so once the pool has grown to the working
+// set, track birth and death never touch the global allocator.
+class TrackPool {
+public:
+  // Every track keeps `checkpointDepth` out-of-sequence checkpoints (see
+  // Track::SetCheckpointDepth); slots hold on to that storage
+  explicit TrackPool(size_t initialCapacity = 256, size_t checkpointDepth = 0);
+
+  TrackHandle Create(uint32_t id, float x, float y, double timestamp,
+                     TrackFilterModel model = TrackFilterModel::EKF);
+  TrackHandle Create(uint32_t id, const TrackSeed &seed, double timestamp,
+                     TrackFilterModel model = TrackFilterModel::EKF);
+  TrackHandle Create(const TrackRecord &record);
+  void Destroy(TrackHandle handle);
+
+  // Returns nullptr for stale or invalid handles
+  Track *Get(TrackHandle handle);
+  const Track *Get(TrackHandle handle) const;
+
+  // Current handle for a live slot (invalid handle if the slot is free)
+  TrackHandle HandleAt(uint32_t index) const {
+    if (index >= m_slots.size() || !m_slots[index].alive) {
+      return TrackHandle();
+    }
+    return TrackHandle{index, m_slots[index].generation};
+  }
+
+  size_t Size() const { return m_liveCount; }
+  size_t Capacity() const { return m_slots.size(); }
+
+private:
+  struct Slot {
+    Track track;
+    uint32_t generation = 0;
+    bool alive = false;
+  };
+
+  void Grow(size_t newCapacity);
+  uint32_t AcquireSlot(); // Pop a free slot, growing if none is left
+
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_freeList; // Stack of free slot indices
+  size_t m_liveCount = 0;
+  size_t m_checkpointDepth;
+};
+
+} // namespace aegis
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "PerformanceMetrics.h"
+#include "RcuBuffer.h"
+#include "Track.h"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace aegis {
+
+// Immutable per-track view published once per scan
+struct TrackView {
+  uint32_t id;
+  TrackState state;
+  glm::vec2 position;
+  glm::vec2 velocity;
+  int hitCount;
+  int missCount;
+  double lastUpdate;
+
+  // Trail points live in TrackSnapshot::history[historyOffset, +historyCount)
+  uint32_t historyOffset;
+  uint32_t historyCount;
+};
+
+// Everything a consumer needs from one scan. Never modified after publish.
+struct TrackSnapshot {
+  uint64_t scanNumber = 0;
+  double scanTime = 0.0;
+  std::vector<TrackView> tracks;
+  std::vector<glm::vec2> history; // Trimmed trails, oldest point first
+  TrackingMetrics metrics;
+
+  void Clear() {
+    tracks.clear();
+    history.clear();
+  }
+};
+
+// Scan snapshots are published RCU-style; see RcuBuffer
+using SnapshotBuffer = RcuBuffer<TrackSnapshot>;
+
+} // namespace aegis
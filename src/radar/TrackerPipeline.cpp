@@ -0,0 +1,595 @@
+#include "TrackerPipeline.h"
+#include "../network/MetricsServer.h"
+#include "../network/UdpSocket.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace aegis {
+
+double NowSeconds() {
+  return std::chrono::duration<double>(
+             std::chrono::high_resolution_clock::now().time_since_epoch())
+      .count();
+}
+
+// Stage latency buckets, 100us to 1s
+static std::vector<double> LatencyBuckets() {
+  return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+          0.01,   0.025,   0.05,   0.1,   0.25,   1.0};
+}
+
+// Track reports packed into one fusion datagram, keeping it under a
+// typical 1500-byte MTU
+static constexpr size_t FUSION_REPORTS_PER_DATAGRAM =
+    1400 / sizeof(TrackStateReport);
+
+// Scans a handover is re-sent without an acknowledgement before it is
+// given up (the neighbour is presumed down, and its region unwatched)
+static constexpr int HANDOVER_RETRY_SCANS = 10;
+
+// A partition node starts tracks only in its own region, and numbers them
+// in its own block so handed-over IDs never collide
+static TrackManagerConfig TrackerConfigFor(const PipelineConfig &config) {
+  TrackManagerConfig tracker = config.tracker;
+  if (config.partitionNode >= 0) {
+    tracker.initiationRegion =
+        config.partition.nodes.at(config.partitionNode).region;
+    tracker.firstTrackId =
+        (static_cast<uint32_t>(config.partitionNode) << 24) + 1;
+  }
+  return tracker;
+}
+
+TrackerPipeline::TrackerPipeline(const PipelineConfig &config)
+    : m_config(config), m_trackManager(TrackerConfigFor(config)),
+      m_merger(m_trackManager.GetSensors()),
+      m_plotsReceived(m_trackManager.GetMetricsRegistry().AddCounter(
+          "aegis_plots_received_total", "Plots read from the ingest sockets")),
+      m_queueDepth(m_trackManager.GetMetricsRegistry().AddGauge(
+          "aegis_plot_queue_depth", "Plots waiting for the next scan")),
+      m_scanDuration(m_trackManager.GetMetricsRegistry().AddHistogram(
+          "aegis_scan_duration_seconds", "Association stage time per scan",
+          LatencyBuckets())),
+      m_snapshotDuration(m_trackManager.GetMetricsRegistry().AddHistogram(
+          "aegis_snapshot_duration_seconds",
+          "Snapshot build and publish time per scan", LatencyBuckets())),
+      m_handoverLost(m_trackManager.GetMetricsRegistry().AddCounter(
+          "aegis_handover_lost_total",
+          "Handovers from neighbours lost in transit (sequence gaps)")),
+      m_handoverResent(m_trackManager.GetMetricsRegistry().AddCounter(
+          "aegis_handover_resent_total",
+          "Handovers sent again for want of an acknowledgement")),
+      m_handoverAbandoned(m_trackManager.GetMetricsRegistry().AddCounter(
+          "aegis_handover_abandoned_total",
+          "Handovers given up after going unacknowledged")) {
+  if (m_config.smoothing) {
+    m_smoother = std::make_unique<SmootherWorker>(
+        m_config.smoother, m_trackManager.GetMetricsRegistry());
+    m_trackManager.SetSmoother(m_smoother.get());
+  }
+  if (!m_config.checkpointPath.empty()) {
+    m_checkpointWriter = std::make_unique<CheckpointWriter>(
+        m_config.checkpointPath, m_trackManager.GetMetricsRegistry());
+  }
+}
+
+TrackerPipeline::~TrackerPipeline() { Stop(); }
+
+void TrackerPipeline::Start() {
+  if (m_running) {
+    return;
+  }
+
+  // Ports to listen on: the shared one, where plots carry their own sensor
+  // ID, and one per sensor that has its own (tagged with that sensor, unless
+  // several sensors share it)
+  std::vector<std::pair<int, int>> ports = {{m_config.listenPort, -1}};
+  for (const SensorConfig &sensor : m_trackManager.GetSensors().GetSensors()) {
+    if (sensor.listenPort == 0) {
+      continue;
+    }
+    auto known = std::find_if(ports.begin(), ports.end(), [&](const auto &p) {
+      return p.first == sensor.listenPort;
+    });
+    if (known == ports.end()) {
+      ports.emplace_back(sensor.listenPort, sensor.id);
+    } else {
+      known->second = -1;
+    }
+  }
+
+  // Bind before spawning threads so configuration errors reach the caller
+  m_ingestSockets.clear();
+  for (const auto &port : ports) {
+    auto socket = std::make_unique<net::UdpSocket>();
+    socket->Bind(port.first);
+    // Bounded receive so the ingest thread notices shutdown promptly
+    socket->SetReceiveTimeout(200);
+    m_ingestSockets.push_back(std::move(socket));
+  }
+
+  if (m_config.partitionNode >= 0) {
+    const PartitionNode &node =
+        m_config.partition.nodes[m_config.partitionNode];
+    m_handoverSocket = std::make_unique<net::UdpSocket>();
+    m_handoverSocket->Bind(node.handoverPort);
+    m_handoverSocket->SetReceiveTimeout(200);
+    m_handoverSender = std::make_unique<net::UdpSocket>();
+    m_handoverSent.assign(m_config.partition.nodes.size(), 0);
+    m_handoverReceived.assign(m_config.partition.nodes.size(), 0);
+  }
+  if (m_config.fusionPort != 0) {
+    m_fusionSocket = std::make_unique<net::UdpSocket>();
+    m_fusionSocket->Bind(m_config.fusionPort);
+    m_fusionSocket->SetReceiveTimeout(200);
+  }
+  if (!m_config.fusionPeers.empty()) {
+    m_fusionSender = std::make_unique<net::UdpSocket>();
+  }
+
+  if (m_config.metricsPort != 0) {
+    StartMetricsServer();
+  }
+
+  if (m_smoother) {
+    m_smoother->Start();
+  }
+  // Before any thread runs, so the first scan already sees the tracks
+  if (m_checkpointWriter) {
+    RestoreCheckpoint();
+    m_checkpointWriter->Start();
+  }
+
+  m_running = true;
+  for (size_t i = 0; i < ports.size(); ++i) {
+    m_ingestThreads.emplace_back(&TrackerPipeline::IngestLoop, this,
+                                 m_ingestSockets[i].get(), ports[i].first,
+                                 ports[i].second);
+  }
+  m_processThread = std::thread(&TrackerPipeline::ProcessLoop, this);
+  m_publishThread = std::thread(&TrackerPipeline::PublishLoop, this);
+  if (m_handoverSocket) {
+    m_handoverThread = std::thread(&TrackerPipeline::HandoverLoop, this);
+  }
+  if (m_fusionSocket) {
+    m_fusionThread = std::thread(&TrackerPipeline::FusionLoop, this);
+  }
+}
+
+void TrackerPipeline::Stop() {
+  if (m_metricsServer) {
+    m_metricsServer->Stop();
+    m_metricsServer.reset();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_stopMutex);
+    m_running = false;
+  }
+  m_stopCond.notify_all();
+
+  for (std::thread &thread : m_ingestThreads) {
+    thread.join();
+  }
+  m_ingestThreads.clear();
+  bool processing = m_processThread.joinable();
+  if (m_processThread.joinable())
+    m_processThread.join();
+  if (m_publishThread.joinable())
+    m_publishThread.join();
+  if (m_handoverThread.joinable())
+    m_handoverThread.join();
+  if (m_fusionThread.joinable())
+    m_fusionThread.join();
+  // After the processing thread, so nothing submits while it drains
+  if (m_smoother) {
+    m_smoother->Stop();
+  }
+  // A last checkpoint, so an orderly restart picks up where this left off
+  if (m_checkpointWriter && processing) {
+    m_checkpointWriter->Stop();
+    TrackCheckpoint checkpoint;
+    m_trackManager.CaptureCheckpoint(checkpoint);
+    checkpoint.scanTime = NowSeconds();
+    m_checkpointWriter->Write(checkpoint);
+  }
+
+  m_ingestSockets.clear();
+  m_handoverSocket.reset();
+  m_handoverSender.reset();
+  m_fusionSocket.reset();
+  m_fusionSender.reset();
+}
+
+bool TrackerPipeline::IsHealthy() const {
+  if (!m_running) {
+    return false;
+  }
+  auto snapshot = GetSnapshot();
+  if (!snapshot) {
+    return true; // Still starting up
+  }
+  // Allow a few missed scan slots before declaring the processor stalled
+  double maxAge = std::max(1.0, 5.0 / m_config.scanRateHz);
+  return NowSeconds() - snapshot->scanTime <= maxAge;
+}
+
+bool TrackerPipeline::IsReady() const {
+  return IsHealthy() && GetSnapshot() != nullptr;
+}
+
+int TrackerPipeline::GetMetricsPort() const {
+  return m_metricsServer ? m_metricsServer->GetPort() : 0;
+}
+
+void TrackerPipeline::RestoreCheckpoint() {
+  const std::string &path = m_config.checkpointPath;
+  std::error_code error;
+  if (!std::filesystem::exists(path, error)) {
+    std::cout << "No checkpoint at " << path << ", starting cold" << std::endl;
+    return;
+  }
+  // A bad or stale checkpoint costs the warm start, never the tracker
+  try {
+    TrackCheckpoint checkpoint = LoadCheckpoint(path);
+    double now = NowSeconds();
+    double age = now - checkpoint.scanTime;
+    if (age > m_config.checkpointMaxAge) {
+      std::cout << "Checkpoint " << path << " is " << age
+                << " s old, starting cold" << std::endl;
+      return;
+    }
+    size_t restored = m_trackManager.RestoreCheckpoint(checkpoint, now);
+    std::cout << "Restored " << restored << " tracks from " << path << " ("
+              << age << " s old)" << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Checkpoint Error: " << e.what() << ", starting cold"
+              << std::endl;
+  }
+}
+
+void TrackerPipeline::StartMetricsServer() {
+  auto server = std::make_unique<net::MetricsServer>();
+
+  server->AddRoute("/metrics", [this] {
+    m_queueDepth.Set(static_cast<double>(m_merger.Size()));
+    net::HttpResponse response;
+    response.contentType = "text/plain; version=0.0.4; charset=utf-8";
+    response.body =
+        FormatPrometheus(m_trackManager.GetMetricsRegistry().Snapshot());
+    return response;
+  });
+  server->AddRoute("/metrics.json", [this] {
+    m_queueDepth.Set(static_cast<double>(m_merger.Size()));
+    net::HttpResponse response;
+    response.contentType = "application/json";
+    response.body = FormatJson(m_trackManager.GetMetricsRegistry().Snapshot());
+    return response;
+  });
+  server->AddRoute("/healthz", [this] {
+    net::HttpResponse response;
+    bool healthy = IsHealthy();
+    response.status = healthy ? 200 : 503;
+    response.body = healthy ? "ok\n" : "stalled\n";
+    return response;
+  });
+  server->AddRoute("/readyz", [this] {
+    net::HttpResponse response;
+    bool ready = IsReady();
+    response.status = ready ? 200 : 503;
+    response.body = ready ? "ready\n" : "not ready\n";
+    return response;
+  });
+
+  server->Start(m_config.metricsAddress, m_config.metricsPort);
+  std::cout << "Metrics Server Listening on " << m_config.metricsAddress << ":"
+            << server->GetPort() << std::endl;
+  m_metricsServer = std::move(server);
+}
+
+bool TrackerPipeline::WaitForStop(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(m_stopMutex);
+  return m_stopCond.wait_for(lock, timeout, [this] { return !m_running; });
+}
+
+void TrackerPipeline::IngestLoop(net::UdpSocket *socket, int port,
+                                 int sensorTag) {
+  std::cout << "Ingest Thread Started on Port " << port;
+  if (sensorTag >= 0) {
+    std::cout << " (sensor " << sensorTag << ")";
+  }
+  std::cout << std::endl;
+
+  while (m_running) {
+    Plot plot;
+    std::string senderAddr;
+    int senderPort;
+
+    int bytes =
+        socket->ReceiveFrom(&plot, sizeof(plot), senderAddr, senderPort);
+    if (bytes == static_cast<int>(LEGACY_PLOT_SIZE)) {
+      plot.sensorId = 0;
+    } else if (bytes != sizeof(plot)) {
+      continue;
+    }
+    if (sensorTag >= 0) {
+      plot.sensorId = static_cast<uint16_t>(sensorTag);
+    }
+    m_merger.Push(plot);
+    m_plotsReceived.Add();
+  }
+}
+
+void TrackerPipeline::HandoverLoop() {
+  std::cout << "Handover Thread Started on Port "
+            << m_config.partition.nodes[m_config.partitionNode].handoverPort
+            << std::endl;
+
+  const PartitionMap &map = m_config.partition;
+  while (m_running) {
+    TrackHandover message;
+    std::string senderAddr;
+    int senderPort;
+    int bytes = m_handoverSocket->ReceiveFrom(&message, sizeof(message),
+                                              senderAddr, senderPort);
+    if (bytes == sizeof(HandoverAck)) {
+      HandoverAck ack;
+      std::memcpy(&ack, &message, sizeof(ack));
+      m_handoverAcks.Push(ack);
+      continue;
+    }
+    if (bytes != sizeof(message) || message.fromNode >= map.nodes.size()) {
+      continue;
+    }
+    // Acknowledge every copy, re-sends included: the earlier receipt may
+    // be the one that was lost
+    HandoverAck ack{static_cast<uint16_t>(m_config.partitionNode),
+                    message.sequence};
+    const PartitionNode &sender = map.nodes[message.fromNode];
+    m_handoverSocket->SendTo(sender.host, sender.handoverPort, &ack,
+                             sizeof(ack));
+
+    // Each neighbour numbers what it sends here: a gap is handovers lost
+    // on the way (re-sent until acknowledged). A loss shows when the next
+    // one arrives. A number at or below the last is a re-send, adopted
+    // again only if the first copy was lost (a copy already adopted is
+    // dropped as a duplicate); 1 after a higher number is a restarted
+    // neighbour.
+    uint32_t &last = m_handoverReceived[message.fromNode];
+    if (message.sequence > last) {
+      if (last != 0 && message.sequence > last + 1) {
+        m_handoverLost.Add(message.sequence - last - 1);
+      }
+      last = message.sequence;
+    } else if (message.sequence == 1) {
+      last = 1;
+    }
+    m_handoverQueue.Push(FromHandover(message));
+  }
+}
+
+void TrackerPipeline::ExchangeTracks() {
+  m_handoverScratch.clear();
+  while (auto record = m_handoverQueue.TryPop()) {
+    m_handoverScratch.push_back(*record);
+  }
+  m_trackManager.AdoptTracks(m_handoverScratch);
+
+  // Settle earlier handovers: acknowledged ones are done, the rest go out
+  // again until HANDOVER_RETRY_SCANS have passed
+  while (auto ack = m_handoverAcks.TryPop()) {
+    auto done = std::find_if(m_handoverPending.begin(),
+                             m_handoverPending.end(), [&](const auto &p) {
+                               return p.owner == ack->fromNode &&
+                                      p.sequence == ack->sequence;
+                             });
+    if (done != m_handoverPending.end()) {
+      *done = m_handoverPending.back();
+      m_handoverPending.pop_back();
+    }
+  }
+  for (size_t i = 0; i < m_handoverPending.size();) {
+    PendingHandover &pending = m_handoverPending[i];
+    if (++pending.scans > HANDOVER_RETRY_SCANS) {
+      m_handoverAbandoned.Add();
+      pending = m_handoverPending.back();
+      m_handoverPending.pop_back();
+      continue;
+    }
+    SendHandover(pending.record, pending.owner, pending.sequence);
+    m_handoverResent.Add();
+    ++i;
+  }
+
+  // A track leaves once it is `hysteresis` into a region another node owns
+  const PartitionMap &map = m_config.partition;
+  const int self = m_config.partitionNode;
+  const Region &own = map.nodes[self].region;
+  m_handoverScratch.clear();
+  m_trackManager.ReleaseTracks(
+      [&](glm::vec2 p) {
+        if (own.Contains(p.x, p.y, map.hysteresis)) {
+          return false;
+        }
+        int owner = map.Owner(p.x, p.y);
+        return owner >= 0 && owner != self;
+      },
+      m_handoverScratch);
+  for (const TrackRecord &record : m_handoverScratch) {
+    int owner = map.Owner(record.x[0], record.x[1]);
+    uint32_t sequence = ++m_handoverSent[owner];
+    m_handoverPending.push_back({record, owner, sequence, 0});
+    SendHandover(record, owner, sequence);
+  }
+}
+
+void TrackerPipeline::SendHandover(const TrackRecord &record, int owner,
+                                   uint32_t sequence) {
+  const PartitionNode &node = m_config.partition.nodes[owner];
+  TrackHandover message =
+      ToHandover(record, static_cast<uint16_t>(m_config.partitionNode));
+  message.sequence = sequence;
+  m_handoverSender->SendTo(node.host, node.handoverPort, &message,
+                           sizeof(message));
+}
+
+void TrackerPipeline::FusionLoop() {
+  std::cout << "Fusion Thread Started on Port " << m_config.fusionPort
+            << std::endl;
+
+  // Reports come several to a datagram
+  std::vector<TrackStateReport> reports(FUSION_REPORTS_PER_DATAGRAM);
+  while (m_running) {
+    std::string senderAddr;
+    int senderPort;
+    int bytes = m_fusionSocket->ReceiveFrom(
+        reports.data(), reports.size() * sizeof(TrackStateReport), senderAddr,
+        senderPort);
+    size_t size = bytes > 0 ? static_cast<size_t>(bytes) : 0;
+    if (size == 0 || size % sizeof(TrackStateReport) != 0) {
+      continue;
+    }
+    for (size_t i = 0; i < size / sizeof(TrackStateReport); ++i) {
+      m_remoteQueue.Push(FromReport(reports[i]));
+    }
+  }
+}
+
+void TrackerPipeline::SendTrackReports() {
+  m_remoteScratch.clear();
+  m_trackManager.ExportRemoteTracks(m_config.fusionSource, m_remoteScratch);
+  m_reportScratch.clear();
+  for (const RemoteTrack &track : m_remoteScratch) {
+    m_reportScratch.push_back(ToReport(track));
+  }
+  for (size_t first = 0; first < m_reportScratch.size();
+       first += FUSION_REPORTS_PER_DATAGRAM) {
+    size_t count = std::min(FUSION_REPORTS_PER_DATAGRAM,
+                            m_reportScratch.size() - first);
+    for (const FusionPeer &peer : m_config.fusionPeers) {
+      m_fusionSender->SendTo(peer.host, peer.port, &m_reportScratch[first],
+                             count * sizeof(TrackStateReport));
+    }
+  }
+}
+
+void TrackerPipeline::ProcessLoop() {
+  using Clock = std::chrono::steady_clock;
+  const auto scanPeriod = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / m_config.scanRateHz));
+  auto nextScan = Clock::now() + scanPeriod;
+  const auto fusionPeriod =
+      std::chrono::milliseconds(m_config.fusionIntervalMs);
+  auto nextReport = Clock::now() + fusionPeriod;
+  const auto checkpointPeriod =
+      std::chrono::milliseconds(m_config.checkpointIntervalMs);
+  auto nextCheckpoint = Clock::now() + checkpointPeriod;
+  uint64_t scanNumber = 0;
+
+  m_scanPlots.reserve(1024);
+
+  while (true) {
+    // Fixed-rate scans, independent of plot arrival and of any renderer
+    {
+      std::unique_lock<std::mutex> lock(m_stopMutex);
+      if (m_stopCond.wait_until(lock, nextScan, [this] { return !m_running; }))
+        break;
+    }
+
+    // Skip missed scan slots rather than bursting to catch up
+    auto now = Clock::now();
+    nextScan += scanPeriod;
+    if (nextScan <= now) {
+      nextScan = now + scanPeriod;
+    }
+
+    // Plots from every sensor, in detection-time order, up to the point
+    // the slowest sensor has caught up to
+    double scanTime = NowSeconds();
+    m_scanPlots.clear();
+    m_merger.Drain(scanTime, m_scanPlots);
+    m_queueDepth.Set(static_cast<double>(m_merger.Size()));
+
+    auto scanStart = Clock::now();
+    if (m_handoverSocket) {
+      ExchangeTracks();
+    }
+    if (m_fusionSocket) {
+      m_remoteScratch.clear();
+      while (auto track = m_remoteQueue.TryPop()) {
+        m_remoteScratch.push_back(*track);
+      }
+      m_trackManager.FuseRemoteTracks(m_remoteScratch);
+    }
+    m_trackManager.ProcessScan(m_scanPlots, scanTime);
+    auto scanEnd = Clock::now();
+    m_scanDuration.Observe(
+        std::chrono::duration<double>(scanEnd - scanStart).count());
+
+    auto snapshot = m_snapshots.AcquireForWrite();
+    snapshot->scanNumber = ++scanNumber;
+    snapshot->scanTime = scanTime;
+    // Report every track at the scan time, not at its last update
+    m_trackManager.FillSnapshot(*snapshot, m_config.snapshotHistory,
+                                m_config.trailResolution, scanTime);
+    m_snapshots.Publish(snapshot);
+    m_snapshotDuration.Observe(
+        std::chrono::duration<double>(Clock::now() - scanEnd).count());
+
+    if (m_fusionSender && scanEnd >= nextReport) {
+      SendTrackReports();
+      nextReport = scanEnd + fusionPeriod;
+    }
+    // Only the copy happens here; if the last checkpoint is still being
+    // written, try again next scan
+    if (m_checkpointWriter && scanEnd >= nextCheckpoint) {
+      if (TrackCheckpoint *checkpoint = m_checkpointWriter->Acquire()) {
+        m_trackManager.CaptureCheckpoint(*checkpoint);
+        checkpoint->scanTime = scanTime;
+        m_checkpointWriter->Submit();
+        nextCheckpoint = scanEnd + checkpointPeriod;
+      }
+    }
+  }
+}
+
+void TrackerPipeline::PublishLoop() {
+  if (m_config.publishPort == 0) {
+    return; // Publishing disabled; in-process consumers read snapshots
+  }
+
+  try {
+    net::UdpSocket socket;
+    const auto interval = std::chrono::milliseconds(m_config.publishIntervalMs);
+
+    while (!WaitForStop(interval)) {
+      auto snapshot = GetSnapshot();
+      if (!snapshot) {
+        continue;
+      }
+
+      for (const auto &track : snapshot->tracks) {
+        TrackReport report;
+        report.trackId = track.id;
+        report.state = static_cast<uint8_t>(track.state);
+        report.hitCount = static_cast<uint16_t>(track.hitCount);
+        report.missCount = static_cast<uint16_t>(track.missCount);
+        report.x = track.position.x;
+        report.y = track.position.y;
+        report.vx = track.velocity.x;
+        report.vy = track.velocity.y;
+        report.timestamp = track.lastUpdate;
+        socket.SendTo(m_config.publishAddress, m_config.publishPort, &report,
+                      sizeof(report));
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Publisher Error: " << e.what() << std::endl;
+  }
+}
+
+} // namespace aegis
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Checkpoint.h"
+#include "FixedLagSmoother.h"
+#include "Partition.h"
+#include "Protocol.h"
+#include "SensorMerger.h"
+#include "ThreadSafeQueue.h"
+#include "TrackFusion.h"
+#include "TrackManager.h"
+#include "TrackSnapshot.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aegis {
+
+namespace net {
+class UdpSocket;
+class MetricsServer;
+} // namespace net
+
+// Wall-clock time in seconds, on the same clock the radar simulator stamps
+// its plots with.
+double NowSeconds();
+
+struct PipelineConfig {
+  int listenPort = 5000;                     // UDP port for incoming plots
+  std::string publishAddress = "127.0.0.1";  // TrackReport destination
+  int publishPort = 0;                       // 0 disables track publishing
+  int publishIntervalMs = 100;               // TrackReport publish period
+  double scanRateHz = 10.0;                  // Fixed processing scan rate
+  size_t snapshotHistory = 128;              // Max trail points per track
+  float trailResolution = 0.0f;              // Trail LOD spacing (meters)
+  std::string metricsAddress = "127.0.0.1";  // HTTP metrics bind address
+  int metricsPort = 0;                       // 0 disables the metrics server
+  TrackManagerConfig tracker;                // Track caps, pool, trails
+  bool smoothing = false;                    // Run the fixed-lag smoother
+  SmootherConfig smoother;                   // Lag, queue depth
+
+  // Partitioned mode: run as node `partitionNode` of `partition`, owning
+  // the tracks in its region and handing the rest to their owners. -1
+  // runs a standalone tracker. listenPort should be the node's plotPort.
+  PartitionMap partition;
+  int partitionNode = -1;
+
+  // Track-to-track fusion: every fusionIntervalMs, send each confirmed
+  // track to every peer as a TrackStateReport tagged fusionSource, and
+  // fuse the reports that arrive on fusionPort into the local tracks
+  uint16_t fusionSource = 0;
+  int fusionPort = 0;                  // 0 receives none
+  std::vector<FusionPeer> fusionPeers; // Empty sends none
+  int fusionIntervalMs = 1000;
+
+  // Warm restart: with checkpointPath set, the tracker state is saved
+  // there every checkpointIntervalMs, and on Stop, by a background thread,
+  // and Start restores it unless it is more than checkpointMaxAge s old
+  std::string checkpointPath;
+  int checkpointIntervalMs = 5000;
+  double checkpointMaxAge = 300.0;
+};
+
+// Ingest -> association -> publish, each on its own thread and independent
+// of any GUI. The GUI and the headless daemon are both consumers of this.
+// Sensors with their own port (tracker.sensors) get their own ingest
+// thread, and their plots are tagged with their ID; all streams meet in a
+// time-ordered merge ahead of the tracker. A partition node also runs a
+// handover thread; before each scan, tracks that arrived from neighbours
+// are adopted and tracks that have left the node's region are sent on,
+// again each scan until the neighbour acknowledges them.
+// With fusion configured, remote track reports are received on their own
+// thread and fused before each scan, and local tracks are reported to the
+// peers at the fusion interval. With a checkpoint path, the processing
+// thread copies the tracker state after a scan at the checkpoint interval
+// and a writer thread saves it.
+class TrackerPipeline {
+public:
+  explicit TrackerPipeline(const PipelineConfig &config = PipelineConfig());
+  ~TrackerPipeline();
+
+  // Prevent copying
+  TrackerPipeline(const TrackerPipeline &) = delete;
+  TrackerPipeline &operator=(const TrackerPipeline &) = delete;
+
+  // Binds the ingest sockets and starts all threads. Throws on bind failure.
+  void Start();
+
+  // Signals all threads and joins them. Safe to call more than once.
+  void Stop();
+
+  bool IsRunning() const { return m_running; }
+
+  TrackManager &GetTrackManager() { return m_trackManager; }
+  const TrackManager &GetTrackManager() const { return m_trackManager; }
+
+  // Latest published scan; never blocks the processing thread. Null until
+  // the first scan completes.
+  std::shared_ptr<const TrackSnapshot> GetSnapshot() const {
+    return m_snapshots.Read();
+  }
+
+  // Latest fixed-lag smoothed tracks, `smoother.lag` updates behind the
+  // live ones. Null when smoothing is off or nothing is smoothed yet.
+  std::shared_ptr<const SmoothedSnapshot> GetSmoothedSnapshot() const {
+    return m_smoother ? m_smoother->GetSnapshot() : nullptr;
+  }
+
+  size_t GetQueueDepth() const { return m_merger.Size(); }
+  uint64_t GetPlotsReceived() const { return m_plotsReceived.Value(); }
+
+  // Liveness: threads running and scans still being published on time
+  bool IsHealthy() const;
+  // Readiness: healthy and at least one scan published
+  bool IsReady() const;
+
+  // Port the metrics server is bound to, 0 if disabled
+  int GetMetricsPort() const;
+
+private:
+  // Read plots from `socket`; sensorTag >= 0 overrides their sensor ID
+  void IngestLoop(net::UdpSocket *socket, int port, int sensorTag);
+  void ProcessLoop();
+  void PublishLoop();
+  void HandoverLoop();
+  // Adopt queued incoming tracks, re-send unacknowledged handovers, then
+  // send off departing tracks
+  void ExchangeTracks();
+  void SendHandover(const TrackRecord &record, int owner, uint32_t sequence);
+  void FusionLoop();
+  // Send every confirmed track to the fusion peers
+  void SendTrackReports();
+
+  // Load the checkpoint, if any, into the track manager
+  void RestoreCheckpoint();
+
+  // Sleeps for up to `timeout`; returns true if Stop() was requested.
+  bool WaitForStop(std::chrono::milliseconds timeout);
+
+  // HTTP routes; read only the metrics registry and published snapshots,
+  // never the track manager lock
+  void StartMetricsServer();
+
+  PipelineConfig m_config;
+  TrackManager m_trackManager;
+  SensorMerger m_merger; // Per-sensor lanes, drained each scan
+  std::vector<std::unique_ptr<net::UdpSocket>> m_ingestSockets;
+  std::unique_ptr<net::MetricsServer> m_metricsServer;
+  SnapshotBuffer m_snapshots;
+  std::unique_ptr<SmootherWorker> m_smoother; // Null unless smoothing
+  std::vector<Plot> m_scanPlots; // Processing-thread scratch, reused
+
+  // Partitioned mode only
+  std::unique_ptr<net::UdpSocket> m_handoverSocket; // Incoming
+  std::unique_ptr<net::UdpSocket> m_handoverSender; // Outgoing
+  ThreadSafeQueue<TrackRecord> m_handoverQueue;
+  std::vector<TrackRecord> m_handoverScratch; // Processing thread
+  std::vector<uint32_t> m_handoverSent;     // Last sequence, by receiver
+  std::vector<uint32_t> m_handoverReceived; // Last sequence, by sender
+  ThreadSafeQueue<HandoverAck> m_handoverAcks; // Receipts for ours
+  // Released tracks not yet acknowledged (processing thread)
+  struct PendingHandover {
+    TrackRecord record;
+    int owner;
+    uint32_t sequence;
+    int scans; // Since first sent
+  };
+  std::vector<PendingHandover> m_handoverPending;
+
+  // Track-to-track fusion only
+  std::unique_ptr<net::UdpSocket> m_fusionSocket; // Incoming reports
+  std::unique_ptr<net::UdpSocket> m_fusionSender; // Outgoing reports
+  ThreadSafeQueue<RemoteTrack> m_remoteQueue;
+  std::vector<RemoteTrack> m_remoteScratch; // Processing thread
+  std::vector<TrackStateReport> m_reportScratch;
+
+  // Warm restart only
+  std::unique_ptr<CheckpointWriter> m_checkpointWriter;
+
+  // Stage metrics, registered in the track manager's registry
+  Counter &m_plotsReceived;
+  Gauge &m_queueDepth;
+  Histogram &m_scanDuration;
+  Histogram &m_snapshotDuration;
+  Counter &m_handoverLost;
+  Counter &m_handoverResent;
+  Counter &m_handoverAbandoned;
+
+  std::atomic<bool> m_running{false};
+  std::mutex m_stopMutex;
+  std::condition_variable m_stopCond;
+
+  std::vector<std::thread> m_ingestThreads; // One per socket
+  std::thread m_processThread;
+  std::thread m_publishThread;
+  std::thread m_handoverThread;
+  std::thread m_fusionThread;
+};
+
+} // namespace aegis
@@ -0,0 +1,319 @@
+#include "radar/PlotRouter.h"
+#include "radar/TrackerPipeline.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Headless tracker daemon: runs the tracking pipeline without any GUI and
+// shuts down cleanly on SIGINT/SIGTERM. With a partition map it runs as one
+// node of a partitioned tracker, or as the plot router in front of them.
+
+namespace {
+
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void HandleSignal(int) { g_stopRequested = 1; }
+
+void PrintUsage() {
+  std::cout << "Usage: aegis_trackerd [options]\n"
+               "  --port N              UDP port for incoming plots (5000)\n"
+               "  --publish HOST:PORT   Publish TrackReports to HOST:PORT\n"
+               "  --publish-interval MS TrackReport publish period (100)\n"
+               "  --scan-rate HZ        Fixed processing scan rate (10)\n"
+               "  --max-tracks N        Hard cap on live tracks (20000)\n"
+               "  --max-tentative N     Hard cap on tentative tracks (10000)\n"
+               "  --scan-budget MS      Association time per scan; past it,\n"
+               "                        plots near no established track wait\n"
+               "                        or are shed, 0 = off (0)\n"
+               "  --far-range M         Under overload, shed plots near no\n"
+               "                        track beyond M from their sensor first\n"
+               "                        (0 = off)\n"
+               "  --filter ekf|imm      Track estimator: single CTRV EKF or\n"
+               "                        CV/turn/manoeuvre IMM (ekf)\n"
+               "  --association nn|global|mht\n"
+               "                        Plot by plot to the nearest track,\n"
+               "                        one-to-one per scan by clusters, or\n"
+               "                        multiple hypotheses per track (nn)\n"
+               "  --association-threads N\n"
+               "                        Threads for global association,\n"
+               "                        0 = one per core (0)\n"
+               "  --deterministic       Same plots and scan times give the\n"
+               "                        same tracks and IDs on any thread\n"
+               "                        count; --scan-budget is charged per\n"
+               "                        plot instead of timed\n"
+               "  --mht-depth N         MHT: frames a choice stays open (3)\n"
+               "  --mht-hypotheses N    MHT: branches held at most (4096)\n"
+               "  --sensor ID:SIGMA[:LATENCY[:X:Y[:PORT]]]\n"
+               "                        Register a sensor: plot noise SIGMA m\n"
+               "                        per axis, worst-case delivery delay\n"
+               "                        LATENCY s, site X,Y m in the common\n"
+               "                        frame, own UDP PORT (repeatable)\n"
+               "  --partition FILE      Partition map (see README); with\n"
+               "  --node N              run as node N of the map (listens on\n"
+               "                        its plot port), or with\n"
+               "  --router              route plots from --port to the nodes\n"
+               "  --fusion-id N         Track-to-track fusion: this tracker's\n"
+               "                        ID in its reports (0)\n"
+               "  --fusion-port N       Fuse track reports received on N\n"
+               "  --fusion-peer HOST:PORT\n"
+               "                        Send track reports there (repeatable)\n"
+               "  --fusion-interval MS  Track report period (1000)\n"
+               "  --checkpoint FILE     Save the tracker state to FILE and\n"
+               "                        restore it on startup (off)\n"
+               "  --checkpoint-interval MS\n"
+               "                        Checkpoint period (5000)\n"
+               "  --checkpoint-max-age S\n"
+               "                        Start cold if the checkpoint is older\n"
+               "                        (300)\n"
+               "  --smoother-lag N      Run a fixed-lag smoother N updates\n"
+               "                        behind the tracks, 0 = off (0)\n"
+               "  --metrics-port N      Serve /metrics, /metrics.json, /healthz\n"
+               "                        and /readyz over HTTP, 0 = off (0)\n"
+               "  --metrics-bind ADDR   Metrics server address (127.0.0.1)\n"
+               "  --stats-interval S    Status line period, 0 = off (5)\n";
+}
+
+// Forward plots to the partition's nodes until signalled
+int RunRouter(const aegis::PipelineConfig &config, int statsIntervalSec) {
+  aegis::PlotRouter router(config.partition, config.tracker.sensors);
+  try {
+    router.Start(config.listenPort);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  auto nextStats = std::chrono::steady_clock::now() +
+                   std::chrono::seconds(statsIntervalSec);
+  while (!g_stopRequested) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (statsIntervalSec > 0 && std::chrono::steady_clock::now() >= nextStats) {
+      std::cout << "Routed: " << router.GetPlotsReceived()
+                << " Forwarded: " << router.GetPlotsForwarded()
+                << " Unrouted: " << router.GetPlotsUnrouted() << std::endl;
+      nextStats += std::chrono::seconds(statsIntervalSec);
+    }
+  }
+
+  std::cout << "Shutting down..." << std::endl;
+  router.Stop();
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  aegis::PipelineConfig config;
+  int statsIntervalSec = 5;
+  std::string partitionFile;
+  bool router = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = (i + 1 < argc);
+    if (arg == "--port" && hasValue) {
+      config.listenPort = std::atoi(argv[++i]);
+    } else if (arg == "--publish" && hasValue) {
+      std::string target = argv[++i];
+      size_t colon = target.rfind(':');
+      if (colon == std::string::npos) {
+        std::cerr << "Invalid --publish target: " << target << std::endl;
+        return 1;
+      }
+      config.publishAddress = target.substr(0, colon);
+      config.publishPort = std::atoi(target.c_str() + colon + 1);
+    } else if (arg == "--publish-interval" && hasValue) {
+      config.publishIntervalMs = std::atoi(argv[++i]);
+    } else if (arg == "--scan-rate" && hasValue) {
+      config.scanRateHz = std::atof(argv[++i]);
+      if (config.scanRateHz <= 0.0) {
+        std::cerr << "Invalid --scan-rate" << std::endl;
+        return 1;
+      }
+    } else if (arg == "--max-tracks" && hasValue) {
+      config.tracker.maxTracks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--max-tentative" && hasValue) {
+      config.tracker.maxTentativeTracks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--scan-budget" && hasValue) {
+      double budgetMs = std::atof(argv[++i]);
+      if (budgetMs < 0.0) {
+        std::cerr << "Invalid --scan-budget" << std::endl;
+        return 1;
+      }
+      config.tracker.scheduler.budget = budgetMs / 1000.0;
+    } else if (arg == "--far-range" && hasValue) {
+      config.tracker.scheduler.farRange =
+          static_cast<float>(std::atof(argv[++i]));
+    } else if (arg == "--filter" && hasValue) {
+      std::string model = argv[++i];
+      if (model == "imm") {
+        config.tracker.filterModel = aegis::TrackFilterModel::IMM;
+      } else if (model == "ekf") {
+        config.tracker.filterModel = aegis::TrackFilterModel::EKF;
+      } else {
+        std::cerr << "Invalid --filter: " << model << std::endl;
+        return 1;
+      }
+    } else if (arg == "--association" && hasValue) {
+      std::string mode = argv[++i];
+      if (mode == "global") {
+        config.tracker.association = aegis::AssociationMode::GLOBAL;
+      } else if (mode == "mht") {
+        config.tracker.association = aegis::AssociationMode::MHT;
+      } else if (mode == "nn") {
+        config.tracker.association = aegis::AssociationMode::NEAREST_NEIGHBOUR;
+      } else {
+        std::cerr << "Invalid --association: " << mode << std::endl;
+        return 1;
+      }
+    } else if (arg == "--association-threads" && hasValue) {
+      config.tracker.associationThreads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--deterministic") {
+      config.tracker.deterministic = true;
+    } else if (arg == "--mht-depth" && hasValue) {
+      config.tracker.mht.scanDepth = std::strtoul(argv[++i], nullptr, 10);
+      if (config.tracker.mht.scanDepth < 1 ||
+          config.tracker.mht.scanDepth > aegis::MAX_SCAN_DEPTH) {
+        std::cerr << "Invalid --mht-depth (1 to " << aegis::MAX_SCAN_DEPTH
+                  << ")" << std::endl;
+        return 1;
+      }
+    } else if (arg == "--mht-hypotheses" && hasValue) {
+      config.tracker.mht.maxHypotheses = std::strtoul(argv[++i], nullptr, 10);
+    } else if (arg == "--sensor" && hasValue) {
+      unsigned id = 0;
+      float sigma = 0.0f;
+      aegis::SensorConfig sensor;
+      int fields = std::sscanf(argv[++i], "%u:%f:%lf:%f:%f:%d", &id, &sigma,
+                               &sensor.latency, &sensor.originX,
+                               &sensor.originY, &sensor.listenPort);
+      if (fields < 2 || fields == 4 || id > 0xFFFF || sigma <= 0.0f ||
+          sensor.latency < 0.0) {
+        std::cerr << "Invalid --sensor: " << argv[i] << std::endl;
+        return 1;
+      }
+      sensor.id = static_cast<uint16_t>(id);
+      sensor.noise.xx = sensor.noise.yy = sigma * sigma;
+      config.tracker.sensors.push_back(sensor);
+    } else if (arg == "--partition" && hasValue) {
+      partitionFile = argv[++i];
+    } else if (arg == "--node" && hasValue) {
+      config.partitionNode = std::atoi(argv[++i]);
+    } else if (arg == "--router") {
+      router = true;
+    } else if (arg == "--fusion-id" && hasValue) {
+      config.fusionSource = static_cast<uint16_t>(std::atoi(argv[++i]));
+    } else if (arg == "--fusion-port" && hasValue) {
+      config.fusionPort = std::atoi(argv[++i]);
+    } else if (arg == "--fusion-peer" && hasValue) {
+      std::string target = argv[++i];
+      size_t colon = target.rfind(':');
+      if (colon == std::string::npos) {
+        std::cerr << "Invalid --fusion-peer: " << target << std::endl;
+        return 1;
+      }
+      aegis::FusionPeer peer;
+      peer.host = target.substr(0, colon);
+      peer.port = std::atoi(target.c_str() + colon + 1);
+      config.fusionPeers.push_back(peer);
+    } else if (arg == "--fusion-interval" && hasValue) {
+      config.fusionIntervalMs = std::atoi(argv[++i]);
+    } else if (arg == "--checkpoint" && hasValue) {
+      config.checkpointPath = argv[++i];
+    } else if (arg == "--checkpoint-interval" && hasValue) {
+      config.checkpointIntervalMs = std::atoi(argv[++i]);
+      if (config.checkpointIntervalMs <= 0) {
+        std::cerr << "Invalid --checkpoint-interval" << std::endl;
+        return 1;
+      }
+    } else if (arg == "--checkpoint-max-age" && hasValue) {
+      config.checkpointMaxAge = std::atof(argv[++i]);
+    } else if (arg == "--smoother-lag" && hasValue) {
+      config.smoother.lag = std::strtoul(argv[++i], nullptr, 10);
+      config.smoothing = config.smoother.lag > 0;
+    } else if (arg == "--metrics-port" && hasValue) {
+      config.metricsPort = std::atoi(argv[++i]);
+    } else if (arg == "--metrics-bind" && hasValue) {
+      config.metricsAddress = argv[++i];
+    } else if (arg == "--stats-interval" && hasValue) {
+      statsIntervalSec = std::atoi(argv[++i]);
+    } else {
+      PrintUsage();
+      return (arg == "--help" || arg == "-h") ? 0 : 1;
+    }
+  }
+
+  if (!partitionFile.empty()) {
+    try {
+      config.partition = aegis::PartitionMap::Load(partitionFile);
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+  bool partitioned = router || config.partitionNode >= 0;
+  if (partitioned != !partitionFile.empty() ||
+      (router && config.partitionNode >= 0) ||
+      config.partitionNode >=
+          static_cast<int>(config.partition.nodes.size())) {
+    std::cerr << "--partition needs exactly one of --router or a valid --node"
+              << std::endl;
+    return 1;
+  }
+  if (config.partitionNode >= 0) {
+    config.listenPort =
+        config.partition.nodes[config.partitionNode].plotPort;
+  }
+
+  std::signal(SIGINT, HandleSignal);
+  std::signal(SIGTERM, HandleSignal);
+
+  if (router) {
+    return RunRouter(config, statsIntervalSec);
+  }
+
+  aegis::TrackerPipeline pipeline(config);
+  try {
+    pipeline.Start();
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "Aegis Tracker Daemon Started" << std::endl;
+
+  auto nextStats = std::chrono::steady_clock::now() +
+                   std::chrono::seconds(statsIntervalSec);
+  while (!g_stopRequested) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    if (statsIntervalSec > 0 && std::chrono::steady_clock::now() >= nextStats) {
+      auto snapshot = pipeline.GetSnapshot();
+      aegis::TrackingMetrics metrics;
+      if (snapshot) {
+        metrics = snapshot->metrics;
+      }
+      std::cout << "Tracks: " << metrics.totalTracks
+                << " (C=" << metrics.confirmedTracks
+                << " T=" << metrics.tentativeTracks
+                << " X=" << metrics.coastingTracks
+                << ") Evicted: " << metrics.tracksEvicted
+                << " Plots: " << pipeline.GetPlotsReceived()
+                << " Queue: " << pipeline.GetQueueDepth();
+      if (auto smoothed = pipeline.GetSmoothedSnapshot()) {
+        std::cout << " Smoothed: " << smoothed->tracks.size();
+      }
+      std::cout << std::endl;
+      nextStats += std::chrono::seconds(statsIntervalSec);
+    }
+  }
+
+  std::cout << "Shutting down..." << std::endl;
+  pipeline.Stop();
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "../src/radar/TrackManager.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Association throughput: nearest neighbour against global association on
+// 1-8 threads and multiple hypothesis tracking (single-threaded), on a dense scene of targets flying in close groups so the
+// gated graph has clusters of several tracks. Scan time covers gating,
+// assignment, the filter updates and bookkeeping. Global association is
+// also run in deterministic mode; `output` digests every track's ID, state
+// and covariance, so equal digests are bit-identical results. Build
+// optimised (Release) for meaningful timings; speedup needs that many
+// cores.
+
+using namespace aegis;
+
+namespace {
+
+const float HALF_WIDTH = 60000.0f;
+const int GROUPS = 2500;    // Formations
+const int GROUP_SIZE = 4;   // Targets per formation, 400 m apart
+const int SCANS = 25;
+const int WARMUP_SCANS = 5; // Initiation; not timed
+
+struct Target {
+  float x, y, vx, vy;
+};
+
+struct Result {
+  double msPerScan;
+  double plotsPerSecond;
+  size_t tracks;
+  double clusters;
+  double trivial;
+  uint32_t digest;
+};
+
+// FNV-1a over the tracker state
+uint32_t Digest(const TrackManager &manager) {
+  TrackCheckpoint state;
+  manager.CaptureCheckpoint(state);
+  uint32_t hash = 2166136261u;
+  auto mix = [&hash](const void *data, size_t bytes) {
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+      hash = (hash ^ p[i]) * 16777619u;
+    }
+  };
+  for (const TrackRecord &track : state.tracks) {
+    mix(&track.id, sizeof(track.id));
+    mix(track.x.data(), sizeof(track.x));
+    mix(track.covariance.data(), sizeof(track.covariance));
+  }
+  return hash;
+}
+
+double Metric(const TrackManager &manager, const std::string &name) {
+  for (const MetricSample &sample :
+       manager.GetMetricsRegistry().Snapshot()) {
+    if (sample.name == name) {
+      return sample.value;
+    }
+  }
+  return 0.0;
+}
+
+Result Run(AssociationMode mode, size_t threads, bool deterministic = false) {
+  TrackManagerConfig config;
+  config.maxTracks = GROUPS * GROUP_SIZE * 2;
+  config.association = mode;
+  config.associationThreads = threads;
+  config.deterministic = deterministic;
+  TrackManager manager(config);
+
+  // Fixed seed: every run sees the same scene
+  unsigned int seed = 4242;
+  auto uniform = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.0f;
+  };
+  std::vector<Target> targets;
+  for (int g = 0; g < GROUPS; ++g) {
+    float x = (uniform() * 2.0f - 1.0f) * HALF_WIDTH;
+    float y = (uniform() * 2.0f - 1.0f) * HALF_WIDTH;
+    float speed = 150.0f + 100.0f * uniform();
+    float heading = uniform() * 6.2831853f;
+    for (int k = 0; k < GROUP_SIZE; ++k) {
+      targets.push_back(Target{x + 400.0f * static_cast<float>(k), y,
+                               speed * std::sin(heading),
+                               speed * std::cos(heading)});
+    }
+  }
+
+  double total = 0.0;
+  size_t plotsTotal = 0;
+  std::vector<Plot> plots;
+  for (int scan = 0; scan < SCANS; ++scan) {
+    double t = scan;
+    plots.clear();
+    for (Target &target : targets) {
+      Plot plot{};
+      plot.x = target.x + (uniform() - 0.5f) * 100.0f;
+      plot.y = target.y + (uniform() - 0.5f) * 100.0f;
+      plot.timestamp = t;
+      plots.push_back(plot);
+      target.x += target.vx;
+      target.y += target.vy;
+    }
+    auto start = std::chrono::steady_clock::now();
+    manager.ProcessScan(plots, t);
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (scan >= WARMUP_SCANS) {
+      total += seconds;
+      plotsTotal += plots.size();
+    }
+  }
+
+  Result result;
+  result.msPerScan = 1000.0 * total / (SCANS - WARMUP_SCANS);
+  result.plotsPerSecond = static_cast<double>(plotsTotal) / total;
+  result.tracks = manager.GetTrackCount();
+  result.clusters = Metric(manager, "aegis_assoc_clusters_total") / SCANS;
+  result.trivial =
+      Metric(manager, "aegis_assoc_trivial_clusters_total") / SCANS;
+  result.digest = Digest(manager);
+  return result;
+}
+
+} // namespace
+
+int main() {
+  std::printf("\n=== Association Benchmark ===\n\n");
+  std::printf("%d targets in groups of %d, %d timed scans\n\n",
+              GROUPS * GROUP_SIZE, GROUP_SIZE, SCANS - WARMUP_SCANS);
+  std::printf("mode     threads  ms/scan     plots/s  speedup  tracks"
+              "  clusters/scan  trivial/scan    output\n");
+  Result nearest = Run(AssociationMode::NEAREST_NEIGHBOUR, 1);
+  std::printf("nearest  %7d  %7.2f  %10.0f  %6.2fx  %6zu  %13s  %12s  %08x\n",
+              1, nearest.msPerScan, nearest.plotsPerSecond, 1.0,
+              nearest.tracks, "-", "-", nearest.digest);
+  double baseline = 0.0;
+  for (bool deterministic : {false, true}) {
+    for (size_t threads : {1, 2, 4, 8}) {
+      Result result = Run(AssociationMode::GLOBAL, threads, deterministic);
+      if (threads == 1 && !deterministic) {
+        baseline = result.plotsPerSecond;
+      }
+      std::printf("%-8s %7zu  %7.2f  %10.0f  %6.2fx  %6zu  %13.0f  %12.0f"
+                  "  %08x\n",
+                  deterministic ? "det" : "global", threads, result.msPerScan,
+                  result.plotsPerSecond, result.plotsPerSecond / baseline,
+                  result.tracks, result.clusters, result.trivial,
+                  result.digest);
+    }
+  }
+  Result mht = Run(AssociationMode::MHT, 1);
+  std::printf("mht      %7d  %7.2f  %10.0f  %6.2fx  %6zu  %13s  %12s  %08x\n",
+              1, mht.msPerScan, mht.plotsPerSecond,
+              mht.plotsPerSecond / baseline, mht.tracks, "-", "-",
+              mht.digest);
+  return 0;
+}
@@ -0,0 +1,216 @@
+#include "../src/physics/ExtendedKalmanFilter.h"
+#include "../src/physics/MotionModels.h"
+#include "../src/physics/StateFilter.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// CTRV predict cost: the fused single-pass propagate (one libm sin/cos pair
+// per heading) and cached velocity, against the previous path (separate Jacobian and
+// predict, each calling libm, and velocity recomputed on every read).
+// Per track per cycle: predict, update, then the three velocity reads a
+// display frame makes (scope vector, table, report). Build optimised
+// (Release) for meaningful timings.
+
+using namespace aegis;
+
+namespace {
+
+// CtrvModel as it was before the trig was fused: every call does its own
+// std::sin/std::cos
+struct LibmCtrvModel {
+  static constexpr int STATE_DIM = 5;
+  static constexpr int MEAS_DIM = 2;
+
+  static void Predict(float *x, float dt) {
+    float v = x[2], theta = x[3], w = x[4];
+    if (std::abs(w) > 0.001f) {
+      x[0] += (v / w) * (std::cos(theta) - std::cos(theta + w * dt));
+      x[1] += (v / w) * (std::sin(theta + w * dt) - std::sin(theta));
+    } else {
+      float half = w * dt / 2;
+      x[0] += v * dt * (std::sin(theta) + half * std::cos(theta));
+      x[1] += v * dt * (std::cos(theta) - half * std::sin(theta));
+    }
+    x[3] = theta + w * dt;
+    Normalize(x);
+  }
+  static void Jacobian(const float *x, float dt, float *F) {
+    detail::SetIdentity(F, 5);
+    float v = x[2], theta = x[3], w = x[4];
+    float s0 = std::sin(theta), c0 = std::cos(theta);
+    if (std::abs(w) > 0.001f) {
+      float s1 = std::sin(theta + w * dt), c1 = std::cos(theta + w * dt);
+      F[0 * 5 + 2] = (c0 - c1) / w;
+      F[0 * 5 + 3] = (v / w) * (s1 - s0);
+      F[0 * 5 + 4] = -(v / (w * w)) * (c0 - c1) + (v / w) * s1 * dt;
+      F[1 * 5 + 2] = (s1 - s0) / w;
+      F[1 * 5 + 3] = (v / w) * (c1 - c0);
+      F[1 * 5 + 4] = -(v / (w * w)) * (s1 - s0) + (v / w) * c1 * dt;
+    } else {
+      float half = w * dt / 2;
+      F[0 * 5 + 2] = dt * (s0 + half * c0);
+      F[0 * 5 + 3] = v * dt * (c0 - half * s0);
+      F[0 * 5 + 4] = v * c0 * dt * dt / 2;
+      F[1 * 5 + 2] = dt * (c0 - half * s0);
+      F[1 * 5 + 3] = -v * dt * (s0 + half * c0);
+      F[1 * 5 + 4] = -v * s0 * dt * dt / 2;
+    }
+    F[3 * 5 + 4] = dt;
+  }
+  static void Propagate(float *x, float dt, float *F) {
+    Jacobian(x, dt, F);
+    Predict(x, dt);
+  }
+  static void Normalize(float *x) { detail::WrapAngle(x[3]); }
+  // The old filter kept no velocity, so leave StateFilter's cache unfilled
+  // and recompute on each read instead (ReadVelocity below)
+  static void Velocity(const float *, float &vx, float &vy) {
+    vx = 0.0f;
+    vy = 0.0f;
+  }
+  static void RecomputeVelocity(const float *x, float &vx, float &vy) {
+    vx = x[2] * std::sin(x[3]);
+    vy = x[2] * std::cos(x[3]);
+  }
+};
+
+using FastFilter = StateFilter<float, CtrvModel>;
+using LibmFilter = StateFilter<float, LibmCtrvModel>;
+
+template <typename Filter> std::vector<Filter> MakeBank(size_t tracks) {
+  std::vector<Filter> bank;
+  bank.reserve(tracks);
+  for (size_t i = 0; i < tracks; ++i) {
+    float x = static_cast<float>(i % 100) * 10.0f;
+    float y = static_cast<float>(i / 100) * 10.0f;
+    // Turning targets, so the full coordinated-turn branch is exercised
+    float heading = 0.001f * static_cast<float>(i % 6283);
+    bank.push_back(Filter({x, y, 200.0f, heading, 0.05f},
+                          {2500.0f, 2500.0f, 10000.0f, 1.0f, 0.01f},
+                          {0.1f, 0.1f, 1.0f, 0.1f, 0.01f}, 2500.0f));
+  }
+  return bank;
+}
+
+// The previous accessor: velocity recomputed from heading on every read
+void ReadVelocity(const LibmFilter &filter, float &vx, float &vy) {
+  LibmCtrvModel::RecomputeVelocity(filter.GetState().data(), vx, vy);
+}
+void ReadVelocity(const FastFilter &filter, float &vx, float &vy) {
+  filter.GetVelocity(vx, vy);
+}
+
+// ns per track per cycle; `checksum` keeps the reads alive
+template <typename Filter>
+double MeasureCost(std::vector<Filter> &bank, int cycles, double &checksum) {
+  auto start = std::chrono::steady_clock::now();
+  float sum = 0.0f;
+  for (int c = 0; c < cycles; ++c) {
+    for (size_t i = 0; i < bank.size(); ++i) {
+      Filter &filter = bank[i];
+      filter.Predict(0.1f);
+      filter.Update({filter.GetState(0) + 5.0f, filter.GetState(1) - 5.0f});
+      for (int read = 0; read < 3; ++read) {
+        float vx, vy;
+        ReadVelocity(filter, vx, vy);
+        sum += vx + vy;
+      }
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  checksum += sum;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  return ns / (static_cast<double>(bank.size()) * cycles);
+}
+
+// Predict only, so the trig share is not diluted by the update
+template <typename Filter> double MeasurePredict(std::vector<Filter> &bank,
+                                                 int cycles) {
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; ++c) {
+    for (Filter &filter : bank)
+      filter.Predict(0.1f);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  return ns / (static_cast<double>(bank.size()) * cycles);
+}
+
+// The model step alone (state and Jacobian, no covariance), where the trig
+// lives
+template <typename Model>
+double MeasureModelStep(std::vector<std::array<float, 5>> &states, int cycles,
+                        double &checksum) {
+  float F[25];
+  float sum = 0.0f;
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; ++c) {
+    for (auto &x : states) {
+      Model::Propagate(x.data(), 0.1f, F);
+      sum += F[0 * 5 + 3] + F[1 * 5 + 4];
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  checksum += sum;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  return ns / (static_cast<double>(states.size()) * cycles);
+}
+
+} // namespace
+
+int main() {
+  std::printf("\n=== CTRV Predict Benchmark ===\n\n");
+
+  const size_t tracks = 10000;
+  const int cycles = 20;
+  auto libm = MakeBank<LibmFilter>(tracks);
+  auto fast = MakeBank<FastFilter>(tracks);
+
+  // Both paths agree to float precision over a run
+  for (int c = 0; c < 50; ++c) {
+    libm[0].Predict(1.0f);
+    fast[0].Predict(1.0f);
+  }
+  std::printf("Drift after 50 predicts: %.3g m\n\n",
+              std::hypot(libm[0].GetState(0) - fast[0].GetState(0),
+                         libm[0].GetState(1) - fast[0].GetState(1)));
+
+  // Best of several interleaved rounds, to shed scheduler noise
+  double checksum = 0.0;
+  MeasureCost(libm, 2, checksum); // Warm up
+  MeasureCost(fast, 2, checksum);
+  std::vector<std::array<float, 5>> libmStates, fastStates;
+  for (const FastFilter &filter : fast) {
+    libmStates.push_back(filter.GetState());
+    fastStates.push_back(filter.GetState());
+  }
+  double libmNs = 1e30, fastNs = 1e30, libmPredict = 1e30, fastPredict = 1e30;
+  double libmStep = 1e30, fastStep = 1e30;
+  for (int round = 0; round < 7; ++round) {
+    libmStep = std::min(libmStep, MeasureModelStep<LibmCtrvModel>(
+                                      libmStates, cycles, checksum));
+    fastStep = std::min(fastStep, MeasureModelStep<CtrvModel>(
+                                      fastStates, cycles, checksum));
+    libmNs = std::min(libmNs, MeasureCost(libm, cycles, checksum));
+    fastNs = std::min(fastNs, MeasureCost(fast, cycles, checksum));
+    libmPredict = std::min(libmPredict, MeasurePredict(libm, cycles));
+    fastPredict = std::min(fastPredict, MeasurePredict(fast, cycles));
+  }
+
+  std::printf("%zu turning tracks x %d cycles\n", tracks, cycles);
+  std::printf("  model step (x and F):      libm %7.1f ns  fused %7.1f ns  "
+              "%.2fx\n",
+              libmStep, fastStep, libmStep / fastStep);
+  std::printf("  predict:                   libm %7.1f ns  fused %7.1f ns  "
+              "%.2fx\n",
+              libmPredict, fastPredict, libmPredict / fastPredict);
+  std::printf("  predict+update+3 reads:    libm %7.1f ns  fused %7.1f ns  "
+              "%.2fx\n",
+              libmNs, fastNs, libmNs / fastNs);
+  std::printf("(checksum %g)\n", checksum);
+  return 0;
+}
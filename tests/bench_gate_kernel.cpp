@@ -0,0 +1,174 @@
+#include "../src/radar/GateKernel.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Gating throughput: the scalar per-pair test against the tile kernel, for
+// one plot per tile (what global association would give it, a tile being
+// one plot's candidate tracks; it gates pairs with the scalar test for
+// that reason) and for blocks of plots sharing a tile. The "+box"
+// column is the scalar test behind an axis-aligned box around the gate
+// ellipse, which was evaluated for the tracker and rejected (see README):
+// it is kept here so the measurement can be repeated. Build optimised
+// (Release) for meaningful timings.
+
+using namespace aegis;
+
+namespace {
+
+const int TILES = 4096;
+const int REPEATS = 20;
+
+unsigned int g_seed = 77;
+float Uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return static_cast<float>(g_seed >> 8) / 16777216.0f;
+}
+
+struct Scene {
+  std::vector<TrackPrediction> predictions; // TILES * LANES
+  std::vector<GateTrack> tracks;            // The same, packed
+  std::vector<GatePlotBlock> blocks;        // One per tile
+};
+
+Scene MakeScene(size_t plots) {
+  Scene scene;
+  for (int i = 0; i < TILES * static_cast<int>(GateTile::LANES); ++i) {
+    TrackPrediction prediction;
+    prediction.time = 0.0;
+    prediction.position = glm::vec2(1000.0f * Uniform(), 1000.0f * Uniform());
+    prediction.velocity = glm::vec2(200.0f * Uniform(), 200.0f * Uniform());
+    prediction.pxx = prediction.pyy = 2500.0f + 2500.0f * Uniform();
+    prediction.pxy = 500.0f * Uniform();
+    scene.predictions.push_back(prediction);
+    scene.tracks.emplace_back(static_cast<uint32_t>(i % GateTile::LANES),
+                              prediction);
+  }
+  scene.blocks.resize(TILES);
+  uint32_t index = 0;
+  for (GatePlotBlock &block : scene.blocks) {
+    for (size_t p = 0; p < plots; ++p) {
+      block.Add(1000.0f * Uniform(), 1000.0f * Uniform(), 0.1f * Uniform(),
+                index++);
+    }
+  }
+  return scene;
+}
+
+// The rejected prefilter: the box bounding the gate ellipse, widened 1% so
+// float rounding never rejects a pair the exact test accepts. Branch-free,
+// so a random scene costs no mispredictions.
+bool InGateBox(const TrackPrediction &prediction, float x, float y,
+               float lead, const MeasurementNoise &noise, float gate) {
+  float dx = x - (prediction.position.x + prediction.velocity.x * lead);
+  float dy = y - (prediction.position.y + prediction.velocity.y * lead);
+  float bound = gate * 1.01f;
+  return (dx * dx <= bound * (prediction.pxx + noise.xx)) &
+         (dy * dy <= bound * (prediction.pyy + noise.yy));
+}
+
+// Nanoseconds per (track, plot) pair, and pairs gated
+template <typename Run> double Time(Run &&run, size_t pairsPerRepeat,
+                                    size_t &gated) {
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPEATS; ++r) {
+    gated = run();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return 1e9 * seconds / (static_cast<double>(pairsPerRepeat) * REPEATS);
+}
+
+} // namespace
+
+int main() {
+  std::printf("\n=== Gate Kernel Benchmark ===\n\n");
+  std::printf("%d tiles of %zu tracks\n\n", TILES, GateTile::LANES);
+  std::printf("plots/tile  scalar ns/pair  +box ns/pair  boxed out  "
+              "kernel ns/pair  speedup  gated\n");
+  MeasurementNoise noise;
+  noise.xx = noise.yy = 900.0f;
+  const size_t lanes = GateTile::LANES;
+  for (size_t plots : {1, 4, 16, 64}) {
+    Scene scene = MakeScene(plots);
+    size_t pairs = TILES * lanes * plots;
+    std::vector<GatedPair> out;
+    out.reserve(pairs);
+
+    size_t scalarGated = 0, boxGated = 0, kernelGated = 0, boxedOut = 0;
+    double scalar = Time(
+        [&]() {
+          out.clear();
+          for (int t = 0; t < TILES; ++t) {
+            const GatePlotBlock &block = scene.blocks[t];
+            for (size_t p = 0; p < plots; ++p) {
+              for (size_t k = 0; k < lanes; ++k) {
+                const TrackPrediction &prediction =
+                    scene.predictions[t * lanes + k];
+                float d2 = prediction.MahalanobisDistance(
+                    block.x[p], block.y[p], block.lead[p], noise);
+                if (d2 < 9.21f) {
+                  out.push_back(GatedPair{static_cast<uint32_t>(k),
+                                          block.index[p], d2});
+                }
+              }
+            }
+          }
+          return out.size();
+        },
+        pairs, scalarGated);
+
+    double boxed = Time(
+        [&]() {
+          out.clear();
+          boxedOut = 0;
+          for (int t = 0; t < TILES; ++t) {
+            const GatePlotBlock &block = scene.blocks[t];
+            for (size_t p = 0; p < plots; ++p) {
+              for (size_t k = 0; k < lanes; ++k) {
+                const TrackPrediction &prediction =
+                    scene.predictions[t * lanes + k];
+                if (!InGateBox(prediction, block.x[p], block.y[p],
+                               block.lead[p], noise, 9.21f)) {
+                  boxedOut++;
+                  continue;
+                }
+                float d2 = prediction.MahalanobisDistance(
+                    block.x[p], block.y[p], block.lead[p], noise);
+                if (d2 < 9.21f) {
+                  out.push_back(GatedPair{static_cast<uint32_t>(k),
+                                          block.index[p], d2});
+                }
+              }
+            }
+          }
+          return out.size();
+        },
+        pairs, boxGated);
+
+    GateTile tile;
+    double kernel = Time(
+        [&]() {
+          out.clear();
+          for (int t = 0; t < TILES; ++t) {
+            tile.Clear();
+            for (size_t k = 0; k < lanes; ++k) {
+              tile.Add(scene.tracks[t * lanes + k]);
+            }
+            tile.Invert(noise);
+            tile.Gate(scene.blocks[t], 9.21f, out);
+          }
+          return out.size();
+        },
+        pairs, kernelGated);
+
+    std::printf("%10zu  %14.2f  %12.2f  %8.0f%%  %14.2f  %6.2fx  "
+                "%zu/%zu/%zu\n",
+                plots, scalar, boxed,
+                100.0 * static_cast<double>(boxedOut) /
+                    static_cast<double>(pairs),
+                kernel, scalar / kernel, kernelGated, scalarGated, boxGated);
+  }
+  return 0;
+}
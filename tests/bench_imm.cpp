@@ -0,0 +1,178 @@
+#include "../src/physics/ExtendedKalmanFilter.h"
+#include "../src/physics/ImmFilter.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// IMM vs single-model EKF: position accuracy on a manoeuvring target, and
+// cost per track per predict+update cycle, IMM both one filter at a time
+// and across tracks through ImmBatch (as Track::UpdateBatch runs it).
+// Costs are the best of several interleaved rounds. Build optimised
+// (Release) for meaningful timings.
+
+using namespace aegis;
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Deterministic Gaussian noise (LCG + Box-Muller)
+struct Noise {
+  unsigned int seed;
+  double Uniform() {
+    seed = seed * 1664525u + 1013904223u;
+    return (static_cast<double>(seed >> 8) + 0.5) / 16777216.0;
+  }
+  double Gaussian(double sigma) {
+    double u1 = Uniform(), u2 = Uniform();
+    return sigma * std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * kPi * u2);
+  }
+};
+
+// Straight legs joined by 1g and 2g coordinated turns at 1 Hz; returns the
+// turn rate for scan `step`
+double TurnRate(int step) {
+  int phase = step % 200;
+  if (phase >= 60 && phase < 90)
+    return 0.05; // ~1g at 200 m/s
+  if (phase >= 150 && phase < 165)
+    return -0.10; // ~2g
+  return 0.0;
+}
+
+struct Accuracy {
+  double rmsEkf;
+  double rmsImm;
+  double rmsEkfStraight;
+  double rmsImmStraight;
+};
+
+Accuracy MeasureAccuracy(int runs, int steps) {
+  const double sigma = 50.0;
+  double sumEkf = 0, sumImm = 0, sumEkfS = 0, sumImmS = 0;
+  int count = 0, countS = 0;
+  for (int run = 0; run < runs; ++run) {
+    Noise noise{static_cast<unsigned int>(run * 7919 + 1)};
+    double tx = 0, ty = 0, heading = 0.4, speed = 200.0;
+    ExtendedKalmanFilter ekf(0.0f, 0.0f, 0.0f, 0.0f);
+    ImmFilter<float> imm(0.0f, 0.0f, 0.0f, 0.0f);
+    for (int step = 0; step < steps; ++step) {
+      heading += TurnRate(step);
+      tx += speed * std::sin(heading);
+      ty += speed * std::cos(heading);
+      float zx = static_cast<float>(tx + noise.Gaussian(sigma));
+      float zy = static_cast<float>(ty + noise.Gaussian(sigma));
+      ekf.Predict(1.0f);
+      ekf.Update(zx, zy);
+      imm.Predict(1.0f);
+      imm.Update(zx, zy);
+      if (step < 20)
+        continue; // Skip initial convergence
+
+      double ex = ekf.GetPosition().x - tx, ey = ekf.GetPosition().y - ty;
+      double ix = imm.GetState(0) - tx, iy = imm.GetState(1) - ty;
+      sumEkf += ex * ex + ey * ey;
+      sumImm += ix * ix + iy * iy;
+      count++;
+      if (TurnRate(step) == 0.0 && TurnRate(step - 10) == 0.0) {
+        sumEkfS += ex * ex + ey * ey;
+        sumImmS += ix * ix + iy * iy;
+        countS++;
+      }
+    }
+  }
+  return {std::sqrt(sumEkf / count), std::sqrt(sumImm / count),
+          std::sqrt(sumEkfS / countS), std::sqrt(sumImmS / countS)};
+}
+
+// ns per track per predict+update cycle over a bank of filters
+template <typename Filter>
+double MeasureCost(std::vector<Filter> &bank, int cycles) {
+  std::vector<float> zx(bank.size()), zy(bank.size());
+  for (size_t i = 0; i < bank.size(); ++i) {
+    zx[i] = static_cast<float>(i % 100) * 10.0f;
+    zy[i] = static_cast<float>(i / 100) * 10.0f;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; ++c) {
+    for (size_t i = 0; i < bank.size(); ++i) {
+      bank[i].Predict(0.1f);
+      bank[i].Update(zx[i] + c * 0.5f, zy[i] + c * 0.5f);
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  return ns / (static_cast<double>(bank.size()) * cycles);
+}
+
+// As MeasureCost, a block of ImmBatch::BLOCK filters at a time
+double MeasureBatchCost(std::vector<ImmFilter<float>> &bank, int cycles) {
+  using Batch = ImmBatch<float>;
+  std::vector<ImmFilter<float> *> filters;
+  std::vector<Batch::Plot> plots(bank.size());
+  std::vector<float> dt(bank.size(), 0.1f);
+  std::unique_ptr<bool[]> ok(new bool[bank.size()]);
+  for (size_t i = 0; i < bank.size(); ++i) {
+    filters.push_back(&bank[i]);
+    plots[i] = {static_cast<float>(i % 100) * 10.0f,
+                static_cast<float>(i / 100) * 10.0f, 2500.0f, 0.0f, 2500.0f};
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < cycles; ++c) {
+    for (Batch::Plot &plot : plots) {
+      plot.x += 0.5f;
+      plot.y += 0.5f;
+    }
+    Batch::Advance(filters.data(), dt.data(), plots.data(), bank.size(),
+                   ok.get());
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  return ns / (static_cast<double>(bank.size()) * cycles);
+}
+
+} // namespace
+
+int main() {
+  std::printf("\n=== IMM Benchmark ===\n\n");
+
+  Accuracy acc = MeasureAccuracy(50, 600);
+  std::printf("Position RMS error, 50 runs x 600 scans, 50m plot noise\n");
+  std::printf("  overall:        EKF %7.2f m   IMM %7.2f m\n", acc.rmsEkf,
+              acc.rmsImm);
+  std::printf("  straight legs:  EKF %7.2f m   IMM %7.2f m\n",
+              acc.rmsEkfStraight, acc.rmsImmStraight);
+
+  const size_t tracks = 10000;
+  const int cycles = 50;
+  const int rounds = 5;
+  std::vector<ExtendedKalmanFilter> ekfBank;
+  std::vector<ImmFilter<float>> immBank, batchBank;
+  for (size_t i = 0; i < tracks; ++i) {
+    float x = static_cast<float>(i % 100) * 10.0f;
+    float y = static_cast<float>(i / 100) * 10.0f;
+    ekfBank.emplace_back(x, y, 0.0f, 0.0f);
+    immBank.emplace_back(x, y, 0.0f, 0.0f);
+  }
+  batchBank = immBank;
+  MeasureCost(ekfBank, 2); // Warm up
+  MeasureCost(immBank, 2);
+  MeasureBatchCost(batchBank, 2);
+  double ekfNs = 1e30, immNs = 1e30, batchNs = 1e30;
+  for (int round = 0; round < rounds; ++round) {
+    ekfNs = std::min(ekfNs, MeasureCost(ekfBank, cycles));
+    immNs = std::min(immNs, MeasureCost(immBank, cycles));
+    batchNs = std::min(batchNs, MeasureBatchCost(batchBank, cycles));
+  }
+  std::printf("\nPredict+update cost, %zu tracks x %d cycles, best of %d\n",
+              tracks, cycles, rounds);
+  std::printf("  EKF          %8.1f ns/track\n", ekfNs);
+  std::printf("  IMM          %8.1f ns/track   ratio %.2fx\n", immNs,
+              immNs / ekfNs);
+  std::printf("  IMM batched  %8.1f ns/track   ratio %.2fx\n", batchNs,
+              batchNs / ekfNs);
+  return 0;
+}
@@ -0,0 +1,196 @@
+#include "../src/radar/Partition.h"
+#include "../src/radar/TrackManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Partitioned tracking throughput: the same scene split into K vertical
+// strips, one TrackManager per strip with the handover exchange a
+// partitioned TrackerPipeline runs before each scan. Nodes run one after
+// another here and each is timed on its own; since real nodes are separate
+// processes, a scan takes as long as its slowest node, so aggregate
+// throughput is plots / max node time. Build optimised (Release) for
+// meaningful timings.
+
+using namespace aegis;
+
+namespace {
+
+const float HALF_WIDTH = 40000.0f; // Scene is 80 km square
+const int TARGETS = 6000;
+const int SCANS = 30;
+const int WARMUP_SCANS = 5; // Initiation; not timed
+
+struct Target {
+  float x, y, vx, vy;
+};
+
+struct Node {
+  int index;
+  TrackManager manager;
+  std::vector<Plot> plots;
+  std::vector<TrackRecord> inbox;
+
+  Node(const PartitionMap &map, int node)
+      : index(node), manager([&] {
+          TrackManagerConfig config;
+          config.maxTracks = TARGETS * 2;
+          config.initiationRegion = map.nodes[node].region;
+          config.firstTrackId = (static_cast<uint32_t>(node) << 24) + 1;
+          return config;
+        }()) {}
+};
+
+PartitionMap MakeStrips(int count) {
+  PartitionMap map;
+  float width = 2.0f * HALF_WIDTH / static_cast<float>(count);
+  map.nodes.resize(count);
+  for (int i = 0; i < count; ++i) {
+    // Outer edges stay unbounded
+    if (i > 0) {
+      map.nodes[i].region.minX = -HALF_WIDTH + width * static_cast<float>(i);
+    }
+    if (i + 1 < count) {
+      map.nodes[i].region.maxX =
+          -HALF_WIDTH + width * static_cast<float>(i + 1);
+    }
+  }
+  return map;
+}
+
+struct Result {
+  double plotsPerSecond;  // Aggregate, nodes in parallel
+  double maxNodeMs;       // Per scan
+  double sumNodeMs;       // Per scan: the work itself
+  double routedPerTarget; // Plot copies from the overlap
+  size_t tracks;
+  size_t handovers;
+};
+
+Result Run(int nodeCount) {
+  PartitionMap map = MakeStrips(nodeCount);
+  std::vector<std::unique_ptr<Node>> nodes;
+  for (int i = 0; i < nodeCount; ++i) {
+    nodes.push_back(std::make_unique<Node>(map, i));
+  }
+
+  // Fixed seed: every K sees the same scene
+  unsigned int seed = 12345;
+  auto uniform = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.0f;
+  };
+  std::vector<Target> targets(TARGETS);
+  for (Target &target : targets) {
+    target.x = (uniform() * 2.0f - 1.0f) * HALF_WIDTH;
+    target.y = (uniform() * 2.0f - 1.0f) * HALF_WIDTH;
+    float speed = 150.0f + 100.0f * uniform();
+    float heading = uniform() * 6.2831853f;
+    target.vx = speed * std::sin(heading);
+    target.vy = speed * std::cos(heading);
+  }
+
+  double maxTotal = 0.0, sumTotal = 0.0;
+  size_t plotsTotal = 0, routedTotal = 0;
+  std::vector<TrackRecord> leaving;
+  for (int scan = 0; scan < SCANS; ++scan) {
+    double t = scan;
+    for (auto &node : nodes) {
+      node->plots.clear();
+    }
+    for (Target &target : targets) {
+      Plot plot{};
+      plot.x = target.x + (uniform() - 0.5f) * 100.0f;
+      plot.y = target.y + (uniform() - 0.5f) * 100.0f;
+      plot.timestamp = t;
+      map.ForEachCovering(plot.x, plot.y, [&](int node) {
+        nodes[node]->plots.push_back(plot);
+        routedTotal += scan >= WARMUP_SCANS;
+      });
+      target.x += target.vx;
+      target.y += target.vy;
+    }
+
+    double slowest = 0.0;
+    for (auto &owned : nodes) {
+      Node &node = *owned;
+      auto start = std::chrono::steady_clock::now();
+      node.manager.AdoptTracks(node.inbox);
+      node.inbox.clear();
+      leaving.clear();
+      const Region &own = map.nodes[node.index].region;
+      node.manager.ReleaseTracks(
+          [&](glm::vec2 p) {
+            if (own.Contains(p.x, p.y, map.hysteresis)) {
+              return false;
+            }
+            int owner = map.Owner(p.x, p.y);
+            return owner >= 0 && owner != node.index;
+          },
+          leaving);
+      for (const TrackRecord &record : leaving) {
+        TrackHandover message =
+            ToHandover(record, static_cast<uint16_t>(node.index));
+        nodes[map.Owner(record.x[0], record.x[1])]->inbox.push_back(
+            FromHandover(message));
+      }
+      node.manager.ProcessScan(node.plots, t);
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      if (scan >= WARMUP_SCANS) {
+        slowest = std::max(slowest, seconds);
+        sumTotal += seconds;
+      }
+    }
+    if (scan >= WARMUP_SCANS) {
+      maxTotal += slowest;
+      plotsTotal += targets.size();
+    }
+  }
+
+  Result result;
+  int timed = SCANS - WARMUP_SCANS;
+  result.plotsPerSecond = static_cast<double>(plotsTotal) / maxTotal;
+  result.maxNodeMs = 1000.0 * maxTotal / timed;
+  result.sumNodeMs = 1000.0 * sumTotal / timed;
+  result.routedPerTarget =
+      static_cast<double>(routedTotal) / static_cast<double>(plotsTotal);
+  result.tracks = 0;
+  result.handovers = 0;
+  for (const auto &node : nodes) {
+    result.tracks += node->manager.GetTrackCount();
+    for (const MetricSample &sample :
+         node->manager.GetMetricsRegistry().Snapshot()) {
+      if (sample.name == "aegis_handover_sent_total") {
+        result.handovers += static_cast<size_t>(sample.value);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+int main() {
+  std::printf("\n=== Partition Benchmark ===\n\n");
+  std::printf("%d targets over %.0f km square, %d timed scans, strips\n\n",
+              TARGETS, 2.0f * HALF_WIDTH / 1000.0f, SCANS - WARMUP_SCANS);
+  std::printf("nodes  max node ms/scan  sum ms/scan  plots/s (aggregate)"
+              "  speedup  copies/plot  tracks  handovers\n");
+  double baseline = 0.0;
+  for (int nodes : {1, 2, 4, 8}) {
+    Result result = Run(nodes);
+    if (nodes == 1) {
+      baseline = result.plotsPerSecond;
+    }
+    std::printf("%5d  %16.2f  %11.2f  %19.0f  %6.2fx  %11.2f  %6zu  %9zu\n",
+                nodes, result.maxNodeMs, result.sumNodeMs,
+                result.plotsPerSecond, result.plotsPerSecond / baseline,
+                result.routedPerTarget, result.tracks, result.handovers);
+  }
+  return 0;
+}
@@ -0,0 +1,264 @@
+#include "../src/radar/Association.h"
+#include "../src/radar/TrackManager.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static const MetricSample *FindMetric(const std::vector<MetricSample> &all,
+                                      const std::string &name) {
+  for (const MetricSample &sample : all) {
+    if (sample.name == name) {
+      return &sample;
+    }
+  }
+  return nullptr;
+}
+
+static double MetricValue(const TrackManager &manager,
+                          const std::string &name) {
+  return FindMetric(manager.GetMetricsRegistry().Snapshot(), name)->value;
+}
+
+// Test 1: The solver matches brute force over every permutation,
+// rectangular and with forbidden entries
+TEST(TestSolveAssignment) {
+  unsigned int seed = 7;
+  auto uniform = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.0f;
+  };
+  AssignmentWorkspace workspace;
+  std::vector<int> rowToCol;
+  for (int trial = 0; trial < 200; ++trial) {
+    size_t rows = 1 + trial % 4;
+    size_t cols = rows + trial % 3;
+    std::vector<float> cost(rows * cols);
+    for (float &c : cost) {
+      c = uniform() < 0.2f ? static_cast<float>(ASSIGNMENT_FORBIDDEN)
+                           : 10.0f * uniform();
+    }
+    double total = SolveAssignment(cost.data(), rows, cols, rowToCol,
+                                   workspace);
+
+    // Brute force: every ordered choice of `rows` distinct columns
+    std::vector<int> columns(cols);
+    std::iota(columns.begin(), columns.end(), 0);
+    double best = std::numeric_limits<double>::infinity();
+    do {
+      double sum = 0.0;
+      for (size_t r = 0; r < rows; ++r) {
+        sum += cost[r * cols + static_cast<size_t>(columns[r])];
+      }
+      best = std::min(best, sum);
+    } while (std::next_permutation(columns.begin(), columns.end()));
+
+    ASSERT_NEAR(total, best, 1e-3 * std::max(1.0, best));
+    std::vector<bool> taken(cols, false);
+    for (size_t r = 0; r < rows; ++r) {
+      ASSERT_TRUE(rowToCol[r] >= 0 && !taken[rowToCol[r]]);
+      taken[rowToCol[r]] = true;
+    }
+  }
+}
+
+// Test 2: Components are found and solved apart; a component of one pair
+// skips the solver; one plot per sensor per track; misses beat bad pairs
+TEST(TestClusters) {
+  UnionFind sets;
+  sets.Reset(6);
+  sets.Union(0, 1);
+  sets.Union(4, 5);
+  sets.Union(1, 2);
+  ASSERT_TRUE(sets.Find(0) == sets.Find(2));
+  ASSERT_TRUE(sets.Find(3) != sets.Find(0) && sets.Find(4) == sets.Find(5));
+
+  // Tracks 0-1 with plots 0-1 (crossing costs), track 2 alone with plot 2,
+  // track 3 with plots 3 (sensor 0) and 4 (sensor 1)
+  std::vector<GatedPair> pairs = {
+      {0, 0, 1.0f}, {0, 1, 2.0f}, {1, 0, 2.0f}, {2, 2, 3.0f},
+      {1, 1, 8.5f}, {3, 3, 1.0f}, {3, 4, 1.0f}};
+  std::vector<uint16_t> sensors = {0, 0, 0, 0, 1};
+  ThreadPool pool(3);
+  ClusterAssociator associator;
+  std::atomic<int> calls{0};
+  associator.Solve(pairs, 4, sensors, 9.21f, &pool,
+                   [&](GatedPair *, size_t) { calls++; });
+  ASSERT_TRUE(associator.GetClusterCount() == 3);
+  ASSERT_TRUE(calls == 3);
+  ASSERT_TRUE(associator.GetClusterPairs(0) == 4);
+  ASSERT_TRUE(associator.GetClusterPairs(1) == 1);
+  ASSERT_TRUE(associator.GetClusterPairs(2) == 2);
+
+  // 0-1 and 1-0 (total 4) beat 0-0 and 1-1 (9.5)
+  std::vector<GatedPair> assigned;
+  associator.ForEachAssigned(
+      [&](const GatedPair &pair) { assigned.push_back(pair); });
+  ASSERT_TRUE(assigned.size() == 5);
+  auto has = [&](uint32_t track, uint32_t plot) {
+    for (const GatedPair &pair : assigned) {
+      if (pair.track == track && pair.plot == plot) {
+        return true;
+      }
+    }
+    return false;
+  };
+  ASSERT_TRUE(has(0, 1) && has(1, 0) && has(2, 2));
+  ASSERT_TRUE(has(3, 3) && has(3, 4)); // One from each sensor
+
+  // A second plot from the same sensor loses the track
+  pairs = {{0, 0, 1.0f}, {0, 1, 4.0f}};
+  sensors = {0, 0};
+  associator.Solve(pairs, 1, sensors, 9.21f, nullptr,
+                   [](GatedPair *, size_t) {});
+  assigned.clear();
+  associator.ForEachAssigned(
+      [&](const GatedPair &pair) { assigned.push_back(pair); });
+  ASSERT_TRUE(assigned.size() == 1 && assigned[0].plot == 0);
+}
+
+// A grid of targets flying in pairs 600 m apart, two plots per target per
+// scan from two sensors at 30 m noise, for `scans` scans
+static TrackManager *RunScene(TrackManager &manager, int scans) {
+  unsigned int seed = 99;
+  auto gaussian = [&seed]() {
+    float sum = 0.0f;
+    for (int k = 0; k < 12; ++k) {
+      seed = seed * 1664525u + 1013904223u;
+      sum += static_cast<float>(seed >> 8) / 16777216.0f;
+    }
+    return sum - 6.0f;
+  };
+  for (int scan = 0; scan < scans; ++scan) {
+    double t = scan;
+    std::vector<Plot> plots;
+    for (int i = 0; i < 40; ++i) {
+      float x = 20000.0f * static_cast<float>(i % 8) + 150.0f * scan;
+      float y = 20000.0f * static_cast<float>(i / 8) + 600.0f * (i % 2);
+      for (uint16_t sensor = 1; sensor <= 2; ++sensor) {
+        Plot plot{};
+        plot.x = x + 30.0f * gaussian();
+        plot.y = y + 30.0f * gaussian();
+        plot.timestamp = t;
+        plot.sensorId = sensor;
+        plots.push_back(plot);
+      }
+    }
+    manager.ProcessScan(plots, t);
+  }
+  return &manager;
+}
+
+static TrackManagerConfig SceneConfig(AssociationMode mode, size_t threads) {
+  TrackManagerConfig config;
+  config.association = mode;
+  config.associationThreads = threads;
+  for (uint16_t id = 1; id <= 2; ++id) {
+    SensorConfig sensor;
+    sensor.id = id;
+    sensor.noise.xx = sensor.noise.yy = 900.0f;
+    config.sensors.push_back(sensor);
+  }
+  return config;
+}
+
+// Test 3: Global association tracks every target once, with both sensors'
+// plots, and gives the same tracks on any number of threads
+TEST(TestGlobalAssociation) {
+  TrackManager serial(SceneConfig(AssociationMode::GLOBAL, 1));
+  TrackManager parallel(SceneConfig(AssociationMode::GLOBAL, 4));
+  RunScene(serial, 12);
+  RunScene(parallel, 12);
+
+  TrackSnapshot a, b;
+  serial.FillSnapshot(a, 0);
+  parallel.FillSnapshot(b, 0);
+  ASSERT_TRUE(a.tracks.size() == 40);
+  ASSERT_TRUE(b.tracks.size() == a.tracks.size());
+  for (size_t i = 0; i < a.tracks.size(); ++i) {
+    ASSERT_TRUE(a.tracks[i].state == TrackState::CONFIRMED);
+    ASSERT_TRUE(a.tracks[i].id == b.tracks[i].id);
+    ASSERT_TRUE(a.tracks[i].position == b.tracks[i].position);
+  }
+
+  // Every plot after initiation updates a track; tracks a single plot
+  // apart still form clusters of their own
+  double plots = MetricValue(serial, "aegis_plots_total");
+  double associated = MetricValue(serial, "aegis_plots_associated_total");
+  ASSERT_TRUE(plots == 40.0 * 2 * 12);
+  ASSERT_TRUE(associated >= plots - 40.0 * 2 * 3);
+  ASSERT_TRUE(MetricValue(serial, "aegis_assoc_clusters_total") > 0.0);
+  ASSERT_TRUE(MetricValue(serial, "aegis_assoc_trivial_clusters_total") <
+              MetricValue(serial, "aegis_assoc_clusters_total"));
+  ASSERT_TRUE(FindMetric(serial.GetMetricsRegistry().Snapshot(),
+                         "aegis_assoc_cluster_pairs")
+                  ->histogram.count > 0);
+
+  // Nearest neighbour on the same scene finds the same targets
+  TrackManager nearest(SceneConfig(AssociationMode::NEAREST_NEIGHBOUR, 1));
+  RunScene(nearest, 12);
+  ASSERT_TRUE(nearest.GetTrackCount() == 40);
+  ASSERT_TRUE(MetricValue(nearest, "aegis_assoc_clusters_total") == 0.0);
+}
+
+// Test 4: The pool runs every index exactly once, on distinct thread slots
+TEST(TestThreadPool) {
+  ThreadPool pool(4);
+  ASSERT_TRUE(pool.Size() == 4);
+  for (int round = 0; round < 50; ++round) {
+    std::vector<std::atomic<int>> hits(257);
+    std::vector<std::atomic<int>> busy(pool.Size());
+    std::atomic<bool> shared{false};
+    pool.ParallelFor(hits.size(), [&](size_t i, size_t thread) {
+      if (busy[thread].fetch_add(1) != 0) {
+        shared = true;
+      }
+      hits[i]++;
+      busy[thread].fetch_sub(1);
+    });
+    ASSERT_TRUE(!shared);
+    for (auto &hit : hits) {
+      ASSERT_TRUE(hit == 1);
+    }
+  }
+  ThreadPool inline_(1);
+  size_t sum = 0;
+  inline_.ParallelFor(10, [&](size_t i, size_t) { sum += i; });
+  ASSERT_TRUE(sum == 45);
+}
+
+int main() {
+  std::cout << "\n=== Association Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,272 @@
+#include "../src/radar/Checkpoint.h"
+#include "../src/radar/TrackManager.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static const MetricSample *FindMetric(const std::vector<MetricSample> &all,
+                                      const std::string &name) {
+  for (const MetricSample &sample : all) {
+    if (sample.name == name) {
+      return &sample;
+    }
+  }
+  return nullptr;
+}
+
+static std::string TempPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Three targets 100 m/s east, 5 km apart, one plot each per scan, plus
+// any `extra` plots
+static void Scan(TrackManager &manager, double t,
+                 std::vector<Plot> plots = {}) {
+  for (int i = 0; i < 3; ++i) {
+    Plot plot{};
+    plot.x = static_cast<float>(100.0 * t);
+    plot.y = 5000.0f * static_cast<float>(i);
+    plot.timestamp = t;
+    plots.push_back(plot);
+  }
+  manager.ProcessScan(plots, t);
+}
+
+static size_t ConfirmedCount(const TrackManager &manager) {
+  TrackSnapshot snapshot;
+  manager.FillSnapshot(snapshot, 0);
+  size_t confirmed = 0;
+  for (const TrackView &view : snapshot.tracks) {
+    confirmed += view.state == TrackState::CONFIRMED;
+  }
+  return confirmed;
+}
+
+// Test 1: A captured checkpoint survives the file round trip exactly
+TEST(TestFileRoundTrip) {
+  TrackManager manager;
+  for (int scan = 0; scan < 6; ++scan) {
+    Scan(manager, scan);
+  }
+  // One lone plot: a tentative track alongside the confirmed ones
+  std::vector<Plot> stray(1);
+  stray[0].x = -20000.0f;
+  stray[0].timestamp = 6.0;
+  manager.ProcessScan(stray, 6.0);
+
+  TrackCheckpoint saved;
+  manager.CaptureCheckpoint(saved);
+  saved.scanTime = 6.0;
+  ASSERT_TRUE(saved.tracks.size() == manager.GetTrackCount());
+  ASSERT_TRUE(!saved.counters.empty());
+
+  std::string path = TempPath("aegis_test_checkpoint.bin");
+  size_t bytes = SaveCheckpoint(saved, path);
+  ASSERT_TRUE(bytes == std::filesystem::file_size(path));
+  ASSERT_TRUE(!std::filesystem::exists(path + ".tmp"));
+  // Compact: the fixed record per track dominates
+  ASSERT_TRUE(bytes < 512 + saved.tracks.size() * sizeof(TrackHandover) +
+                          saved.counters.size() * 64);
+
+  TrackCheckpoint loaded = LoadCheckpoint(path);
+  ASSERT_TRUE(loaded.scanTime == saved.scanTime);
+  ASSERT_TRUE(loaded.nextTrackId == saved.nextTrackId);
+  ASSERT_TRUE(loaded.tracks.size() == saved.tracks.size());
+  for (size_t i = 0; i < saved.tracks.size(); ++i) {
+    const TrackRecord &a = saved.tracks[i], &b = loaded.tracks[i];
+    ASSERT_TRUE(a.id == b.id && a.model == b.model && a.state == b.state);
+    ASSERT_TRUE(a.hitCount == b.hitCount && a.missCount == b.missCount);
+    ASSERT_TRUE(a.stateTime == b.stateTime && a.lastUpdate == b.lastUpdate);
+    ASSERT_TRUE(a.x == b.x && a.covariance == b.covariance);
+  }
+  ASSERT_TRUE(loaded.counters == saved.counters);
+  std::filesystem::remove(path);
+}
+
+// Test 2: Missing, truncated, corrupt and foreign files are refused
+TEST(TestDamagedFiles) {
+  TrackManager manager;
+  for (int scan = 0; scan < 4; ++scan) {
+    Scan(manager, scan);
+  }
+  TrackCheckpoint checkpoint;
+  manager.CaptureCheckpoint(checkpoint);
+  std::string path = TempPath("aegis_test_damaged.bin");
+  SaveCheckpoint(checkpoint, path);
+  std::string good;
+  {
+    std::ifstream in(path, std::ios::binary);
+    good.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  }
+
+  auto refused = [&](const std::string &contents) {
+    {
+      std::ofstream out(path, std::ios::binary | std::ios::trunc);
+      out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+    try {
+      LoadCheckpoint(path);
+    } catch (const std::runtime_error &) {
+      return true;
+    }
+    return false;
+  };
+  ASSERT_TRUE(!refused(good));
+  ASSERT_TRUE(refused(good.substr(0, good.size() / 2)));
+  ASSERT_TRUE(refused(good.substr(0, 10)));
+  std::string flipped = good;
+  flipped[good.size() / 2] ^= 0x10;
+  ASSERT_TRUE(refused(flipped));
+  std::string foreign = good;
+  foreign[0] = 'X';
+  ASSERT_TRUE(refused(foreign));
+  std::filesystem::remove(path);
+
+  bool missing = false;
+  try {
+    LoadCheckpoint(path);
+  } catch (const std::runtime_error &) {
+    missing = true;
+  }
+  ASSERT_TRUE(missing);
+}
+
+// Test 3: A tracker restored after an outage longer than the track timeout
+// carries on with the same confirmed tracks from its first scan, where a
+// cold start shows nothing for several
+TEST(TestWarmRestart) {
+  TrackManager before;
+  for (int scan = 0; scan < 10; ++scan) {
+    Scan(before, scan);
+  }
+  ASSERT_TRUE(ConfirmedCount(before) == 3);
+  TrackCheckpoint checkpoint;
+  before.CaptureCheckpoint(checkpoint);
+  checkpoint.scanTime = 9.0;
+  double plots = FindMetric(before.GetMetricsRegistry().Snapshot(),
+                            "aegis_plots_total")
+                     ->value;
+
+  const double resume = 17.0; // 8 s down
+  TrackManager warm, cold;
+  ASSERT_TRUE(warm.RestoreCheckpoint(checkpoint, resume) == 3);
+  ASSERT_TRUE(ConfirmedCount(warm) == 3);
+  Scan(warm, resume);
+  Scan(cold, resume);
+  ASSERT_TRUE(warm.GetTrackCount() == 3);
+  ASSERT_TRUE(ConfirmedCount(warm) == 3);
+  ASSERT_TRUE(ConfirmedCount(cold) == 0);
+
+  // Same IDs, updated by the new plots after being predicted across the
+  // gap; the outage was not a miss
+  TrackSnapshot snapshot;
+  warm.FillSnapshot(snapshot, 0);
+  for (const TrackView &view : snapshot.tracks) {
+    ASSERT_TRUE(view.id >= 1 && view.id <= 3);
+    ASSERT_NEAR(view.position.x, 100.0f * resume, 30.0f);
+    ASSERT_TRUE(view.missCount == 0);
+  }
+
+  // New tracks continue the numbering; counters carry on from before
+  std::vector<Plot> fresh(1);
+  for (int k = 1; k <= 2; ++k) {
+    fresh[0].x = -30000.0f + 100.0f * k;
+    fresh[0].timestamp = resume + k;
+    Scan(warm, resume + k, fresh);
+  }
+  uint32_t newest = 0;
+  snapshot.tracks.clear();
+  warm.FillSnapshot(snapshot, 0);
+  for (const TrackView &view : snapshot.tracks) {
+    newest = std::max(newest, view.id);
+  }
+  ASSERT_TRUE(newest == checkpoint.nextTrackId);
+  ASSERT_NEAR(FindMetric(warm.GetMetricsRegistry().Snapshot(),
+                         "aegis_plots_total")
+                  ->value,
+              plots + 11.0, 0.0);
+
+  // A checkpoint from the future (clock stepped back) moves back whole
+  TrackManager early;
+  early.RestoreCheckpoint(checkpoint, 5.0);
+  Scan(early, 6.0);
+  ASSERT_TRUE(ConfirmedCount(early) == 3);
+}
+
+// Test 4: The writer saves on its own thread, saves once more on request,
+// and counts failures without throwing
+TEST(TestBackgroundWriter) {
+  TrackManager manager;
+  for (int scan = 0; scan < 5; ++scan) {
+    Scan(manager, scan);
+  }
+  std::string path = TempPath("aegis_test_writer.bin");
+  std::filesystem::remove(path);
+  MetricsRegistry registry;
+  {
+    CheckpointWriter writer(path, registry);
+    writer.Start();
+    TrackCheckpoint *checkpoint = writer.Acquire();
+    ASSERT_TRUE(checkpoint != nullptr);
+    manager.CaptureCheckpoint(*checkpoint);
+    checkpoint->scanTime = 4.0;
+    writer.Submit();
+    writer.Stop(); // Writes what was submitted
+  }
+  ASSERT_TRUE(LoadCheckpoint(path).tracks.size() == 3);
+  std::vector<MetricSample> metrics = registry.Snapshot();
+  ASSERT_TRUE(
+      FindMetric(metrics, "aegis_checkpoints_written_total")->value == 1.0);
+  ASSERT_TRUE(FindMetric(metrics, "aegis_checkpoint_capture_seconds")
+                  ->histogram.count == 1);
+  ASSERT_TRUE(FindMetric(metrics, "aegis_checkpoint_bytes")->value ==
+              static_cast<double>(std::filesystem::file_size(path)));
+  std::filesystem::remove(path);
+
+  MetricsRegistry failing;
+  CheckpointWriter nowhere(
+      TempPath("aegis_no_such_directory/checkpoint.bin"), failing);
+  ASSERT_TRUE(!nowhere.Write(TrackCheckpoint()));
+  ASSERT_TRUE(FindMetric(failing.Snapshot(),
+                         "aegis_checkpoint_failures_total")
+                  ->value == 1.0);
+}
+
+int main() {
+  std::cout << "\n=== Checkpoint Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
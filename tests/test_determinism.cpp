@@ -0,0 +1,210 @@
+#include "../src/radar/TrackManager.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+struct Replay {
+  TrackCheckpoint state;
+  TrackSnapshot snapshot;
+  std::vector<MetricSample> metrics;
+};
+
+// A recording of formations flying in groups of four, 300 m apart, seen by
+// two sensors with some plots late, missed or clutter, replayed through a
+// deterministic tracker
+static Replay Run(size_t threads, TrackFilterModel model) {
+  TrackManagerConfig config;
+  config.association = AssociationMode::GLOBAL;
+  config.associationThreads = threads;
+  config.filterModel = model;
+  config.deterministic = true;
+  // Tight enough that the clutter waits for a later scan or is shed
+  config.scheduler.budget = 0.55e-3;
+  config.scheduler.plotCost = 1e-6;
+  SensorConfig offset;
+  offset.id = 1;
+  offset.originX = 5000.0f;
+  offset.noise.xx = 900.0f;
+  offset.noise.yy = 1600.0f;
+  config.sensors.push_back(offset);
+  TrackManager manager(config);
+
+  unsigned int seed = 99;
+  auto uniform = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.0f;
+  };
+  struct Target {
+    float x, y, vx, vy;
+  };
+  std::vector<Target> targets;
+  for (int g = 0; g < 150; ++g) {
+    float x = (uniform() * 2.0f - 1.0f) * 30000.0f;
+    float y = (uniform() * 2.0f - 1.0f) * 30000.0f;
+    float speed = 150.0f + 100.0f * uniform();
+    float heading = 6.2831853f * uniform();
+    for (int k = 0; k < 4; ++k) {
+      targets.push_back(Target{x + 300.0f * static_cast<float>(k), y,
+                               speed * std::sin(heading),
+                               speed * std::cos(heading)});
+    }
+  }
+  std::vector<Plot> plots;
+  for (int scan = 0; scan < 12; ++scan) {
+    plots.clear();
+    for (Target &target : targets) {
+      Plot plot{};
+      plot.sensorId = uniform() < 0.3f ? 1 : 0;
+      float origin = plot.sensorId == 1 ? 5000.0f : 0.0f;
+      plot.x = target.x + (uniform() - 0.5f) * 150.0f - origin;
+      plot.y = target.y + (uniform() - 0.5f) * 150.0f;
+      plot.timestamp = scan + (plot.sensorId == 1 ? 0.4 : 0.0);
+      if (uniform() < 0.05f) {
+        plot.timestamp -= 1.2; // Late
+      }
+      if (uniform() < 0.9f) {
+        plots.push_back(plot);
+      }
+      target.x += target.vx;
+      target.y += target.vy;
+    }
+    for (int c = 0; c < 100; ++c) {
+      Plot plot{};
+      plot.x = (uniform() * 2.0f - 1.0f) * 30000.0f;
+      plot.y = (uniform() * 2.0f - 1.0f) * 30000.0f;
+      plot.timestamp = scan;
+      plots.push_back(plot);
+    }
+    manager.ProcessScan(plots, scan + 0.5);
+  }
+
+  Replay replay;
+  manager.CaptureCheckpoint(replay.state);
+  manager.FillSnapshot(replay.snapshot, 16);
+  replay.metrics = manager.GetMetricsRegistry().Snapshot();
+  return replay;
+}
+
+static bool SameBits(const void *a, const void *b, size_t bytes) {
+  return std::memcmp(a, b, bytes) == 0;
+}
+
+static bool Identical(const Replay &a, const Replay &b) {
+  if (a.state.nextTrackId != b.state.nextTrackId ||
+      a.state.tracks.size() != b.state.tracks.size() ||
+      a.state.counters != b.state.counters) {
+    return false;
+  }
+  for (size_t i = 0; i < a.state.tracks.size(); ++i) {
+    const TrackRecord &p = a.state.tracks[i], &q = b.state.tracks[i];
+    if (p.id != q.id || p.state != q.state || p.hitCount != q.hitCount ||
+        p.missCount != q.missCount || p.stateTime != q.stateTime ||
+        p.lastUpdate != q.lastUpdate ||
+        !SameBits(p.x.data(), q.x.data(), sizeof(p.x)) ||
+        !SameBits(p.covariance.data(), q.covariance.data(),
+                  sizeof(p.covariance))) {
+      return false;
+    }
+  }
+  if (a.snapshot.tracks.size() != b.snapshot.tracks.size() ||
+      a.snapshot.history.size() != b.snapshot.history.size() ||
+      !SameBits(a.snapshot.history.data(), b.snapshot.history.data(),
+                a.snapshot.history.size() * sizeof(glm::vec2))) {
+    return false;
+  }
+  for (size_t i = 0; i < a.snapshot.tracks.size(); ++i) {
+    const TrackView &p = a.snapshot.tracks[i], &q = b.snapshot.tracks[i];
+    if (p.id != q.id ||
+        !SameBits(&p.position, &q.position, sizeof(p.position)) ||
+        !SameBits(&p.velocity, &q.velocity, sizeof(p.velocity))) {
+      return false;
+    }
+  }
+  // Every metric but the durations
+  for (size_t i = 0; i < a.metrics.size(); ++i) {
+    const MetricSample &p = a.metrics[i], &q = b.metrics[i];
+    if (p.name.find("_seconds") != std::string::npos) {
+      continue;
+    }
+    if (!SameBits(&p.value, &q.value, sizeof(p.value)) ||
+        p.histogram.counts != q.histogram.counts ||
+        !SameBits(&p.histogram.sum, &q.histogram.sum, sizeof(double)) ||
+        p.stat.count != q.stat.count ||
+        !SameBits(&p.stat.mean, &q.stat.mean, sizeof(double)) ||
+        !SameBits(&p.stat.variance, &q.stat.variance, sizeof(double))) {
+      std::cerr << "  metric " << p.name << " differs" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+static double Metric(const Replay &replay, const std::string &name) {
+  for (const MetricSample &sample : replay.metrics) {
+    if (sample.name == name) {
+      return sample.value;
+    }
+  }
+  return -1.0;
+}
+
+// Test 1: The same recording gives bit-identical tracks, trails and
+// metrics on any number of threads, with either filter model, while the
+// scheduler defers and sheds plots
+TEST(TestThreadCountInvariance) {
+  for (TrackFilterModel model :
+       {TrackFilterModel::EKF, TrackFilterModel::IMM}) {
+    Replay single = Run(1, model);
+    std::cout << "  " << single.state.tracks.size() << " tracks, "
+              << Metric(single, "aegis_scan_deferred_plots_total")
+              << " plots deferred" << std::endl;
+    ASSERT_TRUE(single.state.tracks.size() > 400);
+    ASSERT_TRUE(Metric(single, "aegis_scan_deferred_plots_total") > 0.0);
+    ASSERT_TRUE(Metric(single, "aegis_oosm_plots_total") > 0.0);
+    for (size_t threads : {2, 3, 4, 8}) {
+      ASSERT_TRUE(Identical(single, Run(threads, model)));
+    }
+  }
+}
+
+// Test 2: Replaying the same recording twice on a multi-threaded pool gives
+// identical outputs, and new tracks take IDs keyed to their plots, so the
+// scans spend more IDs than they start tracks
+TEST(TestRepeatedReplay) {
+  Replay first = Run(4, TrackFilterModel::EKF);
+  Replay second = Run(4, TrackFilterModel::EKF);
+  ASSERT_TRUE(Identical(first, second));
+  double created = Metric(first, "aegis_tracks_created_total");
+  std::cout << "  " << created << " tracks created, next ID "
+            << first.state.nextTrackId << std::endl;
+  ASSERT_TRUE(created > 400.0);
+  ASSERT_TRUE(first.state.nextTrackId > created + 1.0);
+}
+
+int main() {
+  std::cout << "\n=== Determinism Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "../src/physics/ExtendedKalmanFilter.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -127,6 +128,153 @@ TEST(TestTurningMotion) {
   ASSERT_NEAR(pos.y, 0.0f, 1.0f);
 }
 
+// True if the (symmetric) covariance has a Cholesky factor, i.e. is
+// positive definite; computed in double so the check itself cannot fail
+static bool IsPositiveDefinite(const ExtendedKalmanFilter &ekf) {
+  const int n = ExtendedKalmanFilter::STATE_DIM;
+  double L[n][n] = {};
+  for (int j = 0; j < n; ++j) {
+    double d = ekf.GetCovariance(j, j);
+    for (int k = 0; k < j; ++k)
+      d -= L[j][k] * L[j][k];
+    if (!(d > 0.0))
+      return false;
+    L[j][j] = std::sqrt(d);
+    for (int i = j + 1; i < n; ++i) {
+      double v = ekf.GetCovariance(i, j);
+      for (int k = 0; k < j; ++k)
+        v -= L[i][k] * L[j][k];
+      L[i][j] = v / L[j][j];
+    }
+  }
+  return true;
+}
+
+// Test 7: An hour of 10 Hz float updates on a weaving target keeps P
+// symmetric positive definite and the gate statistic well-behaved
+TEST(TestCovarianceLongRunStability) {
+  ExtendedKalmanFilter ekf(0.0f, 0.0f, 0.0f, 0.0f);
+
+  // Deterministic pseudo-noise (uniform, +-50 m)
+  unsigned int seed = 12345;
+  auto noise = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 100.0f;
+  };
+
+  const float dt = 0.1f;
+  double tx = 0.0, ty = 0.0, heading = 0.0;
+  float maxGate = 0.0f;
+  for (int step = 1; step <= 36000; ++step) {
+    // 200 m/s with a slow sinusoidal weave
+    heading = 0.5 * std::sin(step * dt / 60.0);
+    tx += 200.0 * std::sin(heading) * dt;
+    ty += 200.0 * std::cos(heading) * dt;
+
+    ekf.Predict(dt);
+    float mx = static_cast<float>(tx) + noise();
+    float my = static_cast<float>(ty) + noise();
+    if (step > 100) {
+      maxGate = std::max(maxGate, ekf.GetMahalanobisDistance(mx, my));
+    }
+    ekf.Update(mx, my);
+
+    if (step % 100 == 0) {
+      ASSERT_TRUE(IsPositiveDefinite(ekf));
+      ASSERT_TRUE(ekf.GetCovariance(0, 1) == ekf.GetCovariance(1, 0));
+    }
+  }
+
+  float sigmaX = std::sqrt(ekf.GetCovariance(0, 0));
+  std::cout << "  Position sigma after 1h: " << sigmaX
+            << " m, max gate statistic: " << maxGate << std::endl;
+  ASSERT_TRUE(sigmaX > 1.0f && sigmaX < 50.0f);
+  ASSERT_TRUE(maxGate < 9.21f * 3.0f); // No gating blow-ups
+  ASSERT_NEAR(ekf.GetPosition().x, static_cast<float>(tx), 150.0f);
+  ASSERT_NEAR(ekf.GetPosition().y, static_cast<float>(ty), 150.0f);
+}
+
+// Test 8: A new filter's position is only as good as the plot it started
+// from, so the next plot pulls it about halfway rather than being
+// discounted against an over-confident 1 m prior
+TEST(TestPriorPositionVariance) {
+  ExtendedKalmanFilter ekf(0.0f, 0.0f, 0.0f, 0.0f);
+  ASSERT_NEAR(ekf.GetCovariance(0, 0), 2500.0f, 1e-3f);
+  ekf.Update(100.0f, -60.0f);
+  glm::vec2 pos = ekf.GetPosition();
+  ASSERT_NEAR(pos.x, 50.0f, 5.0f);
+  ASSERT_NEAR(pos.y, -30.0f, 5.0f);
+}
+
+// Test 9: Started at rest on a 250 m/s target, the filter learns the
+// speed within a few 1 s scans and every plot stays inside the 99% gate.
+// With the identity prior the first plot is already outside the gate
+// (d2 ~ 25) and the speed is still ~60 m/s after eight scans.
+TEST(TestPriorVelocityVariance) {
+  ExtendedKalmanFilter ekf(0.0f, 0.0f, 0.0f, 0.0f);
+  float maxGate = 0.0f;
+  for (int k = 1; k <= 8; ++k) {
+    ekf.Predict(1.0f);
+    float y = 250.0f * static_cast<float>(k);
+    maxGate = std::max(maxGate, ekf.GetMahalanobisDistance(0.0f, y));
+    ekf.Update(0.0f, y);
+  }
+  std::cout << "  Max gate statistic: " << maxGate
+            << ", speed after 8 scans: " << ekf.GetVelocity().y << std::endl;
+  ASSERT_TRUE(maxGate < 9.21f);
+  ASSERT_NEAR(ekf.GetVelocity().y, 250.0f, 25.0f);
+}
+
+// Test 10: Started from a single plot at rest, a 200 m/s target converges
+// on every heading. Linearised about v = 0 the velocity can only grow
+// along the guessed heading, and a free turn rate let some starts spiral
+// away (RMS error over 1 km); the second plot starts the motion instead.
+TEST(TestSinglePlotStartConverges) {
+  const double kPi = 3.14159265358979323846;
+  int diverged = 0;
+  double worst = 0.0;
+  for (unsigned int s = 0; s < 200; ++s) {
+    // Deterministic Gaussian plot noise, 50 m per axis
+    unsigned int seed = s;
+    auto uniform = [&seed]() {
+      seed = seed * 1664525u + 1013904223u;
+      return (static_cast<double>(seed >> 8) + 0.5) / 16777216.0;
+    };
+    auto noise = [&uniform, kPi]() {
+      double u1 = uniform(), u2 = uniform();
+      return static_cast<float>(50.0 * std::sqrt(-2.0 * std::log(u1)) *
+                                std::cos(2.0 * kPi * u2));
+    };
+
+    double heading = 10.0 * (s % 36) * kPi / 180.0;
+    double vx = 200.0 * std::sin(heading), vy = 200.0 * std::cos(heading);
+    float x0 = noise(), y0 = noise();
+    ExtendedKalmanFilter ekf(x0, y0, 0.0f, 0.0f);
+    double squared = 0.0;
+    int count = 0;
+    for (int k = 1; k <= 100; ++k) {
+      ekf.Predict(1.0f);
+      float mx = static_cast<float>(vx * k) + noise();
+      float my = static_cast<float>(vy * k) + noise();
+      ekf.Update(mx, my);
+      if (k >= 35) {
+        glm::vec2 pos = ekf.GetPosition();
+        double ex = pos.x - vx * k, ey = pos.y - vy * k;
+        squared += ex * ex + ey * ey;
+        ++count;
+      }
+    }
+    double rms = std::sqrt(squared / count);
+    worst = std::max(worst, rms);
+    if (rms > 100.0) {
+      ++diverged;
+    }
+  }
+  std::cout << "  Diverged: " << diverged << "/200, worst RMS: " << worst
+            << " m" << std::endl;
+  ASSERT_TRUE(diverged == 0);
+}
+
 int main() {
   std::cout << "\n=== Extended Kalman Filter Unit Tests ===" << std::endl;
   std::cout << "\nAll tests passed!\n" << std::endl;
@@ -0,0 +1,151 @@
+#include "../src/radar/GateKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static unsigned int g_seed = 5;
+static float Uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return static_cast<float>(g_seed >> 8) / 16777216.0f;
+}
+
+static TrackPrediction RandomPrediction() {
+  TrackPrediction prediction;
+  prediction.time = 10.0;
+  prediction.position = glm::vec2(2000.0f * Uniform(), 2000.0f * Uniform());
+  prediction.velocity = glm::vec2(400.0f * Uniform() - 200.0f,
+                                  400.0f * Uniform() - 200.0f);
+  float sx = 20.0f + 300.0f * Uniform(), sy = 20.0f + 300.0f * Uniform();
+  float rho = 1.8f * Uniform() - 0.9f;
+  prediction.pxx = sx * sx;
+  prediction.pyy = sy * sy;
+  prediction.pxy = rho * sx * sy;
+  return prediction;
+}
+
+// Test 1: The kernel's distances match the scalar test, and it reports
+// exactly the pairs the scalar test gates (away from the threshold),
+// for full and partial tiles and several plots at once
+TEST(TestMatchesScalarGate) {
+  const float gate = 9.21f;
+  MeasurementNoise noise;
+  noise.xx = 900.0f;
+  noise.xy = 150.0f;
+  noise.yy = 1600.0f;
+  GateTile tile;
+  std::vector<GatedPair> pairs;
+  size_t gated = 0;
+  for (int trial = 0; trial < 500; ++trial) {
+    size_t tracks = 1 + trial % GateTile::LANES;
+    std::vector<TrackPrediction> predictions;
+    tile.Clear();
+    for (size_t t = 0; t < tracks; ++t) {
+      predictions.push_back(RandomPrediction());
+      tile.Add(GateTrack(static_cast<uint32_t>(100 + t), predictions.back()));
+    }
+    ASSERT_TRUE(tile.Size() == tracks);
+    ASSERT_TRUE(tile.Full() == (tracks == GateTile::LANES));
+    tile.Invert(noise);
+
+    // Plots near the first track, some inside its gate
+    GatePlotBlock plots;
+    for (uint32_t p = 0; p < 6; ++p) {
+      float lead = 0.5f * Uniform();
+      glm::vec2 at = predictions[0].position + predictions[0].velocity * lead;
+      plots.Add(at.x + 600.0f * Uniform() - 300.0f,
+                at.y + 600.0f * Uniform() - 300.0f, lead, 7 * p);
+    }
+    pairs.clear();
+    tile.Gate(plots, gate, pairs);
+
+    for (size_t p = 0; p < plots.Size(); ++p) {
+      for (size_t t = 0; t < tracks; ++t) {
+        float d2 = predictions[t].MahalanobisDistance(
+            plots.x[p], plots.y[p], 10.0 + plots.lead[p], noise);
+        auto found = std::find_if(
+            pairs.begin(), pairs.end(), [&](const GatedPair &pair) {
+              return pair.track == 100 + t && pair.plot == plots.index[p];
+            });
+        if (std::abs(d2 - gate) < 1e-3f * gate) {
+          continue; // Rounding may fall either way
+        }
+        ASSERT_TRUE((found != pairs.end()) == (d2 < gate));
+        if (found != pairs.end()) {
+          ASSERT_NEAR(found->cost, d2, 1e-4f * std::max(1.0f, d2));
+          gated++;
+        }
+      }
+    }
+  }
+  ASSERT_TRUE(gated > 200);
+}
+
+// Test 2: A track whose innovation covariance is singular gates nothing,
+// even a plot on its predicted position; the lead carries positions along
+// the velocity
+TEST(TestSingularAndLead) {
+  GateTile tile;
+  TrackPrediction good;
+  good.time = 0.0;
+  good.position = glm::vec2(0.0f, 0.0f);
+  good.velocity = glm::vec2(100.0f, 0.0f);
+  good.pxx = good.pyy = 100.0f;
+  TrackPrediction singular = good;
+  singular.pxy = 100.0f;
+  tile.Add(GateTrack(1, good));
+  tile.Add(GateTrack(2, singular));
+  MeasurementNoise none;
+  none.xx = none.xy = none.yy = 0.0f;
+  tile.Invert(none);
+
+  GatePlotBlock plots;
+  plots.Add(200.0f, 0.0f, 2.0f, 0);
+  plots.Add(0.0f, 0.0f, 2.0f, 1);
+  std::vector<GatedPair> pairs;
+  tile.Gate(plots, 9.21f, pairs);
+  ASSERT_TRUE(pairs.size() == 1);
+  ASSERT_TRUE(pairs[0].track == 1 && pairs[0].plot == 0);
+  ASSERT_NEAR(pairs[0].cost, 0.0f, 1e-6f);
+
+  // Reused after Clear: only the new tracks report
+  tile.Clear();
+  tile.Add(GateTrack(3, good));
+  tile.Invert(none);
+  pairs.clear();
+  tile.Gate(plots, 9.21f, pairs);
+  ASSERT_TRUE(pairs.size() == 1 && pairs[0].track == 3);
+}
+
+int main() {
+  std::cout << "\n=== Gate Kernel Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
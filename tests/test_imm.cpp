@@ -0,0 +1,305 @@
+#include "../src/physics/ExtendedKalmanFilter.h"
+#include "../src/physics/ImmFilter.h"
+#include "../src/radar/Track.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+using Imm = ImmFilter<float>;
+
+// Deterministic Gaussian noise (LCG + Box-Muller)
+struct Noise {
+  unsigned int seed;
+  double Uniform() {
+    seed = seed * 1664525u + 1013904223u;
+    return (static_cast<double>(seed >> 8) + 0.5) / 16777216.0;
+  }
+  double Gaussian(double sigma) {
+    double u1 = Uniform(), u2 = Uniform();
+    return sigma * std::sqrt(-2.0 * std::log(u1)) *
+           std::cos(2.0 * 3.14159265358979323846 * u2);
+  }
+};
+
+// 1 Hz target at 200 m/s heading 0.4 rad; returns the turn rate at `step`
+// (straight, a ~1g turn from 60 to 90 s, straight again)
+static double TurnRate(int step) {
+  return (step >= 60 && step < 90) ? 0.05 : 0.0;
+}
+
+static double ModeSum(const Imm &imm) {
+  return imm.GetModeProbability(Imm::CONSTANT_VELOCITY) +
+         imm.GetModeProbability(Imm::COORDINATED_TURN) +
+         imm.GetModeProbability(Imm::MANEUVER);
+}
+
+// Test 1: Mode probabilities follow the motion: constant velocity on the
+// straight leg, the turning modes during the turn
+TEST(TestModeSwitching) {
+  Imm imm(0.0f, 0.0f, 0.0f, 0.0f);
+  Noise noise{5};
+  double tx = 0.0, ty = 0.0, heading = 0.4;
+  for (int step = 0; step < 90; ++step) {
+    heading += TurnRate(step);
+    tx += 200.0 * std::sin(heading);
+    ty += 200.0 * std::cos(heading);
+    imm.Predict(1.0f);
+    ASSERT_TRUE(imm.Update(static_cast<float>(tx + noise.Gaussian(50.0)),
+                           static_cast<float>(ty + noise.Gaussian(50.0))));
+    ASSERT_NEAR(ModeSum(imm), 1.0, 1e-5);
+
+    if (step == 59) {
+      std::cout << "  straight: mu_cv = "
+                << imm.GetModeProbability(Imm::CONSTANT_VELOCITY)
+                << std::endl;
+      ASSERT_TRUE(imm.GetModeProbability(Imm::CONSTANT_VELOCITY) > 0.5f);
+    }
+  }
+  float turning = imm.GetModeProbability(Imm::COORDINATED_TURN) +
+                  imm.GetModeProbability(Imm::MANEUVER);
+  std::cout << "  turning: mu_ct + mu_man = " << turning
+            << ", turn rate = " << imm.GetState(4) << std::endl;
+  ASSERT_TRUE(turning > 0.5f);
+  ASSERT_NEAR(imm.GetModeState(Imm::COORDINATED_TURN, 4), 0.05, 0.02);
+  // The constant-velocity mode never carries a turn rate
+  ASSERT_NEAR(imm.GetModeState(Imm::CONSTANT_VELOCITY, 4), 0.0f, 0.0f);
+}
+
+// Test 2: IMM beats the single-model EKF on a manoeuvring target
+TEST(TestAccuracyAgainstEkf) {
+  double sumEkf = 0.0, sumImm = 0.0;
+  int count = 0;
+  for (int run = 0; run < 20; ++run) {
+    Noise noise{static_cast<unsigned int>(run * 7919 + 1)};
+    ExtendedKalmanFilter ekf(0.0f, 0.0f, 0.0f, 0.0f);
+    Imm imm(0.0f, 0.0f, 0.0f, 0.0f);
+    double tx = 0.0, ty = 0.0, heading = 0.4;
+    for (int step = 0; step < 150; ++step) {
+      heading += TurnRate(step);
+      tx += 200.0 * std::sin(heading);
+      ty += 200.0 * std::cos(heading);
+      float zx = static_cast<float>(tx + noise.Gaussian(50.0));
+      float zy = static_cast<float>(ty + noise.Gaussian(50.0));
+      ekf.Predict(1.0f);
+      ekf.Update(zx, zy);
+      imm.Predict(1.0f);
+      imm.Update(zx, zy);
+      if (step < 20) {
+        continue;
+      }
+      double ex = ekf.GetPosition().x - tx, ey = ekf.GetPosition().y - ty;
+      double ix = imm.GetState(0) - tx, iy = imm.GetState(1) - ty;
+      sumEkf += ex * ex + ey * ey;
+      sumImm += ix * ix + iy * iy;
+      count++;
+    }
+  }
+  double rmsEkf = std::sqrt(sumEkf / count);
+  double rmsImm = std::sqrt(sumImm / count);
+  std::cout << "  RMS position error: EKF " << rmsEkf << " m, IMM " << rmsImm
+            << " m" << std::endl;
+  ASSERT_TRUE(rmsImm < rmsEkf);
+  ASSERT_TRUE(rmsImm < 50.0); // Below the plot noise
+}
+
+// Test 3: The combined gate statistic is consistent: averaged over a
+// straight run it sits near the 2-DOF chi-squared mean of 2
+TEST(TestGateConsistency) {
+  Imm imm(0.0f, 0.0f, 0.0f, 0.0f);
+  Noise noise{9};
+  double tx = 0.0, ty = 0.0, sum = 0.0;
+  int count = 0;
+  for (int step = 0; step < 400; ++step) {
+    tx += 150.0;
+    ty -= 80.0;
+    float zx = static_cast<float>(tx + noise.Gaussian(50.0));
+    float zy = static_cast<float>(ty + noise.Gaussian(50.0));
+    imm.Predict(1.0f);
+    if (step >= 50) {
+      sum += imm.MahalanobisDistance(zx, zy);
+      count++;
+    }
+    imm.Update(zx, zy);
+  }
+  double mean = sum / count;
+  std::cout << "  mean gate statistic: " << mean << std::endl;
+  ASSERT_TRUE(mean > 1.0 && mean < 4.0);
+
+  // Combined covariance is symmetric and its position block positive
+  float pxx = imm.GetCovariance(0, 0), pyy = imm.GetCovariance(1, 1);
+  float pxy = imm.GetCovariance(0, 1);
+  ASSERT_NEAR(pxy, imm.GetCovariance(1, 0), 0.0f);
+  ASSERT_TRUE(pxx > 0.0f && pyy > 0.0f && pxx * pyy - pxy * pxy > 0.0f);
+}
+
+// Test 4: Float and double runs of the same kernels agree
+TEST(TestFloatMatchesDouble) {
+  ImmFilter<float> f(0.0f, 0.0f, 0.0f, 0.0f);
+  ImmFilter<double> d(0.0, 0.0, 0.0, 0.0);
+  Noise noise{13};
+  double tx = 0.0, ty = 0.0, heading = 0.4;
+  for (int step = 0; step < 120; ++step) {
+    heading += TurnRate(step);
+    tx += 200.0 * std::sin(heading);
+    ty += 200.0 * std::cos(heading);
+    double zx = tx + noise.Gaussian(50.0), zy = ty + noise.Gaussian(50.0);
+    f.Predict(1.0f);
+    f.Update(static_cast<float>(zx), static_cast<float>(zy));
+    d.Predict(1.0);
+    d.Update(zx, zy);
+  }
+  ASSERT_NEAR(static_cast<double>(f.GetState(0)), d.GetState(0), 1.0);
+  ASSERT_NEAR(static_cast<double>(f.GetState(1)), d.GetState(1), 1.0);
+  ASSERT_NEAR(static_cast<double>(f.GetModeProbability(Imm::MANEUVER)),
+              d.GetModeProbability(ImmFilter<double>::MANEUVER), 1e-2);
+}
+
+// Test 5: The estimator is chosen per track, and again on Reset
+TEST(TestTrackFilterSelection) {
+  Track ekfTrack(1, 0.0f, 0.0f, 0.0);
+  Track immTrack(2, 0.0f, 0.0f, 0.0, TrackFilterModel::IMM);
+  ASSERT_TRUE(ekfTrack.GetFilterModel() == TrackFilterModel::EKF);
+  ASSERT_TRUE(ekfTrack.GetImm() == nullptr);
+  ASSERT_TRUE(immTrack.GetFilterModel() == TrackFilterModel::IMM);
+  ASSERT_TRUE(immTrack.GetImm() != nullptr);
+
+  for (int step = 1; step <= 10; ++step) {
+    immTrack.Update(100.0f * step, 70.0f * step, step);
+  }
+  ASSERT_NEAR(immTrack.GetPosition().x, 1000.0f, 20.0f);
+  ASSERT_NEAR(immTrack.GetPosition().y, 700.0f, 20.0f);
+  ASSERT_NEAR(immTrack.GetVelocity().x, 100.0f, 20.0f);
+  ASSERT_TRUE(immTrack.GetMahalanobisDistance(1000.0f, 700.0f) < 9.21f);
+
+  immTrack.Reset(3, 0.0f, 0.0f, 0.0, TrackFilterModel::EKF);
+  ASSERT_TRUE(immTrack.GetFilterModel() == TrackFilterModel::EKF);
+}
+
+// Test 6: Filters advanced through ImmBatch, across a partial block and
+// with per-track steps and noise, end where their own Predict and Update
+// leave them; Track's batch entry points match the per-track calls
+TEST(TestBatchMatchesFilters) {
+  const int count = 11;
+  std::vector<Imm> own, batched;
+  for (int i = 0; i < count; ++i) {
+    own.emplace_back(100.0f * i, -50.0f * i, 150.0f + 10.0f * i, 0.3f * i);
+  }
+  batched = own;
+  Noise noise{29};
+  std::vector<Imm *> filters;
+  for (Imm &f : batched) {
+    filters.push_back(&f);
+  }
+  for (int step = 0; step < 60; ++step) {
+    std::vector<float> dt(count);
+    std::vector<ImmBatch<float>::Plot> plots(count);
+    for (int i = 0; i < count; ++i) {
+      dt[i] = 0.5f + 0.1f * static_cast<float>((i + step) % 7);
+      const float turn = (step > 20 && i % 3 == 0) ? 0.05f : 0.0f;
+      const float heading = 0.3f * i + turn * static_cast<float>(step);
+      const float speed = 150.0f + 10.0f * i;
+      plots[i].x = own[i].GetState(0) + speed * dt[i] * std::sin(heading) +
+                   static_cast<float>(noise.Gaussian(50.0));
+      plots[i].y = own[i].GetState(1) + speed * dt[i] * std::cos(heading) +
+                   static_cast<float>(noise.Gaussian(50.0));
+      plots[i].rxx = 2500.0f + 100.0f * i;
+      plots[i].rxy = 10.0f * i;
+      plots[i].ryy = 2500.0f;
+      own[i].Predict(dt[i]);
+      own[i].Update(plots[i].x, plots[i].y, plots[i].rxx, plots[i].rxy,
+                    plots[i].ryy);
+    }
+    bool ok[count];
+    ImmBatch<float>::Predict(filters.data(), dt.data(), count);
+    ImmBatch<float>::Update(filters.data(), plots.data(), count, ok);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_TRUE(ok[i]);
+    }
+  }
+  for (int i = 0; i < count; ++i) {
+    for (int n = 0; n < Imm::STATE_DIM; ++n) {
+      ASSERT_NEAR(batched[i].GetState(n), own[i].GetState(n),
+                  1e-4f * (1.0f + std::abs(own[i].GetState(n))));
+    }
+    for (int mode = 0; mode < Imm::MODES; ++mode) {
+      ASSERT_NEAR(batched[i].GetModeProbability(mode),
+                  own[i].GetModeProbability(mode), 1e-5f);
+      ASSERT_NEAR(batched[i].GetModeCovariance(mode, 0, 0),
+                  own[i].GetModeCovariance(mode, 0, 0),
+                  1e-4f * own[i].GetModeCovariance(mode, 0, 0));
+    }
+  }
+
+  // Tracks: mixed IMM and EKF, one of them taking a late plot
+  std::vector<Track> single, batch;
+  for (int i = 0; i < count; ++i) {
+    single.emplace_back(i + 1, 1000.0f * i, 0.0f, 0.0,
+                        (i % 4 == 0) ? TrackFilterModel::EKF
+                                     : TrackFilterModel::IMM);
+  }
+  batch = single;
+  std::vector<Track *> tracks;
+  for (Track &track : batch) {
+    tracks.push_back(&track);
+  }
+  for (int step = 1; step <= 10; ++step) {
+    const double time = step;
+    Track::PredictBatch(tracks.data(), count, time);
+    std::vector<TrackPlot> plots(count);
+    for (int i = 0; i < count; ++i) {
+      const TrackPrediction &expected = single[i].PredictTo(time);
+      const TrackPrediction &actual = batch[i].PredictTo(time);
+      ASSERT_NEAR(actual.position.x, expected.position.x, 1e-2f);
+      ASSERT_NEAR(actual.position.y, expected.position.y, 1e-2f);
+      ASSERT_NEAR(actual.velocity.x, expected.velocity.x, 1e-2f);
+      ASSERT_NEAR(actual.sxx, expected.sxx, 1e-3f * expected.sxx);
+      ASSERT_NEAR(actual.pxy, expected.pxy, 1e-3f * (1.0f + expected.pxx));
+
+      plots[i].x = 1000.0f * i + 120.0f * step;
+      plots[i].y = 80.0f * step;
+      plots[i].timestamp = (i == 5 && step == 6) ? time - 1.5 : time;
+      single[i].Update(plots[i].x, plots[i].y, plots[i].timestamp);
+    }
+    Track::UpdateBatch(tracks.data(), plots.data(), count);
+  }
+  for (int i = 0; i < count; ++i) {
+    ASSERT_NEAR(batch[i].GetPosition().x, single[i].GetPosition().x, 1e-2f);
+    ASSERT_NEAR(batch[i].GetPosition().y, single[i].GetPosition().y, 1e-2f);
+    ASSERT_NEAR(batch[i].GetVelocity().y, single[i].GetVelocity().y, 1e-2f);
+    ASSERT_TRUE(batch[i].GetStateTime() == single[i].GetStateTime());
+    ASSERT_TRUE(batch[i].GetCheckpointCount() ==
+                single[i].GetCheckpointCount());
+  }
+}
+
+int main() {
+  std::cout << "\n=== IMM Estimator Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
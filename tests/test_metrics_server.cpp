@@ -0,0 +1,138 @@
+#include "../src/network/MetricsServer.h"
+#include "../src/radar/MetricsRegistry.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+using namespace aegis::net;
+
+// Blocking one-shot HTTP client; returns the raw response
+static std::string HttpGet(int port, const std::string &request) {
+  SocketHandle s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (connect(s, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+      kSocketError) {
+    CloseSocket(s);
+    return "";
+  }
+  SetSocketReceiveTimeout(s, 2000);
+
+  send(s, request.data(), static_cast<int>(request.size()), kSendFlags);
+  std::string response;
+  char buffer[1024];
+  int bytes;
+  while ((bytes = recv(s, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, static_cast<size_t>(bytes));
+  }
+  CloseSocket(s);
+  return response;
+}
+
+static bool Contains(const std::string &text, const std::string &needle) {
+  return text.find(needle) != std::string::npos;
+}
+
+// Test 1: Prometheus output carries cumulative buckets, sums and counts
+TEST(TestPrometheusFormat) {
+  MetricsRegistry registry;
+  registry.AddCounter("aegis_plots_total", "Plots").Add(42);
+  registry.AddGauge("aegis_tracks", "Tracks").Set(7);
+  Histogram &latency =
+      registry.AddHistogram("aegis_scan_seconds", "Scan", {0.001, 0.01});
+  latency.Observe(0.0005);
+  latency.Observe(0.005);
+  latency.Observe(0.5);
+  StatAccumulator &error = registry.AddStat("aegis_error_meters", "Error");
+  error.Add(1.0);
+  error.Add(3.0);
+
+  std::string text = FormatPrometheus(registry.Snapshot());
+  ASSERT_TRUE(Contains(text, "# TYPE aegis_plots_total counter\n"
+                             "aegis_plots_total 42\n"));
+  ASSERT_TRUE(Contains(text, "aegis_tracks 7\n"));
+  ASSERT_TRUE(Contains(text, "aegis_scan_seconds_bucket{le=\"0.001\"} 1\n"));
+  ASSERT_TRUE(Contains(text, "aegis_scan_seconds_bucket{le=\"0.01\"} 2\n"));
+  ASSERT_TRUE(Contains(text, "aegis_scan_seconds_bucket{le=\"+Inf\"} 3\n"));
+  ASSERT_TRUE(Contains(text, "aegis_scan_seconds_count 3\n"));
+  ASSERT_TRUE(Contains(text, "aegis_error_meters_sum 4\n"));
+  ASSERT_TRUE(Contains(text, "aegis_error_meters_count 2\n"));
+
+  std::string json = FormatJson(registry.Snapshot());
+  ASSERT_TRUE(Contains(json, "\"aegis_plots_total\": 42"));
+  ASSERT_TRUE(Contains(json, "{\"le\": null, \"count\": 1}"));
+  ASSERT_TRUE(Contains(json, "\"mean\": 2"));
+}
+
+// Test 2: Routes are served over loopback; unknown paths and methods fail
+TEST(TestServeRoutes) {
+  MetricsRegistry registry;
+  Counter &plots = registry.AddCounter("aegis_plots_total", "Plots");
+  plots.Add(5);
+
+  std::atomic<bool> healthy{true};
+  MetricsServer server;
+  server.AddRoute("/metrics", [&] {
+    HttpResponse response;
+    response.body = FormatPrometheus(registry.Snapshot());
+    return response;
+  });
+  server.AddRoute("/healthz", [&] {
+    HttpResponse response;
+    response.status = healthy ? 200 : 503;
+    response.body = healthy ? "ok\n" : "stalled\n";
+    return response;
+  });
+  server.Start("127.0.0.1", 0);
+  ASSERT_TRUE(server.GetPort() > 0);
+
+  std::string response =
+      HttpGet(server.GetPort(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+  ASSERT_TRUE(Contains(response, "HTTP/1.1 200 OK\r\n"));
+  ASSERT_TRUE(Contains(response, "aegis_plots_total 5\n"));
+
+  // Values are read at request time
+  plots.Add(1);
+  response = HttpGet(server.GetPort(), "GET /metrics?x=1 HTTP/1.0\r\n\r\n");
+  ASSERT_TRUE(Contains(response, "aegis_plots_total 6\n"));
+
+  healthy = false;
+  response = HttpGet(server.GetPort(), "GET /healthz HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(Contains(response, "HTTP/1.1 503 Service Unavailable\r\n"));
+
+  response = HttpGet(server.GetPort(), "GET /nope HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(Contains(response, "HTTP/1.1 404 Not Found\r\n"));
+  response = HttpGet(server.GetPort(), "POST /metrics HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(Contains(response, "HTTP/1.1 405 Method Not Allowed\r\n"));
+
+  server.Stop();
+  response = HttpGet(server.GetPort(), "GET /metrics HTTP/1.1\r\n\r\n");
+  ASSERT_TRUE(response.empty());
+}
+
+int main() {
+  std::cout << "\n=== Metrics Server Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,315 @@
+#include "../src/radar/MultiHypothesis.h"
+#include "../src/radar/TrackManager.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static double MetricValue(const MetricsRegistry &registry,
+                          const std::string &name) {
+  for (const MetricSample &sample : registry.Snapshot()) {
+    if (sample.name == name) {
+      return sample.value;
+    }
+  }
+  return -1.0;
+}
+
+// Test 1: The k best assignments are brute force's k cheapest, in order,
+// each a valid assignment of the cost it reports
+TEST(TestKBestAssignments) {
+  unsigned int seed = 11;
+  auto uniform = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / 16777216.0f;
+  };
+  KBestWorkspace workspace;
+  std::vector<int> assignments;
+  std::vector<double> costs;
+  for (int trial = 0; trial < 100; ++trial) {
+    size_t rows = 1 + trial % 4;
+    size_t cols = rows + trial % 3;
+    std::vector<float> cost(rows * cols);
+    for (float &c : cost) {
+      c = uniform() < 0.15f ? static_cast<float>(ASSIGNMENT_FORBIDDEN)
+                            : 10.0f * uniform();
+    }
+
+    // Brute force: the cost of every feasible assignment
+    std::vector<double> all;
+    std::vector<int> columns(cols);
+    std::iota(columns.begin(), columns.end(), 0);
+    do {
+      double sum = 0.0;
+      bool feasible = true;
+      for (size_t r = 0; r < rows; ++r) {
+        float c = cost[r * cols + static_cast<size_t>(columns[r])];
+        feasible = feasible && c < ASSIGNMENT_FORBIDDEN;
+        sum += c;
+      }
+      if (feasible) {
+        all.push_back(sum);
+      }
+      // Columns past `rows` are unused: skip their orderings
+      std::reverse(columns.begin() + static_cast<std::ptrdiff_t>(rows),
+                   columns.end());
+    } while (std::next_permutation(columns.begin(), columns.end()));
+    std::sort(all.begin(), all.end());
+
+    size_t k = 1 + trial % 7;
+    assignments.clear();
+    costs.clear();
+    size_t found = SolveKBestAssignments(cost.data(), rows, cols, k,
+                                         assignments, costs, workspace);
+    ASSERT_TRUE(found == std::min(k, all.size()));
+    ASSERT_TRUE(costs.size() == found && assignments.size() == found * rows);
+    for (size_t h = 0; h < found; ++h) {
+      ASSERT_NEAR(costs[h], all[h], 1e-3 * std::max(1.0, all[h]));
+      std::vector<bool> taken(cols, false);
+      double sum = 0.0;
+      for (size_t r = 0; r < rows; ++r) {
+        int col = assignments[h * rows + r];
+        ASSERT_TRUE(col >= 0 && !taken[col]);
+        taken[col] = true;
+        sum += cost[r * cols + static_cast<size_t>(col)];
+      }
+      ASSERT_NEAR(sum, costs[h], 1e-3 * std::max(1.0, sum));
+    }
+  }
+}
+
+// Test 2: Branches written in one frame are read in the next, carried
+// while their track is untouched, and dropped on collapse, deletion or
+// when the arena is full
+TEST(TestHypothesisForest) {
+  MetricsRegistry registry;
+  MhtConfig config;
+  config.maxHypotheses = 4;
+  HypothesisForest forest(config, registry);
+  TrackPool pool;
+  TrackHandle a = pool.Create(1, 0.0f, 0.0f, 0.0);
+  TrackHandle b = pool.Create(2, 1000.0f, 0.0f, 0.0);
+  TrackHandle c = pool.Create(3, 2000.0f, 0.0f, 0.0);
+
+  HypothesisBranch root;
+  HypothesisForest::FromTrack(*pool.Get(a), root);
+  ASSERT_TRUE(root.depth == 0 && root.history[0] == HypothesisForest::MISS);
+  HypothesisBranch hit, miss;
+  HypothesisForest::Extend(root, 5, hit);
+  HypothesisForest::Extend(hit, HypothesisForest::MISS, miss);
+  ASSERT_TRUE(hit.hit && hit.depth == 1 && hit.history[0] == 5);
+  ASSERT_TRUE(!miss.hit && miss.depth == 2 && miss.history[1] == 5);
+
+  forest.BeginFrame();
+  HypothesisBranch *out = forest.Store(a, 2);
+  ASSERT_TRUE(out != nullptr);
+  out[0] = hit;
+  out[1] = miss;
+  out[1].score = -2.0f;
+  ASSERT_TRUE(forest.Store(b, 2) != nullptr);
+  ASSERT_TRUE(forest.Store(c, 2) == nullptr); // Full
+  forest.EndFrame(pool);
+  ASSERT_TRUE(forest.GetBranchCount() == 4);
+  ASSERT_TRUE(MetricValue(registry, "aegis_mht_collapsed_total") == 1.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_mht_branches") == 4.0);
+
+  // Read back; a untouched and carried, b resolved
+  forest.BeginFrame();
+  size_t count = 0;
+  const HypothesisBranch *branches = forest.Branches(a, count);
+  ASSERT_TRUE(count == 2 && branches[0].history[0] == 5);
+  ASSERT_NEAR(branches[1].score, -2.0f, 1e-6f);
+  forest.Branches(c, count);
+  ASSERT_TRUE(count == 0);
+  forest.Collapse(b);
+  forest.EndFrame(pool);
+  ASSERT_TRUE(forest.GetBranchCount() == 2);
+
+  forest.BeginFrame();
+  forest.Branches(a, count);
+  ASSERT_TRUE(count == 2);
+  forest.Branches(b, count);
+  ASSERT_TRUE(count == 0);
+
+  // A deleted track's branches are not carried, even if its slot is reused
+  pool.Destroy(a);
+  TrackHandle reused = pool.Create(4, 0.0f, 0.0f, 0.0);
+  forest.EndFrame(pool);
+  forest.BeginFrame();
+  forest.Branches(reused, count);
+  ASSERT_TRUE(count == 0);
+  ASSERT_TRUE(forest.GetBranchCount() == 0);
+}
+
+// Test 3: Two tracks that both gate two plots keep a branch for each plot;
+// a track with one clear plot keeps one
+TEST(TestSelectBranches) {
+  MetricsRegistry registry;
+  HypothesisForest forest(MhtConfig(), registry);
+  TrackPool pool;
+  std::vector<TrackHandle> targets = {pool.Create(1, 0.0f, 0.0f, 0.0),
+                                      pool.Create(2, 100.0f, 0.0f, 0.0),
+                                      pool.Create(3, 9000.0f, 0.0f, 0.0)};
+  forest.BeginFrame();
+  float miss = forest.MissScore();
+  // Near even pairs for tracks 0-1 and plots 0-1, a clear one for 2-2
+  std::vector<GatedPair> pairs = {{0, 0, miss - 10.0f},
+                                  {0, 1, miss - 9.8f},
+                                  {1, 0, miss - 9.9f},
+                                  {1, 1, miss - 10.0f},
+                                  {2, 2, miss - 10.0f}};
+  std::vector<uint32_t> parents(pairs.size(), 0);
+  std::vector<BranchChoice> choices;
+  forest.Select(pairs, parents, targets, 3, choices);
+
+  auto kept = [&](uint32_t target) {
+    std::vector<BranchChoice> out;
+    for (const BranchChoice &choice : choices) {
+      if (choice.target == target) {
+        out.push_back(choice);
+      }
+    }
+    return out;
+  };
+  std::vector<BranchChoice> first = kept(0), second = kept(1),
+                            third = kept(2);
+  ASSERT_TRUE(first.size() == 2 && second.size() == 2);
+  ASSERT_TRUE(first[0].best && first[0].plot == 0 && first[1].plot == 1);
+  ASSERT_TRUE(second[0].best && second[0].plot == 1 &&
+              second[1].plot == 0);
+  ASSERT_NEAR(first[0].score, 10.0f, 1e-4f);
+  ASSERT_TRUE(third.size() == 1 && third[0].plot == 2 && third[0].best);
+  ASSERT_TRUE(MetricValue(registry, "aegis_mht_hypotheses_total") > 2.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_mht_pruned_total") > 0.0);
+}
+
+// Two targets flying through each other at a shallow angle, one plot each
+// per scan at 30 m noise. Returns the targets whose track at the end of
+// the run is not one that held a target before the crossing.
+static int RunCrossing(TrackManager &manager, unsigned int seed) {
+  auto gaussian = [&seed]() {
+    float sum = 0.0f;
+    for (int k = 0; k < 12; ++k) {
+      seed = seed * 1664525u + 1013904223u;
+      sum += static_cast<float>(seed >> 8) / 16777216.0f;
+    }
+    return sum - 6.0f;
+  };
+  auto truth = [](int target, int scan) {
+    float angle = target ? 0.05f : -0.05f;
+    float dt = static_cast<float>(scan - 15);
+    return glm::vec2(200.0f * dt * std::cos(angle),
+                     200.0f * dt * std::sin(angle));
+  };
+  auto nearest = [&](int target, int scan) {
+    TrackSnapshot snapshot;
+    manager.FillSnapshot(snapshot, 0);
+    uint32_t id = 0;
+    float closest = 150.0f;
+    for (const TrackView &view : snapshot.tracks) {
+      float d = glm::distance(view.position, truth(target, scan));
+      if (d < closest) {
+        closest = d;
+        id = view.id;
+      }
+    }
+    return id;
+  };
+
+  uint32_t before[2] = {0, 0};
+  for (int scan = 0; scan < 30; ++scan) {
+    std::vector<Plot> plots;
+    for (int target = 0; target < 2; ++target) {
+      Plot plot{};
+      plot.x = truth(target, scan).x + 30.0f * gaussian();
+      plot.y = truth(target, scan).y + 30.0f * gaussian();
+      plot.timestamp = scan;
+      plot.sensorId = 1;
+      plots.push_back(plot);
+    }
+    manager.ProcessScan(plots, scan);
+    if (scan == 10) {
+      before[0] = nearest(0, scan);
+      before[1] = nearest(1, scan);
+    }
+  }
+  int broken = 0;
+  for (int target = 0; target < 2; ++target) {
+    uint32_t id = nearest(target, 29);
+    if (id == 0 || (id != before[0] && id != before[1])) {
+      broken++;
+    }
+  }
+  return broken;
+}
+
+static TrackManagerConfig CrossingConfig(AssociationMode mode) {
+  TrackManagerConfig config;
+  config.association = mode;
+  SensorConfig sensor;
+  sensor.id = 1;
+  sensor.noise.xx = sensor.noise.yy = 900.0f;
+  config.sensors.push_back(sensor);
+  return config;
+}
+
+// Test 4: Through a crossing, deferring the decision keeps far more tracks
+// than nearest neighbour does, revising some choices and holding few
+// branches once the targets part
+TEST(TestCrossingTargets) {
+  int nearestBroken = 0, mhtBroken = 0;
+  double reversals = 0.0;
+  for (unsigned int seed = 1; seed <= 20; ++seed) {
+    TrackManager nearest(CrossingConfig(AssociationMode::NEAREST_NEIGHBOUR));
+    nearestBroken += RunCrossing(nearest, seed * 7919u);
+
+    TrackManager mht(CrossingConfig(AssociationMode::MHT));
+    mhtBroken += RunCrossing(mht, seed * 7919u);
+    const MetricsRegistry &registry = mht.GetMetricsRegistry();
+    reversals += MetricValue(registry, "aegis_mht_reversals_total");
+    ASSERT_TRUE(MetricValue(registry, "aegis_mht_hypotheses_total") > 0.0);
+    ASSERT_TRUE(MetricValue(registry, "aegis_mht_branches") <= 4.0);
+    ASSERT_TRUE(MetricValue(registry, "aegis_mht_collapsed_total") == 0.0);
+    ASSERT_TRUE(MetricValue(nearest.GetMetricsRegistry(),
+                            "aegis_mht_hypotheses_total") == 0.0);
+  }
+  std::cout << "  broken tracks: nearest " << nearestBroken << ", MHT "
+            << mhtBroken << "; reversals " << reversals << std::endl;
+  ASSERT_TRUE(mhtBroken * 4 <= nearestBroken);
+  ASSERT_TRUE(reversals > 0.0);
+}
+
+int main() {
+  std::cout << "\n=== MHT Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
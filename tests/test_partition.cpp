@@ -0,0 +1,354 @@
+#include "../src/radar/Partition.h"
+#include "../src/radar/Track.h"
+#include "../src/radar/TrackManager.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static const MetricSample *FindMetric(const std::vector<MetricSample> &all,
+                                      const std::string &name) {
+  for (const MetricSample &sample : all) {
+    if (sample.name == name) {
+      return &sample;
+    }
+  }
+  return nullptr;
+}
+
+// West (x < 0) and east (x >= 0) halves of the plane
+static PartitionMap MakeStrips() {
+  PartitionMap map;
+  map.nodes.resize(2);
+  map.nodes[0].region.maxX = 0.0f;
+  map.nodes[1].region.minX = 0.0f;
+  return map;
+}
+
+static Plot MakePlot(float x, float y, double timestamp) {
+  Plot plot{};
+  plot.x = x;
+  plot.y = y;
+  plot.timestamp = timestamp;
+  return plot;
+}
+
+// One partition node in-process: the manager a TrackerPipeline would run,
+// plus the handover exchange it does before each scan
+struct Node {
+  int index;
+  TrackManager manager;
+  std::vector<TrackRecord> inbox;
+
+  Node(const PartitionMap &map, int node) : index(node), manager([&] {
+    TrackManagerConfig config;
+    config.initiationRegion = map.nodes[node].region;
+    config.firstTrackId = (static_cast<uint32_t>(node) << 24) + 1;
+    return config;
+  }()) {}
+
+  void Exchange(const PartitionMap &map, std::vector<Node *> &nodes) {
+    manager.AdoptTracks(inbox);
+    inbox.clear();
+    std::vector<TrackRecord> leaving;
+    const Region &own = map.nodes[index].region;
+    manager.ReleaseTracks(
+        [&](glm::vec2 p) {
+          if (own.Contains(p.x, p.y, map.hysteresis)) {
+            return false;
+          }
+          int owner = map.Owner(p.x, p.y);
+          return owner >= 0 && owner != index;
+        },
+        leaving);
+    for (const TrackRecord &record : leaving) {
+      // Through the wire form, as between processes
+      TrackHandover message =
+          ToHandover(record, static_cast<uint16_t>(index));
+      nodes[map.Owner(record.x[0], record.x[1])]->inbox.push_back(
+          FromHandover(message));
+    }
+  }
+};
+
+// Test 1: Ownership is half-open, plots reach every node whose region
+// grown by the overlap covers them, and maps load from text and are
+// checked
+TEST(TestPartitionMap) {
+  PartitionMap map = MakeStrips();
+  ASSERT_TRUE(map.Owner(-1.0f, 0.0f) == 0);
+  ASSERT_TRUE(map.Owner(0.0f, 0.0f) == 1); // Shared edge: exactly one owner
+
+  std::vector<int> covering;
+  auto collect = [&](float x) {
+    covering.clear();
+    map.ForEachCovering(x, 0.0f, [&](int node) { covering.push_back(node); });
+  };
+  collect(-5000.0f);
+  ASSERT_TRUE(covering.size() == 1 && covering[0] == 0);
+  collect(-1500.0f); // Within the 2 km overlap of the east strip
+  ASSERT_TRUE(covering.size() == 2);
+  collect(1999.0f);
+  ASSERT_TRUE(covering.size() == 2);
+  collect(2500.0f);
+  ASSERT_TRUE(covering.size() == 1 && covering[0] == 1);
+
+  PartitionMap bounded;
+  bounded.nodes.resize(1);
+  bounded.nodes[0].region = Region{0.0f, 0.0f, 10.0f, 10.0f};
+  ASSERT_TRUE(bounded.Owner(20.0f, 5.0f) == -1);
+
+  const std::string path = "test_partition_map.txt";
+  {
+    std::ofstream file(path);
+    file << "# Two strips\n"
+            "overlap 1000\n"
+            "hysteresis 250  # m\n"
+            "\n"
+            "node -50000 -50000 0 50000 127.0.0.1 5701 5801\n"
+            "node 0 -50000 50000 50000 10.0.0.2 5702 5802\n";
+  }
+  PartitionMap loaded = PartitionMap::Load(path);
+  ASSERT_TRUE(loaded.nodes.size() == 2);
+  ASSERT_NEAR(loaded.overlap, 1000.0f, 0.0f);
+  ASSERT_NEAR(loaded.hysteresis, 250.0f, 0.0f);
+  ASSERT_TRUE(loaded.nodes[1].host == "10.0.0.2");
+  ASSERT_TRUE(loaded.nodes[1].plotPort == 5702);
+  ASSERT_TRUE(loaded.nodes[1].handoverPort == 5802);
+  ASSERT_TRUE(loaded.Owner(10.0f, 0.0f) == 1);
+
+  {
+    std::ofstream file(path);
+    file << "node -50000 -50000 0 50000 127.0.0.1 5701 5801\n"
+            "node 10 0 0 10 127.0.0.1 5702 5802\n"; // Empty region
+  }
+  bool threw = false;
+  try {
+    PartitionMap::Load(path);
+  } catch (const std::runtime_error &e) {
+    threw = std::string(e.what()).find(":2:") != std::string::npos;
+  }
+  ASSERT_TRUE(threw);
+
+  // Hysteresis at the overlap: named by whichever of the two came last
+  {
+    std::ofstream file(path);
+    file << "hysteresis 1000\n"
+            "node -50000 -50000 0 50000 127.0.0.1 5701 5801\n"
+            "overlap 1000\n";
+  }
+  threw = false;
+  try {
+    PartitionMap::Load(path);
+  } catch (const std::runtime_error &e) {
+    threw = std::string(e.what()).find(":3:") != std::string::npos;
+  }
+  ASSERT_TRUE(threw);
+  std::remove(path.c_str());
+}
+
+// Test 2: A track exported and rebuilt (via the wire form) carries on as
+// the same track, for both estimators
+TEST(TestRecordRoundTrip) {
+  for (TrackFilterModel model : {TrackFilterModel::EKF, TrackFilterModel::IMM}) {
+    Track original(42, 0.0f, 0.0f, 0.0, model);
+    for (int scan = 1; scan <= 8; ++scan) {
+      original.Update(150.0f * scan, 100.0f * scan, scan);
+    }
+    TrackRecord record;
+    original.Export(record);
+    ASSERT_TRUE(record.id == 42 && record.model == model);
+    ASSERT_TRUE(record.hitCount == original.GetHitCount());
+    ASSERT_NEAR(record.stateTime, 8.0, 0.0);
+
+    TrackRecord received = FromHandover(ToHandover(record, 3));
+    ASSERT_TRUE(received.id == 42 && received.model == model);
+    ASSERT_TRUE(received.state == record.state);
+    for (size_t i = 0; i < record.covariance.size(); ++i) {
+      ASSERT_NEAR(received.covariance[i], record.covariance[i], 0.0f);
+    }
+
+    Track rebuilt(1, 0.0f, 0.0f, 0.0, TrackFilterModel::EKF);
+    rebuilt.Reset(received);
+    ASSERT_TRUE(rebuilt.GetId() == 42);
+    ASSERT_TRUE(rebuilt.GetState() == original.GetState());
+    ASSERT_NEAR(rebuilt.GetPosition().x, original.GetPosition().x, 1e-3f);
+    ASSERT_NEAR(rebuilt.GetVelocity().y, original.GetVelocity().y, 1e-3f);
+
+    // Both predict the next plot alike, and take it alike
+    const TrackPrediction &a = original.PredictTo(9.0);
+    const TrackPrediction &b = rebuilt.PredictTo(9.0);
+    ASSERT_NEAR(b.position.x, a.position.x, 1.0f);
+    ASSERT_NEAR(b.pxx, a.pxx, 0.05f * a.pxx);
+    original.Update(1350.0f, 900.0f, 9.0);
+    rebuilt.Update(1350.0f, 900.0f, 9.0);
+    ASSERT_NEAR(rebuilt.GetPosition().x, original.GetPosition().x, 5.0f);
+  }
+}
+
+// Test 3: A target flying across the boundary is handed over once and
+// keeps its ID; the receiving node's own short-lived copy is discarded
+TEST(TestHandoverAcrossBoundary) {
+  PartitionMap map = MakeStrips();
+  Node west(map, 0), east(map, 1);
+  std::vector<Node *> nodes = {&west, &east};
+
+  std::vector<Plot> plots[2];
+  uint32_t id = 0;
+  for (int scan = 0; scan < 60; ++scan) {
+    double t = scan;
+    // 200 m/s east from x = -6 km, crossing at t = 30
+    Plot plot = MakePlot(static_cast<float>(-6000.0 + 200.0 * t), 8000.0f, t);
+    plots[0].clear();
+    plots[1].clear();
+    map.ForEachCovering(plot.x, plot.y,
+                        [&](int node) { plots[node].push_back(plot); });
+    for (Node *node : nodes) {
+      node->Exchange(map, nodes);
+      node->manager.ProcessScan(plots[node->index], t);
+    }
+
+    // Once the target is past the edge the east node starts its own
+    // tentative track on it, until the west node hands over its track
+    // `hysteresis` further on and adoption resolves the pair
+    size_t total = west.manager.GetTrackCount() + east.manager.GetTrackCount();
+    bool inBand = plot.x >= 0.0f && plot.x < map.hysteresis + 200.0f;
+    if (scan >= 3) {
+      ASSERT_TRUE(inBand ? total <= 2 : total == 1);
+      TrackSnapshot snapshot;
+      // The original stays with the west node until it is handed over
+      (west.manager.GetTrackCount() ? west : east)
+          .manager.FillSnapshot(snapshot, 0);
+      if (id == 0) {
+        id = snapshot.tracks[0].id;
+      }
+      ASSERT_TRUE(snapshot.tracks[0].id == id);
+    }
+  }
+  ASSERT_TRUE(id == 1); // Started by the west node
+  ASSERT_TRUE(east.manager.GetTrackCount() == 1);
+
+  auto counter = [](const Node &node, const std::string &name) {
+    return FindMetric(node.manager.GetMetricsRegistry().Snapshot(), name)
+        ->value;
+  };
+  ASSERT_TRUE(counter(west, "aegis_handover_sent_total") == 1.0);
+  ASSERT_TRUE(counter(east, "aegis_handover_adopted_total") == 1.0);
+  ASSERT_TRUE(counter(east, "aegis_handover_duplicates_total") == 1.0);
+  ASSERT_TRUE(counter(east, "aegis_plots_outside_region_total") > 0.0);
+}
+
+// The track another node would hand over after seeing a target moving
+// 100 m/s east along y = 0 from `firstScan` to `lastScan`
+static TrackRecord RemoteRecord(int firstScan, int lastScan, float offsetY) {
+  TrackManager remote;
+  std::vector<Plot> plots(1);
+  for (int scan = firstScan; scan <= lastScan; ++scan) {
+    plots[0] = MakePlot(100.0f * scan, offsetY, scan);
+    remote.ProcessScan(plots, scan);
+  }
+  std::vector<TrackRecord> records;
+  remote.ReleaseTracks([](glm::vec2) { return true; }, records);
+  ASSERT_TRUE(records.size() == 1);
+  return records[0];
+}
+
+// Test 4: Without the region check both nodes start a track on the same
+// target; adopting the other's copy keeps only the better-established one
+TEST(TestDuplicateResolution) {
+  TrackManager local;
+  std::vector<Plot> plots(1);
+  for (int scan = 0; scan < 3; ++scan) {
+    plots[0] = MakePlot(100.0f * scan, 0.0f, scan);
+    local.ProcessScan(plots, scan);
+  }
+  ASSERT_TRUE(local.GetTrackCount() == 1);
+
+  // The remote copy has seen the target for longer
+  TrackRecord record = RemoteRecord(-4, 2, 0.0f);
+  record.id = 7;
+  ASSERT_TRUE(local.AdoptTracks({record}) == 1);
+  ASSERT_TRUE(local.GetTrackCount() == 1);
+  TrackSnapshot snapshot;
+  local.FillSnapshot(snapshot, 0);
+  ASSERT_TRUE(snapshot.tracks.size() == 1 && snapshot.tracks[0].id == 7);
+
+  // A weaker copy of the same target is dropped instead
+  record = RemoteRecord(1, 2, 0.0f);
+  record.id = 9;
+  ASSERT_TRUE(local.AdoptTracks({record}) == 0);
+  TrackSnapshot after;
+  local.FillSnapshot(after, 0);
+  ASSERT_TRUE(after.tracks.size() == 1 && after.tracks[0].id == 7);
+
+  // A track elsewhere is simply adopted
+  record = RemoteRecord(0, 2, 30000.0f);
+  record.id = 11;
+  ASSERT_TRUE(local.AdoptTracks({record}) == 1);
+  ASSERT_TRUE(local.GetTrackCount() == 2);
+
+  std::vector<MetricSample> metrics = local.GetMetricsRegistry().Snapshot();
+  ASSERT_TRUE(
+      FindMetric(metrics, "aegis_handover_duplicates_total")->value == 2.0);
+  ASSERT_TRUE(
+      FindMetric(metrics, "aegis_handover_adopted_total")->value == 2.0);
+}
+
+// Test 5: Only plots inside the initiation region start tracks, and IDs
+// count from the configured base
+TEST(TestInitiationRegion) {
+  TrackManagerConfig config;
+  config.initiationRegion = Region{0.0f, 0.0f, 10000.0f, 10000.0f};
+  config.firstTrackId = (3u << 24) + 1;
+  TrackManager manager(config);
+
+  for (int scan = 0; scan < 2; ++scan) {
+    float x = 5000.0f + 100.0f * scan;
+    std::vector<Plot> plots = {MakePlot(x, 5000.0f, scan),
+                               MakePlot(x - 10000.0f, 5000.0f, scan)};
+    manager.ProcessScan(plots, scan);
+  }
+  ASSERT_TRUE(manager.GetTrackCount() == 1);
+  TrackSnapshot snapshot;
+  manager.FillSnapshot(snapshot, 0);
+  ASSERT_TRUE(snapshot.tracks[0].id == (3u << 24) + 1);
+  std::vector<MetricSample> metrics = manager.GetMetricsRegistry().Snapshot();
+  ASSERT_TRUE(
+      FindMetric(metrics, "aegis_plots_outside_region_total")->value == 2.0);
+}
+
+int main() {
+  std::cout << "\n=== Partition Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,296 @@
+#include "../src/radar/ScanScheduler.h"
+#include "../src/radar/TrackManager.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+static const MetricSample *FindMetric(const std::vector<MetricSample> &all,
+                                      const std::string &name) {
+  for (const MetricSample &sample : all) {
+    if (sample.name == name) {
+      return &sample;
+    }
+  }
+  return nullptr;
+}
+
+static double MetricValue(const MetricsRegistry &registry,
+                          const std::string &name) {
+  return FindMetric(registry.Snapshot(), name)->value;
+}
+
+static Plot MakePlot(uint32_t id, float x, float y, double t) {
+  Plot plot{};
+  plot.id = id;
+  plot.x = x;
+  plot.y = y;
+  plot.timestamp = t;
+  return plot;
+}
+
+// Test 1: Plots come back most important first, and a scan that overruns
+// its budget still processes the essential classes, defers the rest up to
+// the limits and sheds far clutter
+TEST(TestPriorityOrderAndShedding) {
+  MetricsRegistry registry;
+  ScanSchedulerConfig config;
+  config.budget = 0.05;
+  config.maxDeferred = 2;
+  ScanScheduler scheduler(config, registry);
+  ASSERT_TRUE(scheduler.Enabled());
+
+  // Queued in reverse: ID = priority
+  ASSERT_TRUE(scheduler.BeginScan(0.0).empty());
+  for (int i = static_cast<int>(PLOT_PRIORITY_COUNT) - 1; i >= 0; --i) {
+    for (int copy = 0; copy < 2; ++copy) {
+      scheduler.Add(MakePlot(static_cast<uint32_t>(i), 0.0f, 0.0f, 0.0),
+                    static_cast<PlotPriority>(i));
+    }
+  }
+  std::vector<uint32_t> order;
+  scheduler.Run([&](const Plot *plots, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      order.push_back(plots[i].id);
+    }
+  });
+  ASSERT_TRUE(order.size() == 2 * PLOT_PRIORITY_COUNT);
+  for (size_t i = 1; i < order.size(); ++i) {
+    ASSERT_TRUE(order[i - 1] <= order[i]);
+  }
+  ASSERT_TRUE(!scheduler.OverBudget());
+  ASSERT_TRUE(scheduler.RefreshMetrics());
+
+  // The manoeuvring and established plots go as one batch, which blows
+  // the budget
+  scheduler.BeginScan(1.0);
+  scheduler.Add(MakePlot(0, 0.0f, 0.0f, 1.0), PlotPriority::MANOEUVRING);
+  scheduler.Add(MakePlot(1, 0.0f, 0.0f, 1.0), PlotPriority::ESTABLISHED);
+  scheduler.Add(MakePlot(2, 0.0f, 0.0f, 1.0), PlotPriority::TENTATIVE);
+  scheduler.Add(MakePlot(3, 0.0f, 0.0f, 1.0), PlotPriority::INITIATION);
+  scheduler.Add(MakePlot(3, 0.0f, 0.0f, 1.0), PlotPriority::INITIATION);
+  scheduler.Add(MakePlot(4, 0.0f, 0.0f, 1.0), PlotPriority::FAR_CLUTTER);
+  order.clear();
+  scheduler.Run([&](const Plot *plots, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (plots[i].id == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+      }
+      order.push_back(plots[i].id);
+    }
+  });
+  ASSERT_TRUE(order.size() == 2 && order[0] == 0 && order[1] == 1);
+  ASSERT_TRUE(scheduler.OverBudget());
+  ASSERT_TRUE(scheduler.GetDeferredCount() == 2); // Tentative + 1 initiation
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_over_budget_total") == 1.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_deferred_plots_total") ==
+              2.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_shed_plots_total") == 2.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_deferred_plots") == 2.0);
+  ASSERT_TRUE(FindMetric(registry.Snapshot(), "aegis_scan_priority_seconds")
+                  ->histogram.count == 2);
+
+  // Overloaded scans refresh the gauges only every metricsThinning scans
+  ASSERT_TRUE(!scheduler.RefreshMetrics());
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_metrics_skipped_total") ==
+              1.0);
+
+  // Deferred plots come back for the next scan while young enough
+  const std::vector<Plot> &carried = scheduler.BeginScan(1.5);
+  ASSERT_TRUE(carried.size() == 2);
+  ASSERT_TRUE(carried[0].id == 2 && carried[1].id == 3);
+  ASSERT_TRUE(!scheduler.OverBudget());
+  ASSERT_TRUE(scheduler.GetDeferredCount() == 0);
+  for (const Plot &plot : carried) {
+    scheduler.Add(plot, PlotPriority::TENTATIVE);
+  }
+  order.clear();
+  scheduler.Run([&](const Plot *plots, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      order.push_back(plots[i].id);
+    }
+  });
+  ASSERT_TRUE(order.size() == 2);
+}
+
+// Test 2: Plots deferred for longer than maxDeferredAge are shed
+TEST(TestDeferredPlotsAge) {
+  MetricsRegistry registry;
+  ScanSchedulerConfig config;
+  config.budget = 1e-9; // Always over
+  config.maxDeferredAge = 1.0;
+  ScanScheduler scheduler(config, registry);
+
+  scheduler.BeginScan(0.0);
+  scheduler.Add(MakePlot(1, 0.0f, 0.0f, 0.0), PlotPriority::INITIATION);
+  scheduler.Run([](const Plot *, size_t) {});
+  ASSERT_TRUE(scheduler.GetDeferredCount() == 1);
+
+  // Deferred again at 0.8 s, too old by 1.2 s
+  const std::vector<Plot> &carried = scheduler.BeginScan(0.8);
+  ASSERT_TRUE(carried.size() == 1);
+  scheduler.Add(carried[0], PlotPriority::INITIATION);
+  scheduler.Run([](const Plot *, size_t) {});
+  ASSERT_TRUE(scheduler.BeginScan(1.2).empty());
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_deferred_plots_total") ==
+              2.0);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_shed_plots_total") == 1.0);
+}
+
+// Test 3: An EKF track reports manoeuvring in a turn, not on a straight leg
+TEST(TestManoeuvringTrack) {
+  Track straight(1, 0.0f, 0.0f, 0.0);
+  Track turning(2, 0.0f, 1000.0f, 0.0);
+  for (int k = 1; k <= 20; ++k) {
+    double t = k;
+    straight.Update(100.0f * k, 0.0f, t);
+    // 100 m/s round a 1 km circle: 0.1 rad/s
+    float angle = 0.1f * static_cast<float>(k);
+    turning.Update(1000.0f * std::sin(angle), 1000.0f * std::cos(angle), t);
+  }
+  ASSERT_TRUE(!straight.IsManoeuvring());
+  ASSERT_TRUE(turning.IsManoeuvring());
+}
+
+// Test 4: A tracker that can never meet its budget keeps every confirmed
+// track updated while it defers and sheds the plots near no track, and
+// thins its trails and gauges
+TEST(TestOverloadedTracker) {
+  auto targets = [](double t) {
+    std::vector<Plot> plots;
+    for (int i = 0; i < 3; ++i) {
+      plots.push_back(MakePlot(static_cast<uint32_t>(i),
+                               static_cast<float>(100.0 * t),
+                               5000.0f * static_cast<float>(i), t));
+    }
+    return plots;
+  };
+
+  // Three confirmed tracks, carried over from an unscheduled tracker
+  TrackManager warmup;
+  for (int scan = 0; scan < 6; ++scan) {
+    warmup.ProcessScan(targets(scan), scan);
+  }
+  TrackCheckpoint checkpoint;
+  warmup.CaptureCheckpoint(checkpoint);
+  checkpoint.scanTime = 5.0;
+
+  TrackManagerConfig config;
+  config.scheduler.budget = 1e-9;
+  config.scheduler.farRange = 30000.0f;
+  TrackManager manager(config);
+  ASSERT_TRUE(manager.RestoreCheckpoint(checkpoint, 5.0) == 3);
+  const MetricsRegistry &registry = manager.GetMetricsRegistry();
+  double created = MetricValue(registry, "aegis_tracks_created_total");
+
+  const int scans = 8;
+  for (int scan = 6; scan < 6 + scans; ++scan) {
+    double t = scan;
+    std::vector<Plot> plots = targets(t);
+    // Clutter near no track: one in range, one far out
+    plots.push_back(MakePlot(10, -20000.0f, -20000.0f, t));
+    plots.push_back(MakePlot(11, 60000.0f, 60000.0f, t));
+    manager.ProcessScan(plots, t);
+  }
+
+  TrackSnapshot snapshot;
+  manager.FillSnapshot(snapshot, 0);
+  ASSERT_TRUE(snapshot.tracks.size() == 3);
+  for (const TrackView &view : snapshot.tracks) {
+    ASSERT_TRUE(view.state == TrackState::CONFIRMED);
+    ASSERT_TRUE(view.missCount == 0);
+    ASSERT_NEAR(view.position.x, 100.0f * (5 + scans), 30.0f);
+  }
+  ASSERT_TRUE(MetricValue(registry, "aegis_tracks_created_total") == created);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_over_budget_total") == scans);
+  // The near clutter plot waits a scan, then ages out
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_deferred_plots_total") >=
+              scans);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_shed_plots_total") >=
+              scans);
+  ASSERT_TRUE(MetricValue(registry, "aegis_plots_associated_total") ==
+              MetricValue(warmup.GetMetricsRegistry(),
+                          "aegis_plots_associated_total") +
+                  3.0 * scans);
+  ASSERT_TRUE(MetricValue(registry, "aegis_trail_points_skipped_total") ==
+              3.0 * scans);
+  ASSERT_TRUE(MetricValue(registry, "aegis_scan_metrics_skipped_total") > 0.0);
+  ASSERT_TRUE(FindMetric(registry.Snapshot(), "aegis_scan_priority_seconds")
+                  ->histogram.count == scans);
+
+  // Off by default: nothing is scheduled or shed
+  TrackManager plain;
+  for (int scan = 0; scan < 6; ++scan) {
+    plain.ProcessScan(targets(scan), scan);
+  }
+  ASSERT_TRUE(MetricValue(plain.GetMetricsRegistry(),
+                          "aegis_scan_over_budget_total") == 0.0);
+  ASSERT_TRUE(MetricValue(plain.GetMetricsRegistry(),
+                          "aegis_trail_points_skipped_total") == 0.0);
+}
+
+// Test 5: A deterministic scheduler keeps time by plot count: a chunk
+// that sleeps past the real deadline changes nothing
+TEST(TestModelledDeadline) {
+  for (bool deterministic : {false, true}) {
+    MetricsRegistry registry;
+    ScanSchedulerConfig config;
+    config.budget = 0.005;
+    config.plotCost = 1e-4; // 50 plots
+    ScanScheduler scheduler(config, registry, deterministic);
+    scheduler.BeginScan(0.0);
+    for (uint32_t i = 0; i < 100; ++i) {
+      scheduler.Add(MakePlot(i, 0.0f, 0.0f, 0.0), PlotPriority::INITIATION);
+    }
+    size_t processed = 0;
+    scheduler.Run([&](const Plot *, size_t count) {
+      if (processed == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      processed += count;
+    });
+    ASSERT_TRUE(scheduler.OverBudget());
+    if (deterministic) {
+      // Checked before each chunk of 16: 0, 16, 32 and 48 are under 50
+      ASSERT_TRUE(processed == 64);
+      ASSERT_TRUE(scheduler.GetDeferredCount() == 36);
+    } else {
+      ASSERT_TRUE(processed == 16);
+    }
+  }
+}
+
+int main() {
+  std::cout << "\n=== Scan Scheduler Unit Tests ===\n" << std::endl;
+  std::cout << "\nAll tests passed!" << std::endl;
+  return 0;
+}
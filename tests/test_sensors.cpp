@@ -0,0 +1,250 @@
+#include "../src/radar/SensorMerger.h"
+#include "../src/radar/SensorRegistry.h"
+#include "../src/radar/Track.h"
+#include "../src/radar/TrackManager.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+// Deterministic Gaussian noise (LCG + Box-Muller)
+struct Noise {
+  unsigned int seed;
+  double Uniform() {
+    seed = seed * 1664525u + 1013904223u;
+    return (static_cast<double>(seed >> 8) + 0.5) / 16777216.0;
+  }
+  double Gaussian(double sigma) {
+    double u1 = Uniform(), u2 = Uniform();
+    return sigma * std::sqrt(-2.0 * std::log(u1)) *
+           std::cos(2.0 * 3.14159265358979323846 * u2);
+  }
+};
+
+static SensorConfig MakeSensor(uint16_t id, float sigma, double latency = 0.0,
+                               float originX = 0.0f, float originY = 0.0f) {
+  SensorConfig sensor;
+  sensor.id = id;
+  sensor.noise.xx = sensor.noise.yy = sigma * sigma;
+  sensor.latency = latency;
+  sensor.originX = originX;
+  sensor.originY = originY;
+  return sensor;
+}
+
+static Plot MakePlot(uint16_t sensorId, float x, float y, double timestamp) {
+  Plot plot{};
+  plot.sensorId = sensorId;
+  plot.x = x;
+  plot.y = y;
+  plot.timestamp = timestamp;
+  return plot;
+}
+
+static const MetricSample *FindMetric(const std::vector<MetricSample> &all,
+                                      const std::string &name) {
+  for (const MetricSample &sample : all) {
+    if (sample.name == name) {
+      return &sample;
+    }
+  }
+  return nullptr;
+}
+
+// Test 1: Lookups by ID, with unknown IDs standing in as sensor 0, and the
+// legacy plot size still recognisable on the wire
+TEST(TestRegistryLookup) {
+  SensorRegistry registry;
+  ASSERT_TRUE(registry.Size() == 1);
+  ASSERT_NEAR(registry.Get(0).noise.xx, 2500.0f, 0.0f);
+  ASSERT_NEAR(registry.GetMaxLatency(), 0.0, 0.0);
+
+  registry.Register(MakeSensor(7, 10.0f, 0.25, 1000.0f, -500.0f));
+  registry.Register(MakeSensor(3, 100.0f, 0.5));
+  ASSERT_TRUE(registry.Size() == 3);
+  ASSERT_TRUE(registry.Get(7).id == 7);
+  ASSERT_NEAR(registry.Get(7).noise.yy, 100.0f, 0.0f);
+  ASSERT_NEAR(registry.Get(7).originX, 1000.0f, 0.0f);
+  ASSERT_TRUE(registry.Contains(3) && !registry.Contains(5));
+  ASSERT_TRUE(registry.Get(5).id == 0);     // Never registered
+  ASSERT_TRUE(registry.Get(60000).id == 0); // Beyond every ID
+  ASSERT_NEAR(registry.GetMaxLatency(), 0.5, 0.0);
+
+  // Re-registering replaces in place
+  registry.Register(MakeSensor(7, 20.0f));
+  ASSERT_TRUE(registry.Size() == 3);
+  ASSERT_NEAR(registry.Get(7).noise.xx, 400.0f, 0.0f);
+  registry.Register(MakeSensor(0, 30.0f));
+  ASSERT_NEAR(registry.Get(5).noise.xx, 900.0f, 0.0f);
+
+  ASSERT_TRUE(sizeof(Plot) == 34);
+  ASSERT_TRUE(LEGACY_PLOT_SIZE == 32);
+}
+
+// Test 2: The update and the gate use the plot's own noise: an accurate
+// sensor outweighs a coarse one whichever reports first, for both
+// estimators
+TEST(TestPerSensorNoise) {
+  MeasurementNoise fine{25.0f, 0.0f, 25.0f};        // 5 m
+  MeasurementNoise coarse{90000.0f, 0.0f, 90000.0f}; // 300 m
+  for (TrackFilterModel model : {TrackFilterModel::EKF, TrackFilterModel::IMM}) {
+    Track fineFirst(1, 0.0f, 0.0f, 0.0, model);
+    fineFirst.Update(0.0f, 0.0f, 1.0, fine);
+    fineFirst.Update(400.0f, 0.0f, 1.0, coarse);
+    ASSERT_NEAR(fineFirst.GetPosition().x, 0.0f, 5.0f);
+
+    Track coarseFirst(1, 0.0f, 0.0f, 0.0, model);
+    coarseFirst.Update(400.0f, 0.0f, 1.0, coarse);
+    coarseFirst.Update(0.0f, 0.0f, 1.0, fine);
+    ASSERT_NEAR(coarseFirst.GetPosition().x, 0.0f, 5.0f);
+
+    // Equal default noise splits the difference instead
+    Track equal(1, 0.0f, 0.0f, 0.0, model);
+    equal.Update(0.0f, 0.0f, 1.0);
+    equal.Update(400.0f, 0.0f, 1.0);
+    ASSERT_TRUE(equal.GetPosition().x > 100.0f);
+
+    // Gating: default noise matches the filter's own S, and a plot the
+    // same distance off is further out for the more accurate sensor
+    const TrackPrediction &p = fineFirst.PredictTo(2.0);
+    float own = p.MahalanobisDistance(50.0f, 30.0f, 2.0);
+    float viaDefault =
+        p.MahalanobisDistance(50.0f, 30.0f, 2.0, MeasurementNoise());
+    ASSERT_NEAR(viaDefault, own, 1e-4f * own);
+    ASSERT_TRUE(p.MahalanobisDistance(50.0f, 30.0f, 2.0, fine) >
+                p.MahalanobisDistance(50.0f, 30.0f, 2.0, coarse));
+  }
+}
+
+// Test 3: Lanes merge in timestamp order, held back by the slowest
+// sensor's latency; with no latency everything queued is released
+TEST(TestMergeOrder) {
+  SensorRegistry registry;
+  registry.Register(MakeSensor(1, 50.0f, 0.5)); // Slow link
+  registry.Register(MakeSensor(2, 50.0f, 0.0));
+  SensorMerger merger(registry);
+
+  merger.Push(MakePlot(2, 0.0f, 0.0f, 1.0));
+  merger.Push(MakePlot(2, 0.0f, 0.0f, 1.2));
+  merger.Push(MakePlot(1, 0.0f, 0.0f, 0.9));
+  merger.Push(MakePlot(2, 0.0f, 0.0f, 1.4));
+  merger.Push(MakePlot(1, 0.0f, 0.0f, 1.1));
+  merger.Push(MakePlot(1, 0.0f, 0.0f, 1.05)); // Overtaken in flight
+  merger.Push(MakePlot(9, 0.0f, 0.0f, 1.15)); // Unknown: sensor 0's lane
+  ASSERT_TRUE(merger.Size() == 7);
+
+  std::vector<Plot> out;
+  ASSERT_TRUE(merger.Drain(1.65, out) == 5); // Up to 1.15
+  const double expected[] = {0.9, 1.0, 1.05, 1.1, 1.15};
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_NEAR(out[i].timestamp, expected[i], 0.0);
+  }
+  ASSERT_TRUE(out[4].sensorId == 9);
+  ASSERT_TRUE(merger.Size() == 2);
+
+  ASSERT_TRUE(merger.Drain(1.8, out) == 1); // Appends
+  ASSERT_NEAR(out.back().timestamp, 1.2, 0.0);
+  ASSERT_TRUE(merger.Drain(10.0, out) == 1);
+  ASSERT_TRUE(merger.Size() == 0);
+
+  SensorRegistry immediate;
+  SensorMerger passThrough(immediate);
+  passThrough.Push(MakePlot(0, 0.0f, 0.0f, 50.0)); // Ahead of `now`
+  passThrough.Push(MakePlot(0, 0.0f, 0.0f, 20.0));
+  out.clear();
+  ASSERT_TRUE(passThrough.Drain(0.0, out) == 2);
+  ASSERT_NEAR(out[0].timestamp, 20.0, 0.0);
+}
+
+// Test 4: Two radars at different sites and accuracies build one track in
+// the common frame, and weighting each by its own noise beats giving both
+// the coarser one's (the safe uniform choice: an understated R would make
+// the coarse plots fail the gate)
+TEST(TestTwoSensorTracking) {
+  // Target 200 m/s east along y = 5000; sensor 2 sits 20 km east and is
+  // four times coarser than sensor 1
+  const float sigma1 = 20.0f, sigma2 = 80.0f;
+  const float site2 = 20000.0f;
+  double rms[2];
+  for (int weighted = 0; weighted < 2; ++weighted) {
+    TrackManagerConfig config;
+    config.sensors.push_back(
+        MakeSensor(1, weighted ? sigma1 : sigma2, 0.0, 0.0f, 0.0f));
+    config.sensors.push_back(MakeSensor(2, sigma2, 0.0, site2, 0.0f));
+    TrackManager manager(config);
+    Noise noise{11};
+
+    double squared = 0.0;
+    int compared = 0;
+    std::vector<Plot> plots(2);
+    for (int scan = 0; scan < 60; ++scan) {
+      double t1 = scan, t2 = scan + 0.05;
+      plots[0] = MakePlot(
+          1, static_cast<float>(200.0 * t1 + noise.Gaussian(sigma1)),
+          static_cast<float>(5000.0 + noise.Gaussian(sigma1)), t1);
+      // Sensor 2 reports relative to its own site
+      plots[1] = MakePlot(
+          2, static_cast<float>(200.0 * t2 + noise.Gaussian(sigma2) - site2),
+          static_cast<float>(5000.0 + noise.Gaussian(sigma2)), t2);
+      manager.ProcessScan(plots, t2);
+
+      if (scan < 10) {
+        continue;
+      }
+      TrackSnapshot snapshot;
+      manager.FillSnapshot(snapshot, 0);
+      ASSERT_TRUE(snapshot.tracks.size() == 1);
+      const TrackView &view = snapshot.tracks[0];
+      ASSERT_NEAR(view.lastUpdate, t2, 1e-9);
+      double ex = view.position.x - 200.0 * t2;
+      double ey = view.position.y - 5000.0;
+      squared += ex * ex + ey * ey;
+      compared++;
+    }
+    rms[weighted] = std::sqrt(squared / compared);
+
+    // An unregistered ID is tracked as sensor 0 and counted
+    plots.assign(1, MakePlot(9, 0.0f, -30000.0f, 60.0));
+    manager.ProcessScan(plots, 60.0);
+    std::vector<MetricSample> metrics = manager.GetMetricsRegistry().Snapshot();
+    ASSERT_TRUE(
+        FindMetric(metrics, "aegis_plots_unknown_sensor_total")->value == 1.0);
+  }
+  std::cout << "  position RMS: per-sensor R " << rms[1]
+            << " m, uniform " << sigma2 << " m R " << rms[0] << " m"
+            << std::endl;
+  ASSERT_TRUE(rms[1] < 0.9 * rms[0]);
+}
+
+int main() {
+  std::cout << "\n=== Sensor Fusion Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
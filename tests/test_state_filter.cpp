@@ -0,0 +1,218 @@
+#include "../src/physics/MotionModels.h"
+#include "../src/physics/StateFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+// Largest difference between the model's analytic Jacobian and central
+// finite differences of Predict, in double
+template <typename Model>
+double JacobianError(const double (&x0)[Model::STATE_DIM], double dt) {
+  constexpr int N = Model::STATE_DIM;
+  double F[N * N];
+  Model::Jacobian(x0, dt, F);
+
+  double worst = 0.0;
+  const double h = 1e-6;
+  for (int j = 0; j < N; ++j) {
+    double plus[N], minus[N];
+    for (int k = 0; k < N; ++k) {
+      plus[k] = minus[k] = x0[k];
+    }
+    plus[j] += h;
+    minus[j] -= h;
+    // Test headings stay clear of +-pi, so wrapping cannot distort this
+    Model::Predict(plus, dt);
+    Model::Predict(minus, dt);
+    for (int i = 0; i < N; ++i) {
+      double numeric = (plus[i] - minus[i]) / (2 * h);
+      worst = std::max(worst, std::abs(numeric - F[i * N + j]));
+    }
+  }
+  return worst;
+}
+
+// Test 1: Analytic Jacobians match finite differences for every model
+TEST(TestModelJacobians) {
+  const double cv[4] = {100.0, -50.0, 30.0, -20.0};
+  ASSERT_NEAR(JacobianError<ConstantVelocityModel>(cv, 0.5), 0.0, 1e-6);
+
+  const double ca[6] = {100.0, -50.0, 30.0, -20.0, 2.0, -1.0};
+  ASSERT_NEAR(JacobianError<ConstantAccelerationModel>(ca, 0.5), 0.0, 1e-6);
+
+  const double turning[5] = {100.0, -50.0, 200.0, 0.7, 0.15};
+  ASSERT_NEAR(JacobianError<CtrvModel>(turning, 1.0), 0.0, 1e-4);
+
+  // Near-zero turn rate uses the limiting form
+  const double straight[5] = {100.0, -50.0, 200.0, 0.7, 0.0};
+  ASSERT_NEAR(JacobianError<CtrvModel>(straight, 1.0), 0.0, 1e-3);
+
+  const double climbing[7] = {100.0, -50.0, 3000.0, 200.0, -2.0, -0.1, 15.0};
+  ASSERT_NEAR(JacobianError<CtrvAltitudeModel>(climbing, 1.0), 0.0, 1e-4);
+}
+
+// Deterministic pseudo-noise, uniform in [-scale, scale]
+static double Noise(unsigned int &seed, double scale) {
+  seed = seed * 1664525u + 1013904223u;
+  return (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 2.0 * scale;
+}
+
+// Run one CTRV scenario at a given precision; returns the final state
+template <typename Scalar>
+typename StateFilter<Scalar, CtrvModel>::State RunCtrv(int steps) {
+  StateFilter<Scalar, CtrvModel> filter({0, 0, 0, 0, 0},
+                                        {2500, 2500, 10000, 1, 1},
+                                        {Scalar(0.1), Scalar(0.1), 1,
+                                         Scalar(0.1), Scalar(0.01)},
+                                        2500);
+  unsigned int seed = 7;
+  double tx = 0.0, ty = 0.0, heading = 0.3;
+  for (int step = 0; step < steps; ++step) {
+    heading += 0.02; // Steady turn
+    tx += 150.0 * std::sin(heading);
+    ty += 150.0 * std::cos(heading);
+    filter.Predict(Scalar(1));
+    filter.Update({static_cast<Scalar>(tx + Noise(seed, 30.0)),
+                   static_cast<Scalar>(ty + Noise(seed, 30.0))});
+  }
+  return filter.GetState();
+}
+
+// Test 2: Float and double runs of the same code agree
+TEST(TestFloatMatchesDouble) {
+  auto f = RunCtrv<float>(300);
+  auto d = RunCtrv<double>(300);
+  std::cout << "  float (" << f[0] << ", " << f[1] << ") double (" << d[0]
+            << ", " << d[1] << ")" << std::endl;
+  ASSERT_NEAR(static_cast<double>(f[0]), d[0], 1.0);
+  ASSERT_NEAR(static_cast<double>(f[1]), d[1], 1.0);
+  ASSERT_NEAR(static_cast<double>(f[2]), d[2], 0.1);
+  ASSERT_NEAR(static_cast<double>(f[4]), d[4], 1e-3);
+
+  // The turn rate is observable through the full CTRV Jacobian
+  ASSERT_NEAR(d[4], 0.02, 0.005);
+}
+
+// Test 3: Constant acceleration recovers the acceleration
+TEST(TestConstantAcceleration) {
+  StateFilter<double, ConstantAccelerationModel> filter(
+      {0, 0, 0, 0, 0, 0}, {100, 100, 1e4, 1e4, 100, 100},
+      {0.01, 0.01, 0.01, 0.01, 0.01, 0.01}, 25.0);
+  unsigned int seed = 11;
+  for (int step = 1; step <= 60; ++step) {
+    double t = step * 0.5;
+    filter.Predict(0.5);
+    filter.Update({0.5 * 4.0 * t * t + Noise(seed, 5.0),
+                   50.0 * t - 0.5 * 2.0 * t * t + Noise(seed, 5.0)});
+  }
+  ASSERT_NEAR(filter.GetState(4), 4.0, 0.2);
+  ASSERT_NEAR(filter.GetState(5), -2.0, 0.2);
+}
+
+// Test 4: CTRV with altitude tracks a climbing turn from 3-D plots
+TEST(TestCtrvAltitude) {
+  StateFilter<double, CtrvAltitudeModel> filter(
+      {0, 0, 1000, 0, 0, 0, 0}, {2500, 2500, 2500, 10000, 4, 0.001, 100},
+      {0.1, 0.1, 0.1, 1, 0.1, 0.01, 0.1}, 400.0);
+  unsigned int seed = 3;
+  double tx = 0.0, ty = 0.0, tz = 1000.0, heading = 1.0;
+  for (int step = 0; step < 120; ++step) {
+    heading -= 0.03;
+    tx += 180.0 * std::sin(heading);
+    ty += 180.0 * std::cos(heading);
+    tz += 12.0;
+    filter.Predict(1.0);
+    ASSERT_TRUE(filter.Update({tx + Noise(seed, 20.0), ty + Noise(seed, 20.0),
+                               tz + Noise(seed, 20.0)}));
+  }
+  ASSERT_NEAR(filter.GetState(0), tx, 30.0);
+  ASSERT_NEAR(filter.GetState(2), tz, 30.0);
+  ASSERT_NEAR(filter.GetState(3), 180.0, 5.0);
+  ASSERT_NEAR(filter.GetState(5), -0.03, 0.01);
+  ASSERT_NEAR(filter.GetState(6), 12.0, 1.0);
+
+  // Gate statistic uses the full 3x3 innovation covariance
+  double inGate = filter.MahalanobisDistance(
+      {filter.GetState(0), filter.GetState(1), filter.GetState(2)});
+  ASSERT_NEAR(inGate, 0.0, 1e-9);
+}
+
+// Test 5: A singular innovation covariance is rejected, not applied
+TEST(TestSingularUpdate) {
+  StateFilter<float, ConstantVelocityModel> filter({1, 2, 3, 4}, {0, 0, 0, 0},
+                                                   {0, 0, 0, 0}, 0.0f);
+  ASSERT_TRUE(!filter.Update({10.0f, 10.0f}));
+  ASSERT_NEAR(filter.GetState(0), 1.0f, 0.0f);
+  ASSERT_TRUE(filter.MahalanobisDistance({10.0f, 10.0f}) ==
+              std::numeric_limits<float>::max());
+}
+
+// Test 6: The float sincos is libm's, within 1 ulp of the double result,
+// and cached velocity tracks the state
+TEST(TestSinCos) {
+  double worst = 0.0;
+  const int samples = 2000000;
+  for (int i = 0; i <= samples; ++i) {
+    float x = -1000.0f + 2000.0f * static_cast<float>(i) / samples;
+    float s, c;
+    SinCos(x, s, c);
+    worst = std::max(worst, std::abs(s - std::sin(static_cast<double>(x))));
+    worst = std::max(worst, std::abs(c - std::cos(static_cast<double>(x))));
+  }
+  // Quadrant boundaries and the wrap points
+  for (float x : {0.0f, -0.0f, 0.785398163f, 1.57079633f, 3.14159265f,
+                  -3.14159265f, 4.71238898f, -1.57079633f}) {
+    float s, c;
+    SinCos(x, s, c);
+    worst = std::max(worst, std::abs(s - std::sin(static_cast<double>(x))));
+    worst = std::max(worst, std::abs(c - std::cos(static_cast<double>(x))));
+  }
+  std::cout << "  max |error| over [-1000, 1000] rad: " << worst << std::endl;
+  ASSERT_TRUE(worst <= 6e-8);
+
+  StateFilter<float, CtrvModel> filter({0, 0, 200, 0.5f, 0.05f},
+                                       {2500, 2500, 100, 1, 0.01f},
+                                       {0.1f, 0.1f, 1, 0.1f, 0.01f}, 2500.0f);
+  for (int step = 0; step < 3; ++step) {
+    filter.Predict(1.0f);
+    filter.Update({filter.GetState(0) + 20.0f, filter.GetState(1)});
+    float vx, vy;
+    filter.GetVelocity(vx, vy);
+    ASSERT_NEAR(vx, filter.GetState(2) * std::sin(filter.GetState(3)), 1e-3f);
+    ASSERT_NEAR(vy, filter.GetState(2) * std::cos(filter.GetState(3)), 1e-3f);
+  }
+}
+
+int main() {
+  std::cout << "\n=== State Filter Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "../src/radar/TrackHistory.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+// Test 1: Short trails come back in order at full resolution
+TEST(TestShortTrail) {
+  TrackHistoryArena arena;
+  arena.EnsureSlots(2);
+  arena.Reset(1, 0.0f, 0.0f, 0.0);
+  for (int i = 1; i < 10; ++i) {
+    arena.Append(1, 100.0f * i, 0.0f, 0.1 * i);
+  }
+
+  std::vector<glm::vec2> out(64);
+  size_t n = arena.Query(1, 0.0f, out.data(), out.size());
+  ASSERT_TRUE(n == 10);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_NEAR(out[i].x, 100.0f * i, 0.01f); // Oldest first
+  }
+}
+
+// Test 2: Memory is bounded and old points are thinned by time bucket
+TEST(TestBoundedDecimation) {
+  TrackHistoryConfig config;
+  config.fineCapacity = 16;
+  config.coarseCapacity = 8;
+  config.coarseInterval = 1.0;
+  TrackHistoryArena arena(config);
+  arena.EnsureSlots(1);
+
+  // One hour of 10 Hz updates
+  arena.Reset(0, 0.0f, 0.0f, 0.0);
+  for (int i = 1; i < 36000; ++i) {
+    arena.Append(0, static_cast<float>(i), 0.0f, 0.1 * i);
+  }
+  ASSERT_TRUE(arena.Count(0) == 24);
+
+  std::vector<glm::vec2> out(64);
+  size_t n = arena.Query(0, 0.0f, out.data(), out.size());
+  ASSERT_TRUE(n == 24);
+  // Newest point is last; the fine segment is consecutive
+  ASSERT_NEAR(out[n - 1].x, 35999.0f, 0.5f);
+  ASSERT_NEAR(out[n - 2].x, 35998.0f, 0.5f);
+  // Coarse segment holds one point per second (10 updates)
+  for (size_t i = 1; i < 8; ++i) {
+    ASSERT_NEAR(out[i].x - out[i - 1].x, 10.0f, 0.5f);
+  }
+}
+
+// Test 3: LOD query merges sub-resolution points but keeps the newest
+TEST(TestLevelOfDetail) {
+  TrackHistoryArena arena;
+  arena.EnsureSlots(1);
+  arena.Reset(0, 0.0f, 0.0f, 0.0);
+  for (int i = 1; i < 64; ++i) {
+    arena.Append(0, 10.0f * i, 0.0f, 0.1 * i);
+  }
+
+  std::vector<glm::vec2> out(64);
+  size_t full = arena.Query(0, 0.0f, out.data(), out.size());
+  size_t coarse = arena.Query(0, 95.0f, out.data(), out.size());
+  ASSERT_TRUE(full == 64);
+  ASSERT_TRUE(coarse <= 7);
+  ASSERT_NEAR(out[coarse - 1].x, 630.0f, 0.01f);
+
+  // Output cap favours the newest points
+  size_t capped = arena.Query(0, 0.0f, out.data(), 4);
+  ASSERT_TRUE(capped == 4);
+  ASSERT_NEAR(out[0].x, 600.0f, 0.01f);
+
+  // Snapshot-side decimation matches the arena query
+  std::vector<glm::vec2> src(64), dst(64);
+  size_t n = arena.Query(0, 0.0f, src.data(), src.size());
+  size_t m = DecimateTrail(src.data(), n, 95.0f, dst.data(), dst.size());
+  ASSERT_TRUE(m == coarse);
+}
+
+int main() {
+  std::cout << "\n=== Track History Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,220 @@
+#include "../src/radar/TrackInitiator.h"
+#include "../src/radar/TrackManager.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_NEAR(a, b, tolerance)                                           \
+  if (std::abs((a) - (b)) > (tolerance)) {                                     \
+    std::cerr << "  FAILED: " << #a << " (" << (a) << ") != " << #b << " ("   \
+              << (b) << "), diff = " << std::abs((a) - (b)) << std::endl;      \
+    exit(1);                                                                   \
+  }
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+using Filter = ExtendedKalmanFilter::Filter;
+
+// Deterministic Gaussian noise (LCG + Box-Muller)
+struct Noise {
+  unsigned int seed;
+  double Uniform() {
+    seed = seed * 1664525u + 1013904223u;
+    return (static_cast<double>(seed >> 8) + 0.5) / 16777216.0;
+  }
+  double Gaussian(double sigma) {
+    double u1 = Uniform(), u2 = Uniform();
+    return sigma * std::sqrt(-2.0 * std::log(u1)) *
+           std::cos(2.0 * 3.14159265358979323846 * u2);
+  }
+};
+
+// Test 1: The seed carries the differenced kinematics, and its covariance
+// matches the empirical spread of seeds from noisy plot pairs
+TEST(TestSeedKinematicsAndCovariance) {
+  // 300 m/s heading 60 deg (clockwise from north), plots 2 s apart
+  const double heading = 3.14159265358979323846 / 3.0;
+  const double vx = 300.0 * std::sin(heading), vy = 300.0 * std::cos(heading);
+  TrackSeed exact = TrackInitiator::MakeSeed(
+      0.0f, 0.0f, 10.0, static_cast<float>(2.0 * vx),
+      static_cast<float>(2.0 * vy), 12.0, 2500.0f);
+  ASSERT_NEAR(exact.speed, 300.0f, 1e-2f);
+  ASSERT_NEAR(exact.heading, static_cast<float>(heading), 1e-5f);
+  ASSERT_TRUE(exact.plots == 2);
+
+  Noise noise{21};
+  const int samples = 20000;
+  double sum[4] = {0, 0, 0, 0};
+  double cross[4][4] = {};
+  for (int n = 0; n < samples; ++n) {
+    TrackSeed s = TrackInitiator::MakeSeed(
+        static_cast<float>(noise.Gaussian(50.0)),
+        static_cast<float>(noise.Gaussian(50.0)), 10.0,
+        static_cast<float>(2.0 * vx + noise.Gaussian(50.0)),
+        static_cast<float>(2.0 * vy + noise.Gaussian(50.0)), 12.0, 2500.0f);
+    double e[4] = {s.x - 2.0 * vx, s.y - 2.0 * vy, s.speed - 300.0,
+                   s.heading - heading};
+    for (int i = 0; i < 4; ++i) {
+      sum[i] += e[i];
+      for (int j = 0; j < 4; ++j)
+        cross[i][j] += e[i] * e[j];
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    for (int j = i; j < 4; ++j) {
+      double empirical =
+          cross[i][j] / samples - (sum[i] / samples) * (sum[j] / samples);
+      double predicted = exact.covariance[Filter::PackedIndex(i, j)];
+      double scale = std::sqrt(exact.covariance[Filter::PackedIndex(i, i)] *
+                               exact.covariance[Filter::PackedIndex(j, j)]);
+      // Within 5% of the geometric-mean variance
+      ASSERT_NEAR(empirical / scale, predicted / scale, 0.05);
+    }
+  }
+}
+
+// Test 2: A slow target's heading variance is capped at the single-plot
+// prior and the covariance stays positive definite
+TEST(TestSlowSeedStaysPositiveDefinite) {
+  TrackSeed s = TrackInitiator::MakeSeed(0.0f, 0.0f, 0.0, 0.0f, 0.0f, 1.0,
+                                         2500.0f);
+  ASSERT_NEAR(s.covariance[Filter::PackedIndex(3, 3)], 1.0f, 1e-6f);
+
+  // Cholesky of the full matrix succeeds
+  double L[5][5] = {};
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      double sum = s.covariance[Filter::PackedIndex(i, j)];
+      for (int k = 0; k < j; ++k)
+        sum -= L[i][k] * L[j][k];
+      if (i == j) {
+        ASSERT_TRUE(sum > 0.0);
+        L[i][i] = std::sqrt(sum);
+      } else {
+        L[i][j] = sum / L[j][j];
+      }
+    }
+  }
+}
+
+// Test 3: Pairing is velocity bounded, never within a scan, and lone
+// plots expire
+TEST(TestPairingGate) {
+  TrackInitiatorConfig config;
+  config.maxTargetSpeed = 500.0f;
+  config.maxCandidateAge = 2.5;
+  TrackInitiator initiator(config);
+  TrackSeed seed;
+
+  initiator.BeginScan(0.0);
+  ASSERT_TRUE(!initiator.Offer(0.0f, 0.0f, 0.0, seed));
+  ASSERT_TRUE(!initiator.Offer(100.0f, 0.0f, 0.0, seed)); // Same scan
+  ASSERT_TRUE(initiator.GetCandidateCount() == 2);
+
+  // 2 km in 1 s is beyond 500 m/s plus the noise margin
+  initiator.BeginScan(1.0);
+  ASSERT_TRUE(!initiator.Offer(0.0f, 2000.0f, 1.0, seed));
+  // 400 m in 1 s pairs, with the nearer-in-gate candidate (100, 0)
+  ASSERT_TRUE(initiator.Offer(100.0f, 400.0f, 1.0, seed));
+  ASSERT_NEAR(seed.speed, 400.0f, 1e-3f);
+  ASSERT_NEAR(seed.heading, 0.0f, 1e-5f);
+  ASSERT_TRUE(initiator.GetCandidateCount() == 2);
+
+  // (0, 0) from t=0 expires at t=3; (0, 2000) from t=1 is still young
+  ASSERT_TRUE(initiator.BeginScan(3.0) == 1);
+  ASSERT_TRUE(initiator.GetCandidateCount() == 1);
+  ASSERT_TRUE(initiator.Offer(0.0f, 2600.0f, 3.0, seed));
+  ASSERT_NEAR(seed.speed, 300.0f, 1e-3f);
+}
+
+// Clutter that never repeats within the pairing gate, plus a few targets
+static void FillScan(std::vector<Plot> &plots, int scan, double t) {
+  plots.clear();
+  for (uint32_t target = 0; target < 4; ++target) {
+    Plot p{};
+    p.x = 2000.0f * target + 150.0f * scan;
+    p.y = 100.0f * scan;
+    p.timestamp = t;
+    plots.push_back(p);
+  }
+  for (uint32_t k = 0; k < 20; ++k) {
+    Plot p{};
+    p.x = -50000.0f + 3000.0f * k;
+    p.y = 50000.0f + 3000.0f * static_cast<float>(scan % 37);
+    p.timestamp = t;
+    plots.push_back(p);
+  }
+}
+
+// Test 4: In clutter, only the real targets become tracks; with
+// single-plot initiation every clutter plot would
+TEST(TestClutterDoesNotSpawnTracks) {
+  for (bool twoPoint : {true, false}) {
+    TrackManagerConfig config;
+    config.twoPointInitiation = twoPoint;
+    TrackManager manager(config);
+    std::vector<Plot> plots;
+    double t = 0.0;
+    for (int scan = 0; scan < 50; ++scan, t += 1.0) {
+      FillScan(plots, scan, t);
+      manager.ProcessScan(plots, t);
+    }
+    const auto &metrics = manager.GetMetrics();
+    std::cout << "  " << (twoPoint ? "two-point" : "single-plot")
+              << ": tracks created " << metrics.tracksCreated
+              << ", confirmed " << metrics.confirmedTracks << std::endl;
+    ASSERT_TRUE(metrics.confirmedTracks == 4);
+    if (twoPoint) {
+      ASSERT_TRUE(metrics.tracksCreated == 4);
+    } else {
+      ASSERT_TRUE(metrics.tracksCreated > 50 * 20);
+    }
+  }
+}
+
+// Test 5: A seeded track starts with the target's velocity, so it holds a
+// fast target from its first update where a single-plot start loses it
+TEST(TestSeededTrackHoldsFastTarget) {
+  TrackManager manager;
+  std::vector<Plot> plots(1);
+  double t = 0.0;
+  for (int scan = 0; scan < 6; ++scan, t += 1.0) {
+    plots[0] = Plot{};
+    plots[0].x = 250.0f * scan;
+    plots[0].y = 250.0f * scan;
+    plots[0].timestamp = t;
+    manager.ProcessScan(plots, t);
+  }
+  const auto &metrics = manager.GetMetrics();
+  ASSERT_TRUE(metrics.tracksCreated == 1);
+  ASSERT_TRUE(metrics.confirmedTracks == 1);
+
+  TrackSnapshot snapshot;
+  manager.FillSnapshot(snapshot, 0);
+  ASSERT_TRUE(snapshot.tracks.size() == 1);
+  ASSERT_NEAR(snapshot.tracks[0].velocity.x, 250.0f, 5.0f);
+  ASSERT_NEAR(snapshot.tracks[0].velocity.y, 250.0f, 5.0f);
+}
+
+int main() {
+  std::cout << "\n=== Track Initiator Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,188 @@
+#include "../src/radar/TrackManager.h"
+#include "../src/radar/TrackPool.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+// Count every global heap allocation so steady-state paths can be checked
+static std::atomic<size_t> g_allocations{0};
+
+void *operator new(std::size_t size) {
+  g_allocations++;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Simple test framework
+#define TEST(name)                                                             \
+  void name();                                                                 \
+  struct name##_runner {                                                       \
+    name##_runner() {                                                          \
+      std::cout << "Running " << #name << "..." << std::endl;                  \
+      name();                                                                  \
+      std::cout << "  PASSED" << std::endl;                                    \
+    }                                                                          \
+  } name##_instance;                                                           \
+  void name()
+
+#define ASSERT_TRUE(condition)                                                 \
+  if (!(condition)) {                                                          \
+    std::cerr << "  FAILED: " << #condition << " is false" << std::endl;       \
+    exit(1);                                                                   \
+  }
+
+using namespace aegis;
+
+// Test 1: Handles resolve while alive and go stale after destroy
+TEST(TestHandleLifecycle) {
+  TrackPool pool(4);
+
+  TrackHandle a = pool.Create(1, 10.0f, 20.0f, 0.0);
+  TrackHandle b = pool.Create(2, 30.0f, 40.0f, 0.0);
+  ASSERT_TRUE(pool.Size() == 2);
+  ASSERT_TRUE(pool.Get(a) && pool.Get(a)->GetId() == 1);
+  ASSERT_TRUE(pool.Get(b) && pool.Get(b)->GetId() == 2);
+
+  pool.Destroy(a);
+  ASSERT_TRUE(pool.Get(a) == nullptr);
+  ASSERT_TRUE(pool.Size() == 1);
+
+  // The freed slot is reused with a new generation
+  TrackHandle c = pool.Create(3, 0.0f, 0.0f, 1.0);
+  ASSERT_TRUE(c.index == a.index);
+  ASSERT_TRUE(c.generation != a.generation);
+  ASSERT_TRUE(pool.Get(a) == nullptr);
+  ASSERT_TRUE(pool.Get(c)->GetId() == 3);
+  ASSERT_TRUE(pool.Get(c)->GetHitCount() == 1);
+
+  // Double destroy is harmless
+  pool.Destroy(a);
+  ASSERT_TRUE(pool.Size() == 2);
+}
+
+// Test 2: Pool grows past its initial capacity without invalidating handles
+TEST(TestPoolGrowth) {
+  TrackPool pool(2);
+  std::vector<TrackHandle> handles;
+  for (uint32_t i = 0; i < 50; ++i) {
+    handles.push_back(pool.Create(i, static_cast<float>(i), 0.0f, 0.0));
+  }
+  ASSERT_TRUE(pool.Capacity() >= 50);
+  for (uint32_t i = 0; i < 50; ++i) {
+    ASSERT_TRUE(pool.Get(handles[i])->GetId() == i);
+  }
+}
+
+// One scan of a cluttered scene: a few real targets that keep updating plus
+// fresh clutter plots far from everything, each spawning a short-lived track
+// under single-plot initiation
+static void FillScan(std::vector<Plot> &plots, int scan, double t) {
+  plots.clear();
+  for (uint32_t target = 0; target < 4; ++target) {
+    Plot p{};
+    p.id = target;
+    p.x = 2000.0f * target;
+    p.y = 10.0f * scan;
+    p.timestamp = t;
+    plots.push_back(p);
+  }
+  for (uint32_t k = 0; k < 20; ++k) {
+    Plot p{};
+    p.id = 1000 + k;
+    p.x = -50000.0f + 3000.0f * k;
+    p.y = 50000.0f + 3000.0f * static_cast<float>(scan % 37);
+    p.timestamp = t;
+    plots.push_back(p);
+  }
+}
+
+// Test 3: Track birth/death and updates in steady state never allocate
+TEST(TestSteadyStateZeroAllocation) {
+  TrackManagerConfig config;
+  config.twoPointInitiation = false; // Every clutter plot starts a track
+  TrackManager manager(config);
+  std::vector<Plot> plots;
+  plots.reserve(64);
+
+  // Warm up until tracks are being pruned as fast as they are created
+  double t = 0.0;
+  int scan = 0;
+  for (; scan < 60; ++scan, t += 1.0) {
+    FillScan(plots, scan, t);
+    manager.ProcessScan(plots, t);
+  }
+  size_t warmCount = manager.GetTrackCount();
+
+  size_t before = g_allocations.load();
+  for (; scan < 300; ++scan, t += 1.0) {
+    FillScan(plots, scan, t);
+    manager.ProcessScan(plots, t);
+  }
+  size_t allocations = g_allocations.load() - before;
+
+  std::cout << "  Live tracks: " << manager.GetTrackCount()
+            << " (warm: " << warmCount << ")" << std::endl;
+  std::cout << "  Tracks created: " << manager.GetMetrics().tracksCreated
+            << ", allocations in steady state: " << allocations << std::endl;
+  ASSERT_TRUE(manager.GetMetrics().tracksCreated > 4000);
+  ASSERT_TRUE(allocations == 0);
+}
+
+// Test 4: Caps hold under a clutter burst; only tentative tracks are evicted
+TEST(TestCapacityEviction) {
+  TrackManagerConfig config;
+  config.twoPointInitiation = false; // Every clutter plot starts a track
+  config.maxTracks = 40;
+  config.maxTentativeTracks = 30;
+  TrackManager manager(config);
+  std::vector<Plot> plots;
+
+  // Let the real targets confirm first
+  double t = 0.0;
+  int scan = 0;
+  for (; scan < 5; ++scan, t += 1.0) {
+    FillScan(plots, scan, t);
+    plots.resize(4);
+    manager.ProcessScan(plots, t);
+  }
+  manager.UpdateMetrics();
+  ASSERT_TRUE(manager.GetMetrics().confirmedTracks == 4);
+
+  for (; scan < 40; ++scan, t += 1.0) {
+    FillScan(plots, scan, t);
+    manager.ProcessScan(plots, t);
+    ASSERT_TRUE(manager.GetTrackCount() <= config.maxTracks);
+    ASSERT_TRUE(manager.GetMetrics().tentativeTracks <=
+                static_cast<int>(config.maxTentativeTracks));
+  }
+
+  const auto &metrics = manager.GetMetrics();
+  std::cout << "  Evicted: " << metrics.tracksEvicted << std::endl;
+  ASSERT_TRUE(metrics.tracksEvicted > 0);
+  ASSERT_TRUE(metrics.confirmedTracks + metrics.coastingTracks == 4);
+
+  // With every slot held by a confirmed track, new plots are shed instead
+  config.maxTracks = 4;
+  TrackManager full(config);
+  for (scan = 0, t = 0.0; scan < 10; ++scan, t += 1.0) {
+    FillScan(plots, scan, t);
+    if (scan < 5)
+      plots.resize(4);
+    full.ProcessScan(plots, t);
+  }
+  ASSERT_TRUE(full.GetTrackCount() == 4);
+  ASSERT_TRUE(full.GetMetrics().confirmedTracks == 4);
+  ASSERT_TRUE(full.GetMetrics().plotsDroppedAtCapacity == 100);
+}
+
+int main() {
+  std::cout << "\n=== Track Pool Unit Tests ===" << std::endl;
+  std::cout << "\nAll tests passed!\n" << std::endl;
+  return 0;
+}